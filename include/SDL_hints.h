@@ -83,6 +83,44 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_DRIVER              "SDL_RENDER_DRIVER"
 
+/**
+ *  \brief  A variable controlling how many buffers OpenGL streaming textures are locked into
+ *
+ *  With more than one buffer, each SDL_LockTexture() call returns the next
+ *  pixel buffer object in turn, and SDL_UnlockTexture() starts the upload
+ *  without waiting for it, so filling the next frame overlaps the upload of
+ *  the previous one.  The locked pixels then don't hold the previous contents
+ *  of the texture, so the whole locked area should be written.
+ *
+ *  This variable can be set to the following values:
+ *    "1"       - Upload from a single buffer in client memory (default)
+ *    "N"       - Cycle through N pixel buffer objects, up to 8
+ *
+ *  The value is read when a texture is created.  It has no effect when
+ *  GL_ARB_pixel_buffer_object isn't available, or with renderers that
+ *  lock the texture memory directly, such as the software renderer.
+ */
+#define SDL_HINT_RENDER_STREAMING_BUFFERS "SDL_RENDER_STREAMING_BUFFERS"
+
+/**
+ *  \brief  A variable controlling how much memory the software renderer may use for tinted texture copies
+ *
+ *  When a texture is drawn with a color or alpha modulation, the software
+ *  renderer can keep a copy of it with the modulation already applied, so
+ *  drawing it again with the same modulation is a plain blit.  A few copies
+ *  are kept per texture, and the least recently used ones are dropped when
+ *  the limit is reached.  Blended copies may differ very slightly from
+ *  uncached ones, because the plain blitters round differently.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Don't keep modulated copies (default)
+ *    "N"       - Keep up to N kilobytes of modulated copies
+ *
+ *  The value is read when the renderer is created.  Only 32-bit textures
+ *  that aren't render targets are cached.
+ */
+#define SDL_HINT_RENDER_SOFTWARE_MODULATE_CACHE "SDL_RENDER_SOFTWARE_MODULATE_CACHE"
+
 /**
  *  \brief  A variable controlling whether the OpenGL render driver uses shaders if they are available.
  *
@@ -123,7 +161,8 @@ extern "C" {
  *
  *  This variable can be set to the following values:
  *    "0" or "nearest" - Nearest pixel sampling
- *    "1" or "linear"  - Linear filtering (supported by OpenGL and Direct3D)
+ *    "1" or "linear"  - Linear filtering (supported by OpenGL, Direct3D and the
+ *                       software renderer for 32-bit textures)
  *    "2" or "best"    - Currently this is the same as "linear"
  *
  *  By default nearest pixel sampling is used
@@ -571,6 +610,52 @@ extern "C" {
  */
 #define SDL_HINT_NO_SIGNAL_HANDLERS   "SDL_NO_SIGNAL_HANDLERS"
 
+/**
+ *  \brief  A variable controlling how many worker threads are used for large software blits
+ *
+ *  Unscaled blits, surface conversions, YUV texture conversions and
+ *  rectangle fills covering a large area are split into horizontal bands,
+ *  which are processed by this many worker threads in addition to the
+ *  calling thread.  RLE accelerated
+ *  surfaces are always blitted on the calling thread.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Blits are done on the calling thread
+ *    "N"       - Up to N worker threads help with large blits
+ *
+ *  By default blits are done on the calling thread.
+ */
+#define SDL_HINT_BLIT_THREADS   "SDL_BLIT_THREADS"
+
+/**
+ *  \brief  A variable controlling the YUV conversion matrix used by software YUV textures and SDL_ConvertPixels()
+ *
+ *  This variable can be set to the following values:
+ *    "JPEG"        - Full range BT.601, as used by JPEG (default)
+ *    "BT601"       - Limited range BT.601, as used by standard definition video
+ *    "BT709"       - Limited range BT.709, as used by high definition video
+ *    "BT709_FULL"  - Full range BT.709
+ *    "AUTOMATIC"   - Limited range BT.601 for textures up to 576 pixels high,
+ *                    limited range BT.709 for larger ones
+ *
+ *  The mode is chosen when a texture is created, and each time SDL_ConvertPixels()
+ *  converts to or from a YUV format.
+ */
+#define SDL_HINT_YUV_CONVERSION_MODE   "SDL_YUV_CONVERSION_MODE"
+
+/**
+ *  \brief  A variable controlling how SDL_ConvertPixels() resamples the chroma of YUV images
+ *
+ *  This variable can be set to the following values:
+ *    "NEAREST"     - Use the chroma of the top left pixel of each block when
+ *                    subsampling, and duplicate it when upsampling
+ *    "LINEAR"      - Average the pixels of each block when subsampling, and
+ *                    interpolate between neighboring samples when upsampling (default)
+ *
+ *  Software YUV textures always use nearest neighbor upsampling.
+ */
+#define SDL_HINT_YUV_CHROMA_FILTER   "SDL_YUV_CHROMA_FILTER"
+
 /**
  *  \brief  An enumeration of hint priorities
  */
@@ -137,6 +137,136 @@ extern DECLSPEC SDL_bool SDLCALL SDL_IntersectRectAndLine(const SDL_Rect *
                                                           int *Y1, int *X2,
                                                           int *Y2);
 
+/**
+ *  \brief A set of pixels described by non-overlapping rectangles.
+ *
+ *  The rectangles are kept in y-x banded order: they are sorted top to
+ *  bottom, rectangles sharing a band have the same y and h and are sorted
+ *  left to right, and no two rectangles overlap or touch horizontally.
+ *  This makes it cheap to track dirty areas and hand them to
+ *  SDL_UpdateWindowSurfaceRects() or SDL_RenderFillRects().
+ *
+ *  \sa SDL_CreateRegion
+ *  \sa SDL_GetRegionRects
+ */
+typedef struct SDL_Region SDL_Region;
+
+/**
+ *  \brief Create a new, empty region.
+ *
+ *  \return The new region, or NULL if there was not enough memory.
+ *
+ *  \sa SDL_FreeRegion
+ */
+extern DECLSPEC SDL_Region * SDLCALL SDL_CreateRegion(void);
+
+/**
+ *  \brief Free a region created with SDL_CreateRegion().
+ */
+extern DECLSPEC void SDLCALL SDL_FreeRegion(SDL_Region * region);
+
+/**
+ *  \brief Remove all rectangles from a region, keeping its memory for reuse.
+ */
+extern DECLSPEC void SDLCALL SDL_ClearRegion(SDL_Region * region);
+
+/**
+ *  \brief Add the area of a rectangle to a region.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_AddRectToRegion(SDL_Region * region,
+                                                const SDL_Rect * rect);
+
+/**
+ *  \brief Add the area of a number of rectangles to a region.
+ *
+ *  This is much faster than adding the rectangles one at a time.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_AddRectsToRegion(SDL_Region * region,
+                                                 const SDL_Rect * rects,
+                                                 int count);
+
+/**
+ *  \brief Remove the area of a rectangle from a region.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_SubtractRectFromRegion(SDL_Region * region,
+                                                       const SDL_Rect * rect);
+
+/**
+ *  \brief Clip a region to a rectangle.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_IntersectRegionWithRect(SDL_Region * region,
+                                                        const SDL_Rect * rect);
+
+/**
+ *  \brief Add the area of region \c src to region \c dst.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_UnionRegion(SDL_Region * dst,
+                                            const SDL_Region * src);
+
+/**
+ *  \brief Remove the area of region \c src from region \c dst.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_SubtractRegion(SDL_Region * dst,
+                                               const SDL_Region * src);
+
+/**
+ *  \brief Clip region \c dst to the area of region \c src.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_IntersectRegion(SDL_Region * dst,
+                                                const SDL_Region * src);
+
+/**
+ *  \brief Reduce a region to at most \c maxrects rectangles.
+ *
+ *  The result covers at least the original area.  Gaps are filled in
+ *  cheapest first, so little extra area is added.  This is useful before
+ *  pushing a dirty region to the screen, where every rectangle has a
+ *  fixed cost.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_SimplifyRegion(SDL_Region * region,
+                                               int maxrects);
+
+/**
+ *  \brief Returns true if the region has no area.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_RegionEmpty(const SDL_Region * region);
+
+/**
+ *  \brief Get the smallest rectangle enclosing a region.
+ *
+ *  \return SDL_TRUE if the region is not empty, SDL_FALSE otherwise.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_GetRegionBounds(const SDL_Region * region,
+                                                     SDL_Rect * rect);
+
+/**
+ *  \brief Get the rectangles making up a region.
+ *
+ *  \param region The region to query.
+ *  \param count  Filled in with the number of rectangles returned.
+ *
+ *  \return A pointer to the rectangles in y-x banded order.  It stays
+ *          valid until the region is next modified or freed.
+ */
+extern DECLSPEC const SDL_Rect * SDLCALL SDL_GetRegionRects(const SDL_Region * region,
+                                                            int *count);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
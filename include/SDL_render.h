@@ -127,6 +127,12 @@ typedef struct SDL_Renderer SDL_Renderer;
 struct SDL_Texture;
 typedef struct SDL_Texture SDL_Texture;
 
+/**
+ *  \brief A pending read of pixels from a rendering target
+ */
+struct SDL_RenderReadback;
+typedef struct SDL_RenderReadback SDL_RenderReadback;
+
 
 /* Function prototypes */
 
@@ -825,6 +831,63 @@ extern DECLSPEC int SDLCALL SDL_RenderReadPixels(SDL_Renderer * renderer,
                                                  Uint32 format,
                                                  void *pixels, int pitch);
 
+/**
+ *  \brief Start reading pixels from the current rendering target.
+ *
+ *  The pixels are captured as they are when this function is called, but
+ *  the renderer may finish transferring them and converting them to the
+ *  requested format later, while you keep rendering.
+ *
+ *  \param renderer The renderer from which pixels should be read.
+ *  \param rect   A pointer to the rectangle to read, or NULL for the entire
+ *                render target.
+ *  \param format The desired format of the pixel data, or 0 to use the format
+ *                of the rendering target
+ *
+ *  \return A readback to pass to SDL_WaitRenderReadback(), or NULL on error.
+ *
+ *  \sa SDL_PollRenderReadback()
+ *  \sa SDL_WaitRenderReadback()
+ *  \sa SDL_DestroyRenderReadback()
+ */
+extern DECLSPEC SDL_RenderReadback * SDLCALL SDL_RenderReadPixelsAsync(SDL_Renderer * renderer,
+                                                                      const SDL_Rect * rect,
+                                                                      Uint32 format);
+
+/**
+ *  \brief Check whether the pixels of a readback are available.
+ *
+ *  \return SDL_TRUE if SDL_WaitRenderReadback() would return without waiting,
+ *          or SDL_FALSE if the readback is still in progress.
+ *
+ *  \note This should be called on the thread that uses the renderer.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_PollRenderReadback(SDL_RenderReadback * readback);
+
+/**
+ *  \brief Wait for a readback to complete and copy its pixels.
+ *
+ *  \param readback The readback returned by SDL_RenderReadPixelsAsync().
+ *  \param pixels A pointer to be filled in with the pixel data
+ *  \param pitch  The pitch of the pixels parameter.
+ *
+ *  \return 0 on success, or -1 if the pixels couldn't be read.
+ *
+ *  \note This should be called on the thread that uses the renderer.
+ *
+ *  \sa SDL_RenderReadPixels()
+ */
+extern DECLSPEC int SDLCALL SDL_WaitRenderReadback(SDL_RenderReadback * readback,
+                                                   void *pixels, int pitch);
+
+/**
+ *  \brief Destroy a readback, cancelling it if it is still in progress.
+ *
+ *  Readbacks which haven't been destroyed are destroyed along with their
+ *  renderer.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRenderReadback(SDL_RenderReadback * readback);
+
 /**
  *  \brief Update the screen with rendering performed.
  */
@@ -53,6 +53,8 @@ extern "C" {
 #define SDL_PREALLOC        0x00000001  /**< Surface uses preallocated memory */
 #define SDL_RLEACCEL        0x00000002  /**< Surface is RLE encoded */
 #define SDL_DONTFREE        0x00000004  /**< Surface is referenced internally */
+#define SDL_PREMULTIPLIED   0x00000008  /**< Surface colors are premultiplied by alpha */
+#define SDL_SIMD_ALIGNED    0x00000010  /**< Surface rows start on SIMD aligned addresses */
 /* @} *//* Surface flags */
 
 /**
@@ -97,6 +99,20 @@ typedef struct SDL_Surface
 typedef int (*SDL_blit) (struct SDL_Surface * src, SDL_Rect * srcrect,
                          struct SDL_Surface * dst, SDL_Rect * dstrect);
 
+/**
+ * \brief The filter used when a surface is blitted with SDL_BlitScaled().
+ */
+typedef enum
+{
+    SDL_SCALEMODE_NEAREST = 0,  /**< nearest pixel sampling */
+    SDL_SCALEMODE_LINEAR        /**< bilinear filtering */
+} SDL_ScaleMode;
+
+/**
+ *  The alignment of the pixels allocated for surfaces, in bytes.
+ */
+#define SDL_SURFACE_ALIGNMENT   64
+
 /**
  *  Allocate and free an RGB surface.
  *
@@ -104,9 +120,14 @@ typedef int (*SDL_blit) (struct SDL_Surface * src, SDL_Rect * srcrect,
  *  If the depth is greater than 8 bits, the pixel format is set using the
  *  flags '[RGB]mask'.
  *
+ *  Passing ::SDL_SIMD_ALIGNED allocates the pixels on a ::SDL_SURFACE_ALIGNMENT
+ *  byte boundary and pads the pitch to a multiple of that, so every row is
+ *  aligned and the SIMD blitters can skip their unaligned paths.  The pixels
+ *  of such a surface must not be freed or replaced by the application.
+ *
  *  If the function runs out of memory, it will return NULL.
  *
- *  \param flags The \c flags are obsolete and should be set to 0.
+ *  \param flags 0, or ::SDL_SIMD_ALIGNED to pad the rows for SIMD access.
  *  \param width The width in pixels of the surface to create.
  *  \param height The height in pixels of the surface to create.
  *  \param depth The depth in bits of the surface to create.
@@ -129,6 +150,51 @@ extern DECLSPEC SDL_Surface *SDLCALL SDL_CreateRGBSurfaceFrom(void *pixels,
                                                               Uint32 Amask);
 extern DECLSPEC void SDLCALL SDL_FreeSurface(SDL_Surface * surface);
 
+/**
+ *  \brief A pool of pixel buffers that is shared by the surfaces created from it.
+ *
+ *  When a surface created from a pool is freed, its pixels go back to the
+ *  pool instead of the heap, and are handed out again to the next surface
+ *  that needs a buffer of the same size class.  This avoids heap churn when
+ *  temporary surfaces are created and freed every frame.
+ *
+ *  A pool can be used from any thread.
+ */
+typedef struct SDL_SurfacePool SDL_SurfacePool;
+
+/**
+ *  \brief Create a surface pool.
+ *
+ *  \param max_bytes The most memory the pool keeps in unused buffers, or 0
+ *                   for no limit.
+ *
+ *  \return The new pool, or NULL if there was no memory.
+ *
+ *  \sa SDL_CreateRGBSurfaceFromPool()
+ *  \sa SDL_FreeSurfacePool()
+ */
+extern DECLSPEC SDL_SurfacePool *SDLCALL SDL_CreateSurfacePool(size_t max_bytes);
+
+/**
+ *  \brief Create an RGB surface whose pixels come from a pool.
+ *
+ *  This works like SDL_CreateRGBSurface(), and the surface is still freed
+ *  with SDL_FreeSurface().  Recycled pixels are cleared to zero.  The pixels
+ *  are aligned like those of ::SDL_SIMD_ALIGNED surfaces, and must not be
+ *  freed or replaced by the application either.
+ */
+extern DECLSPEC SDL_Surface *SDLCALL SDL_CreateRGBSurfaceFromPool
+    (SDL_SurfacePool * pool, Uint32 flags, int width, int height, int depth,
+     Uint32 Rmask, Uint32 Gmask, Uint32 Bmask, Uint32 Amask);
+
+/**
+ *  \brief Free a surface pool and its unused buffers.
+ *
+ *  Surfaces created from the pool stay valid, and their pixels are released
+ *  to the heap when they are freed.
+ */
+extern DECLSPEC void SDLCALL SDL_FreeSurfacePool(SDL_SurfacePool * pool);
+
 /**
  *  \brief Set the palette used by a surface.
  *
@@ -321,6 +387,37 @@ extern DECLSPEC int SDLCALL SDL_SetSurfaceBlendMode(SDL_Surface * surface,
 extern DECLSPEC int SDLCALL SDL_GetSurfaceBlendMode(SDL_Surface * surface,
                                                     SDL_BlendMode *blendMode);
 
+/**
+ *  \brief Set the filter used when the surface is blitted with scaling.
+ *
+ *  \param surface The surface to update.
+ *  \param scaleMode ::SDL_ScaleMode to use for scaled blits.
+ *
+ *  \return 0 on success, or -1 if the parameters are not valid.
+ *
+ *  \note Linear filtering is only done for 32-bit RGB and RGBA surfaces
+ *        without a color key, other surfaces are scaled with nearest
+ *        pixel sampling.
+ *
+ *  \sa SDL_GetSurfaceScaleMode()
+ *  \sa SDL_BlitScaled()
+ */
+extern DECLSPEC int SDLCALL SDL_SetSurfaceScaleMode(SDL_Surface * surface,
+                                                    SDL_ScaleMode scaleMode);
+
+/**
+ *  \brief Get the filter used when the surface is blitted with scaling.
+ *
+ *  \param surface   The surface to query.
+ *  \param scaleMode A pointer filled in with the current scale mode.
+ *
+ *  \return 0 on success, or -1 if the surface is not valid.
+ *
+ *  \sa SDL_SetSurfaceScaleMode()
+ */
+extern DECLSPEC int SDLCALL SDL_GetSurfaceScaleMode(SDL_Surface * surface,
+                                                    SDL_ScaleMode *scaleMode);
+
 /**
  *  Sets the clipping rectangle for the destination surface in a blit.
  *
@@ -364,7 +461,15 @@ extern DECLSPEC SDL_Surface *SDLCALL SDL_ConvertSurfaceFormat
 /**
  * \brief Copy a block of pixels of one format to another format
  *
+ *  YUV formats can be converted to and from each other and RGB formats.
+ *  Planar YUV pixels start with the Y plane, using \c pitch, followed by
+ *  the chroma planes.  The source and destination may be the same buffer
+ *  when converting between packed formats whose pixels and pitch don't grow.
+ *
  *  \return 0 on success, or -1 if there was an error
+ *
+ *  \sa SDL_HINT_YUV_CONVERSION_MODE
+ *  \sa SDL_HINT_YUV_CHROMA_FILTER
  */
 extern DECLSPEC int SDLCALL SDL_ConvertPixels(int width, int height,
                                               Uint32 src_format,
@@ -372,6 +477,66 @@ extern DECLSPEC int SDLCALL SDL_ConvertPixels(int width, int height,
                                               Uint32 dst_format,
                                               void * dst, int dst_pitch);
 
+/**
+ * \brief Copy a block of pixels, multiplying their colors by their alpha
+ *
+ *  The destination must be a 32-bit format with an 8-bit alpha channel.
+ *  If the source format is different, the pixels are converted to the
+ *  destination format first.  The source and destination may be the same
+ *  buffer.
+ *
+ *  \return 0 on success, or -1 if there was an error
+ *
+ *  \sa SDL_UnpremultiplyAlpha()
+ *  \sa SDL_BLENDMODE_PREMULTIPLIED
+ */
+extern DECLSPEC int SDLCALL SDL_PremultiplyAlpha(int width, int height,
+                                                 Uint32 src_format,
+                                                 const void * src, int src_pitch,
+                                                 Uint32 dst_format,
+                                                 void * dst, int dst_pitch);
+
+/**
+ * \brief Copy a block of premultiplied pixels, dividing their colors by their alpha
+ *
+ *  This undoes SDL_PremultiplyAlpha(), up to rounding.  Fully transparent
+ *  pixels become transparent black.  The formats are handled the same way.
+ *
+ *  \return 0 on success, or -1 if there was an error
+ *
+ *  \sa SDL_PremultiplyAlpha()
+ */
+extern DECLSPEC int SDLCALL SDL_UnpremultiplyAlpha(int width, int height,
+                                                   Uint32 src_format,
+                                                   const void * src, int src_pitch,
+                                                   Uint32 dst_format,
+                                                   void * dst, int dst_pitch);
+
+/**
+ * \brief Premultiply the colors of a surface by their alpha, in place
+ *
+ *  The surface gets the ::SDL_PREMULTIPLIED flag, and if it was using
+ *  ::SDL_BLENDMODE_BLEND it is switched to ::SDL_BLENDMODE_PREMULTIPLIED.
+ *  Nothing is done if the surface is already premultiplied.
+ *
+ *  \return 0 on success, or -1 if the surface isn't a 32-bit surface with
+ *          an 8-bit alpha channel.
+ *
+ *  \sa SDL_UnpremultiplySurfaceAlpha()
+ */
+extern DECLSPEC int SDLCALL SDL_PremultiplySurfaceAlpha(SDL_Surface * surface);
+
+/**
+ * \brief Undo SDL_PremultiplySurfaceAlpha()
+ *
+ *  The ::SDL_PREMULTIPLIED flag is cleared, and ::SDL_BLENDMODE_PREMULTIPLIED
+ *  is switched back to ::SDL_BLENDMODE_BLEND.  Nothing is done if the surface
+ *  isn't premultiplied.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_UnpremultiplySurfaceAlpha(SDL_Surface * surface);
+
 /**
  *  Performs a fast fill of the given rectangle with \c color.
  *
@@ -465,8 +630,6 @@ extern DECLSPEC int SDLCALL SDL_LowerBlit
 /**
  *  \brief Perform a fast, low quality, stretch blit between two surfaces of the
  *         same pixel format.
- *
- *  \note This function uses a static buffer, and is not thread-safe.
  */
 extern DECLSPEC int SDLCALL SDL_SoftStretch(SDL_Surface * src,
                                             const SDL_Rect * srcrect,
@@ -716,6 +716,22 @@ extern DECLSPEC int SDLCALL SDL_UpdateWindowSurfaceRects(SDL_Window * window,
                                                          const SDL_Rect * rects,
                                                          int numrects);
 
+/**
+ *  \brief Copy the area covered by a region on the window surface to the
+ *         screen.
+ *
+ *  An empty region is a no-op.  Simplifying the region first with
+ *  SDL_SimplifyRegion() keeps the number of rectangles sent to the
+ *  window system down.
+ *
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_GetWindowSurface()
+ *  \sa SDL_UpdateWindowSurfaceRects()
+ */
+extern DECLSPEC int SDLCALL SDL_UpdateWindowSurfaceRegion(SDL_Window * window,
+                                                          const SDL_Region * region);
+
 /**
  *  \brief Set a window's input grab mode.
  *
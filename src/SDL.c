@@ -41,6 +41,7 @@ extern void SDL_TimerQuit(void);
 extern void SDL_TicksInit(void);
 extern void SDL_TicksQuit(void);
 #endif
+extern void SDL_BlitThreadsQuit(void);
 #if SDL_VIDEO_DRIVER_WINDOWS
 extern int SDL_HelperWindowCreate(void);
 extern int SDL_HelperWindowDestroy(void);
@@ -360,6 +361,7 @@ SDL_Quit(void)
     SDL_TicksQuit();
 #endif
 
+    SDL_BlitThreadsQuit();
     SDL_ClearHints();
     SDL_AssertionsQuit();
     SDL_LogResetPriorities();
@@ -758,6 +758,7 @@ SDL_EVDEV_device_added(const char *devpath)
     
     /* Non blocking read mode */
     fcntl(item->fd, F_SETFL, O_NONBLOCK);
+    SDL_AddEventFD(item->fd, SDL_EVENTFD_VIDEO);
     
     if (_this->last == NULL) {
         _this->first = _this->last = item;
@@ -790,6 +791,7 @@ SDL_EVDEV_device_removed(const char *devpath)
             if (item == _this->last) {
                 _this->last = prev;
             }
+            SDL_DelEventFD(item->fd);
             close(item->fd);
             SDL_free(item->path);
             SDL_free(item);
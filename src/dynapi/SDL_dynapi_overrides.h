@@ -592,3 +592,31 @@
 #define SDL_GetQueuedAudioSize SDL_GetQueuedAudioSize_REAL
 #define SDL_ClearQueuedAudio SDL_ClearQueuedAudio_REAL
 #define SDL_GetGrabbedWindow SDL_GetGrabbedWindow_REAL
+#define SDL_SetSurfaceScaleMode SDL_SetSurfaceScaleMode_REAL
+#define SDL_GetSurfaceScaleMode SDL_GetSurfaceScaleMode_REAL
+#define SDL_RenderReadPixelsAsync SDL_RenderReadPixelsAsync_REAL
+#define SDL_PollRenderReadback SDL_PollRenderReadback_REAL
+#define SDL_WaitRenderReadback SDL_WaitRenderReadback_REAL
+#define SDL_DestroyRenderReadback SDL_DestroyRenderReadback_REAL
+#define SDL_PremultiplyAlpha SDL_PremultiplyAlpha_REAL
+#define SDL_UnpremultiplyAlpha SDL_UnpremultiplyAlpha_REAL
+#define SDL_PremultiplySurfaceAlpha SDL_PremultiplySurfaceAlpha_REAL
+#define SDL_UnpremultiplySurfaceAlpha SDL_UnpremultiplySurfaceAlpha_REAL
+#define SDL_CreateSurfacePool SDL_CreateSurfacePool_REAL
+#define SDL_CreateRGBSurfaceFromPool SDL_CreateRGBSurfaceFromPool_REAL
+#define SDL_FreeSurfacePool SDL_FreeSurfacePool_REAL
+#define SDL_CreateRegion SDL_CreateRegion_REAL
+#define SDL_FreeRegion SDL_FreeRegion_REAL
+#define SDL_ClearRegion SDL_ClearRegion_REAL
+#define SDL_AddRectToRegion SDL_AddRectToRegion_REAL
+#define SDL_AddRectsToRegion SDL_AddRectsToRegion_REAL
+#define SDL_SubtractRectFromRegion SDL_SubtractRectFromRegion_REAL
+#define SDL_IntersectRegionWithRect SDL_IntersectRegionWithRect_REAL
+#define SDL_UnionRegion SDL_UnionRegion_REAL
+#define SDL_SubtractRegion SDL_SubtractRegion_REAL
+#define SDL_IntersectRegion SDL_IntersectRegion_REAL
+#define SDL_SimplifyRegion SDL_SimplifyRegion_REAL
+#define SDL_RegionEmpty SDL_RegionEmpty_REAL
+#define SDL_GetRegionBounds SDL_GetRegionBounds_REAL
+#define SDL_GetRegionRects SDL_GetRegionRects_REAL
+#define SDL_UpdateWindowSurfaceRegion SDL_UpdateWindowSurfaceRegion_REAL
@@ -624,3 +624,31 @@ SDL_DYNAPI_PROC(int,SDL_QueueAudio,(SDL_AudioDeviceID a, const void *b, Uint32 c
 SDL_DYNAPI_PROC(Uint32,SDL_GetQueuedAudioSize,(SDL_AudioDeviceID a),(a),return)
 SDL_DYNAPI_PROC(void,SDL_ClearQueuedAudio,(SDL_AudioDeviceID a),(a),)
 SDL_DYNAPI_PROC(SDL_Window*,SDL_GetGrabbedWindow,(void),(),return)
+SDL_DYNAPI_PROC(int,SDL_SetSurfaceScaleMode,(SDL_Surface *a, SDL_ScaleMode b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GetSurfaceScaleMode,(SDL_Surface *a, SDL_ScaleMode *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_RenderReadback*,SDL_RenderReadPixelsAsync,(SDL_Renderer *a, const SDL_Rect *b, Uint32 c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_PollRenderReadback,(SDL_RenderReadback *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_WaitRenderReadback,(SDL_RenderReadback *a, void *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyRenderReadback,(SDL_RenderReadback *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_PremultiplyAlpha,(int a, int b, Uint32 c, const void *d, int e, Uint32 f, void *g, int h),(a,b,c,d,e,f,g,h),return)
+SDL_DYNAPI_PROC(int,SDL_UnpremultiplyAlpha,(int a, int b, Uint32 c, const void *d, int e, Uint32 f, void *g, int h),(a,b,c,d,e,f,g,h),return)
+SDL_DYNAPI_PROC(int,SDL_PremultiplySurfaceAlpha,(SDL_Surface *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_UnpremultiplySurfaceAlpha,(SDL_Surface *a),(a),return)
+SDL_DYNAPI_PROC(SDL_SurfacePool*,SDL_CreateSurfacePool,(size_t a),(a),return)
+SDL_DYNAPI_PROC(SDL_Surface*,SDL_CreateRGBSurfaceFromPool,(SDL_SurfacePool *a, Uint32 b, int c, int d, int e, Uint32 f, Uint32 g, Uint32 h, Uint32 i),(a,b,c,d,e,f,g,h,i),return)
+SDL_DYNAPI_PROC(void,SDL_FreeSurfacePool,(SDL_SurfacePool *a),(a),)
+SDL_DYNAPI_PROC(SDL_Region*,SDL_CreateRegion,(void),(),return)
+SDL_DYNAPI_PROC(void,SDL_FreeRegion,(SDL_Region *a),(a),)
+SDL_DYNAPI_PROC(void,SDL_ClearRegion,(SDL_Region *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_AddRectToRegion,(SDL_Region *a, const SDL_Rect *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_AddRectsToRegion,(SDL_Region *a, const SDL_Rect *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_SubtractRectFromRegion,(SDL_Region *a, const SDL_Rect *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_IntersectRegionWithRect,(SDL_Region *a, const SDL_Rect *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_UnionRegion,(SDL_Region *a, const SDL_Region *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_SubtractRegion,(SDL_Region *a, const SDL_Region *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_IntersectRegion,(SDL_Region *a, const SDL_Region *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_SimplifyRegion,(SDL_Region *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_RegionEmpty,(const SDL_Region *a),(a),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_GetRegionBounds,(const SDL_Region *a, SDL_Rect *b),(a,b),return)
+SDL_DYNAPI_PROC(const SDL_Rect*,SDL_GetRegionRects,(const SDL_Region *a, int *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_UpdateWindowSurfaceRegion,(SDL_Window *a, const SDL_Region *b),(a,b),return)
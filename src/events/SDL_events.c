@@ -33,9 +33,26 @@
 #endif
 #include "../video/SDL_sysvideo.h"
 
+#ifdef __LINUX__
+#define SDL_EVENT_WAIT_FDS  1
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#endif
+
 /* An arbitrary limit so we don't have unbounded growth */
 #define SDL_MAX_QUEUED_EVENTS   65535
 
+/* How many events can be queued without locking, must be a power of two */
+#define SDL_EVENT_RING_SIZE     1024
+
+/* How many file descriptors SDL_WaitEvent() can sleep on */
+#define SDL_MAX_EVENT_FDS       32
+
+/* How often SDL_WaitEvent() pumps input that can't wake it up, in ms */
+#define SDL_EVENT_POLL_INTERVAL 10
+
 /* Public data -- the event filter */
 SDL_EventFilter SDL_EventOK = NULL;
 void *SDL_EventOKParam;
@@ -60,10 +77,23 @@ typedef struct _SDL_EventEntry
 {
     SDL_Event event;
     SDL_SysWMmsg msg;
+    Uint32 order;
     struct _SDL_EventEntry *prev;
     struct _SDL_EventEntry *next;
+    struct _SDL_EventEntry *type_prev;
+    struct _SDL_EventEntry *type_next;
 } SDL_EventEntry;
 
+/* The queued events of 256 consecutive types, indexed like
+   SDL_disabled_events, so type queries don't have to walk the queue */
+typedef struct
+{
+    int count;
+    int counts[256];
+    SDL_EventEntry *head;
+    SDL_EventEntry *tail;
+} SDL_EventTypeBlock;
+
 typedef struct _SDL_SysWMEntry
 {
     SDL_SysWMmsg msg;
@@ -81,8 +111,353 @@ static struct
     SDL_EventEntry *free;
     SDL_SysWMEntry *wmmsg_used;
     SDL_SysWMEntry *wmmsg_free;
+    Uint32 order;
+    SDL_EventTypeBlock *types[256];
 } SDL_EventQ = { NULL, SDL_TRUE, 0, 0, NULL, NULL, NULL, NULL, NULL };
 
+/* Most events are appended to this bounded ring without taking the lock,
+   and only taken out of it with SDL_EventQ.lock held, so there is a single
+   consumer.  Events that don't fit, SysWM events, and everything whenever
+   the queue needs searching go through the list above, and anything in the
+   list is older than anything in the ring. */
+typedef struct
+{
+    SDL_atomic_t sequence;
+    SDL_Event event;
+} SDL_EventSlot;
+
+/* Plain loads and stores are enough between the memory barriers, and
+   don't bounce the cache line between cores like SDL_AtomicGet() does */
+#define SDL_EVENT_RING_GET(a)       (*(volatile int *)&(a)->value)
+#define SDL_EVENT_RING_SET(a, v)    (*(volatile int *)&(a)->value = (v))
+
+static struct
+{
+    volatile SDL_bool ready;
+    SDL_atomic_t enqueue_pos;
+    volatile int dequeue_pos;
+    SDL_EventSlot slots[SDL_EVENT_RING_SIZE];
+} SDL_EventRing;
+
+/* SDL_WaitEvent() sleeps until another thread adds an event or one of the
+   registered file descriptors becomes readable.  Adding an event only
+   signals the sleeper while 'waiters' is set, so pushing stays cheap. */
+static struct
+{
+    SDL_atomic_t waiters;
+#ifdef SDL_EVENT_WAIT_FDS
+    int wakeup_fd;
+    SDL_SpinLock fds_lock;
+    int numfds;
+    int fds[SDL_MAX_EVENT_FDS];
+    SDL_EventFDType types[SDL_MAX_EVENT_FDS];
+    int numdropped;             /* added while the table was full */
+#else
+    SDL_mutex *mutex;
+    SDL_cond *cond;
+    SDL_bool signaled;
+#endif
+} SDL_EventWait = {
+    { 0 },
+#ifdef SDL_EVENT_WAIT_FDS
+    -1
+#endif
+};
+
+
+/* Append an event to the ring, returns SDL_FALSE if it has to be locked */
+static SDL_bool
+SDL_PushEventRing(const SDL_Event * event)
+{
+    SDL_EventSlot *slot;
+    int pos, queued = 0;
+
+    /* Full range gets take events from the ring without looking at their
+       type, so leave the ones they'd skip in the list */
+    if (!SDL_EventRing.ready || event->type == SDL_SYSWMEVENT ||
+        event->type > SDL_LASTEVENT) {
+        return SDL_FALSE;
+    }
+    SDL_MemoryBarrierAcquire();
+
+    pos = SDL_EVENT_RING_GET(&SDL_EventRing.enqueue_pos);
+    for (;;) {
+        const int diff = (int)((Uint32)SDL_EVENT_RING_GET(&SDL_EventRing.slots[pos & (SDL_EVENT_RING_SIZE - 1)].sequence) - (Uint32)pos);
+        if (diff < 0) {
+            /* The ring is full */
+            return SDL_FALSE;
+        }
+        if (diff == 0) {
+            queued = SDL_EventQ.count + (int)((Uint32)pos - (Uint32)SDL_EventRing.dequeue_pos) + 1;
+            if (queued > SDL_MAX_QUEUED_EVENTS) {
+                /* Let the locked path report it */
+                return SDL_FALSE;
+            }
+            if (SDL_AtomicCAS(&SDL_EventRing.enqueue_pos, pos, (int)((Uint32)pos + 1))) {
+                break;
+            }
+        }
+        pos = SDL_EVENT_RING_GET(&SDL_EventRing.enqueue_pos);
+    }
+
+    slot = &SDL_EventRing.slots[pos & (SDL_EVENT_RING_SIZE - 1)];
+    slot->event = *event;
+    SDL_MemoryBarrierRelease();
+    SDL_EVENT_RING_SET(&slot->sequence, (int)((Uint32)pos + 1));
+
+    /* This is only statistics, so a racy update is fine */
+    if (queued > SDL_EventQ.max_events_seen) {
+        SDL_EventQ.max_events_seen = queued;
+    }
+    return SDL_TRUE;
+}
+
+/* Take the oldest event out of the ring -- called with the queue locked */
+static SDL_bool
+SDL_PopEventRing(SDL_Event * event)
+{
+    const int pos = SDL_EventRing.dequeue_pos;
+    SDL_EventSlot *slot;
+
+    if (!SDL_EventRing.ready) {
+        return SDL_FALSE;
+    }
+
+    /* A slot that is still being written to counts as empty */
+    slot = &SDL_EventRing.slots[pos & (SDL_EVENT_RING_SIZE - 1)];
+    if (SDL_EVENT_RING_GET(&slot->sequence) != (int)((Uint32)pos + 1)) {
+        return SDL_FALSE;
+    }
+    SDL_MemoryBarrierAcquire();
+    *event = slot->event;
+    SDL_MemoryBarrierRelease();
+    SDL_EVENT_RING_SET(&slot->sequence, (int)((Uint32)pos + SDL_EVENT_RING_SIZE));
+    SDL_EventRing.dequeue_pos = (int)((Uint32)pos + 1);
+    return SDL_TRUE;
+}
+
+static int SDL_AppendEvent(SDL_Event * event);
+
+/* Move the events in the ring to the end of the list -- called with the queue locked */
+static void
+SDL_DrainEventRing(void)
+{
+    SDL_Event event;
+    int end;
+
+    if (!SDL_EventRing.ready) {
+        return;
+    }
+
+    /* Everything pushed before this point has to move, or it could end up
+       behind events added to the list afterwards.  A slot that has been
+       claimed but not written yet is only a few instructions from done. */
+    end = SDL_EVENT_RING_GET(&SDL_EventRing.enqueue_pos);
+    while (SDL_EventRing.dequeue_pos != end) {
+        if (SDL_PopEventRing(&event)) {
+            SDL_AppendEvent(&event);
+        } else {
+            SDL_Delay(0);
+        }
+    }
+}
+
+/* See if SDL_PumpEvents() reads joystick input */
+static SDL_bool
+SDL_UpdatingJoysticks(void)
+{
+#if !SDL_JOYSTICK_DISABLED
+    if (!SDL_disabled_events[SDL_JOYAXISMOTION >> 8] || SDL_JoystickEventState(SDL_QUERY)) {
+        return SDL_TRUE;
+    }
+#endif
+    return SDL_FALSE;
+}
+
+/* See if events were pushed to the ring that SDL_PeepEvents() didn't see */
+static SDL_bool
+SDL_EventRingPending(void)
+{
+    return (SDL_EventRing.ready &&
+            SDL_EVENT_RING_GET(&SDL_EventRing.enqueue_pos) != SDL_EventRing.dequeue_pos);
+}
+
+/* Wake up SDL_WaitEvent() after adding events, or changing what it waits on.
+
+   Adding to the ring or the list happens before reading 'waiters', and the
+   waiter raises 'waiters' before looking at them, so one of the two sides
+   always notices the other.  The same plain load as the ring is enough. */
+static void
+SDL_WakeEventWait(void)
+{
+    if (SDL_EVENT_RING_GET(&SDL_EventWait.waiters) == 0) {
+        return;
+    }
+#ifdef SDL_EVENT_WAIT_FDS
+    if (SDL_EventWait.wakeup_fd >= 0) {
+        const Uint64 one = 1;
+        while (write(SDL_EventWait.wakeup_fd, &one, sizeof(one)) < 0 && errno == EINTR) {
+            continue;
+        }
+    }
+#else
+    if (SDL_EventWait.cond) {
+        SDL_LockMutex(SDL_EventWait.mutex);
+        SDL_EventWait.signaled = SDL_TRUE;
+        SDL_CondSignal(SDL_EventWait.cond);
+        SDL_UnlockMutex(SDL_EventWait.mutex);
+    }
+#endif
+}
+
+/* Sleep until woken up, some input arrives, or 'timeout' ms pass (-1 = forever) */
+static void
+SDL_WaitForEventSources(int timeout)
+{
+#ifdef SDL_EVENT_WAIT_FDS
+    struct pollfd pfds[SDL_MAX_EVENT_FDS + 1];
+    SDL_bool joysticks;
+    int i, numfds = 0;
+
+    if (SDL_EventWait.wakeup_fd >= 0) {
+        pfds[numfds].fd = SDL_EventWait.wakeup_fd;
+        pfds[numfds].events = POLLIN;
+        pfds[numfds].revents = 0;
+        ++numfds;
+    } else if (timeout < 0 || timeout > SDL_EVENT_POLL_INTERVAL) {
+        /* Nothing would tell us about pushed events */
+        timeout = SDL_EVENT_POLL_INTERVAL;
+    }
+
+    /* Input nobody is going to read would keep poll() from sleeping */
+    joysticks = SDL_UpdatingJoysticks();
+    SDL_AtomicLock(&SDL_EventWait.fds_lock);
+    for (i = 0; i < SDL_EventWait.numfds; ++i) {
+        if (SDL_EventWait.types[i] == SDL_EVENTFD_JOYSTICK && !joysticks) {
+            continue;
+        }
+        pfds[numfds].fd = SDL_EventWait.fds[i];
+        pfds[numfds].events = POLLIN;
+        pfds[numfds].revents = 0;
+        ++numfds;
+    }
+    SDL_AtomicUnlock(&SDL_EventWait.fds_lock);
+
+    if (poll(pfds, numfds, timeout) > 0 &&
+        SDL_EventWait.wakeup_fd >= 0 && (pfds[0].revents & POLLIN)) {
+        Uint64 count;
+        /* Reset the counter, it's non-blocking */
+        if (read(SDL_EventWait.wakeup_fd, &count, sizeof(count)) < 0) {
+            /* Someone else got it first */
+        }
+    }
+#else
+    if (!SDL_EventWait.cond) {
+        if (timeout < 0 || timeout > SDL_EVENT_POLL_INTERVAL) {
+            timeout = SDL_EVENT_POLL_INTERVAL;
+        }
+        SDL_Delay(timeout);
+        return;
+    }
+
+    SDL_LockMutex(SDL_EventWait.mutex);
+    if (!SDL_EventWait.signaled) {
+        if (timeout < 0) {
+            SDL_CondWait(SDL_EventWait.cond, SDL_EventWait.mutex);
+        } else {
+            SDL_CondWaitTimeout(SDL_EventWait.cond, SDL_EventWait.mutex, (Uint32) timeout);
+        }
+    }
+    SDL_EventWait.signaled = SDL_FALSE;
+    SDL_UnlockMutex(SDL_EventWait.mutex);
+#endif
+}
+
+/* The longest SDL_WaitEvent() can go without pumping events, or -1 */
+static int
+SDL_GetEventWaitLimit(void)
+{
+    SDL_VideoDevice *_this = SDL_GetVideoDevice();
+    int limit = -1;
+#ifdef SDL_EVENT_WAIT_FDS
+    SDL_bool dropped;
+#endif
+
+    if (_this) {
+#ifdef SDL_EVENT_WAIT_FDS
+        if (_this->GetEventWaitTimeout) {
+            limit = _this->GetEventWaitTimeout(_this);
+        } else {
+            limit = SDL_EVENT_POLL_INTERVAL;
+        }
+#else
+        /* There's no way to sleep on the driver's input here */
+        limit = SDL_EVENT_POLL_INTERVAL;
+#endif
+    }
+#ifdef SDL_EVENT_WAIT_FDS
+    /* Some input can't wake us up, it didn't fit in the table */
+    SDL_AtomicLock(&SDL_EventWait.fds_lock);
+    dropped = (SDL_EventWait.numdropped > 0);
+    SDL_AtomicUnlock(&SDL_EventWait.fds_lock);
+    if (dropped && (limit < 0 || limit > SDL_EVENT_POLL_INTERVAL)) {
+        limit = SDL_EVENT_POLL_INTERVAL;
+    }
+#endif
+#if !SDL_JOYSTICK_DISABLED && !SDL_JOYSTICK_LINUX && !SDL_JOYSTICK_DUMMY
+    /* Joystick drivers that don't register their file descriptors */
+    if (SDL_WasInit(SDL_INIT_JOYSTICK) && SDL_UpdatingJoysticks() &&
+        (limit < 0 || limit > SDL_EVENT_POLL_INTERVAL)) {
+        limit = SDL_EVENT_POLL_INTERVAL;
+    }
+#endif
+    return limit;
+}
+
+void
+SDL_AddEventFD(int fd, SDL_EventFDType type)
+{
+#ifdef SDL_EVENT_WAIT_FDS
+    SDL_AtomicLock(&SDL_EventWait.fds_lock);
+    if (SDL_EventWait.numfds < SDL_MAX_EVENT_FDS) {
+        SDL_EventWait.fds[SDL_EventWait.numfds] = fd;
+        SDL_EventWait.types[SDL_EventWait.numfds] = type;
+        ++SDL_EventWait.numfds;
+    } else {
+        /* SDL_WaitEvent() will have to poll for this one */
+        ++SDL_EventWait.numdropped;
+    }
+    SDL_AtomicUnlock(&SDL_EventWait.fds_lock);
+    SDL_WakeEventWait();
+#endif
+}
+
+void
+SDL_DelEventFD(int fd)
+{
+#ifdef SDL_EVENT_WAIT_FDS
+    SDL_bool found = SDL_FALSE;
+    int i;
+
+    SDL_AtomicLock(&SDL_EventWait.fds_lock);
+    for (i = 0; i < SDL_EventWait.numfds; ++i) {
+        if (SDL_EventWait.fds[i] == fd) {
+            --SDL_EventWait.numfds;
+            SDL_EventWait.fds[i] = SDL_EventWait.fds[SDL_EventWait.numfds];
+            SDL_EventWait.types[i] = SDL_EventWait.types[SDL_EventWait.numfds];
+            found = SDL_TRUE;
+            break;
+        }
+    }
+    if (!found && SDL_EventWait.numdropped > 0) {
+        /* It was never in the table */
+        --SDL_EventWait.numdropped;
+    }
+    SDL_AtomicUnlock(&SDL_EventWait.fds_lock);
+    SDL_WakeEventWait();
+#endif
+}
+
 
 /* Public functions */
 
@@ -91,6 +466,7 @@ SDL_StopEventLoop(void)
 {
     const char *report = SDL_GetHint("SDL_EVENT_QUEUE_STATISTICS");
     int i;
+    SDL_Event event;
     SDL_EventEntry *entry;
     SDL_SysWMEntry *wmmsg;
 
@@ -106,6 +482,9 @@ SDL_StopEventLoop(void)
     }
 
     /* Clean out EventQ */
+    while (SDL_PopEventRing(&event)) {
+        continue;
+    }
     for (entry = SDL_EventQ.head; entry; ) {
         SDL_EventEntry *next = entry->next;
         SDL_free(entry);
@@ -127,6 +506,11 @@ SDL_StopEventLoop(void)
         wmmsg = next;
     }
 
+    for (i = 0; i < SDL_arraysize(SDL_EventQ.types); ++i) {
+        SDL_free(SDL_EventQ.types[i]);
+        SDL_EventQ.types[i] = NULL;
+    }
+
     SDL_EventQ.count = 0;
     SDL_EventQ.max_events_seen = 0;
     SDL_EventQ.head = NULL;
@@ -148,6 +532,20 @@ SDL_StopEventLoop(void)
     }
     SDL_EventOK = NULL;
 
+#ifdef SDL_EVENT_WAIT_FDS
+    if (SDL_EventWait.wakeup_fd >= 0) {
+        close(SDL_EventWait.wakeup_fd);
+        SDL_EventWait.wakeup_fd = -1;
+    }
+#else
+    if (SDL_EventWait.cond) {
+        SDL_DestroyCond(SDL_EventWait.cond);
+        SDL_DestroyMutex(SDL_EventWait.mutex);
+        SDL_EventWait.cond = NULL;
+        SDL_EventWait.mutex = NULL;
+    }
+#endif
+
     if (SDL_EventQ.lock) {
         SDL_UnlockMutex(SDL_EventQ.lock);
         SDL_DestroyMutex(SDL_EventQ.lock);
@@ -175,6 +573,36 @@ SDL_StartEventLoop(void)
     }
 #endif /* !SDL_THREADS_DISABLED */
 
+    if (!SDL_EventRing.ready) {
+        int i;
+
+        for (i = 0; i < SDL_EVENT_RING_SIZE; ++i) {
+            SDL_AtomicSet(&SDL_EventRing.slots[i].sequence, i);
+        }
+        SDL_AtomicSet(&SDL_EventRing.enqueue_pos, 0);
+        SDL_EventRing.dequeue_pos = 0;
+        SDL_MemoryBarrierRelease();
+        SDL_EventRing.ready = SDL_TRUE;
+    }
+
+    /* Set up waking SDL_WaitEvent(), it falls back to polling without it */
+#ifdef SDL_EVENT_WAIT_FDS
+    if (SDL_EventWait.wakeup_fd < 0) {
+        SDL_EventWait.wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    }
+#elif !SDL_THREADS_DISABLED
+    if (!SDL_EventWait.cond) {
+        SDL_EventWait.mutex = SDL_CreateMutex();
+        SDL_EventWait.cond = SDL_CreateCond();
+        if (!SDL_EventWait.mutex || !SDL_EventWait.cond) {
+            SDL_DestroyCond(SDL_EventWait.cond);
+            SDL_DestroyMutex(SDL_EventWait.mutex);
+            SDL_EventWait.cond = NULL;
+            SDL_EventWait.mutex = NULL;
+        }
+    }
+#endif
+
     /* Process most event types */
     SDL_EventState(SDL_TEXTINPUT, SDL_DISABLE);
     SDL_EventState(SDL_TEXTEDITING, SDL_DISABLE);
@@ -190,12 +618,28 @@ SDL_StartEventLoop(void)
 static int
 SDL_AddEvent(SDL_Event * event)
 {
-    SDL_EventEntry *entry;
-
     if (SDL_EventQ.count >= SDL_MAX_QUEUED_EVENTS) {
         SDL_SetError("Event queue is full (%d events)", SDL_EventQ.count);
         return 0;
     }
+    return SDL_AppendEvent(event);
+}
+
+/* Add an event to the end of the list -- called with the queue locked */
+static int
+SDL_AppendEvent(SDL_Event * event)
+{
+    const Uint8 hi = ((event->type >> 8) & 0xff);
+    SDL_EventTypeBlock *block = SDL_EventQ.types[hi];
+    SDL_EventEntry *entry;
+
+    if (block == NULL) {
+        block = (SDL_EventTypeBlock *)SDL_calloc(1, sizeof(*block));
+        if (!block) {
+            return 0;
+        }
+        SDL_EventQ.types[hi] = block;
+    }
 
     if (SDL_EventQ.free == NULL) {
         entry = (SDL_EventEntry *)SDL_malloc(sizeof(*entry));
@@ -227,6 +671,18 @@ SDL_AddEvent(SDL_Event * event)
     }
     ++SDL_EventQ.count;
 
+    entry->order = SDL_EventQ.order++;
+    entry->type_next = NULL;
+    entry->type_prev = block->tail;
+    if (block->tail) {
+        block->tail->type_next = entry;
+    } else {
+        block->head = entry;
+    }
+    block->tail = entry;
+    ++block->counts[event->type & 0xff];
+    ++block->count;
+
     if (SDL_EventQ.count > SDL_EventQ.max_events_seen) {
         SDL_EventQ.max_events_seen = SDL_EventQ.count;
     }
@@ -238,6 +694,22 @@ SDL_AddEvent(SDL_Event * event)
 static void
 SDL_CutEvent(SDL_EventEntry *entry)
 {
+    SDL_EventTypeBlock *block = SDL_EventQ.types[(entry->event.type >> 8) & 0xff];
+
+    if (entry->type_prev) {
+        entry->type_prev->type_next = entry->type_next;
+    } else {
+        block->head = entry->type_next;
+    }
+    if (entry->type_next) {
+        entry->type_next->type_prev = entry->type_prev;
+    } else {
+        block->tail = entry->type_prev;
+    }
+    SDL_assert(block->counts[entry->event.type & 0xff] > 0);
+    --block->counts[entry->event.type & 0xff];
+    --block->count;
+
     if (entry->prev) {
         entry->prev->next = entry->next;
     }
@@ -260,6 +732,132 @@ SDL_CutEvent(SDL_EventEntry *entry)
     --SDL_EventQ.count;
 }
 
+/* Count the queued events in a type range -- called with the queue locked.
+   Types past SDL_LASTEVENT share slots with others, so this can be high
+   for them, but never low. */
+static int
+SDL_CountEvents(Uint32 minType, Uint32 maxType)
+{
+    int hi, lo, count = 0;
+
+    if (minType > maxType) {
+        return 0;
+    }
+    if (maxType > SDL_LASTEVENT ||
+        (minType == SDL_FIRSTEVENT && maxType == SDL_LASTEVENT)) {
+        return SDL_EventQ.count;
+    }
+
+    for (hi = (int)(minType >> 8); hi <= (int)(maxType >> 8); ++hi) {
+        const SDL_EventTypeBlock *block = SDL_EventQ.types[hi];
+        int first, last;
+
+        if (!block || !block->count) {
+            continue;
+        }
+        first = (hi == (int)(minType >> 8)) ? (int)(minType & 0xff) : 0;
+        last = (hi == (int)(maxType >> 8)) ? (int)(maxType & 0xff) : 0xff;
+        if (first == 0 && last == 0xff) {
+            count += block->count;
+        } else {
+            for (lo = first; lo <= last; ++lo) {
+                count += block->counts[lo];
+            }
+        }
+    }
+    return count;
+}
+
+/* Walks the queued events of a type range in queue order.  It merges the
+   chains of the type blocks that have matching events, unless nearly
+   everything matches, and stops after the last match. */
+typedef struct
+{
+    Uint32 minType;
+    Uint32 maxType;
+    int remaining;
+    SDL_EventEntry *list;
+    int numchains;
+    SDL_EventEntry *chains[256];
+} SDL_EventIterator;
+
+static SDL_EventEntry *
+SDL_SkipToType(SDL_EventEntry *entry, Uint32 minType, Uint32 maxType)
+{
+    while (entry && (entry->event.type < minType || entry->event.type > maxType)) {
+        entry = entry->type_next;
+    }
+    return entry;
+}
+
+/* Called with the queue locked, and the queue may only lose the entries
+   this has returned while iterating */
+static void
+SDL_StartEventIterator(SDL_EventIterator *it, Uint32 minType, Uint32 maxType)
+{
+    int hi;
+
+    it->minType = minType;
+    it->maxType = maxType;
+    it->remaining = SDL_CountEvents(minType, maxType);
+    it->list = NULL;
+    it->numchains = 0;
+
+    if (it->remaining == 0) {
+        return;
+    }
+    if (it->remaining >= SDL_EventQ.count / 2 || maxType > SDL_LASTEVENT) {
+        it->list = SDL_EventQ.head;
+        return;
+    }
+
+    for (hi = (int)(minType >> 8); hi <= (int)(maxType >> 8); ++hi) {
+        const SDL_EventTypeBlock *block = SDL_EventQ.types[hi];
+        if (block && block->count) {
+            SDL_EventEntry *entry = SDL_SkipToType(block->head, minType, maxType);
+            if (entry) {
+                it->chains[it->numchains++] = entry;
+            }
+        }
+    }
+}
+
+static SDL_EventEntry *
+SDL_NextEventEntry(SDL_EventIterator *it)
+{
+    SDL_EventEntry *entry;
+    int i, oldest;
+
+    if (it->remaining <= 0) {
+        return NULL;
+    }
+
+    if (it->numchains == 0) {
+        while ((entry = it->list) != NULL) {
+            it->list = entry->next;
+            if (it->minType <= entry->event.type && entry->event.type <= it->maxType) {
+                --it->remaining;
+                return entry;
+            }
+        }
+        return NULL;
+    }
+
+    oldest = 0;
+    for (i = 1; i < it->numchains; ++i) {
+        if ((Sint32)(it->chains[i]->order - it->chains[oldest]->order) < 0) {
+            oldest = i;
+        }
+    }
+    entry = it->chains[oldest];
+    it->chains[oldest] = SDL_SkipToType(entry->type_next, it->minType, it->maxType);
+    if (!it->chains[oldest]) {
+        it->chains[oldest] = it->chains[--it->numchains];
+    }
+    --it->remaining;
+    return entry;
+}
+
 /* Lock the event queue, take a peep at it, and unlock it */
 int
 SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
@@ -275,18 +873,32 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
         }
         return (-1);
     }
-    /* Lock the event queue */
     used = 0;
+
+    /* Add to the ring without locking while there's room */
+    if (action == SDL_ADDEVENT) {
+        while (used < numevents && SDL_PushEventRing(&events[used])) {
+            ++used;
+        }
+        if (used == numevents) {
+            SDL_WakeEventWait();
+            return (used);
+        }
+    }
+
+    /* Lock the event queue */
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         if (action == SDL_ADDEVENT) {
-            for (i = 0; i < numevents; ++i) {
+            /* Stay behind the events already in the ring */
+            SDL_DrainEventRing();
+            for (i = used; i < numevents; ++i) {
                 used += SDL_AddEvent(&events[i]);
             }
         } else {
-            SDL_EventEntry *entry, *next;
+            SDL_EventIterator it;
+            SDL_EventEntry *entry;
             SDL_SysWMEntry *wmmsg, *wmmsg_next;
             SDL_Event tmpevent;
-            Uint32 type;
 
             /* If 'events' is NULL, just see if they exist */
             if (events == NULL) {
@@ -305,32 +917,44 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
             }
             SDL_EventQ.wmmsg_used = NULL;
 
-            for (entry = SDL_EventQ.head; entry && used < numevents; entry = next) {
-                next = entry->next;
-                type = entry->event.type;
-                if (minType <= type && type <= maxType) {
-                    events[used] = entry->event;
-                    if (entry->event.type == SDL_SYSWMEVENT) {
-                        /* We need to copy the wmmsg somewhere safe.
-                           For now we'll guarantee it's valid at least until
-                           the next call to SDL_PeepEvents()
-                         */
-                        if (SDL_EventQ.wmmsg_free) {
-                            wmmsg = SDL_EventQ.wmmsg_free;
-                            SDL_EventQ.wmmsg_free = wmmsg->next;
-                        } else {
-                            wmmsg = (SDL_SysWMEntry *)SDL_malloc(sizeof(*wmmsg));
-                        }
-                        wmmsg->msg = *entry->event.syswm.msg;
-                        wmmsg->next = SDL_EventQ.wmmsg_used;
-                        SDL_EventQ.wmmsg_used = wmmsg;
-                        events[used].syswm.msg = &wmmsg->msg;
-                    }
-                    ++used;
+            /* Only taking events in order can leave them in the ring */
+            if (action != SDL_GETEVENT ||
+                minType > SDL_FIRSTEVENT || maxType < SDL_LASTEVENT) {
+                SDL_DrainEventRing();
+            }
 
-                    if (action == SDL_GETEVENT) {
-                        SDL_CutEvent(entry);
+            SDL_StartEventIterator(&it, minType, maxType);
+            while (used < numevents && (entry = SDL_NextEventEntry(&it)) != NULL) {
+                events[used] = entry->event;
+                if (entry->event.type == SDL_SYSWMEVENT) {
+                    /* We need to copy the wmmsg somewhere safe.
+                       For now we'll guarantee it's valid at least until
+                       the next call to SDL_PeepEvents()
+                     */
+                    if (SDL_EventQ.wmmsg_free) {
+                        wmmsg = SDL_EventQ.wmmsg_free;
+                        SDL_EventQ.wmmsg_free = wmmsg->next;
+                    } else {
+                        wmmsg = (SDL_SysWMEntry *)SDL_malloc(sizeof(*wmmsg));
                     }
+                    wmmsg->msg = *entry->event.syswm.msg;
+                    wmmsg->next = SDL_EventQ.wmmsg_used;
+                    SDL_EventQ.wmmsg_used = wmmsg;
+                    events[used].syswm.msg = &wmmsg->msg;
+                }
+                ++used;
+
+                if (action == SDL_GETEVENT) {
+                    SDL_CutEvent(entry);
+                }
+            }
+
+            /* The list is empty now if there's room left, but other
+               threads may have pushed events that don't match since */
+            if (action == SDL_GETEVENT &&
+                minType <= SDL_FIRSTEVENT && maxType >= SDL_LASTEVENT) {
+                while (used < numevents && SDL_PopEventRing(&events[used])) {
+                    ++used;
                 }
             }
         }
@@ -338,6 +962,9 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
     } else {
         return SDL_SetError("Couldn't lock event queue");
     }
+    if (action == SDL_ADDEVENT && used > 0) {
+        SDL_WakeEventWait();
+    }
     return (used);
 }
 
@@ -377,14 +1004,12 @@ SDL_FlushEvents(Uint32 minType, Uint32 maxType)
 
     /* Lock the event queue */
     if (SDL_LockMutex(SDL_EventQ.lock) == 0) {
-        SDL_EventEntry *entry, *next;
-        Uint32 type;
-        for (entry = SDL_EventQ.head; entry; entry = next) {
-            next = entry->next;
-            type = entry->event.type;
-            if (minType <= type && type <= maxType) {
-                SDL_CutEvent(entry);
-            }
+        SDL_EventIterator it;
+        SDL_EventEntry *entry;
+        SDL_DrainEventRing();
+        SDL_StartEventIterator(&it, minType, maxType);
+        while ((entry = SDL_NextEventEntry(&it)) != NULL) {
+            SDL_CutEvent(entry);
         }
         SDL_UnlockMutex(SDL_EventQ.lock);
     }
@@ -402,7 +1027,7 @@ SDL_PumpEvents(void)
     }
 #if !SDL_JOYSTICK_DISABLED
     /* Check for joystick state change */
-    if ((!SDL_disabled_events[SDL_JOYAXISMOTION >> 8] || SDL_JoystickEventState(SDL_QUERY))) {
+    if (SDL_UpdatingJoysticks()) {
         SDL_JoystickUpdate();
     }
 #endif
@@ -426,30 +1051,49 @@ int
 SDL_WaitEventTimeout(SDL_Event * event, int timeout)
 {
     Uint32 expiration = 0;
+    int result;
 
     if (timeout > 0)
         expiration = SDL_GetTicks() + timeout;
 
+    if (timeout != 0) {
+        SDL_AtomicAdd(&SDL_EventWait.waiters, 1);
+    }
     for (;;) {
+        int wait = -1, limit;
+
         SDL_PumpEvents();
-        switch (SDL_PeepEvents(event, 1, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT)) {
-        case -1:
+        result = SDL_PeepEvents(event, 1, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+        if (result != 0) {
+            /* Got an event, or an error */
+            result = (result > 0);
+            break;
+        }
+        if (timeout == 0) {
+            /* Polling and no events, just return */
             return 0;
-        case 1:
-            return 1;
-        case 0:
-            if (timeout == 0) {
-                /* Polling and no events, just return */
-                return 0;
-            }
-            if (timeout > 0 && SDL_TICKS_PASSED(SDL_GetTicks(), expiration)) {
+        }
+        if (timeout > 0) {
+            const Uint32 now = SDL_GetTicks();
+            if (SDL_TICKS_PASSED(now, expiration)) {
                 /* Timeout expired and no events */
-                return 0;
+                break;
             }
-            SDL_Delay(10);
-            break;
+            wait = (int) (expiration - now);
         }
+
+        limit = SDL_GetEventWaitLimit();
+        if (limit >= 0 && (wait < 0 || limit < wait)) {
+            wait = limit;
+        }
+        if (!SDL_EventRingPending()) {
+            SDL_WaitForEventSources(wait);
+        }
+    }
+    if (timeout != 0) {
+        SDL_AtomicAdd(&SDL_EventWait.waiters, -1);
     }
+    return result;
 }
 
 int
@@ -551,6 +1195,7 @@ SDL_FilterEvents(SDL_EventFilter filter, void *userdata)
 {
     if (SDL_EventQ.lock && SDL_LockMutex(SDL_EventQ.lock) == 0) {
         SDL_EventEntry *entry, *next;
+        SDL_DrainEventRing();
         for (entry = SDL_EventQ.head; entry; entry = next) {
             next = entry->next;
             if (!filter(userdata, &entry->event)) {
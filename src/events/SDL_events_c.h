@@ -39,6 +39,17 @@ extern void SDL_QuitInterrupt(void);
 extern int SDL_SendAppEvent(SDL_EventType eventType);
 extern int SDL_SendSysWMEvent(SDL_SysWMmsg * message);
 
+/* Input sources that SDL_WaitEvent() sleeps on, where supported.
+   The type says who reads the file descriptor when it's readable. */
+typedef enum
+{
+    SDL_EVENTFD_VIDEO,      /* The video driver's PumpEvents() */
+    SDL_EVENTFD_JOYSTICK    /* SDL_JoystickUpdate() */
+} SDL_EventFDType;
+
+extern void SDL_AddEventFD(int fd, SDL_EventFDType type);
+extern void SDL_DelEventFD(int fd);
+
 extern int SDL_QuitInit(void);
 extern int SDL_SendQuit(void);
 extern void SDL_QuitQuit(void);
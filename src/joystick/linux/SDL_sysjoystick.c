@@ -29,6 +29,7 @@
 /* This is the Linux implementation of the SDL joystick API */
 
 #include <sys/stat.h>
+#include <errno.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
@@ -346,6 +347,11 @@ JoystickInitWithUdev(void)
         SDL_UDEV_Quit();
         return SDL_SetError("Could not set up joystick <-> udev callback");
     }
+
+    /* Hotplug events wake up SDL_WaitEvent() */
+    if (SDL_UDEV_GetFD() >= 0) {
+        SDL_AddEventFD(SDL_UDEV_GetFD(), SDL_EVENTFD_JOYSTICK);
+    }
     
     /* Force a scan to build the initial device list */
     SDL_UDEV_Scan();
@@ -611,6 +617,7 @@ SDL_SYS_JoystickOpen(SDL_Joystick * joystick, int device_index)
 
     /* Set the joystick to non-blocking read mode */
     fcntl(fd, F_SETFL, O_NONBLOCK);
+    SDL_AddEventFD(fd, SDL_EVENTFD_JOYSTICK);
 
     /* Get the number of buttons and axes on the joystick */
     ConfigJoystick(joystick, fd);
@@ -805,6 +812,11 @@ HandleInputEvents(SDL_Joystick * joystick)
             }
         }
     }
+
+    if (len < 0 && errno == ENODEV) {
+        /* The device is gone, it would keep waking up SDL_WaitEvent() */
+        SDL_DelEventFD(joystick->hwdata->fd);
+    }
 }
 
 void
@@ -833,6 +845,7 @@ void
 SDL_SYS_JoystickClose(SDL_Joystick * joystick)
 {
     if (joystick->hwdata) {
+        SDL_DelEventFD(joystick->hwdata->fd);
         close(joystick->hwdata->fd);
         if (joystick->hwdata->item) {
             joystick->hwdata->item->hwdata = NULL;
@@ -864,6 +877,7 @@ SDL_SYS_JoystickQuit(void)
     instance_counter = 0;
 
 #if SDL_USE_LIBUDEV
+    SDL_DelEventFD(SDL_UDEV_GetFD());
     SDL_UDEV_DelCallback(joystick_udev_callback);
     SDL_UDEV_Quit();
 #endif
@@ -44,6 +44,12 @@
         return retval; \
     }
 
+#define CHECK_READBACK_MAGIC(readback, retval) \
+    if (!readback || readback->magic != &readback_magic) { \
+        SDL_SetError("Invalid readback"); \
+        return retval; \
+    }
+
 
 #if !SDL_RENDER_DISABLED
 static const SDL_RenderDriver *render_drivers[] = {
@@ -74,6 +80,7 @@ static const SDL_RenderDriver *render_drivers[] = {
 
 static char renderer_magic;
 static char texture_magic;
+static char readback_magic;
 
 static int UpdateLogicalSize(SDL_Renderer *renderer);
 
@@ -498,6 +505,43 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
     return texture;
 }
 
+/* Size of the buffer textures are converted through */
+#define SDL_RENDER_STAGING_SIZE (512 * 1024)
+
+/* Convert a surface into a texture in strips through a small staging
+   buffer, instead of converting the whole image into a temporary surface.
+   The strips stay in cache between the conversion and the upload.
+ */
+static int
+SDL_ConvertSurfaceToTexture(SDL_Texture * texture, SDL_Surface * surface)
+{
+    SDL_Renderer *renderer = texture->renderer;
+    const Uint8 *src = (const Uint8 *) surface->pixels;
+    int pitch = surface->w * SDL_BYTESPERPIXEL(texture->format);
+    int rows = SDL_RENDER_STAGING_SIZE / pitch;
+    SDL_Rect rect;
+
+    if (!renderer->staging) {
+        renderer->staging = SDL_malloc(SDL_RENDER_STAGING_SIZE);
+        if (!renderer->staging) {
+            return SDL_OutOfMemory();
+        }
+    }
+
+    rect.x = 0;
+    rect.w = surface->w;
+    for (rect.y = 0; rect.y < surface->h; rect.y += rect.h) {
+        rect.h = SDL_min(rows, surface->h - rect.y);
+        if (SDL_ConvertPixels(rect.w, rect.h, surface->format->format,
+                              src + rect.y * surface->pitch, surface->pitch,
+                              texture->format, renderer->staging, pitch) < 0 ||
+            SDL_UpdateTexture(texture, &rect, renderer->staging, pitch) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
 SDL_Texture *
 SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface)
 {
@@ -530,6 +574,17 @@ SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface)
         }
     }
 
+    /* Keep the surface format if the renderer takes it, so nothing is converted */
+    if (SDL_GetColorKey(surface, NULL) < 0 &&
+        SDL_ISPIXELFORMAT_ALPHA(fmt->format) == needAlpha) {
+        for (i = 0; i < renderer->info.num_texture_formats; ++i) {
+            if (renderer->info.texture_formats[i] == fmt->format) {
+                format = fmt->format;
+                break;
+            }
+        }
+    }
+
     texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STATIC,
                                 surface->w, surface->h);
     if (!texture) {
@@ -544,6 +599,23 @@ SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface)
         } else {
             SDL_UpdateTexture(texture, NULL, surface->pixels, surface->pitch);
         }
+    } else if (!SDL_ISPIXELFORMAT_INDEXED(fmt->format) &&
+               SDL_GetColorKey(surface, NULL) < 0 &&
+               surface->w * SDL_BYTESPERPIXEL(format) <= SDL_RENDER_STAGING_SIZE) {
+        /* A plain pixel format conversion, no colorkey or palette to apply */
+        int status;
+
+        if (SDL_MUSTLOCK(surface)) {
+            SDL_LockSurface(surface);
+            status = SDL_ConvertSurfaceToTexture(texture, surface);
+            SDL_UnlockSurface(surface);
+        } else {
+            status = SDL_ConvertSurfaceToTexture(texture, surface);
+        }
+        if (status < 0) {
+            SDL_DestroyTexture(texture);
+            return NULL;
+        }
     } else {
         SDL_PixelFormat *dst_fmt;
         SDL_Surface *temp = NULL;
@@ -1570,6 +1642,11 @@ SDL_RenderDrawRect(SDL_Renderer * renderer, const SDL_Rect * rect)
         rect = &full_rect;
     }
 
+    if (renderer->RenderDrawRects &&
+        renderer->scale.x == 1.0f && renderer->scale.y == 1.0f) {
+        return SDL_RenderDrawRects(renderer, rect, 1);
+    }
+
     points[0].x = rect->x;
     points[0].y = rect->y;
     points[1].x = rect->x+rect->w-1;
@@ -1602,6 +1679,30 @@ SDL_RenderDrawRects(SDL_Renderer * renderer,
     if (renderer->hidden) {
         return 0;
     }
+
+    if (renderer->RenderDrawRects &&
+        renderer->scale.x == 1.0f && renderer->scale.y == 1.0f) {
+        SDL_FRect *frects;
+        int status;
+
+        frects = SDL_stack_alloc(SDL_FRect, count);
+        if (!frects) {
+            return SDL_OutOfMemory();
+        }
+        for (i = 0; i < count; ++i) {
+            frects[i].x = (float)rects[i].x;
+            frects[i].y = (float)rects[i].y;
+            frects[i].w = (float)rects[i].w;
+            frects[i].h = (float)rects[i].h;
+        }
+
+        status = renderer->RenderDrawRects(renderer, frects, count);
+
+        SDL_stack_free(frects);
+
+        return status;
+    }
+
     for (i = 0; i < count; ++i) {
         if (SDL_RenderDrawRect(renderer, &rects[i]) < 0) {
             return -1;
@@ -1817,6 +1918,379 @@ SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                       format, pixels, pitch);
 }
 
+/* The format the driver reads pixels in when it doesn't have to convert them */
+static Uint32
+SDL_GetReadbackFormat(SDL_Renderer * renderer, Uint32 format)
+{
+    if (renderer->target) {
+        return renderer->target->format;
+    }
+    if (renderer->window) {
+        Uint32 window_format = SDL_GetWindowPixelFormat(renderer->window);
+        if (window_format != SDL_PIXELFORMAT_UNKNOWN) {
+            return window_format;
+        }
+    }
+    if (format && !SDL_ISPIXELFORMAT_FOURCC(format)) {
+        return format;
+    }
+    return SDL_PIXELFORMAT_ARGB8888;
+}
+
+static void
+SDL_ConvertReadback(SDL_RenderReadback * readback)
+{
+    if (SDL_ConvertPixels(readback->rect.w, readback->rect.h,
+                          readback->raw_format, readback->raw_pixels,
+                          readback->raw_pitch, readback->format,
+                          readback->pixels, readback->pitch) < 0) {
+        readback->error = SDL_strdup(SDL_GetError());
+    }
+    SDL_free(readback->raw_pixels);
+    readback->raw_pixels = NULL;
+}
+
+/* Convert queued readbacks until the renderer is destroyed */
+static int SDLCALL
+SDL_ReadbackThread(void *data)
+{
+    SDL_Renderer *renderer = (SDL_Renderer *) data;
+    SDL_RenderReadback *readback;
+
+    SDL_LockMutex(renderer->readback_lock);
+    for ( ; ; ) {
+        while (!renderer->readback_queue && !renderer->readback_quit) {
+            SDL_CondWait(renderer->readback_cond, renderer->readback_lock);
+        }
+        readback = renderer->readback_queue;
+        if (!readback) {
+            break;
+        }
+        renderer->readback_queue = readback->next_queued;
+        if (!renderer->readback_queue) {
+            renderer->readback_queue_tail = NULL;
+        }
+        SDL_UnlockMutex(renderer->readback_lock);
+
+        SDL_ConvertReadback(readback);
+
+        SDL_LockMutex(renderer->readback_lock);
+        SDL_AtomicSet(&readback->converted, 1);
+        SDL_CondBroadcast(renderer->readback_cond);
+    }
+    SDL_UnlockMutex(renderer->readback_lock);
+    return 0;
+}
+
+/* Hand a readback to the renderer's readback thread, starting it if needed */
+static SDL_bool
+SDL_QueueReadbackConversion(SDL_RenderReadback * readback)
+{
+    SDL_Renderer *renderer = readback->renderer;
+
+    if (!renderer->readback_thread) {
+        if (!renderer->readback_lock) {
+            renderer->readback_lock = SDL_CreateMutex();
+        }
+        if (!renderer->readback_cond) {
+            renderer->readback_cond = SDL_CreateCond();
+        }
+        if (!renderer->readback_lock || !renderer->readback_cond) {
+            return SDL_FALSE;
+        }
+        renderer->readback_thread = SDL_CreateThread(SDL_ReadbackThread, "SDLReadback", renderer);
+        if (!renderer->readback_thread) {
+            return SDL_FALSE;
+        }
+    }
+
+    SDL_LockMutex(renderer->readback_lock);
+    readback->next_queued = NULL;
+    if (renderer->readback_queue_tail) {
+        renderer->readback_queue_tail->next_queued = readback;
+    } else {
+        renderer->readback_queue = readback;
+    }
+    renderer->readback_queue_tail = readback;
+    SDL_CondBroadcast(renderer->readback_cond);
+    SDL_UnlockMutex(renderer->readback_lock);
+    return SDL_TRUE;
+}
+
+/* Wait for the readback thread to finish converting a readback */
+static void
+SDL_WaitReadbackConversion(SDL_RenderReadback * readback)
+{
+    SDL_Renderer *renderer = readback->renderer;
+
+    if (SDL_AtomicGet(&readback->converted)) {
+        return;
+    }
+    SDL_LockMutex(renderer->readback_lock);
+    while (!SDL_AtomicGet(&readback->converted)) {
+        SDL_CondWait(renderer->readback_cond, renderer->readback_lock);
+    }
+    SDL_UnlockMutex(renderer->readback_lock);
+}
+
+/* Stop the readback thread, after it has converted everything queued */
+static void
+SDL_StopReadbackThread(SDL_Renderer * renderer)
+{
+    if (renderer->readback_thread) {
+        SDL_LockMutex(renderer->readback_lock);
+        renderer->readback_quit = SDL_TRUE;
+        SDL_CondBroadcast(renderer->readback_cond);
+        SDL_UnlockMutex(renderer->readback_lock);
+        SDL_WaitThread(renderer->readback_thread, NULL);
+        renderer->readback_thread = NULL;
+    }
+    if (renderer->readback_cond) {
+        SDL_DestroyCond(renderer->readback_cond);
+        renderer->readback_cond = NULL;
+    }
+    if (renderer->readback_lock) {
+        SDL_DestroyMutex(renderer->readback_lock);
+        renderer->readback_lock = NULL;
+    }
+}
+
+/* Convert the raw pixels to the requested format on the readback thread */
+static int
+SDL_StartReadbackConversion(SDL_RenderReadback * readback)
+{
+    int w = readback->rect.w;
+    int h = readback->rect.h;
+    size_t size;
+
+    if (readback->raw_format == readback->format) {
+        readback->pixels = readback->raw_pixels;
+        readback->pitch = readback->raw_pitch;
+        readback->raw_pixels = NULL;
+        readback->state = SDL_READBACK_COMPLETE;
+        return 0;
+    }
+
+    if (SDL_ISPIXELFORMAT_FOURCC(readback->format)) {
+        readback->pitch = (w + 1) & ~1;
+        if (!SDL_IsPlanarYUV(readback->format)) {
+            readback->pitch *= 2;
+        }
+        size = SDL_CalculateYUVSize(readback->format, w, h, readback->pitch);
+        if (!size) {
+            return SDL_SetError("Unknown pixel format");
+        }
+    } else {
+        readback->pitch = w * SDL_BYTESPERPIXEL(readback->format);
+        size = (size_t) h * readback->pitch;
+    }
+    readback->pixels = SDL_malloc(size);
+    if (!readback->pixels) {
+        return SDL_OutOfMemory();
+    }
+
+    readback->state = SDL_READBACK_CONVERTING;
+    if (!SDL_QueueReadbackConversion(readback)) {
+        /* Convert the pixels right away instead */
+        SDL_ConvertReadback(readback);
+        SDL_AtomicSet(&readback->converted, 1);
+    }
+    return 0;
+}
+
+/* Collect the pixels from the driver once it has finished reading them */
+static int
+SDL_FinishReadback(SDL_RenderReadback * readback)
+{
+    SDL_Renderer *renderer = readback->renderer;
+    int status;
+
+    readback->raw_pitch = readback->rect.w * SDL_BYTESPERPIXEL(readback->raw_format);
+    readback->raw_pixels = SDL_malloc(readback->rect.h * readback->raw_pitch);
+    if (!readback->raw_pixels) {
+        status = SDL_OutOfMemory();
+    } else {
+        status = renderer->FinishReadPixels(renderer, readback);
+    }
+    renderer->DestroyReadPixels(renderer, readback);
+    readback->driverdata = NULL;
+
+    if (status == 0) {
+        status = SDL_StartReadbackConversion(readback);
+    }
+    if (status < 0) {
+        readback->error = SDL_strdup(SDL_GetError());
+        readback->state = SDL_READBACK_FAILED;
+    }
+    return status;
+}
+
+static void
+SDL_CompleteReadback(SDL_RenderReadback * readback)
+{
+    SDL_WaitReadbackConversion(readback);
+    if (readback->error) {
+        readback->state = SDL_READBACK_FAILED;
+    } else {
+        readback->state = SDL_READBACK_COMPLETE;
+    }
+}
+
+SDL_RenderReadback *
+SDL_RenderReadPixelsAsync(SDL_Renderer * renderer, const SDL_Rect * rect,
+                          Uint32 format)
+{
+    SDL_RenderReadback *readback;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!renderer->RenderReadPixels) {
+        SDL_Unsupported();
+        return NULL;
+    }
+
+    readback = (SDL_RenderReadback *) SDL_calloc(1, sizeof(*readback));
+    if (!readback) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    readback->magic = &readback_magic;
+    readback->renderer = renderer;
+    readback->raw_format = SDL_GetReadbackFormat(renderer, format);
+    readback->format = format ? format : readback->raw_format;
+    readback->next = renderer->readbacks;
+    if (renderer->readbacks) {
+        renderer->readbacks->prev = readback;
+    }
+    renderer->readbacks = readback;
+
+    readback->rect = renderer->viewport;
+    if (rect) {
+        if (!SDL_IntersectRect(rect, &readback->rect, &readback->rect)) {
+            readback->rect.w = readback->rect.h = 0;
+        }
+        readback->x = SDL_max(readback->rect.x - rect->x, 0);
+        readback->y = SDL_max(readback->rect.y - rect->y, 0);
+    }
+
+    if (readback->rect.w <= 0 || readback->rect.h <= 0) {
+        /* There's nothing to read */
+        readback->state = SDL_READBACK_COMPLETE;
+    } else if (renderer->StartReadPixels) {
+        readback->state = SDL_READBACK_PENDING;
+        if (renderer->StartReadPixels(renderer, readback) < 0) {
+            SDL_DestroyRenderReadback(readback);
+            return NULL;
+        }
+    } else {
+        /* Take a snapshot of the pixels in the format they're stored in,
+           and leave the conversion to the requested format for later */
+        readback->raw_pitch = readback->rect.w * SDL_BYTESPERPIXEL(readback->raw_format);
+        readback->raw_pixels = SDL_malloc(readback->rect.h * readback->raw_pitch);
+        if (!readback->raw_pixels) {
+            SDL_OutOfMemory();
+            SDL_DestroyRenderReadback(readback);
+            return NULL;
+        }
+        if (renderer->RenderReadPixels(renderer, &readback->rect,
+                                       readback->raw_format,
+                                       readback->raw_pixels,
+                                       readback->raw_pitch) < 0 ||
+            SDL_StartReadbackConversion(readback) < 0) {
+            SDL_DestroyRenderReadback(readback);
+            return NULL;
+        }
+    }
+    return readback;
+}
+
+SDL_bool
+SDL_PollRenderReadback(SDL_RenderReadback * readback)
+{
+    CHECK_READBACK_MAGIC(readback, SDL_FALSE);
+
+    if (readback->state == SDL_READBACK_PENDING) {
+        SDL_Renderer *renderer = readback->renderer;
+
+        if (!renderer->PollReadPixels(renderer, readback)) {
+            return SDL_FALSE;
+        }
+        SDL_FinishReadback(readback);
+    }
+    if (readback->state == SDL_READBACK_CONVERTING) {
+        if (!SDL_AtomicGet(&readback->converted)) {
+            return SDL_FALSE;
+        }
+        SDL_CompleteReadback(readback);
+    }
+    return SDL_TRUE;
+}
+
+int
+SDL_WaitRenderReadback(SDL_RenderReadback * readback, void *pixels, int pitch)
+{
+    CHECK_READBACK_MAGIC(readback, -1);
+
+    if (!pixels) {
+        return SDL_InvalidParamError("pixels");
+    }
+
+    if (readback->state == SDL_READBACK_PENDING) {
+        SDL_FinishReadback(readback);
+    }
+    if (readback->state == SDL_READBACK_CONVERTING) {
+        SDL_CompleteReadback(readback);
+    }
+    if (readback->state == SDL_READBACK_FAILED) {
+        return SDL_SetError("%s", readback->error);
+    }
+    if (!readback->pixels) {
+        return 0;
+    }
+
+    if (readback->y) {
+        pixels = (Uint8 *)pixels + pitch * readback->y;
+    }
+    if (readback->x) {
+        pixels = (Uint8 *)pixels + SDL_BYTESPERPIXEL(readback->format) * readback->x;
+    }
+    return SDL_ConvertPixels(readback->rect.w, readback->rect.h,
+                             readback->format, readback->pixels, readback->pitch,
+                             readback->format, pixels, pitch);
+}
+
+void
+SDL_DestroyRenderReadback(SDL_RenderReadback * readback)
+{
+    SDL_Renderer *renderer;
+
+    CHECK_READBACK_MAGIC(readback, );
+
+    renderer = readback->renderer;
+    if (readback->driverdata) {
+        renderer->DestroyReadPixels(renderer, readback);
+    }
+    if (readback->state == SDL_READBACK_CONVERTING) {
+        SDL_WaitReadbackConversion(readback);
+    }
+
+    readback->magic = NULL;
+
+    if (readback->next) {
+        readback->next->prev = readback->prev;
+    }
+    if (readback->prev) {
+        readback->prev->next = readback->next;
+    } else {
+        renderer->readbacks = readback->next;
+    }
+
+    SDL_free(readback->raw_pixels);
+    SDL_free(readback->pixels);
+    SDL_free(readback->error);
+    SDL_free(readback);
+}
+
 void
 SDL_RenderPresent(SDL_Renderer * renderer)
 {
@@ -1871,6 +2345,12 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
 
     SDL_DelEventWatch(SDL_RendererEventWatch, renderer);
 
+    /* Free pending readbacks for this renderer */
+    while (renderer->readbacks) {
+        SDL_DestroyRenderReadback(renderer->readbacks);
+    }
+    SDL_StopReadbackThread(renderer);
+
     /* Free existing textures for this renderer */
     while (renderer->textures) {
         SDL_DestroyTexture(renderer->textures);
@@ -1880,6 +2360,9 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
         SDL_SetWindowData(renderer->window, SDL_WINDOWRENDERDATA, NULL);
     }
 
+    SDL_free(renderer->staging);
+    renderer->staging = NULL;
+
     /* It's no longer magical... */
     renderer->magic = NULL;
 
@@ -25,6 +25,8 @@
 
 #include "SDL_render.h"
 #include "SDL_events.h"
+#include "SDL_atomic.h"
+#include "SDL_thread.h"
 #include "SDL_yuv_sw_c.h"
 
 /* The SDL 2D rendering system */
@@ -72,6 +74,46 @@ struct SDL_Texture
     SDL_Texture *next;
 };
 
+/* The progress of a readback */
+typedef enum
+{
+    SDL_READBACK_PENDING,       /**< The driver hasn't finished reading the pixels */
+    SDL_READBACK_CONVERTING,    /**< The pixels are being converted */
+    SDL_READBACK_COMPLETE,
+    SDL_READBACK_FAILED
+} SDL_ReadbackState;
+
+/* Define the SDL readback structure */
+struct SDL_RenderReadback
+{
+    const void *magic;
+    SDL_Renderer *renderer;
+    SDL_ReadbackState state;
+
+    SDL_Rect rect;              /**< The area read from the render target */
+    int x, y;                   /**< The offset of rect in the caller's pixels */
+    Uint32 format;              /**< The requested pixel format */
+
+    /* The pixels as read by the driver, in the driver's format */
+    Uint32 raw_format;
+    void *raw_pixels;
+    int raw_pitch;
+
+    /* The pixels converted to the requested format */
+    void *pixels;
+    int pitch;
+
+    /* The conversion, which runs on the renderer's readback thread */
+    SDL_atomic_t converted;
+    char *error;
+    SDL_RenderReadback *next_queued;
+
+    void *driverdata;           /**< Driver specific readback state */
+
+    SDL_RenderReadback *prev;
+    SDL_RenderReadback *next;
+};
+
 /* Define the SDL renderer structure */
 struct SDL_Renderer
 {
@@ -105,6 +147,9 @@ struct SDL_Renderer
                              int count);
     int (*RenderDrawLines) (SDL_Renderer * renderer, const SDL_FPoint * points,
                             int count);
+    /* Optional, draws rect outlines when the scale is 1.0 */
+    int (*RenderDrawRects) (SDL_Renderer * renderer, const SDL_FRect * rects,
+                            int count);
     int (*RenderFillRects) (SDL_Renderer * renderer, const SDL_FRect * rects,
                             int count);
     int (*RenderCopy) (SDL_Renderer * renderer, SDL_Texture * texture,
@@ -114,6 +159,10 @@ struct SDL_Renderer
                        const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip);
     int (*RenderReadPixels) (SDL_Renderer * renderer, const SDL_Rect * rect,
                              Uint32 format, void * pixels, int pitch);
+    int (*StartReadPixels) (SDL_Renderer * renderer, SDL_RenderReadback * readback);
+    SDL_bool (*PollReadPixels) (SDL_Renderer * renderer, SDL_RenderReadback * readback);
+    int (*FinishReadPixels) (SDL_Renderer * renderer, SDL_RenderReadback * readback);
+    void (*DestroyReadPixels) (SDL_Renderer * renderer, SDL_RenderReadback * readback);
     void (*RenderPresent) (SDL_Renderer * renderer);
     void (*DestroyTexture) (SDL_Renderer * renderer, SDL_Texture * texture);
 
@@ -155,6 +204,21 @@ struct SDL_Renderer
     SDL_Texture *textures;
     SDL_Texture *target;
 
+    /* The list of pending readbacks */
+    SDL_RenderReadback *readbacks;
+
+    /* The thread readbacks are converted on, created when first needed,
+       and the queue of readbacks waiting for it */
+    SDL_Thread *readback_thread;
+    SDL_mutex *readback_lock;
+    SDL_cond *readback_cond;
+    SDL_RenderReadback *readback_queue;
+    SDL_RenderReadback *readback_queue_tail;
+    SDL_bool readback_quit;
+
+    /* Buffer converted pixels are uploaded through, see SDL_CreateTextureFromSurface() */
+    void *staging;
+
     Uint8 r, g, b, a;                   /**< Color for drawing operations values */
     SDL_BlendMode blendMode;            /**< The drawing blend mode */
 
@@ -21,37 +21,24 @@
 #include "../SDL_internal.h"
 
 #include "SDL_video.h"
+#include "../video/SDL_yuv_c.h"
 
 /* This is the software implementation of the YUV texture support */
 
+typedef struct SDL_SW_YUVTexture SDL_SW_YUVTexture;
+
 struct SDL_SW_YUVTexture
 {
     Uint32 format;
     Uint32 target_format;
     int w, h;
     Uint8 *pixels;
-    int *colortab;
-    Uint32 *rgb_2_pix;
-    void (*Display1X) (int *colortab, Uint32 * rgb_2_pix,
-                       unsigned char *lum, unsigned char *cr,
-                       unsigned char *cb, unsigned char *out,
-                       int rows, int cols, int mod);
-    void (*Display2X) (int *colortab, Uint32 * rgb_2_pix,
-                       unsigned char *lum, unsigned char *cr,
-                       unsigned char *cb, unsigned char *out,
-                       int rows, int cols, int mod);
-
-    /* These are just so we don't have to allocate them separately */
-    Uint16 pitches[3];
-    Uint8 *planes[3];
 
-    /* This is a temporary surface in case we have to stretch copy */
-    SDL_Surface *stretch;
-    SDL_Surface *display;
+    /* The layout of the pixels, and the conversion to the target format */
+    SDL_YUVImage image;
+    SDL_YUVToRGB conv;
 };
 
-typedef struct SDL_SW_YUVTexture SDL_SW_YUVTexture;
-
 SDL_SW_YUVTexture *SDL_SW_CreateYUVTexture(Uint32 format, int w, int h);
 int SDL_SW_QueryYUVTexturePixels(SDL_SW_YUVTexture * swdata, void **pixels,
                                  int *pitch);
@@ -113,6 +113,7 @@ typedef struct
     ID3D11BlendState *blendModeBlend;
     ID3D11BlendState *blendModeAdd;
     ID3D11BlendState *blendModeMod;
+    ID3D11BlendState *blendModePremultiplied;
     ID3D11SamplerState *nearestPixelSampler;
     ID3D11SamplerState *linearSampler;
     D3D_FEATURE_LEVEL featureLevel;
@@ -895,6 +896,7 @@ D3D11_ReleaseAll(SDL_Renderer * renderer)
         SAFE_RELEASE(data->blendModeBlend);
         SAFE_RELEASE(data->blendModeAdd);
         SAFE_RELEASE(data->blendModeMod);
+        SAFE_RELEASE(data->blendModePremultiplied);
         SAFE_RELEASE(data->nearestPixelSampler);
         SAFE_RELEASE(data->linearSampler);
         SAFE_RELEASE(data->mainRasterizer);
@@ -1309,6 +1311,19 @@ D3D11_CreateDeviceResources(SDL_Renderer * renderer)
         goto done;
     }
 
+    result = D3D11_CreateBlendMode(
+        renderer,
+        TRUE,
+        D3D11_BLEND_ONE,                /* srcBlend */
+        D3D11_BLEND_INV_SRC_ALPHA,      /* destBlend */
+        D3D11_BLEND_ONE,                /* srcBlendAlpha */
+        D3D11_BLEND_INV_SRC_ALPHA,      /* destBlendAlpha */
+        &data->blendModePremultiplied);
+    if (FAILED(result)) {
+        /* D3D11_CreateBlendMode will set the SDL error, if it fails */
+        goto done;
+    }
+
     /* Setup render state that doesn't change */
     ID3D11DeviceContext_IASetInputLayout(data->d3dContext, data->inputLayout);
     ID3D11DeviceContext_VSSetShader(data->d3dContext, data->vertexShader, NULL, 0);
@@ -2434,6 +2449,9 @@ D3D11_RenderSetBlendMode(SDL_Renderer * renderer, SDL_BlendMode blendMode)
     case SDL_BLENDMODE_MOD:
         blendState = rendererData->blendModeMod;
         break;
+    case SDL_BLENDMODE_PREMULTIPLIED:
+        blendState = rendererData->blendModePremultiplied;
+        break;
     case SDL_BLENDMODE_NONE:
         blendState = NULL;
         break;
@@ -2648,6 +2666,12 @@ D3D11_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     if (texture->modMode & SDL_TEXTUREMODULATE_ALPHA) {
         color.w = (float)(texture->a / 255.0f);     /* alpha */
     }
+    if (texture->blendMode == SDL_BLENDMODE_PREMULTIPLIED) {
+        /* The color channels of premultiplied textures scale with the alpha */
+        color.x *= color.w;
+        color.y *= color.w;
+        color.z *= color.w;
+    }
 
     vertices[0].pos.x = dstrect->x;
     vertices[0].pos.y = dstrect->y;
@@ -2742,6 +2766,12 @@ D3D11_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     if (texture->modMode & SDL_TEXTUREMODULATE_ALPHA) {
         color.w = (float)(texture->a / 255.0f);     /* alpha */
     }
+    if (texture->blendMode == SDL_BLENDMODE_PREMULTIPLIED) {
+        /* The color channels of premultiplied textures scale with the alpha */
+        color.x *= color.w;
+        color.y *= color.w;
+        color.z *= color.w;
+    }
 
     if (flip & SDL_FLIP_HORIZONTAL) {
         float tmp = maxu;
@@ -84,6 +84,10 @@ static int GL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
                          const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip);
 static int GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                Uint32 pixel_format, void * pixels, int pitch);
+static int GL_StartReadPixels(SDL_Renderer * renderer, SDL_RenderReadback * readback);
+static SDL_bool GL_PollReadPixels(SDL_Renderer * renderer, SDL_RenderReadback * readback);
+static int GL_FinishReadPixels(SDL_Renderer * renderer, SDL_RenderReadback * readback);
+static void GL_DestroyReadPixels(SDL_Renderer * renderer, SDL_RenderReadback * readback);
 static void GL_RenderPresent(SDL_Renderer * renderer);
 static void GL_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture);
 static void GL_DestroyRenderer(SDL_Renderer * renderer);
@@ -101,6 +105,12 @@ SDL_RenderDriver GL_RenderDriver = {
      0}
 };
 
+/* The most pixel buffer objects a streaming texture cycles through */
+#define GL_MAX_STREAMING_BUFFERS    8
+
+/* The number of vertices batched before they're drawn regardless */
+#define GL_MAX_BATCH_VERTICES       (4 * 4096)
+
 typedef struct GL_FBOList GL_FBOList;
 
 struct GL_FBOList
@@ -127,8 +137,19 @@ typedef struct
         GL_Shader shader;
         Uint32 color;
         int blendMode;
+        SDL_Texture *texture;
+        GLenum textype;
     } current;
 
+    /* Vertices waiting to be drawn with the current state, each one
+       an x, y position followed by u, v texture coordinates */
+    struct {
+        GLenum mode;
+        GLfloat *vertices;
+        int count;
+        int max_count;
+    } batch;
+
     SDL_bool GL_EXT_framebuffer_object_supported;
     GL_FBOList *framebuffers;
 
@@ -148,6 +169,21 @@ typedef struct
     PFNGLBINDFRAMEBUFFEREXTPROC glBindFramebufferEXT;
     PFNGLCHECKFRAMEBUFFERSTATUSEXTPROC glCheckFramebufferStatusEXT;
 
+    /* Pixel buffer object support, for streaming texture uploads */
+    SDL_bool GL_ARB_pixel_buffer_object_supported;
+    PFNGLGENBUFFERSARBPROC glGenBuffersARB;
+    PFNGLDELETEBUFFERSARBPROC glDeleteBuffersARB;
+    PFNGLBINDBUFFERARBPROC glBindBufferARB;
+    PFNGLBUFFERDATAARBPROC glBufferDataARB;
+    PFNGLMAPBUFFERARBPROC glMapBufferARB;
+    PFNGLUNMAPBUFFERARBPROC glUnmapBufferARB;
+
+    /* Sync object support, for polling asynchronous reads */
+    SDL_bool GL_ARB_sync_supported;
+    PFNGLFENCESYNCPROC glFenceSync;
+    PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+    PFNGLDELETESYNCPROC glDeleteSync;
+
     /* Shader support */
     GL_ShaderContext *shaders;
 
@@ -163,8 +199,16 @@ typedef struct
     GLenum formattype;
     void *pixels;
     int pitch;
+    size_t size;
     SDL_Rect locked_rect;
 
+    /* Streaming textures are locked into these pixel buffer objects in
+       turn, so a lock doesn't wait for the previous upload to finish */
+    GLuint pbos[GL_MAX_STREAMING_BUFFERS];
+    int num_pbos;
+    int next_pbo;
+    GLuint locked_pbo;
+
     /* YUV texture support */
     SDL_bool yuv;
     SDL_bool nv12;
@@ -174,6 +218,14 @@ typedef struct
     GL_FBOList *fbo;
 } GL_TextureData;
 
+typedef struct
+{
+    /* The buffer the pixels are read into, and a fence which is signaled
+       when they're there */
+    GLuint pbo;
+    GLsync fence;
+} GL_ReadbackData;
+
 SDL_FORCE_INLINE const char*
 GL_TranslateError (GLenum error)
 {
@@ -307,6 +359,69 @@ GL_ActivateRenderer(SDL_Renderer * renderer)
     return 0;
 }
 
+/* Draw the vertices batched up so far */
+static void
+GL_FlushBatch(GL_RenderData * data)
+{
+    const GLsizei stride = 4 * sizeof(GLfloat);
+
+    if (!data->batch.count) {
+        return;
+    }
+
+    data->glVertexPointer(2, GL_FLOAT, stride, data->batch.vertices);
+    if (data->current.texture) {
+        data->glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        data->glTexCoordPointer(2, GL_FLOAT, stride, data->batch.vertices + 2);
+    }
+    data->glDrawArrays(data->batch.mode, 0, data->batch.count);
+    if (data->current.texture) {
+        data->glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    }
+    data->batch.count = 0;
+}
+
+/* Make room for count more vertices drawn with mode, returning where
+   they go, or NULL if we're out of memory */
+static GLfloat *
+GL_AddVertices(GL_RenderData * data, GLenum mode, int count)
+{
+    GLfloat *vertices;
+
+    if (data->batch.mode != mode) {
+        GL_FlushBatch(data);
+        data->batch.mode = mode;
+    }
+    if (data->batch.count + count > GL_MAX_BATCH_VERTICES) {
+        GL_FlushBatch(data);
+    }
+    if (data->batch.count + count > data->batch.max_count) {
+        int max_count = SDL_max(data->batch.count + count, 2 * data->batch.max_count);
+
+        vertices = (GLfloat *) SDL_realloc(data->batch.vertices, max_count * 4 * sizeof(GLfloat));
+        if (!vertices) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        data->batch.vertices = vertices;
+        data->batch.max_count = max_count;
+    }
+    vertices = data->batch.vertices + data->batch.count * 4;
+    data->batch.count += count;
+    return vertices;
+}
+
+/* Stop texturing, drawing what was batched with the texture first */
+static void
+GL_ResetTexture(GL_RenderData * data)
+{
+    if (data->current.texture) {
+        GL_FlushBatch(data);
+        data->glDisable(data->current.textype);
+        data->current.texture = NULL;
+    }
+}
+
 /* This is called if we need to invalidate all of the SDL OpenGL state */
 static void
 GL_ResetState(SDL_Renderer *renderer)
@@ -322,9 +437,12 @@ GL_ResetState(SDL_Renderer *renderer)
     data->current.shader = SHADER_NONE;
     data->current.color = 0;
     data->current.blendMode = -1;
+    data->current.texture = NULL;
+    data->batch.count = 0;
 
     data->glDisable(GL_DEPTH_TEST);
     data->glDisable(GL_CULL_FACE);
+    data->glEnableClientState(GL_VERTEX_ARRAY);
     /* This ended up causing video discrepancies between OpenGL and Direct3D */
     /* data->glEnable(GL_LINE_SMOOTH); */
 
@@ -563,6 +681,44 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     }
     data->framebuffers = NULL;
 
+    if (SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object")) {
+        data->glGenBuffersARB = (PFNGLGENBUFFERSARBPROC)
+            SDL_GL_GetProcAddress("glGenBuffersARB");
+        data->glDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC)
+            SDL_GL_GetProcAddress("glDeleteBuffersARB");
+        data->glBindBufferARB = (PFNGLBINDBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glBindBufferARB");
+        data->glBufferDataARB = (PFNGLBUFFERDATAARBPROC)
+            SDL_GL_GetProcAddress("glBufferDataARB");
+        data->glMapBufferARB = (PFNGLMAPBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glMapBufferARB");
+        data->glUnmapBufferARB = (PFNGLUNMAPBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glUnmapBufferARB");
+        if (data->glGenBuffersARB && data->glDeleteBuffersARB &&
+            data->glBindBufferARB && data->glBufferDataARB &&
+            data->glMapBufferARB && data->glUnmapBufferARB) {
+            data->GL_ARB_pixel_buffer_object_supported = SDL_TRUE;
+        }
+    }
+    if (data->GL_ARB_pixel_buffer_object_supported) {
+        renderer->StartReadPixels = GL_StartReadPixels;
+        renderer->PollReadPixels = GL_PollReadPixels;
+        renderer->FinishReadPixels = GL_FinishReadPixels;
+        renderer->DestroyReadPixels = GL_DestroyReadPixels;
+    }
+
+    if (SDL_GL_ExtensionSupported("GL_ARB_sync")) {
+        data->glFenceSync = (PFNGLFENCESYNCPROC)
+            SDL_GL_GetProcAddress("glFenceSync");
+        data->glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)
+            SDL_GL_GetProcAddress("glClientWaitSync");
+        data->glDeleteSync = (PFNGLDELETESYNCPROC)
+            SDL_GL_GetProcAddress("glDeleteSync");
+        if (data->glFenceSync && data->glClientWaitSync && data->glDeleteSync) {
+            data->GL_ARB_sync_supported = SDL_TRUE;
+        }
+    }
+
     /* Set up parameters for rendering */
     GL_ResetState(renderer);
 
@@ -694,6 +850,20 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
             SDL_free(data);
             return SDL_OutOfMemory();
         }
+        data->size = size;
+
+        if (renderdata->GL_ARB_pixel_buffer_object_supported) {
+            const char *hint = SDL_GetHint(SDL_HINT_RENDER_STREAMING_BUFFERS);
+            int num_pbos = hint ? SDL_atoi(hint) : 1;
+
+            if (num_pbos > 1) {
+                num_pbos = SDL_min(num_pbos, GL_MAX_STREAMING_BUFFERS);
+                renderdata->glGenBuffersARB(num_pbos, data->pbos);
+                if (GL_CheckError("glGenBuffersARB()", renderer) == 0) {
+                    data->num_pbos = num_pbos;
+                }
+            }
+        }
     }
 
     if (texture->access == SDL_TEXTUREACCESS_TARGET) {
@@ -705,6 +875,9 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     GL_CheckError("", renderer);
     renderdata->glGenTextures(1, &data->texture);
     if (GL_CheckError("glGenTextures()", renderer) < 0) {
+        if (data->num_pbos) {
+            renderdata->glDeleteBuffersARB(data->num_pbos, data->pbos);
+        }
         if (data->pixels) {
             SDL_free(data->pixels);
         }
@@ -736,6 +909,7 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     data->format = format;
     data->formattype = type;
     scaleMode = GetScaleQuality();
+    GL_ResetTexture(renderdata);
     renderdata->glEnable(data->type);
     renderdata->glBindTexture(data->type, data->texture);
     renderdata->glTexParameteri(data->type, GL_TEXTURE_MIN_FILTER, scaleMode);
@@ -858,6 +1032,7 @@ GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
     SDL_assert(texturebpp != 0);  /* otherwise, division by zero later. */
 
     GL_ActivateRenderer(renderer);
+    GL_ResetTexture(renderdata);
 
     renderdata->glEnable(data->type);
     renderdata->glBindTexture(data->type, data->texture);
@@ -918,6 +1093,7 @@ GL_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
     GL_TextureData *data = (GL_TextureData *) texture->driverdata;
 
     GL_ActivateRenderer(renderer);
+    GL_ResetTexture(renderdata);
 
     renderdata->glEnable(data->type);
     renderdata->glBindTexture(data->type, data->texture);
@@ -947,12 +1123,39 @@ static int
 GL_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                const SDL_Rect * rect, void **pixels, int *pitch)
 {
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
     GL_TextureData *data = (GL_TextureData *) texture->driverdata;
+    const size_t offset = rect->y * data->pitch +
+                          rect->x * SDL_BYTESPERPIXEL(texture->format);
 
     data->locked_rect = *rect;
-    *pixels =
-        (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
-                  rect->x * SDL_BYTESPERPIXEL(texture->format));
+
+    if (data->num_pbos) {
+        const GLuint pbo = data->pbos[data->next_pbo];
+        void *mapped;
+
+        GL_ActivateRenderer(renderer);
+
+        /* Orphan the previous contents of the buffer, so mapping it
+           doesn't wait for an upload that is still in flight */
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo);
+        renderdata->glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->size,
+                                    NULL, GL_STREAM_DRAW_ARB);
+        mapped = renderdata->glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB,
+                                            GL_WRITE_ONLY_ARB);
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+        if (mapped) {
+            data->next_pbo = (data->next_pbo + 1) % data->num_pbos;
+            data->locked_pbo = pbo;
+            *pixels = (void *) ((Uint8 *) mapped + offset);
+            *pitch = data->pitch;
+            return 0;
+        }
+        /* Fall back to uploading from client memory */
+        GL_ClearErrors(renderer);
+    }
+
+    *pixels = (void *) ((Uint8 *) data->pixels + offset);
     *pitch = data->pitch;
     return 0;
 }
@@ -965,6 +1168,23 @@ GL_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     void *pixels;
 
     rect = &data->locked_rect;
+    if (data->locked_pbo) {
+        GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
+        const size_t offset = rect->y * data->pitch +
+                              rect->x * SDL_BYTESPERPIXEL(texture->format);
+
+        GL_ActivateRenderer(renderer);
+
+        /* With the buffer bound, the pixels are an offset into it and
+           the upload doesn't have to finish before this returns */
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->locked_pbo);
+        if (renderdata->glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB)) {
+            GL_UpdateTexture(renderer, texture, rect, (void *) (uintptr_t) offset, data->pitch);
+        }
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+        data->locked_pbo = 0;
+        return;
+    }
     pixels =
         (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
                   rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -979,6 +1199,7 @@ GL_SetRenderTarget(SDL_Renderer * renderer, SDL_Texture * texture)
     GLenum status;
 
     GL_ActivateRenderer(renderer);
+    GL_FlushBatch(data);
 
     if (texture == NULL) {
         data->glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
@@ -1007,6 +1228,8 @@ GL_UpdateViewport(SDL_Renderer * renderer)
         return 0;
     }
 
+    GL_FlushBatch(data);
+
     if (renderer->target) {
         data->glViewport(renderer->viewport.x, renderer->viewport.y,
                          renderer->viewport.w, renderer->viewport.h);
@@ -1043,6 +1266,8 @@ GL_UpdateClipRect(SDL_Renderer * renderer)
 {
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
 
+    GL_FlushBatch(data);
+
     if (renderer->clipping_enabled) {
         const SDL_Rect *rect = &renderer->clip_rect;
         data->glEnable(GL_SCISSOR_TEST);
@@ -1057,6 +1282,7 @@ static void
 GL_SetShader(GL_RenderData * data, GL_Shader shader)
 {
     if (data->shaders && shader != data->current.shader) {
+        GL_FlushBatch(data);
         GL_SelectShader(data->shaders, shader);
         data->current.shader = shader;
     }
@@ -1068,6 +1294,7 @@ GL_SetColor(GL_RenderData * data, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
     Uint32 color = ((a << 24) | (r << 16) | (g << 8) | b);
 
     if (color != data->current.color) {
+        GL_FlushBatch(data);
         data->glColor4f((GLfloat) r * inv255f,
                         (GLfloat) g * inv255f,
                         (GLfloat) b * inv255f,
@@ -1080,6 +1307,7 @@ static void
 GL_SetBlendMode(GL_RenderData * data, int blendMode)
 {
     if (blendMode != data->current.blendMode) {
+        GL_FlushBatch(data);
         switch (blendMode) {
         case SDL_BLENDMODE_NONE:
             data->glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
@@ -1100,6 +1328,11 @@ GL_SetBlendMode(GL_RenderData * data, int blendMode)
             data->glEnable(GL_BLEND);
             data->glBlendFuncSeparate(GL_ZERO, GL_SRC_COLOR, GL_ZERO, GL_ONE);
             break;
+        case SDL_BLENDMODE_PREMULTIPLIED:
+            data->glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+            data->glEnable(GL_BLEND);
+            data->glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            break;
         }
         data->current.blendMode = blendMode;
     }
@@ -1111,6 +1344,7 @@ GL_SetDrawingState(SDL_Renderer * renderer)
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
 
     GL_ActivateRenderer(renderer);
+    GL_ResetTexture(data);
 
     GL_SetColor(data, renderer->r,
                       renderer->g,
@@ -1128,6 +1362,7 @@ GL_RenderClear(SDL_Renderer * renderer)
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
 
     GL_ActivateRenderer(renderer);
+    GL_FlushBatch(data);
 
     data->glClearColor((GLfloat) renderer->r * inv255f,
                        (GLfloat) renderer->g * inv255f,
@@ -1144,15 +1379,20 @@ GL_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
                     int count)
 {
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GLfloat *vertices;
     int i;
 
     GL_SetDrawingState(renderer);
 
-    data->glBegin(GL_POINTS);
+    vertices = GL_AddVertices(data, GL_POINTS, count);
+    if (!vertices) {
+        return -1;
+    }
     for (i = 0; i < count; ++i) {
-        data->glVertex2f(0.5f + points[i].x, 0.5f + points[i].y);
+        vertices[0] = 0.5f + points[i].x;
+        vertices[1] = 0.5f + points[i].y;
+        vertices += 4;
     }
-    data->glEnd();
 
     return 0;
 }
@@ -1165,6 +1405,7 @@ GL_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
     int i;
 
     GL_SetDrawingState(renderer);
+    GL_FlushBatch(data);
 
     if (count > 2 &&
         points[0].x == points[count-1].x && points[0].y == points[count-1].y) {
@@ -1221,20 +1462,51 @@ GL_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
     return GL_CheckError("", renderer);
 }
 
+/* Write the vertices of a quad, given its corners in the order top left,
+   top right, bottom left, bottom right */
+static void
+GL_SetQuadVertices(GLfloat *vertices, const GLfloat *x, const GLfloat *y,
+                   GLfloat minu, GLfloat minv, GLfloat maxu, GLfloat maxv)
+{
+    static const int corners[4] = { 0, 1, 3, 2 };
+    int i;
+
+    for (i = 0; i < 4; ++i) {
+        const int corner = corners[i];
+
+        vertices[0] = x[corner];
+        vertices[1] = y[corner];
+        vertices[2] = (corner & 1) ? maxu : minu;
+        vertices[3] = (corner & 2) ? maxv : minv;
+        vertices += 4;
+    }
+}
+
 static int
 GL_RenderFillRects(SDL_Renderer * renderer, const SDL_FRect * rects, int count)
 {
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GLfloat *vertices;
     int i;
 
     GL_SetDrawingState(renderer);
 
+    vertices = GL_AddVertices(data, GL_QUADS, count * 4);
+    if (!vertices) {
+        return -1;
+    }
     for (i = 0; i < count; ++i) {
         const SDL_FRect *rect = &rects[i];
+        GLfloat x[4], y[4];
 
-        data->glRectf(rect->x, rect->y, rect->x + rect->w, rect->y + rect->h);
+        x[0] = x[2] = rect->x;
+        x[1] = x[3] = rect->x + rect->w;
+        y[0] = y[1] = rect->y;
+        y[2] = y[3] = rect->y + rect->h;
+        GL_SetQuadVertices(vertices, x, y, 0.0f, 0.0f, 0.0f, 0.0f);
+        vertices += 16;
     }
-    return GL_CheckError("", renderer);
+    return 0;
 }
 
 static int
@@ -1243,25 +1515,39 @@ GL_SetupCopy(SDL_Renderer * renderer, SDL_Texture * texture)
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
     GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
 
-    data->glEnable(texturedata->type);
-    if (texturedata->yuv) {
-        data->glActiveTextureARB(GL_TEXTURE2_ARB);
-        data->glBindTexture(texturedata->type, texturedata->vtexture);
+    if (texture != data->current.texture) {
+        /* Untextured vertices must not be drawn with the new texture */
+        GL_FlushBatch(data);
+        GL_ResetTexture(data);
 
-        data->glActiveTextureARB(GL_TEXTURE1_ARB);
-        data->glBindTexture(texturedata->type, texturedata->utexture);
+        data->glEnable(texturedata->type);
+        if (texturedata->yuv) {
+            data->glActiveTextureARB(GL_TEXTURE2_ARB);
+            data->glBindTexture(texturedata->type, texturedata->vtexture);
 
-        data->glActiveTextureARB(GL_TEXTURE0_ARB);
-    }
-    if (texturedata->nv12) {
-        data->glActiveTextureARB(GL_TEXTURE1_ARB);
-        data->glBindTexture(texturedata->type, texturedata->utexture);
+            data->glActiveTextureARB(GL_TEXTURE1_ARB);
+            data->glBindTexture(texturedata->type, texturedata->utexture);
 
-        data->glActiveTextureARB(GL_TEXTURE0_ARB);
+            data->glActiveTextureARB(GL_TEXTURE0_ARB);
+        }
+        if (texturedata->nv12) {
+            data->glActiveTextureARB(GL_TEXTURE1_ARB);
+            data->glBindTexture(texturedata->type, texturedata->utexture);
+
+            data->glActiveTextureARB(GL_TEXTURE0_ARB);
+        }
+        data->glBindTexture(texturedata->type, texturedata->texture);
+
+        data->current.texture = texture;
+        data->current.textype = texturedata->type;
     }
-    data->glBindTexture(texturedata->type, texturedata->texture);
 
-    if (texture->modMode) {
+    if (texture->modMode && texture->blendMode == SDL_BLENDMODE_PREMULTIPLIED) {
+        /* The color channels of premultiplied textures scale with the alpha */
+        GL_SetColor(data, (texture->r * texture->a) / 255,
+                          (texture->g * texture->a) / 255,
+                          (texture->b * texture->a) / 255, texture->a);
+    } else if (texture->modMode) {
         GL_SetColor(data, texture->r, texture->g, texture->b, texture->a);
     } else {
         GL_SetColor(data, 255, 255, 255, 255);
@@ -1291,6 +1577,8 @@ GL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
     GLfloat minx, miny, maxx, maxy;
     GLfloat minu, maxu, minv, maxv;
+    GLfloat x[4], y[4];
+    GLfloat *vertices;
 
     GL_ActivateRenderer(renderer);
 
@@ -1312,20 +1600,17 @@ GL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     maxv = (GLfloat) (srcrect->y + srcrect->h) / texture->h;
     maxv *= texturedata->texh;
 
-    data->glBegin(GL_TRIANGLE_STRIP);
-    data->glTexCoord2f(minu, minv);
-    data->glVertex2f(minx, miny);
-    data->glTexCoord2f(maxu, minv);
-    data->glVertex2f(maxx, miny);
-    data->glTexCoord2f(minu, maxv);
-    data->glVertex2f(minx, maxy);
-    data->glTexCoord2f(maxu, maxv);
-    data->glVertex2f(maxx, maxy);
-    data->glEnd();
-
-    data->glDisable(texturedata->type);
+    vertices = GL_AddVertices(data, GL_QUADS, 4);
+    if (!vertices) {
+        return -1;
+    }
+    x[0] = x[2] = minx;
+    x[1] = x[3] = maxx;
+    y[0] = y[1] = miny;
+    y[2] = y[3] = maxy;
+    GL_SetQuadVertices(vertices, x, y, minu, minv, maxu, maxv);
 
-    return GL_CheckError("", renderer);
+    return 0;
 }
 
 static int
@@ -1338,6 +1623,10 @@ GL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     GLfloat minx, miny, maxx, maxy;
     GLfloat centerx, centery;
     GLfloat minu, maxu, minv, maxv;
+    GLfloat originx, originy, s, c;
+    GLfloat x[4], y[4];
+    GLfloat *vertices;
+    int i;
 
     GL_ActivateRenderer(renderer);
 
@@ -1375,26 +1664,31 @@ GL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     maxv = (GLfloat) (srcrect->y + srcrect->h) / texture->h;
     maxv *= texturedata->texh;
 
-    /* Translate to flip, rotate, translate to position */
-    data->glPushMatrix();
-    data->glTranslatef((GLfloat)dstrect->x + centerx, (GLfloat)dstrect->y + centery, (GLfloat)0.0);
-    data->glRotated(angle, (GLdouble)0.0, (GLdouble)0.0, (GLdouble)1.0);
-
-    data->glBegin(GL_TRIANGLE_STRIP);
-    data->glTexCoord2f(minu, minv);
-    data->glVertex2f(minx, miny);
-    data->glTexCoord2f(maxu, minv);
-    data->glVertex2f(maxx, miny);
-    data->glTexCoord2f(minu, maxv);
-    data->glVertex2f(minx, maxy);
-    data->glTexCoord2f(maxu, maxv);
-    data->glVertex2f(maxx, maxy);
-    data->glEnd();
-    data->glPopMatrix();
+    vertices = GL_AddVertices(data, GL_QUADS, 4);
+    if (!vertices) {
+        return -1;
+    }
 
-    data->glDisable(texturedata->type);
+    /* Flip, rotate and translate to position on the CPU, so the copy can
+       be batched with others */
+    originx = dstrect->x + centerx;
+    originy = dstrect->y + centery;
+    s = (GLfloat) SDL_sin(angle * M_PI / 180.0);
+    c = (GLfloat) SDL_cos(angle * M_PI / 180.0);
+    x[0] = x[2] = minx;
+    x[1] = x[3] = maxx;
+    y[0] = y[1] = miny;
+    y[2] = y[3] = maxy;
+    for (i = 0; i < 4; ++i) {
+        const GLfloat px = x[i];
+        const GLfloat py = y[i];
 
-    return GL_CheckError("", renderer);
+        x[i] = originx + c * px - s * py;
+        y[i] = originy + s * px + c * py;
+    }
+    GL_SetQuadVertices(vertices, x, y, minu, minv, maxu, maxv);
+
+    return 0;
 }
 
 static int
@@ -1412,6 +1706,7 @@ GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
     int status;
 
     GL_ActivateRenderer(renderer);
+    GL_FlushBatch(data);
 
     temp_pitch = rect->w * SDL_BYTESPERPIXEL(temp_format);
     temp_pixels = SDL_malloc(rect->h * temp_pitch);
@@ -1458,10 +1753,137 @@ GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
     return status;
 }
 
+static int
+GL_StartReadPixels(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *readbackdata;
+    const SDL_Rect *rect = &readback->rect;
+    GLint internalFormat;
+    GLenum format, type;
+    int w, h;
+
+    GL_ActivateRenderer(renderer);
+    GL_FlushBatch(data);
+
+    readbackdata = (GL_ReadbackData *) SDL_calloc(1, sizeof(*readbackdata));
+    if (!readbackdata) {
+        return SDL_OutOfMemory();
+    }
+    readback->driverdata = readbackdata;
+    readback->raw_format = SDL_PIXELFORMAT_ARGB8888;
+
+    convert_format(data, readback->raw_format, &internalFormat, &format, &type);
+
+    SDL_GetRendererOutputSize(renderer, &w, &h);
+
+    /* Read into a pixel buffer object, so glReadPixels() returns without
+       waiting for rendering to finish */
+    data->glGenBuffersARB(1, &readbackdata->pbo);
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readbackdata->pbo);
+    data->glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB,
+                          rect->w * rect->h * SDL_BYTESPERPIXEL(readback->raw_format),
+                          NULL, GL_STREAM_READ_ARB);
+
+    data->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    data->glPixelStorei(GL_PACK_ROW_LENGTH, rect->w);
+
+    data->glReadPixels(rect->x, (h-rect->y)-rect->h, rect->w, rect->h,
+                       format, type, NULL);
+
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    if (GL_CheckError("glReadPixels()", renderer) < 0) {
+        return -1;
+    }
+
+    if (data->GL_ARB_sync_supported) {
+        readbackdata->fence = data->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    return 0;
+}
+
+static SDL_bool
+GL_PollReadPixels(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *readbackdata = (GL_ReadbackData *) readback->driverdata;
+    GLenum status;
+
+    if (!readbackdata->fence) {
+        /* There's no way to tell, mapping the buffer will wait if needed */
+        return SDL_TRUE;
+    }
+
+    GL_ActivateRenderer(renderer);
+
+    status = data->glClientWaitSync(readbackdata->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    return (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED);
+}
+
+static int
+GL_FinishReadPixels(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *readbackdata = (GL_ReadbackData *) readback->driverdata;
+    const Uint8 *src;
+    Uint8 *dst;
+    int length, rows;
+
+    GL_ActivateRenderer(renderer);
+
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readbackdata->pbo);
+    src = (const Uint8 *) data->glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
+    if (!src) {
+        data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+        return SDL_SetError("Couldn't map pixel buffer object");
+    }
+
+    /* Copy the rows out top-down */
+    length = readback->rect.w * SDL_BYTESPERPIXEL(readback->raw_format);
+    src += (readback->rect.h - 1) * length;
+    dst = (Uint8 *) readback->raw_pixels;
+    rows = readback->rect.h;
+    while (rows--) {
+        SDL_memcpy(dst, src, length);
+        dst += readback->raw_pitch;
+        src -= length;
+    }
+
+    data->glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+    return 0;
+}
+
+static void
+GL_DestroyReadPixels(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *readbackdata = (GL_ReadbackData *) readback->driverdata;
+
+    if (!readbackdata) {
+        return;
+    }
+
+    GL_ActivateRenderer(renderer);
+
+    if (readbackdata->fence) {
+        data->glDeleteSync(readbackdata->fence);
+    }
+    if (readbackdata->pbo) {
+        data->glDeleteBuffersARB(1, &readbackdata->pbo);
+    }
+    SDL_free(readbackdata);
+    readback->driverdata = NULL;
+}
+
 static void
 GL_RenderPresent(SDL_Renderer * renderer)
 {
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+
     GL_ActivateRenderer(renderer);
+    GL_FlushBatch(data);
 
     SDL_GL_SwapWindow(renderer->window);
 }
@@ -1477,6 +1899,9 @@ GL_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     if (!data) {
         return;
     }
+    if (texture == renderdata->current.texture) {
+        GL_ResetTexture(renderdata);
+    }
     if (data->texture) {
         renderdata->glDeleteTextures(1, &data->texture);
     }
@@ -1484,6 +1909,9 @@ GL_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
         renderdata->glDeleteTextures(1, &data->utexture);
         renderdata->glDeleteTextures(1, &data->vtexture);
     }
+    if (data->num_pbos) {
+        renderdata->glDeleteBuffersARB(data->num_pbos, data->pbos);
+    }
     SDL_free(data->pixels);
     SDL_free(data);
     texture->driverdata = NULL;
@@ -1517,6 +1945,7 @@ GL_DestroyRenderer(SDL_Renderer * renderer)
             }
             SDL_GL_DeleteContext(data->context);
         }
+        SDL_free(data->batch.vertices);
         SDL_free(data);
     }
     SDL_free(renderer);
@@ -1529,6 +1958,13 @@ GL_BindTexture (SDL_Renderer * renderer, SDL_Texture *texture, float *texw, floa
     GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
     GL_ActivateRenderer(renderer);
 
+    /* The application is about to draw with its own GL calls, so whatever
+       was batched has to be drawn first, with the state it was batched
+       with. This has to happen before the texture is bound, or untextured
+       vertices would be drawn with it. */
+    GL_FlushBatch(data);
+    GL_ResetTexture(data);
+
     data->glEnable(texturedata->type);
     if (texturedata->yuv) {
         data->glActiveTextureARB(GL_TEXTURE2_ARB);
@@ -1554,6 +1990,10 @@ GL_UnbindTexture (SDL_Renderer * renderer, SDL_Texture *texture)
     GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
     GL_ActivateRenderer(renderer);
 
+    /* Likewise, nothing batched may be drawn after the texture is unbound
+       with state that was changed while it was bound */
+    GL_FlushBatch(data);
+
     if (texturedata->yuv) {
         data->glActiveTextureARB(GL_TEXTURE2_ARB);
         data->glDisable(texturedata->type);
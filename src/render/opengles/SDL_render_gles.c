@@ -766,6 +766,15 @@ GLES_SetBlendMode(GLES_RenderData * data, int blendMode)
                 data->glBlendFunc(GL_ZERO, GL_SRC_COLOR);
             }
             break;
+        case SDL_BLENDMODE_PREMULTIPLIED:
+            data->glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+            data->glEnable(GL_BLEND);
+            if (data->GL_OES_blend_func_separate_supported) {
+                data->glBlendFuncSeparateOES(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            } else {
+                data->glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            }
+            break;
         }
         data->current.blendMode = blendMode;
     }
@@ -929,7 +938,12 @@ GLES_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
 
     data->glBindTexture(texturedata->type, texturedata->texture);
 
-    if (texture->modMode) {
+    if (texture->modMode && texture->blendMode == SDL_BLENDMODE_PREMULTIPLIED) {
+        /* The color channels of premultiplied textures scale with the alpha */
+        GLES_SetColor(data, (texture->r * texture->a) / 255,
+                            (texture->g * texture->a) / 255,
+                            (texture->b * texture->a) / 255, texture->a);
+    } else if (texture->modMode) {
         GLES_SetColor(data, texture->r, texture->g, texture->b, texture->a);
     } else {
         GLES_SetColor(data, 255, 255, 255, 255);
@@ -1030,7 +1044,12 @@ GLES_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
 
     data->glBindTexture(texturedata->type, texturedata->texture);
 
-    if (texture->modMode) {
+    if (texture->modMode && texture->blendMode == SDL_BLENDMODE_PREMULTIPLIED) {
+        /* The color channels of premultiplied textures scale with the alpha */
+        GLES_SetColor(data, (texture->r * texture->a) / 255,
+                            (texture->g * texture->a) / 255,
+                            (texture->b * texture->a) / 255, texture->a);
+    } else if (texture->modMode) {
         GLES_SetColor(data, texture->r, texture->g, texture->b, texture->a);
     } else {
         GLES_SetColor(data, 255, 255, 255, 255);
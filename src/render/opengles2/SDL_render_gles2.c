@@ -23,6 +23,7 @@
 #if SDL_VIDEO_RENDER_OGL_ES2 && !SDL_RENDER_DISABLED
 
 #include "SDL_hints.h"
+#include "SDL_log.h"
 #include "SDL_opengles2.h"
 #include "../SDL_sysrender.h"
 #include "../../video/SDL_blit.h"
@@ -178,9 +179,27 @@ typedef struct GLES2_DriverContext
 
     struct {
         int blendMode;
-        SDL_bool tex_coords;
+        GLES2_ImageSource source;
+        SDL_BlendMode shaderBlendMode;
+        Uint32 attribs;
+        Uint32 attrib_pointers;
+        const void *pointers[4];
+        GLuint vertex_buffer;
+        int active_texture;
+        GLuint textures[3];
     } current;
 
+    /* GL calls issued since the last present, logged for profiling */
+    struct {
+        int programs;
+        int uniforms;
+        int textures;
+        int attribs;
+        int buffers;
+        int blends;
+        int draws;
+    } stats;
+
 #define SDL_PROC(ret,func,params) ret (APIENTRY *func) params;
 #include "SDL_gles2funcs.h"
 #undef SDL_PROC
@@ -329,14 +348,25 @@ GLES2_GetFBO(GLES2_DriverContext *data, Uint32 w, Uint32 h)
    return result;
 }
 
+static void
+GLES2_InvalidateBindings(GLES2_DriverContext *data)
+{
+    /* Forget the objects we think are bound, so they're bound again on next use */
+    data->current_program = NULL;
+    data->current.attrib_pointers = 0;
+    data->current.vertex_buffer = 0;
+    data->current.active_texture = -1;
+    SDL_zero(data->current.textures);
+}
+
 static int
 GLES2_ActivateRenderer(SDL_Renderer * renderer)
 {
     GLES2_DriverContext *data = (GLES2_DriverContext *)renderer->driverdata;
 
     if (SDL_CurrentContext != data->context) {
-        /* Null out the current program to ensure we set it again */
-        data->current_program = NULL;
+        /* Null out the current program and bindings to ensure we set them again */
+        GLES2_InvalidateBindings(data);
 
         if (SDL_GL_MakeCurrent(renderer->window, data->context) < 0) {
             return -1;
@@ -481,6 +511,36 @@ static void GLES2_UnlockTexture(SDL_Renderer *renderer, SDL_Texture *texture);
 static int GLES2_SetRenderTarget(SDL_Renderer * renderer, SDL_Texture * texture);
 static void GLES2_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture);
 
+static void
+GLES2_ActiveTexture(GLES2_DriverContext *data, int unit)
+{
+    if (data->current.active_texture != unit) {
+        data->glActiveTexture(GL_TEXTURE0 + unit);
+        data->current.active_texture = unit;
+        ++data->stats.textures;
+    }
+}
+
+/* Make sure texture is bound to unit for drawing */
+static void
+GLES2_BindTextureUnit(GLES2_DriverContext *data, int unit, GLenum type, GLuint texture)
+{
+    if (data->current.textures[unit] != texture) {
+        GLES2_ActiveTexture(data, unit);
+        data->glBindTexture(type, texture);
+        data->current.textures[unit] = texture;
+        ++data->stats.textures;
+    }
+}
+
+/* Bind texture to unit and make that unit active, so texture calls affect it */
+static void
+GLES2_SelectTexture(GLES2_DriverContext *data, int unit, GLenum type, GLuint texture)
+{
+    GLES2_ActiveTexture(data, unit);
+    GLES2_BindTextureUnit(data, unit, type, texture);
+}
+
 static GLenum
 GetScaleQuality(void)
 {
@@ -568,8 +628,7 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         if (GL_CheckError("glGenTexures()", renderer) < 0) {
             return -1;
         }
-        renderdata->glActiveTexture(GL_TEXTURE2);
-        renderdata->glBindTexture(data->texture_type, data->texture_v);
+        GLES2_SelectTexture(renderdata, 2, data->texture_type, data->texture_v);
         renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_MIN_FILTER, scaleMode);
         renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_MAG_FILTER, scaleMode);
         renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -580,8 +639,7 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         if (GL_CheckError("glGenTexures()", renderer) < 0) {
             return -1;
         }
-        renderdata->glActiveTexture(GL_TEXTURE1);
-        renderdata->glBindTexture(data->texture_type, data->texture_u);
+        GLES2_SelectTexture(renderdata, 1, data->texture_type, data->texture_u);
         renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_MIN_FILTER, scaleMode);
         renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_MAG_FILTER, scaleMode);
         renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -597,8 +655,7 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         if (GL_CheckError("glGenTexures()", renderer) < 0) {
             return -1;
         }
-        renderdata->glActiveTexture(GL_TEXTURE1);
-        renderdata->glBindTexture(data->texture_type, data->texture_u);
+        GLES2_SelectTexture(renderdata, 1, data->texture_type, data->texture_u);
         renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_MIN_FILTER, scaleMode);
         renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_MAG_FILTER, scaleMode);
         renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -614,8 +671,7 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         return -1;
     }
     texture->driverdata = data;
-    renderdata->glActiveTexture(GL_TEXTURE0);
-    renderdata->glBindTexture(data->texture_type, data->texture);
+    GLES2_SelectTexture(renderdata, 0, data->texture_type, data->texture);
     renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_MIN_FILTER, scaleMode);
     renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_MAG_FILTER, scaleMode);
     renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -681,7 +737,7 @@ GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
         return 0;
 
     /* Create a texture subimage with the supplied data */
-    data->glBindTexture(tdata->texture_type, tdata->texture);
+    GLES2_SelectTexture(data, 0, tdata->texture_type, tdata->texture);
     GLES2_TexSubImage2D(data, tdata->texture_type,
                     rect->x,
                     rect->y,
@@ -695,9 +751,9 @@ GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
         /* Skip to the correct offset into the next texture */
         pixels = (const void*)((const Uint8*)pixels + rect->h * pitch);
         if (texture->format == SDL_PIXELFORMAT_YV12) {
-            data->glBindTexture(tdata->texture_type, tdata->texture_v);
+            GLES2_SelectTexture(data, 2, tdata->texture_type, tdata->texture_v);
         } else {
-            data->glBindTexture(tdata->texture_type, tdata->texture_u);
+            GLES2_SelectTexture(data, 1, tdata->texture_type, tdata->texture_u);
         }
         GLES2_TexSubImage2D(data, tdata->texture_type,
                 rect->x / 2,
@@ -711,9 +767,9 @@ GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
         /* Skip to the correct offset into the next texture */
         pixels = (const void*)((const Uint8*)pixels + (rect->h * pitch)/4);
         if (texture->format == SDL_PIXELFORMAT_YV12) {
-            data->glBindTexture(tdata->texture_type, tdata->texture_u);
+            GLES2_SelectTexture(data, 1, tdata->texture_type, tdata->texture_u);
         } else {
-            data->glBindTexture(tdata->texture_type, tdata->texture_v);
+            GLES2_SelectTexture(data, 2, tdata->texture_type, tdata->texture_v);
         }
         GLES2_TexSubImage2D(data, tdata->texture_type,
                 rect->x / 2,
@@ -728,7 +784,7 @@ GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
     if (tdata->nv12) {
         /* Skip to the correct offset into the next texture */
         pixels = (const void*)((const Uint8*)pixels + rect->h * pitch);
-        data->glBindTexture(tdata->texture_type, tdata->texture_u);
+        GLES2_SelectTexture(data, 1, tdata->texture_type, tdata->texture_u);
         GLES2_TexSubImage2D(data, tdata->texture_type,
                 rect->x / 2,
                 rect->y / 2,
@@ -758,7 +814,7 @@ GLES2_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
     if (rect->w <= 0 || rect->h <= 0)
         return 0;
 
-    data->glBindTexture(tdata->texture_type, tdata->texture_v);
+    GLES2_SelectTexture(data, 2, tdata->texture_type, tdata->texture_v);
     GLES2_TexSubImage2D(data, tdata->texture_type,
                     rect->x / 2,
                     rect->y / 2,
@@ -768,7 +824,7 @@ GLES2_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
                     tdata->pixel_type,
                     Vplane, Vpitch, 1);
 
-    data->glBindTexture(tdata->texture_type, tdata->texture_u);
+    GLES2_SelectTexture(data, 1, tdata->texture_type, tdata->texture_u);
     GLES2_TexSubImage2D(data, tdata->texture_type,
                     rect->x / 2,
                     rect->y / 2,
@@ -778,7 +834,7 @@ GLES2_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
                     tdata->pixel_type,
                     Uplane, Upitch, 1);
 
-    data->glBindTexture(tdata->texture_type, tdata->texture);
+    GLES2_SelectTexture(data, 0, tdata->texture_type, tdata->texture);
     GLES2_TexSubImage2D(data, tdata->texture_type,
                     rect->x,
                     rect->y,
@@ -854,6 +910,15 @@ GLES2_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture)
     /* Destroy the texture */
     if (tdata)
     {
+        int unit;
+
+        /* Deleting a texture unbinds it, and its name may be reused */
+        for (unit = 0; unit < (int)SDL_arraysize(data->current.textures); ++unit) {
+            GLuint bound = data->current.textures[unit];
+            if (bound == tdata->texture || bound == tdata->texture_u || bound == tdata->texture_v) {
+                data->current.textures[unit] = 0;
+            }
+        }
         data->glDeleteTextures(1, &tdata->texture);
         if (tdata->texture_v) {
             data->glDeleteTextures(1, &tdata->texture_v);
@@ -967,6 +1032,8 @@ GLES2_CacheProgram(SDL_Renderer *renderer, GLES2_ShaderCacheEntry *vertex,
     data->glUniformMatrix4fv(entry->uniform_locations[GLES2_UNIFORM_PROJECTION], 1, GL_FALSE, (GLfloat *)entry->projection);
     data->glUniform4f(entry->uniform_locations[GLES2_UNIFORM_MODULATION], 1.0f, 1.0f, 1.0f, 1.0f);
     data->glUniform4f(entry->uniform_locations[GLES2_UNIFORM_COLOR], 1.0f, 1.0f, 1.0f, 1.0f);
+    ++data->stats.programs;
+    data->stats.uniforms += 6;
 
     /* Cache the linked program */
     if (data->program_cache.head)
@@ -1137,6 +1204,11 @@ GLES2_SelectProgram(SDL_Renderer *renderer, GLES2_ImageSource source, SDL_BlendM
     GLES2_ShaderType vtype, ftype;
     GLES2_ProgramCacheEntry *program;
 
+    /* Skip the shader lookup if this is the same selection as last time */
+    if (data->current_program &&
+        data->current.source == source && data->current.shaderBlendMode == blendMode)
+        return 0;
+
     /* Select an appropriate shader pair for the specified modes */
     vtype = GLES2_SHADER_VERTEX_DEFAULT;
     switch (source)
@@ -1180,8 +1252,11 @@ GLES2_SelectProgram(SDL_Renderer *renderer, GLES2_ImageSource source, SDL_BlendM
     /* Check if we need to change programs at all */
     if (data->current_program &&
         data->current_program->vertex_shader == vertex &&
-        data->current_program->fragment_shader == fragment)
+        data->current_program->fragment_shader == fragment) {
+        data->current.source = source;
+        data->current.shaderBlendMode = blendMode;
         return 0;
+    }
 
     /* Generate a matching program */
     program = GLES2_CacheProgram(renderer, vertex, fragment, blendMode);
@@ -1190,9 +1265,12 @@ GLES2_SelectProgram(SDL_Renderer *renderer, GLES2_ImageSource source, SDL_BlendM
 
     /* Select that program in OpenGL */
     data->glUseProgram(program->id);
+    ++data->stats.programs;
 
     /* Set the current program */
     data->current_program = program;
+    data->current.source = source;
+    data->current.shaderBlendMode = blendMode;
 
     /* Activate an orthographic projection */
     if (GLES2_SetOrthographicProjection(renderer) < 0)
@@ -1249,6 +1327,7 @@ GLES2_SetOrthographicProjection(SDL_Renderer *renderer)
     if (SDL_memcmp(data->current_program->projection, projection, sizeof (projection)) != 0) {
         const GLuint locProjection = data->current_program->uniform_locations[GLES2_UNIFORM_PROJECTION];
         data->glUniformMatrix4fv(locProjection, 1, GL_FALSE, (GLfloat *)projection);
+        ++data->stats.uniforms;
         SDL_memcpy(data->current_program->projection, projection, sizeof (projection));
     }
 
@@ -1333,18 +1412,27 @@ GLES2_SetBlendMode(GLES2_DriverContext *data, int blendMode)
         default:
         case SDL_BLENDMODE_NONE:
             data->glDisable(GL_BLEND);
+            ++data->stats.blends;
             break;
         case SDL_BLENDMODE_BLEND:
             data->glEnable(GL_BLEND);
             data->glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            data->stats.blends += 2;
             break;
         case SDL_BLENDMODE_ADD:
             data->glEnable(GL_BLEND);
             data->glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE, GL_ZERO, GL_ONE);
+            data->stats.blends += 2;
             break;
         case SDL_BLENDMODE_MOD:
             data->glEnable(GL_BLEND);
             data->glBlendFuncSeparate(GL_ZERO, GL_SRC_COLOR, GL_ZERO, GL_ONE);
+            data->stats.blends += 2;
+            break;
+        case SDL_BLENDMODE_PREMULTIPLIED:
+            data->glEnable(GL_BLEND);
+            data->glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            data->stats.blends += 2;
             break;
         }
         data->current.blendMode = blendMode;
@@ -1352,16 +1440,35 @@ GLES2_SetBlendMode(GLES2_DriverContext *data, int blendMode)
 }
 
 static void
-GLES2_SetTexCoords(GLES2_DriverContext * data, SDL_bool enabled)
+GLES2_SetAttributes(GLES2_DriverContext * data, Uint32 attribs)
 {
-    if (enabled != data->current.tex_coords) {
-        if (enabled) {
-            data->glEnableVertexAttribArray(GLES2_ATTRIBUTE_TEXCOORD);
-        } else {
-            data->glDisableVertexAttribArray(GLES2_ATTRIBUTE_TEXCOORD);
+    Uint32 changed = (attribs ^ data->current.attribs);
+    GLuint attr;
+
+    for (attr = 0; changed; ++attr, changed >>= 1) {
+        if (changed & 1) {
+            if (attribs & (1 << attr)) {
+                data->glEnableVertexAttribArray(attr);
+            } else {
+                data->glDisableVertexAttribArray(attr);
+            }
+            ++data->stats.attribs;
         }
-        data->current.tex_coords = enabled;
     }
+    data->current.attribs = attribs;
+}
+
+static void
+GLES2_SetAttribPointer(GLES2_DriverContext * data, GLES2_Attribute attr, const void *pointer)
+{
+    /* Client arrays are read at draw time, so the same pointer needn't be set again */
+    if ((data->current.attrib_pointers & (1 << attr)) && data->current.pointers[attr] == pointer) {
+        return;
+    }
+    data->glVertexAttribPointer(attr, attr == GLES2_ATTRIBUTE_ANGLE ? 1 : 2, GL_FLOAT, GL_FALSE, 0, pointer);
+    data->current.attrib_pointers |= (1 << attr);
+    data->current.pointers[attr] = pointer;
+    ++data->stats.attribs;
 }
 
 static int
@@ -1376,7 +1483,7 @@ GLES2_SetDrawingState(SDL_Renderer * renderer)
 
     GLES2_SetBlendMode(data, blendMode);
 
-    GLES2_SetTexCoords(data, SDL_FALSE);
+    GLES2_SetAttributes(data, (1 << GLES2_ATTRIBUTE_POSITION));
 
     /* Activate an appropriate shader and set the projection matrix */
     if (GLES2_SelectProgram(renderer, GLES2_IMAGESOURCE_SOLID, blendMode) < 0) {
@@ -1401,6 +1508,7 @@ GLES2_SetDrawingState(SDL_Renderer * renderer)
     if (!CompareColors(program->color_r, program->color_g, program->color_b, program->color_a, r, g, b, a)) {
         /* Select the color to draw with */
         data->glUniform4f(program->uniform_locations[GLES2_UNIFORM_COLOR], r * inv255f, g * inv255f, b * inv255f, a * inv255f);
+        ++data->stats.uniforms;
         program->color_r = r;
         program->color_g = g;
         program->color_b = b;
@@ -1417,12 +1525,16 @@ GLES2_UpdateVertexBuffer(SDL_Renderer *renderer, GLES2_Attribute attr,
     GLES2_DriverContext *data = (GLES2_DriverContext *)renderer->driverdata;
 
 #if !SDL_GLES2_USE_VBOS
-    data->glVertexAttribPointer(attr, attr == GLES2_ATTRIBUTE_ANGLE ? 1 : 2, GL_FLOAT, GL_FALSE, 0, vertexData);
+    GLES2_SetAttribPointer(data, attr, vertexData);
 #else
     if (!data->vertex_buffers[attr])
         data->glGenBuffers(1, &data->vertex_buffers[attr]);
 
-    data->glBindBuffer(GL_ARRAY_BUFFER, data->vertex_buffers[attr]);
+    if (data->current.vertex_buffer != data->vertex_buffers[attr]) {
+        data->glBindBuffer(GL_ARRAY_BUFFER, data->vertex_buffers[attr]);
+        data->current.vertex_buffer = data->vertex_buffers[attr];
+        ++data->stats.buffers;
+    }
 
     if (data->vertex_buffer_size[attr] < dataSizeInBytes) {
         data->glBufferData(GL_ARRAY_BUFFER, dataSizeInBytes, vertexData, GL_STREAM_DRAW);
@@ -1430,8 +1542,10 @@ GLES2_UpdateVertexBuffer(SDL_Renderer *renderer, GLES2_Attribute attr,
     } else {
         data->glBufferSubData(GL_ARRAY_BUFFER, 0, dataSizeInBytes, vertexData);
     }
+    ++data->stats.buffers;
 
-    data->glVertexAttribPointer(attr, attr == GLES2_ATTRIBUTE_ANGLE ? 1 : 2, GL_FLOAT, GL_FALSE, 0, 0);
+    /* Each attribute has its own buffer, so its pointer only needs setting once */
+    GLES2_SetAttribPointer(data, attr, NULL);
 #endif
 
     return 0;
@@ -1460,6 +1574,7 @@ GLES2_RenderDrawPoints(SDL_Renderer *renderer, const SDL_FPoint *points, int cou
     /*data->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);*/
     GLES2_UpdateVertexBuffer(renderer, GLES2_ATTRIBUTE_POSITION, vertices, count * 2 * sizeof(GLfloat));
     data->glDrawArrays(GL_POINTS, 0, count);
+    ++data->stats.draws;
     SDL_stack_free(vertices);
     return 0;
 }
@@ -1487,11 +1602,13 @@ GLES2_RenderDrawLines(SDL_Renderer *renderer, const SDL_FPoint *points, int coun
     /*data->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);*/
     GLES2_UpdateVertexBuffer(renderer, GLES2_ATTRIBUTE_POSITION, vertices, count * 2 * sizeof(GLfloat));
     data->glDrawArrays(GL_LINE_STRIP, 0, count);
+    ++data->stats.draws;
 
     /* We need to close the endpoint of the line */
     if (count == 2 ||
         points[0].x != points[count-1].x || points[0].y != points[count-1].y) {
         data->glDrawArrays(GL_POINTS, count-1, 1);
+        ++data->stats.draws;
     }
     SDL_stack_free(vertices);
 
@@ -1529,6 +1646,7 @@ GLES2_RenderFillRects(SDL_Renderer *renderer, const SDL_FRect *rects, int count)
         /*data->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);*/
         GLES2_UpdateVertexBuffer(renderer, GLES2_ATTRIBUTE_POSITION, vertices, 8 * sizeof(GLfloat));
         data->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        ++data->stats.draws;
     }
     return GL_CheckError("", renderer);
 }
@@ -1653,21 +1771,12 @@ GLES2_SetupCopy(SDL_Renderer *renderer, SDL_Texture *texture)
 
     /* Select the target texture */
     if (tdata->yuv) {
-        data->glActiveTexture(GL_TEXTURE2);
-        data->glBindTexture(tdata->texture_type, tdata->texture_v);
-
-        data->glActiveTexture(GL_TEXTURE1);
-        data->glBindTexture(tdata->texture_type, tdata->texture_u);
-
-        data->glActiveTexture(GL_TEXTURE0);
+        GLES2_BindTextureUnit(data, 2, tdata->texture_type, tdata->texture_v);
     }
-    if (tdata->nv12) {
-        data->glActiveTexture(GL_TEXTURE1);
-        data->glBindTexture(tdata->texture_type, tdata->texture_u);
-
-        data->glActiveTexture(GL_TEXTURE0);
+    if (tdata->yuv || tdata->nv12) {
+        GLES2_BindTextureUnit(data, 1, tdata->texture_type, tdata->texture_u);
     }
-    data->glBindTexture(tdata->texture_type, tdata->texture);
+    GLES2_BindTextureUnit(data, 0, tdata->texture_type, tdata->texture);
 
     /* Configure color modulation */
     g = texture->g;
@@ -1682,11 +1791,18 @@ GLES2_SetupCopy(SDL_Renderer *renderer, SDL_Texture *texture)
         r = texture->r;
         b = texture->b;
     }
+    if (texture->blendMode == SDL_BLENDMODE_PREMULTIPLIED) {
+        /* The color channels of premultiplied textures scale with the alpha */
+        r = (r * a) / 255;
+        g = (g * a) / 255;
+        b = (b * a) / 255;
+    }
 
     program = data->current_program;
 
     if (!CompareColors(program->modulation_r, program->modulation_g, program->modulation_b, program->modulation_a, r, g, b, a)) {
         data->glUniform4f(program->uniform_locations[GLES2_UNIFORM_MODULATION], r * inv255f, g * inv255f, b * inv255f, a * inv255f);
+        ++data->stats.uniforms;
         program->modulation_r = r;
         program->modulation_g = g;
         program->modulation_b = b;
@@ -1695,8 +1811,6 @@ GLES2_SetupCopy(SDL_Renderer *renderer, SDL_Texture *texture)
 
     /* Configure texture blending */
     GLES2_SetBlendMode(data, blendMode);
-
-    GLES2_SetTexCoords(data, SDL_TRUE);
     return 0;
 }
 
@@ -1714,6 +1828,9 @@ GLES2_RenderCopy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *s
         return -1;
     }
 
+    GLES2_SetAttributes(data, (1 << GLES2_ATTRIBUTE_POSITION) |
+                              (1 << GLES2_ATTRIBUTE_TEXCOORD));
+
     /* Emit the textured quad */
     vertices[0] = dstrect->x;
     vertices[1] = dstrect->y;
@@ -1736,6 +1853,7 @@ GLES2_RenderCopy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *s
     /*data->glVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, texCoords);*/
     GLES2_UpdateVertexBuffer(renderer, GLES2_ATTRIBUTE_TEXCOORD, texCoords, 8 * sizeof(GLfloat));
     data->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    ++data->stats.draws;
 
     return GL_CheckError("", renderer);
 }
@@ -1757,8 +1875,10 @@ GLES2_RenderCopyEx(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
         return -1;
     }
 
-    data->glEnableVertexAttribArray(GLES2_ATTRIBUTE_CENTER);
-    data->glEnableVertexAttribArray(GLES2_ATTRIBUTE_ANGLE);
+    GLES2_SetAttributes(data, (1 << GLES2_ATTRIBUTE_POSITION) |
+                              (1 << GLES2_ATTRIBUTE_TEXCOORD) |
+                              (1 << GLES2_ATTRIBUTE_ANGLE) |
+                              (1 << GLES2_ATTRIBUTE_CENTER));
     fAngle[0] = fAngle[1] = fAngle[2] = fAngle[3] = (GLfloat)(360.0f - angle);
     /* Calculate the center of rotation */
     translate[0] = translate[2] = translate[4] = translate[6] = (center->x + dstrect->x);
@@ -1803,8 +1923,7 @@ GLES2_RenderCopyEx(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
     /*data->glVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, texCoords);*/
     GLES2_UpdateVertexBuffer(renderer, GLES2_ATTRIBUTE_TEXCOORD, texCoords, 8 * sizeof(GLfloat));
     data->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    data->glDisableVertexAttribArray(GLES2_ATTRIBUTE_CENTER);
-    data->glDisableVertexAttribArray(GLES2_ATTRIBUTE_ANGLE);
+    ++data->stats.draws;
 
     return GL_CheckError("", renderer);
 }
@@ -1863,8 +1982,17 @@ GLES2_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
 static void
 GLES2_RenderPresent(SDL_Renderer *renderer)
 {
+    GLES2_DriverContext *data = (GLES2_DriverContext *)renderer->driverdata;
+
     GLES2_ActivateRenderer(renderer);
 
+    SDL_LogDebug(SDL_LOG_CATEGORY_RENDER,
+                 "GLES2 frame: %d draws, %d program, %d uniform, %d texture, %d attribute, %d buffer, %d blend calls",
+                 data->stats.draws, data->stats.programs, data->stats.uniforms,
+                 data->stats.textures, data->stats.attribs, data->stats.buffers,
+                 data->stats.blends);
+    SDL_zero(data->stats);
+
     /* Tell the video driver to swap buffers */
     SDL_GL_SwapWindow(renderer->window);
 }
@@ -1882,7 +2010,7 @@ static int GLES2_BindTexture (SDL_Renderer * renderer, SDL_Texture *texture, flo
     GLES2_TextureData *texturedata = (GLES2_TextureData *)texture->driverdata;
     GLES2_ActivateRenderer(renderer);
 
-    data->glBindTexture(texturedata->texture_type, texturedata->texture);
+    GLES2_SelectTexture(data, 0, texturedata->texture_type, texturedata->texture);
 
     if(texw) *texw = 1.0;
     if(texh) *texh = 1.0;
@@ -1896,7 +2024,9 @@ static int GLES2_UnbindTexture (SDL_Renderer * renderer, SDL_Texture *texture)
     GLES2_TextureData *texturedata = (GLES2_TextureData *)texture->driverdata;
     GLES2_ActivateRenderer(renderer);
 
+    GLES2_ActiveTexture(data, 0);
     data->glBindTexture(texturedata->texture_type, 0);
+    data->current.textures[0] = 0;
 
     return 0;
 }
@@ -1919,10 +2049,11 @@ GLES2_ResetState(SDL_Renderer *renderer)
         GLES2_ActivateRenderer(renderer);
     }
 
+    GLES2_InvalidateBindings(data);
     data->current.blendMode = -1;
-    data->current.tex_coords = SDL_FALSE;
 
     data->glActiveTexture(GL_TEXTURE0);
+    data->current.active_texture = 0;
     data->glPixelStorei(GL_PACK_ALIGNMENT, 1);
     data->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
@@ -1933,6 +2064,9 @@ GLES2_ResetState(SDL_Renderer *renderer)
 
     data->glEnableVertexAttribArray(GLES2_ATTRIBUTE_POSITION);
     data->glDisableVertexAttribArray(GLES2_ATTRIBUTE_TEXCOORD);
+    data->glDisableVertexAttribArray(GLES2_ATTRIBUTE_ANGLE);
+    data->glDisableVertexAttribArray(GLES2_ATTRIBUTE_CENTER);
+    data->current.attribs = (1 << GLES2_ATTRIBUTE_POSITION);
 
     GL_CheckError("", renderer);
 }
@@ -34,6 +34,7 @@ SDL_BlendPoint_RGB555(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode,
 
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_PREMULTIPLIED:
         DRAW_SETPIXELXY_BLEND_RGB555(x, y);
         break;
     case SDL_BLENDMODE_ADD:
@@ -57,6 +58,7 @@ SDL_BlendPoint_RGB565(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode,
 
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_PREMULTIPLIED:
         DRAW_SETPIXELXY_BLEND_RGB565(x, y);
         break;
     case SDL_BLENDMODE_ADD:
@@ -80,6 +82,7 @@ SDL_BlendPoint_RGB888(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode,
 
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_PREMULTIPLIED:
         DRAW_SETPIXELXY_BLEND_RGB888(x, y);
         break;
     case SDL_BLENDMODE_ADD:
@@ -103,6 +106,7 @@ SDL_BlendPoint_ARGB8888(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode
 
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_PREMULTIPLIED:
         DRAW_SETPIXELXY_BLEND_ARGB8888(x, y);
         break;
     case SDL_BLENDMODE_ADD:
@@ -129,6 +133,7 @@ SDL_BlendPoint_RGB(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode, Uin
     case 2:
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_PREMULTIPLIED:
             DRAW_SETPIXELXY2_BLEND_RGB(x, y);
             break;
         case SDL_BLENDMODE_ADD:
@@ -145,6 +150,7 @@ SDL_BlendPoint_RGB(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode, Uin
     case 4:
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_PREMULTIPLIED:
             DRAW_SETPIXELXY4_BLEND_RGB(x, y);
             break;
         case SDL_BLENDMODE_ADD:
@@ -174,6 +180,7 @@ SDL_BlendPoint_RGBA(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode, Ui
     case 4:
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_PREMULTIPLIED:
             DRAW_SETPIXELXY4_BLEND_RGBA(x, y);
             break;
         case SDL_BLENDMODE_ADD:
@@ -263,6 +270,7 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
     int maxx, maxy;
     int i;
     int x, y;
+    Uint32 color = 0, factor = 0;
     int (*func)(SDL_Surface * dst, int x, int y,
                 SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) = NULL;
     int status = 0;
@@ -326,6 +334,23 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
     miny = dst->clip_rect.y;
     maxy = dst->clip_rect.y + dst->clip_rect.h - 1;
 
+    if ((func == SDL_BlendPoint_RGB888 || func == SDL_BlendPoint_ARGB8888) &&
+        DRAW_GetSpanBlend8888(blendMode, r, g, b, a, &color, &factor)) {
+        /* Blend each point inline as a one pixel span */
+        const Uint32 mask = dst->format->Amask ? 0xFFFFFFFF : 0x00FFFFFF;
+        for (i = 0; i < count; ++i) {
+            x = points[i].x;
+            y = points[i].y;
+
+            if (x < minx || x > maxx || y < miny || y > maxy) {
+                continue;
+            }
+            DRAW_BlendSpan8888((Uint32 *)((Uint8 *)dst->pixels + y * dst->pitch) + x,
+                               1, color, factor, mask);
+        }
+        return 0;
+    }
+
     for (i = 0; i < count; ++i) {
         x = points[i].x;
         y = points[i].y;
@@ -286,6 +286,155 @@ do { \
 #define DRAW_SETPIXELXY4_MOD_RGBA(x, y) \
     DRAW_SETPIXELXY(x, y, Uint32, 4, DRAW_SETPIXEL_MOD_RGBA)
 
+/*
+ * Define span functions, used for runs of pixels in a single row
+ */
+
+/* Shallow lines are drawn as spans when the runs average at least this long */
+#define DRAW_SPAN_MIN_RUN   4
+
+SDL_FORCE_INLINE void
+DRAW_FillSpan2(Uint16 *pixel, Uint32 color, int length)
+{
+#ifdef __SSE2__
+    if (length >= 16 && SDL_HasSSE2()) {
+        const __m128i c128 = _mm_set1_epi16((short)color);
+        while (length >= 8) {
+            _mm_storeu_si128((__m128i *)pixel, c128);
+            pixel += 8;
+            length -= 8;
+        }
+    }
+#endif
+    while (length--) {
+        *pixel++ = (Uint16)color;
+    }
+}
+
+SDL_FORCE_INLINE void
+DRAW_FillSpan4(Uint32 *pixel, Uint32 color, int length)
+{
+#ifdef __SSE2__
+    if (length >= 8 && SDL_HasSSE2()) {
+        const __m128i c128 = _mm_set1_epi32((int)color);
+        while (length >= 4) {
+            _mm_storeu_si128((__m128i *)pixel, c128);
+            pixel += 4;
+            length -= 4;
+        }
+    }
+#endif
+    while (length--) {
+        *pixel++ = color;
+    }
+}
+
+/* Each 8-bit channel of the pixels becomes (pixel * factor) / 255 + color,
+   saturated, with the result masked.  This covers every blend mode on
+   ARGB8888 and RGB888, see DRAW_GetSpanBlend8888() */
+SDL_FORCE_INLINE void
+DRAW_BlendSpan8888(Uint32 *pixel, int length,
+                   Uint32 color, Uint32 factor, Uint32 mask)
+{
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i c128 = _mm_set1_epi32((int)color);
+        const __m128i m128 = _mm_set1_epi32((int)mask);
+        const __m128i f128 = _mm_unpacklo_epi8(_mm_set1_epi32((int)factor), zero);
+        while (length >= 4) {
+            __m128i p = _mm_loadu_si128((const __m128i *)pixel);
+            __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), f128);
+            __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), f128);
+            /* (v + 1 + (v >> 8)) >> 8 is exactly v / 255 for these products */
+            lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, one), _mm_srli_epi16(lo, 8)), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, one), _mm_srli_epi16(hi, 8)), 8);
+            p = _mm_adds_epu8(_mm_packus_epi16(lo, hi), c128);
+            _mm_storeu_si128((__m128i *)pixel, _mm_and_si128(p, m128));
+            pixel += 4;
+            length -= 4;
+        }
+        while (length--) {
+            __m128i p = _mm_cvtsi32_si128((int)*pixel);
+            __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), f128);
+            lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, one), _mm_srli_epi16(lo, 8)), 8);
+            p = _mm_adds_epu8(_mm_packus_epi16(lo, zero), c128);
+            *pixel++ = (Uint32)_mm_cvtsi128_si32(_mm_and_si128(p, m128));
+        }
+        return;
+    }
+#endif
+    while (length--) {
+        Uint32 p = *pixel, result = 0;
+        int shift;
+        for (shift = 0; shift < 32; shift += 8) {
+            unsigned v = DRAW_MUL((p >> shift) & 0xFF, (factor >> shift) & 0xFF) +
+                         ((color >> shift) & 0xFF);
+            if (v > 0xFF) {
+                v = 0xFF;
+            }
+            result |= (v << shift);
+        }
+        *pixel++ = (result & mask);
+    }
+}
+
+/* Work out the span parameters for drawing with a blend mode, where r, g, b
+   and a are the color as the DRAW_SETPIXEL_* operators expect it.  Returns
+   SDL_FALSE for premultiplied colors brighter than their alpha, which the
+   operators don't clamp. */
+SDL_FORCE_INLINE SDL_bool
+DRAW_GetSpanBlend8888(SDL_BlendMode blendMode,
+                      unsigned r, unsigned g, unsigned b, unsigned a,
+                      Uint32 *color, Uint32 *factor)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_PREMULTIPLIED:
+        if (r > a || g > a || b > a) {
+            return SDL_FALSE;
+        }
+        *color = (a << 24) | (r << 16) | (g << 8) | b;
+        *factor = (a ^ 0xFF) * 0x01010101;
+        break;
+    case SDL_BLENDMODE_ADD:
+        *color = (r << 16) | (g << 8) | b;
+        *factor = 0xFFFFFFFF;
+        break;
+    case SDL_BLENDMODE_MOD:
+        *color = 0;
+        *factor = 0xFF000000 | (r << 16) | (g << 8) | b;
+        break;
+    default:
+        *color = (a << 24) | (r << 16) | (g << 8) | b;
+        *factor = 0;
+        break;
+    }
+    return SDL_TRUE;
+}
+
+#define DRAW_BLENDSPAN_RGB888(pixel, length) \
+    DRAW_BlendSpan8888(pixel, length, spancolor, spanfactor, 0x00FFFFFF)
+
+#define DRAW_BLENDSPAN_ARGB8888(pixel, length) \
+    DRAW_BlendSpan8888(pixel, length, spancolor, spanfactor, 0xFFFFFFFF)
+
+/* Returns SDL_TRUE if none of the points need clipping */
+SDL_FORCE_INLINE SDL_bool
+DRAW_PointsInClip(const SDL_Surface * dst, const SDL_Point * points, int count)
+{
+    SDL_Rect bounds;
+
+    if (!SDL_EnclosePoints(points, count, NULL, &bounds)) {
+        return SDL_TRUE;
+    }
+    return (bounds.x >= dst->clip_rect.x && bounds.y >= dst->clip_rect.y &&
+            bounds.x + bounds.w <= dst->clip_rect.x + dst->clip_rect.w &&
+            bounds.y + bounds.h <= dst->clip_rect.y + dst->clip_rect.h) ?
+            SDL_TRUE : SDL_FALSE;
+}
+
 /*
  * Define line drawing macro
  */
@@ -314,6 +463,25 @@ do { \
     } \
 }
 
+/* Horizontal line, drawn as one span */
+#define HSPAN(type, span_op, draw_end) \
+{ \
+    int length; \
+    int pitch = (dst->pitch / dst->format->BytesPerPixel); \
+    type *pixel; \
+    if (x1 <= x2) { \
+        pixel = (type *)dst->pixels + y1 * pitch + x1; \
+        length = draw_end ? (x2-x1+1) : (x2-x1); \
+    } else { \
+        pixel = (type *)dst->pixels + y1 * pitch + x2; \
+        if (!draw_end) { \
+            ++pixel; \
+        } \
+        length = draw_end ? (x1-x2+1) : (x1-x2); \
+    } \
+    span_op(pixel, length); \
+}
+
 /* Vertical line */
 #define VLINE(type, op, draw_end) \
 { \
@@ -431,6 +599,49 @@ do { \
     } \
 }
 
+/* Bresenham's line algorithm for X-major lines, drawing each row's run of
+   pixels as a span.  This plots the same pixels as BLINE. */
+#define BLINE_SPANS(x1, y1, x2, y2, type, span_op, draw_end) \
+{ \
+    int i, deltax, deltay, numpixels; \
+    int d, dinc1, dinc2; \
+    int x, xinc, y, yinc, run; \
+ \
+    deltax = ABS(x2 - x1); \
+    deltay = ABS(y2 - y1); \
+    numpixels = deltax + 1; \
+    d = (2 * deltay) - deltax; \
+    dinc1 = deltay * 2; \
+    dinc2 = (deltay - deltax) * 2; \
+    xinc = (x1 > x2) ? -1 : 1; \
+    yinc = (y1 > y2) ? -1 : 1; \
+ \
+    x = x1; \
+    y = y1; \
+    run = 0; \
+ \
+    if (!draw_end) { \
+        --numpixels; \
+    } \
+    for (i = 0; i < numpixels; ++i) { \
+        ++run; \
+        if (d < 0) { \
+            d += dinc1; \
+        } else { \
+            span_op((type *)((Uint8 *)dst->pixels + y * dst->pitch) + \
+                    (xinc > 0 ? x - run + 1 : x), run); \
+            run = 0; \
+            d += dinc2; \
+            y += yinc; \
+        } \
+        x += xinc; \
+    } \
+    if (run) { \
+        span_op((type *)((Uint8 *)dst->pixels + y * dst->pitch) + \
+                (xinc > 0 ? x - run : x + 1), run); \
+    } \
+}
+
 /* Xiaolin Wu's line algorithm, based on Michael Abrash's implementation */
 #define WULINE(x1, y1, x2, y2, opaque_op, blend_op, draw_end) \
 { \
@@ -543,9 +754,13 @@ do { \
 #ifdef AA_LINES
 #define AALINE(x1, y1, x2, y2, opaque_op, blend_op, draw_end) \
             WULINE(x1, y1, x2, y2, opaque_op, blend_op, draw_end)
+/* Antialiased lines are blended pixel by pixel */
+#define SPANLINE_OK(x1, y1, x2, y2) SDL_FALSE
 #else
 #define AALINE(x1, y1, x2, y2, opaque_op, blend_op, draw_end) \
             BLINE(x1, y1, x2, y2, opaque_op, draw_end)
+#define SPANLINE_OK(x1, y1, x2, y2) \
+            (ABS(x2 - x1) >= DRAW_SPAN_MIN_RUN * ABS(y2 - y1))
 #endif
 
 /*
@@ -573,4 +788,15 @@ do { \
     } \
 } while (0)
 
+/* Fill rect, drawing each row as a span */
+#define FILLSPANS(type, span_op) \
+do { \
+    int height = rect->h; \
+    Uint8 *row = (Uint8 *)dst->pixels + rect->y * dst->pitch; \
+    while (height--) { \
+        span_op((type *)row + rect->x, rect->w); \
+        row += dst->pitch; \
+    } \
+} while (0)
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -27,6 +27,10 @@
 #include "SDL_drawpoint.h"
 
 
+#define DRAW_FILLSPAN1(pixel, length)   SDL_memset(pixel, color, length)
+#define DRAW_FILLSPAN2(pixel, length)   DRAW_FillSpan2(pixel, color, length)
+#define DRAW_FILLSPAN4(pixel, length)   DRAW_FillSpan4(pixel, color, length)
+
 static void
 SDL_DrawLine1(SDL_Surface * dst, int x1, int y1, int x2, int y2, Uint32 color,
               SDL_bool draw_end)
@@ -50,6 +54,8 @@ SDL_DrawLine1(SDL_Surface * dst, int x1, int y1, int x2, int y2, Uint32 color,
         VLINE(Uint8, DRAW_FASTSETPIXEL1, draw_end);
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         DLINE(Uint8, DRAW_FASTSETPIXEL1, draw_end);
+    } else if (SPANLINE_OK(x1, y1, x2, y2)) {
+        BLINE_SPANS(x1, y1, x2, y2, Uint8, DRAW_FILLSPAN1, draw_end);
     } else {
         BLINE(x1, y1, x2, y2, DRAW_FASTSETPIXELXY1, draw_end);
     }
@@ -60,11 +66,13 @@ SDL_DrawLine2(SDL_Surface * dst, int x1, int y1, int x2, int y2, Uint32 color,
               SDL_bool draw_end)
 {
     if (y1 == y2) {
-        HLINE(Uint16, DRAW_FASTSETPIXEL2, draw_end);
+        HSPAN(Uint16, DRAW_FILLSPAN2, draw_end);
     } else if (x1 == x2) {
         VLINE(Uint16, DRAW_FASTSETPIXEL2, draw_end);
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         DLINE(Uint16, DRAW_FASTSETPIXEL2, draw_end);
+    } else if (SPANLINE_OK(x1, y1, x2, y2)) {
+        BLINE_SPANS(x1, y1, x2, y2, Uint16, DRAW_FILLSPAN2, draw_end);
     } else {
         Uint8 _r, _g, _b, _a;
         const SDL_PixelFormat * fmt = dst->format;
@@ -90,11 +98,13 @@ SDL_DrawLine4(SDL_Surface * dst, int x1, int y1, int x2, int y2, Uint32 color,
               SDL_bool draw_end)
 {
     if (y1 == y2) {
-        HLINE(Uint32, DRAW_FASTSETPIXEL4, draw_end);
+        HSPAN(Uint32, DRAW_FILLSPAN4, draw_end);
     } else if (x1 == x2) {
         VLINE(Uint32, DRAW_FASTSETPIXEL4, draw_end);
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         DLINE(Uint32, DRAW_FASTSETPIXEL4, draw_end);
+    } else if (SPANLINE_OK(x1, y1, x2, y2)) {
+        BLINE_SPANS(x1, y1, x2, y2, Uint32, DRAW_FILLSPAN4, draw_end);
     } else {
         Uint8 _r, _g, _b, _a;
         const SDL_PixelFormat * fmt = dst->format;
@@ -181,22 +191,30 @@ SDL_DrawLines(SDL_Surface * dst, const SDL_Point * points, int count,
         return SDL_SetError("SDL_DrawLines(): Unsupported surface format");
     }
 
-    for (i = 1; i < count; ++i) {
-        x1 = points[i-1].x;
-        y1 = points[i-1].y;
-        x2 = points[i].x;
-        y2 = points[i].y;
-
-        /* Perform clipping */
-        /* FIXME: We don't actually want to clip, as it may change line slope */
-        if (!SDL_IntersectRectAndLine(&dst->clip_rect, &x1, &y1, &x2, &y2)) {
-            continue;
+    if (DRAW_PointsInClip(dst, points, count)) {
+        /* The whole polyline is visible, no segment needs clipping */
+        for (i = 1; i < count; ++i) {
+            func(dst, points[i-1].x, points[i-1].y, points[i].x, points[i].y,
+                 color, SDL_FALSE);
         }
+    } else {
+        for (i = 1; i < count; ++i) {
+            x1 = points[i-1].x;
+            y1 = points[i-1].y;
+            x2 = points[i].x;
+            y2 = points[i].y;
+
+            /* Perform clipping */
+            /* FIXME: We don't actually want to clip, as it may change line slope */
+            if (!SDL_IntersectRectAndLine(&dst->clip_rect, &x1, &y1, &x2, &y2)) {
+                continue;
+            }
 
-        /* Draw the end if it was clipped */
-        draw_end = (x2 != points[i].x || y2 != points[i].y);
+            /* Draw the end if it was clipped */
+            draw_end = (x2 != points[i].x || y2 != points[i].y);
 
-        func(dst, x1, y1, x2, y2, color, draw_end);
+            func(dst, x1, y1, x2, y2, color, draw_end);
+        }
     }
     if (points[0].x != points[count-1].x || points[0].y != points[count-1].y) {
         SDL_DrawPoint(dst, points[count-1].x, points[count-1].y, color);
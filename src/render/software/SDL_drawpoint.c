@@ -25,6 +25,17 @@
 #include "SDL_draw.h"
 #include "SDL_drawpoint.h"
 
+/* Draw all the points inside the clip rectangle */
+#define DRAW_POINTS(setpixel) \
+    for (i = 0; i < count; ++i) { \
+        x = points[i].x; \
+        y = points[i].y; \
+        if (x < minx || x > maxx || y < miny || y > maxy) { \
+            continue; \
+        } \
+        setpixel(x, y); \
+    }
+
 
 int
 SDL_DrawPoint(SDL_Surface * dst, int x, int y, Uint32 color)
@@ -84,27 +95,18 @@ SDL_DrawPoints(SDL_Surface * dst, const SDL_Point * points, int count,
     miny = dst->clip_rect.y;
     maxy = dst->clip_rect.y + dst->clip_rect.h - 1;
 
-    for (i = 0; i < count; ++i) {
-        x = points[i].x;
-        y = points[i].y;
-
-        if (x < minx || x > maxx || y < miny || y > maxy) {
-            continue;
-        }
-
-        switch (dst->format->BytesPerPixel) {
-        case 1:
-            DRAW_FASTSETPIXELXY1(x, y);
-            break;
-        case 2:
-            DRAW_FASTSETPIXELXY2(x, y);
-            break;
-        case 3:
-            return SDL_Unsupported();
-        case 4:
-            DRAW_FASTSETPIXELXY4(x, y);
-            break;
-        }
+    switch (dst->format->BytesPerPixel) {
+    case 1:
+        DRAW_POINTS(DRAW_FASTSETPIXELXY1);
+        break;
+    case 2:
+        DRAW_POINTS(DRAW_FASTSETPIXELXY2);
+        break;
+    case 3:
+        return SDL_Unsupported();
+    case 4:
+        DRAW_POINTS(DRAW_FASTSETPIXELXY4);
+        break;
     }
     return 0;
 }
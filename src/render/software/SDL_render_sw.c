@@ -61,6 +61,8 @@ static int SW_RenderDrawPoints(SDL_Renderer * renderer,
                                const SDL_FPoint * points, int count);
 static int SW_RenderDrawLines(SDL_Renderer * renderer,
                               const SDL_FPoint * points, int count);
+static int SW_RenderDrawRects(SDL_Renderer * renderer,
+                              const SDL_FRect * rects, int count);
 static int SW_RenderFillRects(SDL_Renderer * renderer,
                               const SDL_FRect * rects, int count);
 static int SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
@@ -95,10 +97,37 @@ SDL_RenderDriver SW_RenderDriver = {
      0}
 };
 
+/* A copy of a texture with its color and alpha modulation applied */
+typedef struct SW_ModulatedSurface
+{
+    SDL_Surface *texture;
+    Uint8 r, g, b, a;
+    SDL_Surface *surface;
+    size_t size;
+    Uint32 last_used;
+    struct SW_ModulatedSurface *next;
+} SW_ModulatedSurface;
+
+/* How many modulated copies of a single texture are kept */
+#define SW_MODULATED_PER_TEXTURE 4
+
+/* How many rectangles of the window surface are pushed to the screen */
+#define SW_MAX_DAMAGE_RECTS 16
+
+/* How many rect outlines are filled together */
+#define SW_OUTLINE_BATCH 64
+
 typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+    SDLgfx_RotateCache *rotate_cache;
+    SW_ModulatedSurface *modulated;
+    size_t modulated_size;
+    size_t modulated_max;
+    Uint32 modulated_clock;
+    SDL_Region *damage;
+    SDL_bool full_damage;
 } SW_RenderData;
 
 
@@ -122,11 +151,43 @@ SW_ActivateRenderer(SDL_Renderer * renderer)
     return data->surface;
 }
 
+/* Remember which part of the window surface a draw call touched, so
+   SW_RenderPresent only pushes that to the screen.
+ */
+static void
+SW_AddDamage(SW_RenderData * data, const SDL_Rect * rect)
+{
+    SDL_Surface *surface = data->surface;
+    SDL_Rect clipped;
+    int count;
+
+    if (!data->damage || data->full_damage || surface != data->window) {
+        return;
+    }
+    if (!rect) {
+        data->full_damage = SDL_TRUE;
+        return;
+    }
+    if (SDL_IntersectRect(rect, &surface->clip_rect, &clipped)) {
+        if (SDL_AddRectToRegion(data->damage, &clipped) < 0) {
+            data->full_damage = SDL_TRUE;
+            return;
+        }
+        /* Keep the region small so adding to it stays cheap */
+        SDL_GetRegionRects(data->damage, &count);
+        if (count > 4 * SW_MAX_DAMAGE_RECTS &&
+            SDL_SimplifyRegion(data->damage, SW_MAX_DAMAGE_RECTS) < 0) {
+            data->full_damage = SDL_TRUE;
+        }
+    }
+}
+
 SDL_Renderer *
 SW_CreateRendererForSurface(SDL_Surface * surface)
 {
     SDL_Renderer *renderer;
     SW_RenderData *data;
+    const char *hint;
 
     if (!surface) {
         SDL_SetError("Can't create renderer for NULL surface");
@@ -148,6 +209,11 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     data->surface = surface;
     data->window = surface;
 
+    hint = SDL_GetHint(SDL_HINT_RENDER_SOFTWARE_MODULATE_CACHE);
+    if (hint && SDL_atoi(hint) > 0) {
+        data->modulated_max = (size_t) SDL_atoi(hint) * 1024;
+    }
+
     renderer->WindowEvent = SW_WindowEvent;
     renderer->GetOutputSize = SW_GetOutputSize;
     renderer->CreateTexture = SW_CreateTexture;
@@ -163,6 +229,7 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     renderer->RenderClear = SW_RenderClear;
     renderer->RenderDrawPoints = SW_RenderDrawPoints;
     renderer->RenderDrawLines = SW_RenderDrawLines;
+    renderer->RenderDrawRects = SW_RenderDrawRects;
     renderer->RenderFillRects = SW_RenderFillRects;
     renderer->RenderCopy = SW_RenderCopy;
     renderer->RenderCopyEx = SW_RenderCopyEx;
@@ -181,13 +248,22 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
 SDL_Renderer *
 SW_CreateRenderer(SDL_Window * window, Uint32 flags)
 {
+    SDL_Renderer *renderer;
     SDL_Surface *surface;
 
     surface = SDL_GetWindowSurface(window);
     if (!surface) {
         return NULL;
     }
-    return SW_CreateRendererForSurface(surface);
+    renderer = SW_CreateRendererForSurface(surface);
+    if (renderer) {
+        SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+
+        /* Without a damage region every present updates the whole window */
+        data->damage = SDL_CreateRegion();
+        data->full_damage = SDL_TRUE;
+    }
+    return renderer;
 }
 
 static void
@@ -198,6 +274,9 @@ SW_WindowEvent(SDL_Renderer * renderer, const SDL_WindowEvent *event)
     if (event->event == SDL_WINDOWEVENT_SIZE_CHANGED) {
         data->surface = NULL;
         data->window = NULL;
+        data->full_damage = SDL_TRUE;
+    } else if (event->event == SDL_WINDOWEVENT_EXPOSED) {
+        data->full_damage = SDL_TRUE;
     }
 }
 
@@ -220,6 +299,181 @@ SW_GetOutputSize(SDL_Renderer * renderer, int *w, int *h)
     }
 }
 
+static int
+GetScaleQuality(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_RENDER_SCALE_QUALITY);
+
+    if (!hint || *hint == '0' || SDL_strcasecmp(hint, "nearest") == 0) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+/* Drop the least recently used modulated copy of a texture, or of any
+   texture if it's NULL */
+static void
+SW_DropModulated(SW_RenderData * data, SDL_Surface * texture)
+{
+    SW_ModulatedSurface *entry, **prev, **oldest = NULL;
+
+    for (prev = &data->modulated; *prev; prev = &(*prev)->next) {
+        if (!texture || (*prev)->texture == texture) {
+            if (!oldest || (*prev)->last_used < (*oldest)->last_used) {
+                oldest = prev;
+            }
+        }
+    }
+    if (oldest) {
+        entry = *oldest;
+        *oldest = entry->next;
+        data->modulated_size -= entry->size;
+        SDL_FreeSurface(entry->surface);
+        SDL_free(entry);
+    }
+}
+
+/* Drop all modulated copies of a texture, or of every texture if it's NULL */
+static void
+SW_FreeModulated(SW_RenderData * data, SDL_Surface * texture)
+{
+    SW_ModulatedSurface *entry, **prev = &data->modulated;
+
+    while (*prev) {
+        entry = *prev;
+        if (!texture || entry->texture == texture) {
+            *prev = entry->next;
+            data->modulated_size -= entry->size;
+            SDL_FreeSurface(entry->surface);
+            SDL_free(entry);
+        } else {
+            prev = &entry->next;
+        }
+    }
+}
+
+/* Apply a color and alpha modulation the same way the blitters do */
+static int
+SW_ModulatePixels(SDL_Surface * src, SDL_Surface * dst,
+                  Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    const SDL_PixelFormat *fmt = src->format;
+    const Uint32 other = ~(fmt->Rmask | fmt->Gmask | fmt->Bmask | fmt->Amask);
+    const Uint8 *srcrow;
+    Uint8 *dstrow;
+    int x, y;
+
+    if (SDL_MUSTLOCK(src)) {
+        if (SDL_LockSurface(src) < 0) {
+            return -1;
+        }
+    }
+    srcrow = (const Uint8 *) src->pixels;
+    dstrow = (Uint8 *) dst->pixels;
+    for (y = 0; y < src->h; ++y) {
+        const Uint32 *srcp = (const Uint32 *) srcrow;
+        Uint32 *dstp = (Uint32 *) dstrow;
+        for (x = 0; x < src->w; ++x) {
+            const Uint32 pixel = srcp[x];
+            const Uint32 R = (((pixel & fmt->Rmask) >> fmt->Rshift) * r) / 255;
+            const Uint32 G = (((pixel & fmt->Gmask) >> fmt->Gshift) * g) / 255;
+            const Uint32 B = (((pixel & fmt->Bmask) >> fmt->Bshift) * b) / 255;
+            const Uint32 A = (((pixel & fmt->Amask) >> fmt->Ashift) * a) / 255;
+            dstp[x] = (R << fmt->Rshift) | (G << fmt->Gshift) |
+                      (B << fmt->Bshift) | ((A << fmt->Ashift) & fmt->Amask) |
+                      (pixel & other);
+        }
+        srcrow += src->pitch;
+        dstrow += dst->pitch;
+    }
+    if (SDL_MUSTLOCK(src)) {
+        SDL_UnlockSurface(src);
+    }
+    return 0;
+}
+
+/* Find or make a copy of the texture with its current modulation applied,
+   or return NULL if the texture should be drawn with modulation instead */
+static SDL_Surface *
+SW_GetModulatedSurface(SW_RenderData * data, SDL_Texture * texture)
+{
+    SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+    SDL_Surface *surface;
+    SW_ModulatedSurface *entry;
+    SDL_ScaleMode scaleMode;
+    size_t size;
+    int count = 0;
+
+    if (src->format->BytesPerPixel != 4 ||
+        texture->access == SDL_TEXTUREACCESS_TARGET ||
+        texture->blendMode == SDL_BLENDMODE_PREMULTIPLIED ||
+        (src->map->info.flags & SDL_COPY_COLORKEY)) {
+        return NULL;
+    }
+
+    for (entry = data->modulated; entry; entry = entry->next) {
+        if (entry->texture == src) {
+            if (entry->r == texture->r && entry->g == texture->g &&
+                entry->b == texture->b && entry->a == texture->a) {
+                entry->last_used = ++data->modulated_clock;
+                SDL_SetSurfaceBlendMode(entry->surface, texture->blendMode);
+                return entry->surface;
+            }
+            ++count;
+        }
+    }
+
+    size = (size_t) src->pitch * src->h;
+    if (size > data->modulated_max) {
+        return NULL;
+    }
+    while (count-- >= SW_MODULATED_PER_TEXTURE) {
+        SW_DropModulated(data, src);
+    }
+    while (data->modulated_size + size > data->modulated_max) {
+        SW_DropModulated(data, NULL);
+    }
+
+    surface = SDL_CreateRGBSurface(0, src->w, src->h,
+                                   src->format->BitsPerPixel,
+                                   src->format->Rmask, src->format->Gmask,
+                                   src->format->Bmask, src->format->Amask);
+    if (!surface) {
+        return NULL;
+    }
+    entry = (SW_ModulatedSurface *) SDL_calloc(1, sizeof(*entry));
+    if (!entry || SW_ModulatePixels(src, surface, texture->r, texture->g,
+                                    texture->b, texture->a) < 0) {
+        SDL_free(entry);
+        SDL_FreeSurface(surface);
+        return NULL;
+    }
+    if (!src->format->Amask) {
+        /* There is no alpha channel to carry the alpha modulation */
+        SDL_SetSurfaceAlphaMod(surface, texture->a);
+    }
+    SDL_GetSurfaceScaleMode(src, &scaleMode);
+    SDL_SetSurfaceScaleMode(surface, scaleMode);
+    SDL_SetSurfaceBlendMode(surface, texture->blendMode);
+    if (texture->access == SDL_TEXTUREACCESS_STATIC) {
+        SDL_SetSurfaceRLE(surface, 1);
+    }
+
+    entry->texture = src;
+    entry->r = texture->r;
+    entry->g = texture->g;
+    entry->b = texture->b;
+    entry->a = texture->a;
+    entry->surface = surface;
+    entry->size = size;
+    entry->last_used = ++data->modulated_clock;
+    entry->next = data->modulated;
+    data->modulated = entry;
+    data->modulated_size += size;
+    return surface;
+}
+
 static int
 SW_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
@@ -238,6 +492,8 @@ SW_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
                            texture->b);
     SDL_SetSurfaceAlphaMod(texture->driverdata, texture->a);
     SDL_SetSurfaceBlendMode(texture->driverdata, texture->blendMode);
+    SDL_SetSurfaceScaleMode(texture->driverdata, GetScaleQuality() ?
+                            SDL_SCALEMODE_LINEAR : SDL_SCALEMODE_NEAREST);
 
     if (texture->access == SDL_TEXTUREACCESS_STATIC) {
         SDL_SetSurfaceRLE(texture->driverdata, 1);
@@ -275,6 +531,7 @@ static int
 SW_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                  const SDL_Rect * rect, const void *pixels, int pitch)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
     Uint8 *src, *dst;
     int row;
@@ -294,6 +551,8 @@ SW_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
     }
     if(SDL_MUSTLOCK(surface))
         SDL_UnlockSurface(surface);
+    SDLgfx_invalidateRotateCache(data->rotate_cache, surface);
+    SW_FreeModulated(data, surface);
     return 0;
 }
 
@@ -313,6 +572,10 @@ SW_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 static void
 SW_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+
+    SDLgfx_invalidateRotateCache(data->rotate_cache, (SDL_Surface *) texture->driverdata);
+    SW_FreeModulated(data, (SDL_Surface *) texture->driverdata);
 }
 
 static int
@@ -377,6 +640,7 @@ SW_RenderClear(SDL_Renderer * renderer)
     SDL_SetClipRect(surface, NULL);
     SDL_FillRect(surface, NULL, color);
     SDL_SetClipRect(surface, &clip_rect);
+    SW_AddDamage((SW_RenderData *) renderer->driverdata, NULL);
     return 0;
 }
 
@@ -386,6 +650,7 @@ SW_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
 {
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
     SDL_Point *final_points;
+    SDL_Rect bounds;
     int i, status;
 
     if (!surface) {
@@ -411,6 +676,10 @@ SW_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
         }
     }
 
+    if (SDL_EnclosePoints(final_points, count, NULL, &bounds)) {
+        SW_AddDamage((SW_RenderData *) renderer->driverdata, &bounds);
+    }
+
     /* Draw the points! */
     if (renderer->blendMode == SDL_BLENDMODE_NONE) {
         Uint32 color = SDL_MapRGBA(surface->format,
@@ -435,6 +704,7 @@ SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
 {
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
     SDL_Point *final_points;
+    SDL_Rect bounds;
     int i, status;
 
     if (!surface) {
@@ -460,6 +730,10 @@ SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
         }
     }
 
+    if (SDL_EnclosePoints(final_points, count, NULL, &bounds)) {
+        SW_AddDamage((SW_RenderData *) renderer->driverdata, &bounds);
+    }
+
     /* Draw the lines! */
     if (renderer->blendMode == SDL_BLENDMODE_NONE) {
         Uint32 color = SDL_MapRGBA(surface->format,
@@ -478,11 +752,90 @@ SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
     return status;
 }
 
+static int
+SW_RenderDrawRects(SDL_Renderer * renderer, const SDL_FRect * rects,
+                   int count)
+{
+    SDL_FRect strips[SW_OUTLINE_BATCH * 4];
+    SDL_FRect *strip = strips;
+    int i, status = 0;
+
+    /* Each outline is filled as up to four non-overlapping strips, so blended
+       outlines touch every pixel once, and many outlines share one fill */
+    for (i = 0; i < count; ++i) {
+        const float x = rects[i].x;
+        const float y = rects[i].y;
+        const float w = rects[i].w;
+        const float h = rects[i].h;
+
+        if (w < 1.0f || h < 1.0f) {
+            /* Draw degenerate outlines as lines, like SDL_RenderDrawRect() */
+            SDL_FPoint points[5];
+
+            points[0].x = x;
+            points[0].y = y;
+            points[1].x = x+w-1;
+            points[1].y = y;
+            points[2].x = x+w-1;
+            points[2].y = y+h-1;
+            points[3].x = x;
+            points[3].y = y+h-1;
+            points[4].x = x;
+            points[4].y = y;
+            if (SW_RenderDrawLines(renderer, points, 5) < 0) {
+                status = -1;
+            }
+            continue;
+        }
+
+        strip->x = x;
+        strip->y = y;
+        strip->w = w;
+        strip->h = 1.0f;
+        ++strip;
+        if (h > 1.0f) {
+            strip->x = x;
+            strip->y = y+h-1;
+            strip->w = w;
+            strip->h = 1.0f;
+            ++strip;
+        }
+        if (h > 2.0f) {
+            strip->x = x;
+            strip->y = y+1;
+            strip->w = 1.0f;
+            strip->h = h-2;
+            ++strip;
+            if (w > 1.0f) {
+                strip->x = x+w-1;
+                strip->y = y+1;
+                strip->w = 1.0f;
+                strip->h = h-2;
+                ++strip;
+            }
+        }
+
+        if (strip - strips > (SW_OUTLINE_BATCH - 1) * 4) {
+            if (SW_RenderFillRects(renderer, strips, (int)(strip - strips)) < 0) {
+                status = -1;
+            }
+            strip = strips;
+        }
+    }
+    if (strip != strips) {
+        if (SW_RenderFillRects(renderer, strips, (int)(strip - strips)) < 0) {
+            status = -1;
+        }
+    }
+    return status;
+}
+
 static int
 SW_RenderFillRects(SDL_Renderer * renderer, const SDL_FRect * rects, int count)
 {
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
     SDL_Rect *final_rects;
+    SDL_Rect bounds;
     int i, status;
 
     if (!surface) {
@@ -512,6 +865,14 @@ SW_RenderFillRects(SDL_Renderer * renderer, const SDL_FRect * rects, int count)
         }
     }
 
+    if (count > 0) {
+        bounds = final_rects[0];
+        for (i = 1; i < count; ++i) {
+            SDL_UnionRect(&bounds, &final_rects[i], &bounds);
+        }
+        SW_AddDamage((SW_RenderData *) renderer->driverdata, &bounds);
+    }
+
     if (renderer->blendMode == SDL_BLENDMODE_NONE) {
         Uint32 color = SDL_MapRGBA(surface->format,
                                    renderer->r, renderer->g, renderer->b,
@@ -532,6 +893,7 @@ static int
 SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
               const SDL_Rect * srcrect, const SDL_FRect * dstrect)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
     SDL_Surface *src = (SDL_Surface *) texture->driverdata;
     SDL_Rect final_rect;
@@ -540,6 +902,14 @@ SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
         return -1;
     }
 
+    if (data->modulated_max &&
+        (texture->r & texture->g & texture->b & texture->a) != 0xFF) {
+        SDL_Surface *modulated = SW_GetModulatedSurface(data, texture);
+        if (modulated) {
+            src = modulated;
+        }
+    }
+
     if (renderer->viewport.x || renderer->viewport.y) {
         final_rect.x = (int)(renderer->viewport.x + dstrect->x);
         final_rect.y = (int)(renderer->viewport.y + dstrect->y);
@@ -550,6 +920,8 @@ SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     final_rect.w = (int)dstrect->w;
     final_rect.h = (int)dstrect->h;
 
+    SW_AddDamage(data, &final_rect);
+
     if ( srcrect->w == final_rect.w && srcrect->h == final_rect.h ) {
         return SDL_BlitSurface(src, srcrect, surface, &final_rect);
     } else {
@@ -557,27 +929,17 @@ SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     }
 }
 
-static int
-GetScaleQuality(void)
-{
-    const char *hint = SDL_GetHint(SDL_HINT_RENDER_SCALE_QUALITY);
-
-    if (!hint || *hint == '0' || SDL_strcasecmp(hint, "nearest") == 0) {
-        return 0;
-    } else {
-        return 1;
-    }
-}
-
 static int
 SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
                 const SDL_Rect * srcrect, const SDL_FRect * dstrect,
                 const double angle, const SDL_FPoint * center, const SDL_RendererFlip flip)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
     SDL_Surface *src = (SDL_Surface *) texture->driverdata;
     SDL_Rect final_rect, tmp_rect;
     SDL_Surface *surface_rotated, *surface_scaled;
+    SDL_ScaleMode scaleMode;
     Uint32 colorkey;
     int retval, dstwidth, dstheight, abscenterx, abscentery;
     double cangle, sangle, px, py, p1x, p1y, p2x, p2y, p3x, p3y, p4x, p4y;
@@ -596,6 +958,30 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     final_rect.w = (int)dstrect->w;
     final_rect.h = (int)dstrect->h;
 
+    /* The rotated bounds aren't worth computing, damage the whole clip */
+    SW_AddDamage(data, &surface->clip_rect);
+
+    /* 32-bit textures are rotated straight into the target */
+    if (src->format->BytesPerPixel == 4) {
+        if (!data->rotate_cache) {
+            data->rotate_cache = SDLgfx_createRotateCache();
+            if (!data->rotate_cache) {
+                return -1;
+            }
+        }
+        if (texture->access == SDL_TEXTUREACCESS_TARGET) {
+            /* Its contents can change without the renderer being told */
+            SDLgfx_invalidateRotateCache(data->rotate_cache, src);
+        }
+        SDL_GetSurfaceScaleMode(src, &scaleMode);
+        return SDLgfx_rotateBlit(src, srcrect, surface, &final_rect, angle,
+                                 center->x, center->y,
+                                 scaleMode == SDL_SCALEMODE_LINEAR,
+                                 (flip & SDL_FLIP_HORIZONTAL) ? 1 : 0,
+                                 (flip & SDL_FLIP_VERTICAL) ? 1 : 0,
+                                 data->rotate_cache);
+    }
+
     surface_scaled = SDL_CreateRGBSurface(SDL_SWSURFACE, final_rect.w, final_rect.h, src->format->BitsPerPixel,
                                           src->format->Rmask, src->format->Gmask,
                                           src->format->Bmask, src->format->Amask );
@@ -647,11 +1033,10 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
                 tmp_rect.h = dstheight;
 
                 retval = SDL_BlitSurface(surface_rotated, NULL, surface, &tmp_rect);
-                SDL_FreeSurface(surface_scaled);
                 SDL_FreeSurface(surface_rotated);
-                return retval;
             }
         }
+        SDL_FreeSurface(surface_scaled);
         return retval;
     }
 
@@ -697,18 +1082,31 @@ SW_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
 static void
 SW_RenderPresent(SDL_Renderer * renderer)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Window *window = renderer->window;
 
-    if (window) {
+    if (!window) {
+        return;
+    }
+
+    if (!data->damage || data->full_damage ||
+        SDL_SimplifyRegion(data->damage, SW_MAX_DAMAGE_RECTS) < 0) {
         SDL_UpdateWindowSurface(window);
+    } else {
+        SDL_UpdateWindowSurfaceRegion(window, data->damage);
     }
+    SDL_ClearRegion(data->damage);
+    data->full_damage = SDL_FALSE;
 }
 
 static void
 SW_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
 
+    SDLgfx_invalidateRotateCache(data->rotate_cache, surface);
+    SW_FreeModulated(data, surface);
     SDL_FreeSurface(surface);
 }
 
@@ -717,6 +1115,11 @@ SW_DestroyRenderer(SDL_Renderer * renderer)
 {
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
 
+    if (data) {
+        SDLgfx_destroyRotateCache(data->rotate_cache);
+        SW_FreeModulated(data, NULL);
+        SDL_FreeRegion(data->damage);
+    }
     SDL_free(data);
     SDL_free(renderer);
 }
@@ -38,7 +38,11 @@ Andreas Schiffler -- aschiffler at ferzkopp dot net
 #include <string.h>
 
 #include "SDL.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_rotate.h"
+#include "../../video/SDL_blit.h"
+#include "../../video/SDL_blit_copy.h"
+#include "../../video/SDL_pixels_c.h"
 
 /* ---- Internally used structures */
 
@@ -499,3 +503,569 @@ SDLgfx_rotateSurface(SDL_Surface * src, double angle, int centerx, int centery,
     */
     return (rz_dst);
 }
+
+
+/* ---- Direct rotation into a destination surface */
+
+/* Rotated blits of 32-bit surfaces map every destination pixel center back
+   into the source and sample it straight into a row buffer, which is then
+   handed to the surface's regular blitter.  Modulation and blending work
+   like any other blit and no rotated copy of the whole image is needed.
+
+   Along a destination row the source position moves by a constant step,
+   so it is stepped in 16.16 fixed point, and only the span of the row that
+   lands inside the source rectangle is sampled.
+
+   The sampled rows are kept in a small cache, so drawing the same part of
+   a surface with the same transform again only repeats the final blit.
+*/
+
+#define ROTATE_CACHE_SIZE 4
+
+/* Larger transforms are sampled a row at a time and not kept around */
+#define ROTATE_CACHE_MAX_PIXELS (512 * 512)
+
+typedef struct
+{
+    /* What the rows were sampled from, and how */
+    SDL_Surface *src;
+    SDL_Rect srcrect;
+    int w, h;
+    double angle;
+    double centerx, centery;
+    int smooth, flipx, flipy;
+    SDL_Rect visible;           /* relative to the destination rectangle */
+    SDL_bool valid;
+    Uint32 last_used;
+
+    /* The first column and number of samples of every visible row */
+    int *spans;
+    int spans_size;
+    Uint32 *pixels;
+    int pixels_size;
+} SDLgfx_RotateCacheEntry;
+
+struct SDLgfx_RotateCache
+{
+    Uint32 clock;
+    SDLgfx_RotateCacheEntry entries[ROTATE_CACHE_SIZE];
+};
+
+/* The rectangle being sampled */
+typedef struct
+{
+    const Uint8 *pixels;
+    int pitch;
+    int w, h;
+} SDLgfx_RotateSource;
+
+typedef void (*SDLgfx_SampleFunc) (const SDLgfx_RotateSource * src, Uint32 * dst,
+                                   int n, Sint32 fx, Sint32 fy, Sint32 dfx, Sint32 dfy);
+
+SDLgfx_RotateCache *
+SDLgfx_createRotateCache(void)
+{
+    SDLgfx_RotateCache *cache = (SDLgfx_RotateCache *) SDL_calloc(1, sizeof(*cache));
+    if (!cache) {
+        SDL_OutOfMemory();
+    }
+    return cache;
+}
+
+void
+SDLgfx_invalidateRotateCache(SDLgfx_RotateCache * cache, SDL_Surface * src)
+{
+    int i;
+
+    if (!cache) {
+        return;
+    }
+    for (i = 0; i < ROTATE_CACHE_SIZE; ++i) {
+        if (!src || cache->entries[i].src == src) {
+            cache->entries[i].valid = SDL_FALSE;
+            cache->entries[i].src = NULL;
+        }
+    }
+}
+
+void
+SDLgfx_destroyRotateCache(SDLgfx_RotateCache * cache)
+{
+    int i;
+
+    if (!cache) {
+        return;
+    }
+    for (i = 0; i < ROTATE_CACHE_SIZE; ++i) {
+        SDL_free(cache->entries[i].spans);
+        SDL_free(cache->entries[i].pixels);
+    }
+    SDL_free(cache);
+}
+
+static SDL_INLINE int
+clamp_index(int i, int len)
+{
+    return (i < 0) ? 0 : ((i >= len) ? len - 1 : i);
+}
+
+static void
+sample_nearest(const SDLgfx_RotateSource * src, Uint32 * dst,
+               int n, Sint32 fx, Sint32 fy, Sint32 dfx, Sint32 dfy)
+{
+    int i;
+
+    for (i = 0; i < n; ++i, fx += dfx, fy += dfy) {
+        const int x = clamp_index(fx >> 16, src->w);
+        const int y = clamp_index(fy >> 16, src->h);
+        dst[i] = *((const Uint32 *) (src->pixels + y * src->pitch) + x);
+    }
+}
+
+/* The pixel before the sample point, and the weight of the one after it */
+static SDL_INLINE int
+linear_index(Sint32 pos, int len, Uint32 * weight)
+{
+    int i;
+
+    pos -= 0x8000;
+    if (pos <= 0) {
+        *weight = 0;
+        return 0;
+    }
+    i = pos >> 16;
+    if (i >= len - 1) {
+        *weight = 0;
+        return len - 1;
+    }
+    *weight = ((Uint32) pos >> 8) & 0xFF;
+    return i;
+}
+
+static SDL_INLINE Uint32
+lerp_pixel(Uint32 a, Uint32 b, Uint32 w)
+{
+    const Uint32 iw = 256 - w;
+    const Uint32 rb = ((a & 0x00FF00FF) * iw + (b & 0x00FF00FF) * w) >> 8;
+    const Uint32 ga = ((a >> 8) & 0x00FF00FF) * iw + ((b >> 8) & 0x00FF00FF) * w;
+
+    return (rb & 0x00FF00FF) | (ga & 0xFF00FF00);
+}
+
+static void
+sample_linear(const SDLgfx_RotateSource * src, Uint32 * dst,
+              int n, Sint32 fx, Sint32 fy, Sint32 dfx, Sint32 dfy)
+{
+    int i;
+
+    for (i = 0; i < n; ++i, fx += dfx, fy += dfy) {
+        Uint32 wx, wy;
+        const int x = linear_index(fx, src->w, &wx);
+        const int y = linear_index(fy, src->h, &wy);
+        const Uint32 *p0 = (const Uint32 *) (src->pixels + y * src->pitch) + x;
+        const Uint32 *p1 = wy ? (const Uint32 *) ((const Uint8 *) p0 + src->pitch) : p0;
+        const int dx = wx ? 1 : 0;
+
+        /* Filter vertically first, the same way the SSE2 version does */
+        dst[i] = lerp_pixel(lerp_pixel(p0[0], p1[0], wy),
+                            lerp_pixel(p0[dx], p1[dx], wy), wx);
+    }
+}
+
+#ifdef __SSE2__
+/* Filter the two columns around a sample vertically, and return them
+   weighted for the horizontal filter */
+static SDL_INLINE __m128i
+linear_columns_SSE2(const SDLgfx_RotateSource * src, Sint32 fx, Sint32 fy)
+{
+    const __m128i zero = _mm_setzero_si128();
+    Uint32 wx, wy;
+    int x = linear_index(fx, src->w, &wx);
+    int y = linear_index(fy, src->h, &wy);
+    const Uint8 *p;
+    __m128i top, bottom, v;
+
+    /* Both neighbours are always loaded, so step back from the right and
+       bottom edges and give the edge pixels all of the weight instead */
+    if (x == src->w - 1) {
+        --x;
+        wx = 256;
+    }
+    if (y == src->h - 1) {
+        --y;
+        wy = 256;
+    }
+    p = src->pixels + y * src->pitch + x * 4;
+    top = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) p), zero);
+    bottom = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (p + src->pitch)), zero);
+    v = _mm_add_epi16(_mm_mullo_epi16(top, _mm_set1_epi16((short) (256 - wy))),
+                      _mm_mullo_epi16(bottom, _mm_set1_epi16((short) wy)));
+    v = _mm_srli_epi16(v, 8);
+    return _mm_mullo_epi16(v, _mm_set_epi16((short) wx, (short) wx, (short) wx, (short) wx,
+                                            (short) (256 - wx), (short) (256 - wx),
+                                            (short) (256 - wx), (short) (256 - wx)));
+}
+
+static void
+sample_linear_SSE2(const SDLgfx_RotateSource * src, Uint32 * dst,
+                   int n, Sint32 fx, Sint32 fy, Sint32 dfx, Sint32 dfy)
+{
+    int i;
+
+    for (i = 0; i + 2 <= n; i += 2) {
+        const __m128i a = linear_columns_SSE2(src, fx, fy);
+        const __m128i b = linear_columns_SSE2(src, fx + dfx, fy + dfy);
+        __m128i sum;
+
+        sum = _mm_add_epi16(_mm_unpacklo_epi64(a, b), _mm_unpackhi_epi64(a, b));
+        sum = _mm_srli_epi16(sum, 8);
+        _mm_storel_epi64((__m128i *) (dst + i), _mm_packus_epi16(sum, sum));
+        fx += 2 * dfx;
+        fy += 2 * dfy;
+    }
+    sample_linear(src, dst + i, n - i, fx, fy, dfx, dfy);
+}
+#endif /* __SSE2__ */
+
+/* Narrow [*x0, *x1) down to the integers X with 0 <= a + b * X < len */
+static void
+rotate_span(double a, double b, double len, int *x0, int *x1)
+{
+    double first, end;
+
+    if (b == 0.0) {
+        if (a < 0.0 || a >= len) {
+            *x1 = *x0;
+        }
+        return;
+    }
+    if (b > 0.0) {
+        first = SDL_ceil(-a / b);
+        end = SDL_ceil((len - a) / b);
+    } else {
+        first = SDL_floor((len - a) / b) + 1.0;
+        end = SDL_floor(-a / b) + 1.0;
+    }
+    if (first > *x0) {
+        *x0 = (first >= *x1) ? *x1 : (int) first;
+    }
+    if (end < *x1) {
+        *x1 = (end <= *x0) ? *x0 : (int) end;
+    }
+}
+
+static SDL_INLINE Sint32
+to_fixed(double value)
+{
+    return (Sint32) SDL_floor(value * 65536.0 + 0.5);
+}
+
+static SDL_bool
+rotate_buffers(SDLgfx_RotateCacheEntry * entry, int rows, int pixels)
+{
+    if (entry->spans_size < rows * 2) {
+        int *spans = (int *) SDL_realloc(entry->spans, rows * 2 * sizeof(int));
+        if (!spans) {
+            return SDL_FALSE;
+        }
+        entry->spans = spans;
+        entry->spans_size = rows * 2;
+    }
+    if (entry->pixels_size < pixels) {
+        Uint32 *buffer = (Uint32 *) SDL_realloc(entry->pixels, pixels * sizeof(Uint32));
+        if (!buffer) {
+            return SDL_FALSE;
+        }
+        entry->pixels = buffer;
+        entry->pixels_size = pixels;
+    }
+    return SDL_TRUE;
+}
+
+/*!
+\brief Rotates, flips and scales part of a 32-bit surface directly into another surface.
+
+The source rectangle is stretched over 'dstrect', flipped, and rotated by
+'angle' degrees clockwise around (centerx, centery), relative to 'dstrect'.
+The result is clipped to the clip rectangle of 'dst' and drawn with the
+blend mode and modulation of 'src'.
+
+\param src The 32-bit surface to draw from.
+\param srcrect The part of src to draw, which must lie within src.
+\param dst The surface to draw to.
+\param dstrect Where the unrotated source rectangle would be drawn.
+\param angle The angle to rotate in degrees.
+\param centerx The horizontal rotation center, relative to dstrect.
+\param centery The vertical rotation center, relative to dstrect.
+\param smooth Set to 1 for bilinear filtering, 0 for nearest sampling.
+\param flipx Set to 1 to flip the image horizontally
+\param flipy Set to 1 to flip the image vertically
+\param cache Where sampled rows are kept for identical requests.
+\return 0 on success, or -1 on error.
+
+*/
+int
+SDLgfx_rotateBlit(SDL_Surface * src, const SDL_Rect * srcrect,
+                  SDL_Surface * dst, const SDL_Rect * dstrect,
+                  double angle, double centerx, double centery,
+                  int smooth, int flipx, int flipy,
+                  SDLgfx_RotateCache * cache)
+{
+    SDLgfx_RotateCacheEntry *entry = NULL;
+    SDLgfx_RotateSource source;
+    SDLgfx_SampleFunc sample;
+    SDL_BlitFunc RunBlit;
+    SDL_BlitInfo info;
+    SDL_Rect visible;
+    SDL_bool keep;
+    double rad, c, s, cx, cy, kx, ky;
+    double minx, miny, maxx, maxy;
+    int i, y, offset, dstbpp;
+    int src_locked = 0;
+    int dst_locked = 0;
+
+    if (src->format->BytesPerPixel != 4) {
+        return SDL_SetError("Only 32-bit surfaces can be rotated directly");
+    }
+    if (SDL_RectEmpty(srcrect) || SDL_RectEmpty(dstrect)) {
+        return 0;
+    }
+
+    /* The source is sampled directly, so it can't stay RLE encoded */
+    if (src->map->info.flags & SDL_COPY_RLE_DESIRED) {
+        SDL_SetSurfaceRLE(src, 0);
+    }
+    if ((src->map->dst != dst) ||
+        (dst->format->palette &&
+         src->map->dst_palette_version != dst->format->palette->version)) {
+        if (SDL_MapSurface(src, dst) < 0) {
+            return -1;
+        }
+    }
+    RunBlit = (SDL_BlitFunc) src->map->data;
+    if (!RunBlit) {
+        return SDL_SetError("Blit combination not supported");
+    }
+
+    rad = angle * (M_PI / 180.0);
+    c = SDL_cos(rad);
+    s = SDL_sin(rad);
+    if (SDL_fabs(c) < 1e-12) {
+        c = 0.0;
+    }
+    if (SDL_fabs(s) < 1e-12) {
+        s = 0.0;
+    }
+    cx = dstrect->x + centerx;
+    cy = dstrect->y + centery;
+
+    /* Find the bounding box of the rotated rectangle */
+    minx = maxx = cx - centerx * c + centery * s;
+    miny = maxy = cy - centerx * s - centery * c;
+    for (i = 1; i < 4; ++i) {
+        const double px = ((i & 1) ? dstrect->w : 0) - centerx;
+        const double py = ((i & 2) ? dstrect->h : 0) - centery;
+        const double qx = cx + px * c - py * s;
+        const double qy = cy + px * s + py * c;
+        minx = SDL_min(minx, qx);
+        maxx = SDL_max(maxx, qx);
+        miny = SDL_min(miny, qy);
+        maxy = SDL_max(maxy, qy);
+    }
+    visible.x = (int) SDL_floor(minx);
+    visible.y = (int) SDL_floor(miny);
+    visible.w = (int) SDL_ceil(maxx) - visible.x;
+    visible.h = (int) SDL_ceil(maxy) - visible.y;
+    if (!SDL_IntersectRect(&visible, &dst->clip_rect, &visible)) {
+        return 0;
+    }
+    visible.x -= dstrect->x;
+    visible.y -= dstrect->y;
+
+    /* Look for these rows in the cache, or pick an entry to sample into.
+       Prefer one last used for the same source, which is likely a sprite
+       being animated, then the least recently used one. */
+    for (i = 0; i < ROTATE_CACHE_SIZE; ++i) {
+        SDLgfx_RotateCacheEntry *candidate = &cache->entries[i];
+        if (candidate->valid && candidate->src == src &&
+            SDL_memcmp(&candidate->srcrect, srcrect, sizeof(*srcrect)) == 0 &&
+            candidate->w == dstrect->w && candidate->h == dstrect->h &&
+            candidate->angle == angle &&
+            candidate->centerx == centerx && candidate->centery == centery &&
+            candidate->smooth == smooth &&
+            candidate->flipx == flipx && candidate->flipy == flipy &&
+            SDL_memcmp(&candidate->visible, &visible, sizeof(visible)) == 0) {
+            entry = candidate;
+            break;
+        }
+    }
+    if (!entry) {
+        for (i = 0; i < ROTATE_CACHE_SIZE; ++i) {
+            SDLgfx_RotateCacheEntry *candidate = &cache->entries[i];
+            if (candidate->src == src) {
+                entry = candidate;
+                break;
+            }
+            if (!entry || candidate->last_used < entry->last_used) {
+                entry = candidate;
+            }
+        }
+        entry->valid = SDL_FALSE;
+    }
+    entry->last_used = ++cache->clock;
+
+    dstbpp = dst->format->BytesPerPixel;
+    info = src->map->info;
+    info.src_skip = 0;
+    info.dst_pitch = dst->pitch;
+
+    if (SDL_MUSTLOCK(dst)) {
+        if (SDL_LockSurface(dst) < 0) {
+            return -1;
+        }
+        dst_locked = 1;
+    }
+
+    if (entry->valid) {
+        /* Blit the rows sampled last time */
+        for (y = 0, offset = 0; y < visible.h; ++y) {
+            const int x0 = entry->spans[y * 2];
+            const int n = entry->spans[y * 2 + 1];
+            if (n > 0) {
+                info.src = (Uint8 *) (entry->pixels + offset);
+                info.src_w = info.dst_w = n;
+                info.src_h = info.dst_h = 1;
+                info.src_pitch = n * 4;
+                info.dst = (Uint8 *) dst->pixels +
+                           (dstrect->y + visible.y + y) * dst->pitch +
+                           (dstrect->x + visible.x + x0) * dstbpp;
+                info.dst_skip = dst->pitch - n * dstbpp;
+                RunBlit(&info);
+                offset += n;
+            }
+        }
+        if (dst_locked) {
+            SDL_UnlockSurface(dst);
+        }
+        return 0;
+    }
+
+    if (SDL_MUSTLOCK(src)) {
+        if (SDL_LockSurface(src) < 0) {
+            if (dst_locked) {
+                SDL_UnlockSurface(dst);
+            }
+            return -1;
+        }
+        src_locked = 1;
+    }
+
+    keep = (visible.w * visible.h <= ROTATE_CACHE_MAX_PIXELS);
+    if (!rotate_buffers(entry, visible.h, keep ? visible.w * visible.h : visible.w)) {
+        entry->src = NULL;
+        if (src_locked) {
+            SDL_UnlockSurface(src);
+        }
+        if (dst_locked) {
+            SDL_UnlockSurface(dst);
+        }
+        return SDL_OutOfMemory();
+    }
+
+    source.pixels = (const Uint8 *) src->pixels +
+                    srcrect->y * src->pitch + srcrect->x * 4;
+    source.pitch = src->pitch;
+    source.w = srcrect->w;
+    source.h = srcrect->h;
+
+    sample = sample_nearest;
+    if (smooth) {
+        sample = sample_linear;
+#ifdef __SSE2__
+        if (SDL_HasSSE2() && source.w > 1 && source.h > 1) {
+            sample = sample_linear_SSE2;
+        }
+#endif
+    }
+
+    /* Source position per destination pixel center, before flipping:
+       u = (X + 0.5 - cx) * c + (Y + 0.5 - cy) * s + centerx
+       v = (Y + 0.5 - cy) * c - (X + 0.5 - cx) * s + centery */
+    kx = (double) srcrect->w / dstrect->w;
+    ky = (double) srcrect->h / dstrect->h;
+    for (y = 0, offset = 0; y < visible.h; ++y) {
+        const int Y = dstrect->y + visible.y + y;
+        const int X = dstrect->x + visible.x;
+        const double dx = X + 0.5 - cx;
+        const double dy = Y + 0.5 - cy;
+        const double u = dx * c + dy * s + centerx;
+        const double v = dy * c - dx * s + centery;
+        Uint32 *samples;
+        Uint8 *dstp;
+        int x0 = 0, x1 = visible.w, n;
+        double fx, fy, dfx, dfy;
+
+        rotate_span(u, c, dstrect->w, &x0, &x1);
+        rotate_span(v, -s, dstrect->h, &x0, &x1);
+        n = x1 - x0;
+        entry->spans[y * 2] = x0;
+        entry->spans[y * 2 + 1] = n;
+        if (n <= 0) {
+            continue;
+        }
+
+        fx = u + x0 * c;
+        fy = v - x0 * s;
+        dfx = c;
+        dfy = -s;
+        if (flipx) {
+            fx = dstrect->w - fx;
+            dfx = -dfx;
+        }
+        if (flipy) {
+            fy = dstrect->h - fy;
+            dfy = -dfy;
+        }
+
+        dstp = (Uint8 *) dst->pixels + Y * dst->pitch + (X + x0) * dstbpp;
+        if (!keep && RunBlit == SDL_BlitCopy) {
+            /* Nothing to convert or blend, sample straight into the target */
+            sample(&source, (Uint32 *) dstp, n, to_fixed(fx * kx), to_fixed(fy * ky),
+                   to_fixed(dfx * kx), to_fixed(dfy * ky));
+            continue;
+        }
+
+        samples = entry->pixels + (keep ? offset : 0);
+        sample(&source, samples, n, to_fixed(fx * kx), to_fixed(fy * ky),
+               to_fixed(dfx * kx), to_fixed(dfy * ky));
+        info.src = (Uint8 *) samples;
+        info.src_w = info.dst_w = n;
+        info.src_h = info.dst_h = 1;
+        info.src_pitch = n * 4;
+        info.dst = dstp;
+        info.dst_skip = dst->pitch - n * dstbpp;
+        RunBlit(&info);
+        offset += n;
+    }
+
+    entry->src = src;
+    entry->srcrect = *srcrect;
+    entry->w = dstrect->w;
+    entry->h = dstrect->h;
+    entry->angle = angle;
+    entry->centerx = centerx;
+    entry->centery = centery;
+    entry->smooth = smooth;
+    entry->flipx = flipx;
+    entry->flipy = flipy;
+    entry->visible = visible;
+    entry->valid = keep;
+
+    if (src_locked) {
+        SDL_UnlockSurface(src);
+    }
+    if (dst_locked) {
+        SDL_UnlockSurface(dst);
+    }
+    return 0;
+}
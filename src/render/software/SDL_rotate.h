@@ -26,3 +26,10 @@
 extern SDL_Surface *SDLgfx_rotateSurface(SDL_Surface * src, double angle, int centerx, int centery, int smooth, int flipx, int flipy, int dstwidth, int dstheight, double cangle, double sangle);
 extern void SDLgfx_rotozoomSurfaceSizeTrig(int width, int height, double angle, int *dstwidth, int *dstheight, double *cangle, double *sangle);
 
+
+typedef struct SDLgfx_RotateCache SDLgfx_RotateCache;
+
+extern SDLgfx_RotateCache *SDLgfx_createRotateCache(void);
+extern void SDLgfx_invalidateRotateCache(SDLgfx_RotateCache * cache, SDL_Surface * src);
+extern void SDLgfx_destroyRotateCache(SDLgfx_RotateCache * cache);
+extern int SDLgfx_rotateBlit(SDL_Surface * src, const SDL_Rect * srcrect, SDL_Surface * dst, const SDL_Rect * dstrect, double angle, double centerx, double centery, int smooth, int flipx, int flipy, SDLgfx_RotateCache * cache);
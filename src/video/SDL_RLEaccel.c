@@ -60,9 +60,6 @@
  *
  * Encoding of surfaces with per-pixel alpha:
  *
- *   The sequence begins with a struct RLEDestFormat describing the target
- *   pixel format, to provide reliable un-encoding.
- *
  *   Each scan line is encoded twice: First all completely opaque pixels,
  *   encoded in the target format as described above, and then all
  *   partially transparent (translucent) pixels (where 1 <= alpha <= 254),
@@ -83,12 +80,22 @@
  *
  *   The end of the sequence is marked by a zero <skip>,<run> pair at the
  *   beginning of an opaque line.
+ *
+ * The stream is preceded by an RLEHeader that records where each scan line
+ * starts. The surface keeps its pixels while it is encoded, so locking it
+ * doesn't need to decode anything: it only takes a snapshot of the pixels.
+ * The next blit compares the pixels against that snapshot and encodes just
+ * the scan lines that changed, copying the others from the old stream.
+ * An encoded line doesn't depend on the lines before it, and its length is
+ * a multiple of the alignment its pixels need, so it can be copied from one
+ * stream to another as it is.
  */
 
 #include "SDL_video.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
+#include "SDL_pixels_c.h"
 
 #ifndef MAX
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
@@ -100,6 +107,19 @@
 #define PIXEL_COPY(to, from, len, bpp)          \
     SDL_memcpy(to, from, (size_t)(len) * (bpp))
 
+/* kept in front of the encoded stream in map->data */
+typedef struct
+{
+    int *lines;             /* offset of each line, and of the end of the last */
+    int nlines;             /* number of lines, trailing blank ones left out */
+    Uint8 *snapshot;        /* the encoded pixels, if the surface was locked */
+} RLEHeader;
+
+#define RLE_HEADER_SIZE ((sizeof(RLEHeader) + 15) & ~15)
+#define RLE_HEADER(data) ((RLEHeader *)((Uint8 *)(data) - RLE_HEADER_SIZE))
+
+static int RLEUpdateSurface(SDL_Surface * surface);
+
 /*
  * Various colorkey blit methods, for opaque and per-surface alpha
  */
@@ -114,24 +134,72 @@
  * of each component, so the bits from the multiplication don't collide.
  * This can be used for any RGB permutation of course.
  */
-#define ALPHA_BLIT32_888(to, from, length, bpp, alpha)      \
+#define BLEND_888(s, d, alpha)                              \
     do {                                                    \
-        int i;                                              \
-        Uint32 *src = (Uint32 *)(from);                     \
-        Uint32 *dst = (Uint32 *)(to);                       \
-        for (i = 0; i < (int)(length); i++) {               \
-            Uint32 s = *src++;                              \
-            Uint32 d = *dst;                                \
-            Uint32 s1 = s & 0xff00ff;                       \
-            Uint32 d1 = d & 0xff00ff;                       \
-            d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff; \
-            s &= 0xff00;                                    \
-            d &= 0xff00;                                    \
-            d = (d + ((s - d) * alpha >> 8)) & 0xff00;      \
-            *dst++ = d1 | d;                                \
-        }                                                   \
+        Uint32 s1 = s & 0xff00ff;                           \
+        Uint32 d1 = d & 0xff00ff;                           \
+        d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff;    \
+        s &= 0xff00;                                        \
+        d &= 0xff00;                                        \
+        d = (d + ((s - d) * alpha >> 8)) & 0xff00;          \
+        d |= d1;                                            \
     } while (0)
 
+#ifdef __SSE2__
+/*
+ * The same for four pixels at a time. SSE2 has no 32-bit multiply, so the
+ * products are put together from 16-bit ones, with alpha in both halves of
+ * each lane. They wrap around exactly like the scalar ones do, which keeps
+ * the results identical.
+ */
+static SDL_INLINE __m128i
+RLEMul32(__m128i x, __m128i alpha)
+{
+    return _mm_add_epi32(_mm_mullo_epi16(x, alpha),
+                         _mm_slli_epi32(_mm_mulhi_epu16(x, alpha), 16));
+}
+
+static SDL_INLINE __m128i
+RLEBlend888SSE2(__m128i s, __m128i d, __m128i alpha)
+{
+    const __m128i rbmask = _mm_set1_epi32(0x00ff00ff);
+    const __m128i gmask = _mm_set1_epi32(0x0000ff00);
+    __m128i d1 = _mm_and_si128(d, rbmask);
+    __m128i d2 = _mm_and_si128(d, gmask);
+    __m128i s1 = _mm_sub_epi32(_mm_and_si128(s, rbmask), d1);
+    __m128i s2 = _mm_sub_epi32(_mm_and_si128(s, gmask), d2);
+    d1 = _mm_add_epi32(d1, _mm_srli_epi32(RLEMul32(s1, alpha), 8));
+    d2 = _mm_add_epi32(d2, _mm_srli_epi32(RLEMul32(s2, alpha), 8));
+    return _mm_or_si128(_mm_and_si128(d1, rbmask), _mm_and_si128(d2, gmask));
+}
+#endif /* __SSE2__ */
+
+static void
+RLEBlit888(Uint32 * dst, const Uint32 * src, int n, unsigned alpha)
+{
+    int i = 0;
+
+#ifdef __SSE2__
+    if (n >= 4 && SDL_HasSSE2()) {
+        const __m128i a = _mm_set1_epi16((short) alpha);
+        for (; i + 4 <= n; i += 4) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+            const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+            _mm_storeu_si128((__m128i *) (dst + i), RLEBlend888SSE2(s, d, a));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        Uint32 s = src[i];
+        Uint32 d = dst[i];
+        BLEND_888(s, d, alpha);
+        dst[i] = d;
+    }
+}
+
+#define ALPHA_BLIT32_888(to, from, length, bpp, alpha)      \
+    RLEBlit888((Uint32 *)(to), (const Uint32 *)(from), length, alpha)
+
 /*
  * For 16bpp pixels we can go a step further: put the middle component
  * in the high 16 bits of a 32 bit word, and process all three RGB
@@ -446,6 +514,12 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     int w = surf_src->w;
     unsigned alpha;
 
+    /* Encode the lines changed since the surface was locked */
+    if (RLE_HEADER(surf_src->map->data)->snapshot &&
+        RLEUpdateSurface(surf_src) < 0) {
+        return -1;
+    }
+
     /* Lock the destination if necessary */
     if (SDL_MUSTLOCK(surf_dst)) {
         if (SDL_LockSurface(surf_dst) < 0) {
@@ -561,16 +635,11 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
  */
 #define BLIT_TRANSL_888(src, dst)               \
     do {                            \
-        Uint32 s = src;                     \
+    Uint32 s = src;                     \
     Uint32 d = dst;                     \
     unsigned alpha = s >> 24;               \
-    Uint32 s1 = s & 0xff00ff;               \
-    Uint32 d1 = d & 0xff00ff;               \
-    d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff;    \
-    s &= 0xff00;                        \
-    d &= 0xff00;                        \
-    d = (d + ((s - d) * alpha >> 8)) & 0xff00;      \
-    dst = d1 | d | 0xff000000;              \
+    BLEND_888(s, d, alpha);                 \
+    dst = d | 0xff000000;                   \
     } while(0)
 
 /*
@@ -601,25 +670,44 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     dst = (Uint16)(d | d >> 16);            \
     } while(0)
 
-/* used to save the destination format in the encoding. Designed to be
-   macro-compatible with SDL_PixelFormat but without the unneeded fields */
-typedef struct
+/*
+ * Blend a run of translucent pixels. 32bpp runs are done four pixels at a
+ * time where SSE2 is available.
+ */
+#define BLEND_RUN(do_blend, dst, src, n)        \
+    do {                                        \
+    int i;                                      \
+    for (i = 0; i < (int)(n); i++)              \
+        do_blend((src)[i], (dst)[i]);           \
+    } while(0)
+
+#define BLEND_RUN_565(dst, src, n) BLEND_RUN(BLIT_TRANSL_565, dst, src, n)
+#define BLEND_RUN_555(dst, src, n) BLEND_RUN(BLIT_TRANSL_555, dst, src, n)
+
+static void
+RLEBlendTransl888(Uint32 * dst, const Uint32 * src, int n)
 {
-    Uint8 BytesPerPixel;
-    Uint8 padding[3];
-    Uint32 Rmask;
-    Uint32 Gmask;
-    Uint32 Bmask;
-    Uint32 Amask;
-    Uint8 Rloss;
-    Uint8 Gloss;
-    Uint8 Bloss;
-    Uint8 Aloss;
-    Uint8 Rshift;
-    Uint8 Gshift;
-    Uint8 Bshift;
-    Uint8 Ashift;
-} RLEDestFormat;
+    int i = 0;
+
+#ifdef __SSE2__
+    if (n >= 4 && SDL_HasSSE2()) {
+        const __m128i opaque = _mm_set1_epi32(0xff000000);
+        for (; i + 4 <= n; i += 4) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+            const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+            __m128i a = _mm_srli_epi32(s, 24);
+            a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+            _mm_storeu_si128((__m128i *) (dst + i),
+                             _mm_or_si128(RLEBlend888SSE2(s, d, a), opaque));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        BLIT_TRANSL_888(src[i], dst[i]);
+    }
+}
+
+#define BLEND_RUN_888(dst, src, n) RLEBlendTransl888(dst, src, n)
 
 /* blit a pixel-alpha RLE surface clipped at the right and/or left edges */
 static void
@@ -629,10 +717,10 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
     SDL_PixelFormat *df = surf_dst->format;
     /*
      * clipped blitter: Ptype is the destination pixel type,
-     * Ctype the translucent count type, and do_blend the macro
-     * to blend one pixel.
+     * Ctype the opaque count type, and blend_run the macro
+     * to blend a run of translucent pixels.
      */
-#define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend)              \
+#define RLEALPHACLIPBLIT(Ptype, Ctype, blend_run)             \
     do {                                  \
     int linecount = srcrect->h;                   \
     int left = srcrect->x;                        \
@@ -685,13 +773,9 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
             }                             \
             if(crun > right - cofs)               \
             crun = right - cofs;                  \
-            if(crun > 0) {                    \
-            Ptype *dst = (Ptype *)dstbuf + cofs;          \
-            Uint32 *src = (Uint32 *)srcbuf + (cofs - ofs);    \
-            int i;                        \
-            for(i = 0; i < crun; i++)             \
-                do_blend(src[i], dst[i]);             \
-            }                             \
+            if(crun > 0)                      \
+            blend_run((Ptype *)dstbuf + cofs,             \
+                  (Uint32 *)srcbuf + (cofs - ofs), crun); \
             srcbuf += run * 4;                    \
             ofs += run;                       \
         }                             \
@@ -703,12 +787,12 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
     switch (df->BytesPerPixel) {
     case 2:
         if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0)
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_565);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLEND_RUN_565);
         else
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_555);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLEND_RUN_555);
         break;
     case 4:
-        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_888);
+        RLEALPHACLIPBLIT(Uint32, Uint16, BLEND_RUN_888);
         break;
     }
 }
@@ -723,6 +807,12 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     Uint8 *srcbuf, *dstbuf;
     SDL_PixelFormat *df = surf_dst->format;
 
+    /* Encode the lines changed since the surface was locked */
+    if (RLE_HEADER(surf_src->map->data)->snapshot &&
+        RLEUpdateSurface(surf_src) < 0) {
+        return -1;
+    }
+
     /* Lock the destination if necessary */
     if (SDL_MUSTLOCK(surf_dst)) {
         if (SDL_LockSurface(surf_dst) < 0) {
@@ -733,7 +823,7 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *) surf_dst->pixels + y * surf_dst->pitch + x * df->BytesPerPixel;
-    srcbuf = (Uint8 *) surf_src->map->data + sizeof(RLEDestFormat);
+    srcbuf = (Uint8 *) surf_src->map->data;
 
     {
         /* skip lines at the top if necessary */
@@ -798,10 +888,10 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
 
         /*
          * non-clipped blitter. Ptype is the destination pixel type,
-         * Ctype the translucent count type, and do_blend the
-         * macro to blend one pixel.
+         * Ctype the opaque count type, and blend_run the macro
+         * to blend a run of translucent pixels.
          */
-#define RLEALPHABLIT(Ptype, Ctype, do_blend)                 \
+#define RLEALPHABLIT(Ptype, Ctype, blend_run)                \
     do {                                 \
         int linecount = srcrect->h;                  \
         do {                             \
@@ -831,14 +921,8 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
             run = ((Uint16 *)srcbuf)[1];             \
             srcbuf += 4;                     \
             if(run) {                        \
-            Ptype *dst = (Ptype *)dstbuf + ofs;      \
-            unsigned i;                  \
-            for(i = 0; i < run; i++) {           \
-                Uint32 src = *(Uint32 *)srcbuf;      \
-                do_blend(src, *dst);             \
-                srcbuf += 4;                 \
-                dst++;                   \
-            }                        \
+            blend_run((Ptype *)dstbuf + ofs, (Uint32 *)srcbuf, run); \
+            srcbuf += run * 4;               \
             ofs += run;                  \
             }                            \
         } while(ofs < w);                    \
@@ -850,12 +934,12 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
         case 2:
             if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0
                 || df->Bmask == 0x07e0)
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_565);
+                RLEALPHABLIT(Uint16, Uint8, BLEND_RUN_565);
             else
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_555);
+                RLEALPHABLIT(Uint16, Uint8, BLEND_RUN_555);
             break;
         case 4:
-            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_888);
+            RLEALPHABLIT(Uint32, Uint16, BLEND_RUN_888);
             break;
         }
     }
@@ -872,9 +956,7 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
  * Auxiliary functions:
  * The encoding functions take 32bpp rgb + a, and
  * return the number of bytes copied to the destination.
- * The decoding functions copy to 32bpp rgb + a, and
- * return the number of bytes copied from the source.
- * These are only used in the encoder and un-RLE code and are therefore not
+ * These are only used in the encoder and are therefore not
  * highly optimised.
  */
 
@@ -895,26 +977,6 @@ copy_opaque_16(void *dst, Uint32 * src, int n,
     return n * 2;
 }
 
-/* decode opaque pixels from 16bpp to 32bpp rgb + a */
-static int
-uncopy_opaque_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint16 *s = src;
-    unsigned alpha = dfmt->Amask ? 255 : 0;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b;
-        RGB_FROM_PIXEL(*s, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, alpha);
-        s++;
-        dst++;
-    }
-    return n * 2;
-}
-
-
-
 /* encode 32bpp rgb + a into 32bpp G0RAB format for blitting into 565 */
 static int
 copy_transl_565(void *dst, Uint32 * src, int n,
@@ -953,80 +1015,455 @@ copy_transl_555(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode translucent pixels from 32bpp GORAB to 32bpp rgb + a */
+/* encode 32bpp rgba into 32bpp rgba, for opaque pixels */
 static int
-uncopy_transl_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
+copy_32(void *dst, Uint32 * src, int n,
+        SDL_PixelFormat * sfmt, SDL_PixelFormat * dfmt)
 {
     int i;
-    Uint32 *s = src;
+    Uint32 *d = dst;
     for (i = 0; i < n; i++) {
         unsigned r, g, b, a;
-        Uint32 pix = *s++;
-        a = (pix & 0x3e0) >> 2;
-        pix = (pix & ~0x3e0) | pix >> 16;
-        RGB_FROM_PIXEL(pix, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
+        RGBA_FROM_8888(*src, sfmt, r, g, b, a);
+        PIXEL_FROM_RGBA(*d, dfmt, r, g, b, a);
+        d++;
+        src++;
     }
     return n * 4;
 }
 
-/* encode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
+/* encode 32bpp rgba into 32bpp rgb with the alpha in the top 8 bits,
+   whether or not the target has an alpha channel there */
 static int
-copy_32(void *dst, Uint32 * src, int n,
-        SDL_PixelFormat * sfmt, SDL_PixelFormat * dfmt)
+copy_transl_32(void *dst, Uint32 * src, int n,
+               SDL_PixelFormat * sfmt, SDL_PixelFormat * dfmt)
 {
     int i;
     Uint32 *d = dst;
     for (i = 0; i < n; i++) {
         unsigned r, g, b, a;
+        Uint32 pix;
         RGBA_FROM_8888(*src, sfmt, r, g, b, a);
-        PIXEL_FROM_RGBA(*d, dfmt, r, g, b, a);
+        PIXEL_FROM_RGB(pix, dfmt, r, g, b);
+        *d = (pix & 0x00ffffff) | ((Uint32) a << 24);
         d++;
         src++;
     }
     return n * 4;
 }
 
-/* decode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
+static Uint32
+getpix_8(Uint8 * srcbuf)
+{
+    return *srcbuf;
+}
+
+static Uint32
+getpix_16(Uint8 * srcbuf)
+{
+    return *(Uint16 *) srcbuf;
+}
+
+static Uint32
+getpix_24(Uint8 * srcbuf)
+{
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    return srcbuf[0] + (srcbuf[1] << 8) + (srcbuf[2] << 16);
+#else
+    return (srcbuf[0] << 16) + (srcbuf[1] << 8) + srcbuf[2];
+#endif
+}
+
+static Uint32
+getpix_32(Uint8 * srcbuf)
+{
+    return *(Uint32 *) srcbuf;
+}
+
+typedef Uint32(*getpix_func) (Uint8 *);
+
+static const getpix_func getpixes[4] = {
+    getpix_8, getpix_16, getpix_24, getpix_32
+};
+
+/* how a surface is encoded, one scan line at a time */
+typedef struct RLEEncoder
+{
+    SDL_PixelFormat *sf;        /* source format */
+    SDL_PixelFormat *df;        /* target format */
+    int w;
+    size_t maxsize;             /* worst case size of the stream */
+    int endsize;                /* size of the end marker */
+    SDL_bool sse2;
+    Uint8 *(*encode_line) (const struct RLEEncoder * enc, Uint8 * dst,
+                           const Uint8 * srcbuf, SDL_bool * blank);
+
+    /* colorkey */
+    int bpp;
+    int maxn;
+    Uint32 rgbmask;
+    Uint32 ckey;
+
+    /* pixel alpha */
+    int max_opaque_run;
+    int (*copy_opaque) (void *, Uint32 *, int,
+                        SDL_PixelFormat *, SDL_PixelFormat *);
+    int (*copy_transl) (void *, Uint32 *, int,
+                        SDL_PixelFormat *, SDL_PixelFormat *);
+} RLEEncoder;
+
+/*
+ * Count the pixels at the start of src that have an alpha value between
+ * lo and hi, or if inside is false, the ones that don't.
+ */
 static int
-uncopy_32(Uint32 * dst, void *src, int n,
-          RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
+RLEAlphaRun(const RLEEncoder * enc, const Uint32 * src, int n,
+            unsigned lo, unsigned hi, SDL_bool inside)
 {
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pixel = *s++;
-        RGB_FROM_PIXEL(pixel, sfmt, r, g, b);
-        a = pixel >> 24;
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
+    const SDL_PixelFormat *sf = enc->sf;
+    int x = 0;
+
+#ifdef __SSE2__
+    if (enc->sse2) {
+        const __m128i shift = _mm_cvtsi32_si128(sf->Ashift);
+        const __m128i amask = _mm_set1_epi32((int) (sf->Amask >> sf->Ashift));
+        const __m128i below = _mm_set1_epi32((int) lo - 1);
+        const __m128i above = _mm_set1_epi32((int) hi + 1);
+        const int all = inside ? 0xffff : 0;
+        for (; x + 4 <= n; x += 4) {
+            const __m128i v = _mm_loadu_si128((const __m128i *) (src + x));
+            const __m128i a = _mm_and_si128(_mm_srl_epi32(v, shift), amask);
+            const __m128i in = _mm_and_si128(_mm_cmpgt_epi32(a, below),
+                                             _mm_cmplt_epi32(a, above));
+            if (_mm_movemask_epi8(in) != all) {
+                break;
+            }
+        }
     }
-    return n * 4;
+#endif
+    for (; x < n; x++) {
+        const unsigned a = (src[x] & sf->Amask) >> sf->Ashift;
+        if ((a >= lo && a <= hi) != inside) {
+            break;
+        }
+    }
+    return x;
+}
+
+#define RLEOpaqueRun(enc, src, n, inside)   \
+    RLEAlphaRun(enc, src, n, 255, 255, inside)
+
+#define RLETranslRun(enc, src, n, inside)   \
+    RLEAlphaRun(enc, src, n, 1, 254, inside)
+
+/* encode one scan line of a surface with pixel alpha */
+static Uint8 *
+RLEAlphaLine(const RLEEncoder * enc, Uint8 * dst, const Uint8 * srcbuf,
+             SDL_bool * blank)
+{
+    SDL_PixelFormat *sf = enc->sf;
+    SDL_PixelFormat *df = enc->df;
+    Uint32 *src = (Uint32 *) srcbuf;
+    int w = enc->w;
+    int max_opaque_run = enc->max_opaque_run;
+    int max_transl_run = 65535;
+    int x, runstart, skipstart;
+    SDL_bool blankline = SDL_FALSE;
+
+    /* opaque counts are 8 or 16 bits, depending on target depth */
+#define ADD_OPAQUE_COUNTS(n, m)         \
+    if(df->BytesPerPixel == 4) {        \
+        ((Uint16 *)dst)[0] = n;     \
+        ((Uint16 *)dst)[1] = m;     \
+        dst += 4;               \
+    } else {                \
+        dst[0] = n;             \
+        dst[1] = m;             \
+        dst += 2;               \
+    }
+
+    /* translucent counts are always 16 bit */
+#define ADD_TRANSL_COUNTS(n, m)     \
+    (((Uint16 *)dst)[0] = n, ((Uint16 *)dst)[1] = m, dst += 4)
+
+    /* First encode all opaque pixels of a scan line */
+    x = 0;
+    do {
+        int run, skip, len;
+        skipstart = x;
+        x += RLEOpaqueRun(enc, src + x, w - x, SDL_FALSE);
+        runstart = x;
+        x += RLEOpaqueRun(enc, src + x, w - x, SDL_TRUE);
+        skip = runstart - skipstart;
+        if (skip == w)
+            blankline = SDL_TRUE;
+        run = x - runstart;
+        while (skip > max_opaque_run) {
+            ADD_OPAQUE_COUNTS(max_opaque_run, 0);
+            skip -= max_opaque_run;
+        }
+        len = MIN(run, max_opaque_run);
+        ADD_OPAQUE_COUNTS(skip, len);
+        dst += enc->copy_opaque(dst, src + runstart, len, sf, df);
+        runstart += len;
+        run -= len;
+        while (run) {
+            len = MIN(run, max_opaque_run);
+            ADD_OPAQUE_COUNTS(0, len);
+            dst += enc->copy_opaque(dst, src + runstart, len, sf, df);
+            runstart += len;
+            run -= len;
+        }
+    } while (x < w);
+
+    /* Make sure the next output address is 32-bit aligned */
+    dst += (uintptr_t) dst & 2;
+
+    /* Next, encode all translucent pixels of the same scan line */
+    x = 0;
+    do {
+        int run, skip, len;
+        skipstart = x;
+        x += RLETranslRun(enc, src + x, w - x, SDL_FALSE);
+        runstart = x;
+        x += RLETranslRun(enc, src + x, w - x, SDL_TRUE);
+        skip = runstart - skipstart;
+        if (skip != w)
+            blankline = SDL_FALSE;
+        run = x - runstart;
+        while (skip > max_transl_run) {
+            ADD_TRANSL_COUNTS(max_transl_run, 0);
+            skip -= max_transl_run;
+        }
+        len = MIN(run, max_transl_run);
+        ADD_TRANSL_COUNTS(skip, len);
+        dst += enc->copy_transl(dst, src + runstart, len, sf, df);
+        runstart += len;
+        run -= len;
+        while (run) {
+            len = MIN(run, max_transl_run);
+            ADD_TRANSL_COUNTS(0, len);
+            dst += enc->copy_transl(dst, src + runstart, len, sf, df);
+            runstart += len;
+            run -= len;
+        }
+    } while (x < w);
+
+#undef ADD_OPAQUE_COUNTS
+#undef ADD_TRANSL_COUNTS
+
+    *blank = blankline;
+    return dst;
 }
 
-#define ISOPAQUE(pixel, fmt) ((((pixel) & fmt->Amask) >> fmt->Ashift) == 255)
+/*
+ * Count the pixels at the start of srcbuf that have the colorkey, or if
+ * keyed is false, the ones that don't.
+ */
+static int
+RLEKeyRun(const RLEEncoder * enc, const Uint8 * srcbuf, int n,
+          SDL_bool keyed)
+{
+    const int bpp = enc->bpp;
+    const Uint32 rgbmask = enc->rgbmask;
+    const Uint32 ckey = enc->ckey;
+    const getpix_func getpix = getpixes[bpp - 1];
+    int x = 0;
+
+#ifdef __SSE2__
+    if (enc->sse2 && bpp != 3) {
+        /* compare 16 bytes worth of pixels at a time */
+        const int step = 16 / bpp;
+        const int all = keyed ? 0xffff : 0;
+        __m128i mask, key;
+        if (bpp == 1) {
+            mask = _mm_set1_epi8((char) rgbmask);
+            key = _mm_set1_epi8((char) ckey);
+        } else if (bpp == 2) {
+            mask = _mm_set1_epi16((short) rgbmask);
+            key = _mm_set1_epi16((short) ckey);
+        } else {
+            mask = _mm_set1_epi32((int) rgbmask);
+            key = _mm_set1_epi32((int) ckey);
+        }
+        for (; x + step <= n; x += step) {
+            __m128i v = _mm_loadu_si128((const __m128i *) (srcbuf + x * bpp));
+            v = _mm_and_si128(v, mask);
+            if (bpp == 1) {
+                v = _mm_cmpeq_epi8(v, key);
+            } else if (bpp == 2) {
+                v = _mm_cmpeq_epi16(v, key);
+            } else {
+                v = _mm_cmpeq_epi32(v, key);
+            }
+            if (_mm_movemask_epi8(v) != all) {
+                break;
+            }
+        }
+    }
+#endif
+    for (; x < n; x++) {
+        if (((getpix((Uint8 *) srcbuf + x * bpp) & rgbmask) == ckey) != keyed) {
+            break;
+        }
+    }
+    return x;
+}
 
-#define ISTRANSL(pixel, fmt)    \
-    ((unsigned)((((pixel) & fmt->Amask) >> fmt->Ashift) - 1U) < 254U)
+/* encode one scan line of a colorkeyed surface */
+static Uint8 *
+RLEColorkeyLine(const RLEEncoder * enc, Uint8 * dst, const Uint8 * srcbuf,
+                SDL_bool * blank)
+{
+    int bpp = enc->bpp;
+    int maxn = enc->maxn;
+    int w = enc->w;
+    int x = 0;
+
+#define ADD_COUNTS(n, m)            \
+    if(bpp == 4) {              \
+        ((Uint16 *)dst)[0] = n;     \
+        ((Uint16 *)dst)[1] = m;     \
+        dst += 4;               \
+    } else {                \
+        dst[0] = n;             \
+        dst[1] = m;             \
+        dst += 2;               \
+    }
+
+    *blank = SDL_FALSE;
+    do {
+        int run, skip, len;
+        int runstart;
+        int skipstart = x;
+
+        /* find run of transparent, then opaque pixels */
+        x += RLEKeyRun(enc, srcbuf + x * bpp, w - x, SDL_TRUE);
+        runstart = x;
+        x += RLEKeyRun(enc, srcbuf + x * bpp, w - x, SDL_FALSE);
+        skip = runstart - skipstart;
+        if (skip == w)
+            *blank = SDL_TRUE;
+        run = x - runstart;
+
+        /* encode segment */
+        while (skip > maxn) {
+            ADD_COUNTS(maxn, 0);
+            skip -= maxn;
+        }
+        len = MIN(run, maxn);
+        ADD_COUNTS(skip, len);
+        SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
+        dst += len * bpp;
+        run -= len;
+        runstart += len;
+        while (run) {
+            len = MIN(run, maxn);
+            ADD_COUNTS(0, len);
+            SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
+            dst += len * bpp;
+            runstart += len;
+            run -= len;
+        }
+    } while (x < w);
+
+#undef ADD_COUNTS
+
+    return dst;
+}
+
+static void
+RLEFreeHeader(RLEHeader * header)
+{
+    SDL_free(header->lines);
+    SDL_free(header->snapshot);
+    SDL_free(header);
+}
+
+/*
+ * Encode the surface into a new stream in map->data. If old is given, the
+ * lines whose pixels are still the same as in its snapshot are copied from
+ * it instead of being encoded again.
+ */
+static int
+RLEEncodeSurface(SDL_Surface * surface, const RLEEncoder * enc,
+                 const RLEHeader * old)
+{
+    const size_t linesize = (size_t) surface->w * surface->format->BytesPerPixel;
+    const Uint8 *snapshot = old ? old->snapshot : NULL;
+    const Uint8 *oldstream = (const Uint8 *) old + RLE_HEADER_SIZE;
+    const Uint8 *srcbuf = (const Uint8 *) surface->pixels;
+    RLEHeader *header;
+    Uint8 *rlebuf, *stream, *dst, *lastline;
+    int *lines;
+    int y, h = surface->h;
+    int nlines = 0;
+
+    rlebuf = (Uint8 *) SDL_malloc(RLE_HEADER_SIZE + enc->maxsize);
+    lines = (int *) SDL_malloc((h + 1) * sizeof(*lines));
+    if (!rlebuf || !lines) {
+        SDL_free(rlebuf);
+        SDL_free(lines);
+        return SDL_OutOfMemory();
+    }
+    stream = rlebuf + RLE_HEADER_SIZE;
+    dst = lastline = stream;    /* lastline is the end of the last non-blank line */
+
+    for (y = 0; y < h; y++) {
+        SDL_bool blank;
+
+        lines[y] = (int) (dst - stream);
+        if (snapshot && y < old->nlines &&
+            SDL_memcmp(srcbuf, snapshot, linesize) == 0) {
+            const int len = old->lines[y + 1] - old->lines[y];
+            SDL_memcpy(dst, oldstream + old->lines[y], len);
+            dst += len;
+            blank = SDL_FALSE;
+        } else {
+            dst = enc->encode_line(enc, dst, srcbuf, &blank);
+        }
+        if (!blank) {
+            lastline = dst;
+            nlines = y + 1;
+        }
+
+        srcbuf += surface->pitch;
+        if (snapshot) {
+            snapshot += surface->pitch;
+        }
+    }
+    dst = lastline;             /* back up past trailing blank lines */
+    lines[nlines] = (int) (dst - stream);
+
+    /* the end is marked by a zero <skip>,<run> pair */
+    SDL_memset(dst, 0, enc->endsize);
+    dst += enc->endsize;
+
+    /* realloc the buffer to release unused memory */
+    {
+        /* If realloc returns NULL, the original block is left intact */
+        Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
+        if (p)
+            rlebuf = p;
+    }
+
+    header = (RLEHeader *) rlebuf;
+    header->lines = lines;
+    header->nlines = nlines;
+    header->snapshot = NULL;
+    surface->map->data = rlebuf + RLE_HEADER_SIZE;
+
+    return 0;
+}
 
 /* convert surface to be quickly alpha-blittable onto dest, if possible */
 static int
-RLEAlphaSurface(SDL_Surface * surface)
+RLEAlphaSurface(SDL_Surface * surface, const RLEHeader * old)
 {
     SDL_Surface *dest;
     SDL_PixelFormat *df;
-    int maxsize = 0;
-    int max_opaque_run;
-    int max_transl_run = 65535;
+    RLEEncoder enc;
     unsigned masksum;
-    Uint8 *rlebuf, *dst;
-    int (*copy_opaque) (void *, Uint32 *, int,
-                        SDL_PixelFormat *, SDL_PixelFormat *);
-    int (*copy_transl) (void *, Uint32 *, int,
-                        SDL_PixelFormat *, SDL_PixelFormat *);
 
     dest = surface->map->dst;
     if (!dest)
@@ -1035,6 +1472,8 @@ RLEAlphaSurface(SDL_Surface * surface)
     if (surface->format->BitsPerPixel != 32)
         return -1;              /* only 32bpp source supported */
 
+    SDL_zero(enc);
+
     /* find out whether the destination is one we support,
        and determine the max size of the encoded result */
     masksum = df->Rmask | df->Gmask | df->Bmask;
@@ -1045,346 +1484,129 @@ RLEAlphaSurface(SDL_Surface * surface)
         case 0xffff:
             if (df->Gmask == 0x07e0
                 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0) {
-                copy_opaque = copy_opaque_16;
-                copy_transl = copy_transl_565;
+                enc.copy_opaque = copy_opaque_16;
+                enc.copy_transl = copy_transl_565;
             } else
                 return -1;
             break;
         case 0x7fff:
             if (df->Gmask == 0x03e0
                 || df->Rmask == 0x03e0 || df->Bmask == 0x03e0) {
-                copy_opaque = copy_opaque_16;
-                copy_transl = copy_transl_555;
+                enc.copy_opaque = copy_opaque_16;
+                enc.copy_transl = copy_transl_555;
             } else
                 return -1;
             break;
         default:
             return -1;
         }
-        max_opaque_run = 255;   /* runs stored as bytes */
+        enc.max_opaque_run = 255;       /* runs stored as bytes */
+        enc.endsize = 2;
 
         /* worst case is alternating opaque and translucent pixels,
            with room for alignment padding between lines */
-        maxsize = surface->h * (2 + (4 + 2) * (surface->w + 1)) + 2;
+        enc.maxsize = (size_t) surface->h * (2 + (4 + 2) * (surface->w + 1)) + 2;
         break;
     case 4:
         if (masksum != 0x00ffffff)
             return -1;          /* requires unused high byte */
-        copy_opaque = copy_32;
-        copy_transl = copy_32;
-        max_opaque_run = 255;   /* runs stored as short ints */
+        enc.copy_opaque = copy_32;
+        enc.copy_transl = copy_transl_32;
+        enc.max_opaque_run = 255;       /* runs stored as short ints */
+        enc.endsize = 4;
 
         /* worst case is alternating opaque and translucent pixels */
-        maxsize = surface->h * 2 * 4 * (surface->w + 1) + 4;
+        enc.maxsize = (size_t) surface->h * 2 * 4 * (surface->w + 1) + 4;
         break;
     default:
         return -1;              /* anything else unsupported right now */
     }
 
-    maxsize += sizeof(RLEDestFormat);
-    rlebuf = (Uint8 *) SDL_malloc(maxsize);
-    if (!rlebuf) {
-        return SDL_OutOfMemory();
-    }
-    {
-        /* save the destination format so we can undo the encoding later */
-        RLEDestFormat *r = (RLEDestFormat *) rlebuf;
-        r->BytesPerPixel = df->BytesPerPixel;
-        r->Rmask = df->Rmask;
-        r->Gmask = df->Gmask;
-        r->Bmask = df->Bmask;
-        r->Amask = df->Amask;
-        r->Rloss = df->Rloss;
-        r->Gloss = df->Gloss;
-        r->Bloss = df->Bloss;
-        r->Aloss = df->Aloss;
-        r->Rshift = df->Rshift;
-        r->Gshift = df->Gshift;
-        r->Bshift = df->Bshift;
-        r->Ashift = df->Ashift;
-    }
-    dst = rlebuf + sizeof(RLEDestFormat);
-
-    /* Do the actual encoding */
-    {
-        int x, y;
-        int h = surface->h, w = surface->w;
-        SDL_PixelFormat *sf = surface->format;
-        Uint32 *src = (Uint32 *) surface->pixels;
-        Uint8 *lastline = dst;  /* end of last non-blank line */
-
-        /* opaque counts are 8 or 16 bits, depending on target depth */
-#define ADD_OPAQUE_COUNTS(n, m)         \
-    if(df->BytesPerPixel == 4) {        \
-        ((Uint16 *)dst)[0] = n;     \
-        ((Uint16 *)dst)[1] = m;     \
-        dst += 4;               \
-    } else {                \
-        dst[0] = n;             \
-        dst[1] = m;             \
-        dst += 2;               \
-    }
-
-        /* translucent counts are always 16 bit */
-#define ADD_TRANSL_COUNTS(n, m)     \
-    (((Uint16 *)dst)[0] = n, ((Uint16 *)dst)[1] = m, dst += 4)
-
-        for (y = 0; y < h; y++) {
-            int runstart, skipstart;
-            int blankline = 0;
-            /* First encode all opaque pixels of a scan line */
-            x = 0;
-            do {
-                int run, skip, len;
-                skipstart = x;
-                while (x < w && !ISOPAQUE(src[x], sf))
-                    x++;
-                runstart = x;
-                while (x < w && ISOPAQUE(src[x], sf))
-                    x++;
-                skip = runstart - skipstart;
-                if (skip == w)
-                    blankline = 1;
-                run = x - runstart;
-                while (skip > max_opaque_run) {
-                    ADD_OPAQUE_COUNTS(max_opaque_run, 0);
-                    skip -= max_opaque_run;
-                }
-                len = MIN(run, max_opaque_run);
-                ADD_OPAQUE_COUNTS(skip, len);
-                dst += copy_opaque(dst, src + runstart, len, sf, df);
-                runstart += len;
-                run -= len;
-                while (run) {
-                    len = MIN(run, max_opaque_run);
-                    ADD_OPAQUE_COUNTS(0, len);
-                    dst += copy_opaque(dst, src + runstart, len, sf, df);
-                    runstart += len;
-                    run -= len;
-                }
-            } while (x < w);
-
-            /* Make sure the next output address is 32-bit aligned */
-            dst += (uintptr_t) dst & 2;
-
-            /* Next, encode all translucent pixels of the same scan line */
-            x = 0;
-            do {
-                int run, skip, len;
-                skipstart = x;
-                while (x < w && !ISTRANSL(src[x], sf))
-                    x++;
-                runstart = x;
-                while (x < w && ISTRANSL(src[x], sf))
-                    x++;
-                skip = runstart - skipstart;
-                blankline &= (skip == w);
-                run = x - runstart;
-                while (skip > max_transl_run) {
-                    ADD_TRANSL_COUNTS(max_transl_run, 0);
-                    skip -= max_transl_run;
-                }
-                len = MIN(run, max_transl_run);
-                ADD_TRANSL_COUNTS(skip, len);
-                dst += copy_transl(dst, src + runstart, len, sf, df);
-                runstart += len;
-                run -= len;
-                while (run) {
-                    len = MIN(run, max_transl_run);
-                    ADD_TRANSL_COUNTS(0, len);
-                    dst += copy_transl(dst, src + runstart, len, sf, df);
-                    runstart += len;
-                    run -= len;
-                }
-                if (!blankline)
-                    lastline = dst;
-            } while (x < w);
-
-            src += surface->pitch >> 2;
-        }
-        dst = lastline;         /* back up past trailing blank lines */
-        ADD_OPAQUE_COUNTS(0, 0);
-    }
-
-#undef ADD_OPAQUE_COUNTS
-#undef ADD_TRANSL_COUNTS
-
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
-        surface->pixels = NULL;
-    }
-
-    /* realloc the buffer to release unused memory */
-    {
-        Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
-        if (!p)
-            p = rlebuf;
-        surface->map->data = p;
-    }
-
-    return 0;
-}
-
-static Uint32
-getpix_8(Uint8 * srcbuf)
-{
-    return *srcbuf;
-}
+    enc.sf = surface->format;
+    enc.df = df;
+    enc.w = surface->w;
+    enc.sse2 = SDL_HasSSE2();
+    enc.encode_line = RLEAlphaLine;
 
-static Uint32
-getpix_16(Uint8 * srcbuf)
-{
-    return *(Uint16 *) srcbuf;
+    return RLEEncodeSurface(surface, &enc, old);
 }
 
-static Uint32
-getpix_24(Uint8 * srcbuf)
-{
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-    return srcbuf[0] + (srcbuf[1] << 8) + (srcbuf[2] << 16);
-#else
-    return (srcbuf[0] << 16) + (srcbuf[1] << 8) + srcbuf[2];
-#endif
-}
-
-static Uint32
-getpix_32(Uint8 * srcbuf)
-{
-    return *(Uint32 *) srcbuf;
-}
-
-typedef Uint32(*getpix_func) (Uint8 *);
-
-static const getpix_func getpixes[4] = {
-    getpix_8, getpix_16, getpix_24, getpix_32
-};
-
 static int
-RLEColorkeySurface(SDL_Surface * surface)
+RLEColorkeySurface(SDL_Surface * surface, const RLEHeader * old)
 {
-    Uint8 *rlebuf, *dst;
-    int maxn;
-    int y;
-    Uint8 *srcbuf, *lastline;
-    int maxsize = 0;
+    RLEEncoder enc;
     int bpp = surface->format->BytesPerPixel;
-    getpix_func getpix;
-    Uint32 ckey, rgbmask;
-    int w, h;
+
+    SDL_zero(enc);
 
     /* calculate the worst case size for the compressed surface */
     switch (bpp) {
     case 1:
         /* worst case is alternating opaque and transparent pixels,
            starting with an opaque pixel */
-        maxsize = surface->h * 3 * (surface->w / 2 + 1) + 2;
+        enc.maxsize = (size_t) surface->h * 3 * (surface->w / 2 + 1) + 2;
         break;
     case 2:
     case 3:
         /* worst case is solid runs, at most 255 pixels wide */
-        maxsize = surface->h * (2 * (surface->w / 255 + 1)
-                                + surface->w * bpp) + 2;
+        enc.maxsize = (size_t) surface->h * (2 * (surface->w / 255 + 1)
+                                             + surface->w * bpp) + 2;
         break;
     case 4:
         /* worst case is solid runs, at most 65535 pixels wide */
-        maxsize = surface->h * (4 * (surface->w / 65535 + 1)
-                                + surface->w * 4) + 4;
+        enc.maxsize = (size_t) surface->h * (4 * (surface->w / 65535 + 1)
+                                             + surface->w * 4) + 4;
         break;
     }
 
-    rlebuf = (Uint8 *) SDL_malloc(maxsize);
-    if (rlebuf == NULL) {
-        return SDL_OutOfMemory();
-    }
-
     /* Set up the conversion */
-    srcbuf = (Uint8 *) surface->pixels;
-    maxn = bpp == 4 ? 65535 : 255;
-    dst = rlebuf;
-    rgbmask = ~surface->format->Amask;
-    ckey = surface->map->info.colorkey & rgbmask;
-    lastline = dst;
-    getpix = getpixes[bpp - 1];
-    w = surface->w;
-    h = surface->h;
+    enc.sf = surface->format;
+    enc.w = surface->w;
+    enc.bpp = bpp;
+    enc.maxn = bpp == 4 ? 65535 : 255;
+    enc.endsize = bpp == 4 ? 4 : 2;
+    enc.rgbmask = ~surface->format->Amask;
+    enc.ckey = surface->map->info.colorkey & enc.rgbmask;
+    enc.sse2 = SDL_HasSSE2();
+    enc.encode_line = RLEColorkeyLine;
+
+    return RLEEncodeSurface(surface, &enc, old);
+}
 
-#define ADD_COUNTS(n, m)            \
-    if(bpp == 4) {              \
-        ((Uint16 *)dst)[0] = n;     \
-        ((Uint16 *)dst)[1] = m;     \
-        dst += 4;               \
-    } else {                \
-        dst[0] = n;             \
-        dst[1] = m;             \
-        dst += 2;               \
+/* encode the lines that changed since the surface was locked */
+static int
+RLEUpdateSurface(SDL_Surface * surface)
+{
+    SDL_BlitMap *map = surface->map;
+    RLEHeader *old = RLE_HEADER(map->data);
+    const size_t linesize = (size_t) surface->w * surface->format->BytesPerPixel;
+    const Uint8 *pixels = (const Uint8 *) surface->pixels;
+    int y, retval;
+
+    /* the surface may well have been locked without changing anything */
+    for (y = 0; y < surface->h; y++) {
+        const size_t offset = (size_t) y * surface->pitch;
+        if (SDL_memcmp(pixels + offset, old->snapshot + offset, linesize) != 0) {
+            break;
+        }
     }
-
-    for (y = 0; y < h; y++) {
-        int x = 0;
-        int blankline = 0;
-        do {
-            int run, skip, len;
-            int runstart;
-            int skipstart = x;
-
-            /* find run of transparent, then opaque pixels */
-            while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) == ckey)
-                x++;
-            runstart = x;
-            while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) != ckey)
-                x++;
-            skip = runstart - skipstart;
-            if (skip == w)
-                blankline = 1;
-            run = x - runstart;
-
-            /* encode segment */
-            while (skip > maxn) {
-                ADD_COUNTS(maxn, 0);
-                skip -= maxn;
-            }
-            len = MIN(run, maxn);
-            ADD_COUNTS(skip, len);
-            SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
-            dst += len * bpp;
-            run -= len;
-            runstart += len;
-            while (run) {
-                len = MIN(run, maxn);
-                ADD_COUNTS(0, len);
-                SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
-                dst += len * bpp;
-                runstart += len;
-                run -= len;
-            }
-            if (!blankline)
-                lastline = dst;
-        } while (x < w);
-
-        srcbuf += surface->pitch;
+    if (y == surface->h) {
+        SDL_free(old->snapshot);
+        old->snapshot = NULL;
+        return 0;
     }
-    dst = lastline;             /* back up bast trailing blank lines */
-    ADD_COUNTS(0, 0);
-
-#undef ADD_COUNTS
 
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
-        surface->pixels = NULL;
+    if (map->info.flags & SDL_COPY_RLE_COLORKEY) {
+        retval = RLEColorkeySurface(surface, old);
+    } else {
+        retval = RLEAlphaSurface(surface, old);
     }
-
-    /* realloc the buffer to release unused memory */
-    {
-        /* If realloc returns NULL, the original block is left intact */
-        Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
-        if (!p)
-            p = rlebuf;
-        surface->map->data = p;
+    if (retval < 0) {
+        return -1;
     }
+    RLEFreeHeader(old);
 
-    return (0);
+    return 0;
 }
 
 int
@@ -1394,7 +1616,7 @@ SDL_RLESurface(SDL_Surface * surface)
 
     /* Clear any previous RLE conversion */
     if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 1);
+        SDL_UnRLESurface(surface);
     }
 
     /* We don't support RLE encoding of bitmaps */
@@ -1416,8 +1638,8 @@ SDL_RLESurface(SDL_Surface * surface)
     /* Pass on combinations not supported */
     if ((flags & SDL_COPY_MODULATE_COLOR) ||
         ((flags & SDL_COPY_MODULATE_ALPHA) && surface->format->Amask) ||
-        (flags & (SDL_COPY_ADD | SDL_COPY_MOD)) ||
-        (flags & SDL_COPY_NEAREST)) {
+        (flags & (SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_BLEND_PREMULTIPLIED)) ||
+        (flags & (SDL_COPY_NEAREST | SDL_COPY_LINEAR))) {
         return -1;
     }
 
@@ -1426,13 +1648,13 @@ SDL_RLESurface(SDL_Surface * surface)
         if (!surface->map->identity) {
             return -1;
         }
-        if (RLEColorkeySurface(surface) < 0) {
+        if (RLEColorkeySurface(surface, NULL) < 0) {
             return -1;
         }
         surface->map->blit = SDL_RLEBlit;
         surface->map->info.flags |= SDL_COPY_RLE_COLORKEY;
     } else {
-        if (RLEAlphaSurface(surface) < 0) {
+        if (RLEAlphaSurface(surface, NULL) < 0) {
             return -1;
         }
         surface->map->blit = SDL_RLEAlphaBlit;
@@ -1446,123 +1668,42 @@ SDL_RLESurface(SDL_Surface * surface)
 }
 
 /*
- * Un-RLE a surface with pixel alpha
- * This may not give back exactly the image before RLE-encoding; all
- * completely transparent pixels will be lost, and color and alpha depth
- * may have been reduced (when encoding for 16bpp targets).
+ * Called when an encoded surface is locked. The pixels are copied, so the
+ * next blit can tell which lines were changed and encode just those.
  */
-static SDL_bool
-UnRLEAlpha(SDL_Surface * surface)
+void
+SDL_LockRLESurface(SDL_Surface * surface)
 {
-    Uint8 *srcbuf;
-    Uint32 *dst;
-    SDL_PixelFormat *sf = surface->format;
-    RLEDestFormat *df = surface->map->data;
-    int (*uncopy_opaque) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int (*uncopy_transl) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int w = surface->w;
-    int bpp = df->BytesPerPixel;
-
-    if (bpp == 2) {
-        uncopy_opaque = uncopy_opaque_16;
-        uncopy_transl = uncopy_transl_16;
-    } else {
-        uncopy_opaque = uncopy_transl = uncopy_32;
-    }
+    const size_t size = (size_t) surface->h * surface->pitch;
+    RLEHeader *header = RLE_HEADER(surface->map->data);
 
-    surface->pixels = SDL_malloc(surface->h * surface->pitch);
-    if (!surface->pixels) {
-        return (SDL_FALSE);
+    if (header->snapshot) {
+        return;                 /* not blitted since it was last locked */
     }
-    /* fill background with transparent pixels */
-    SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
 
-    dst = surface->pixels;
-    srcbuf = (Uint8 *) (df + 1);
-    for (;;) {
-        /* copy opaque pixels */
-        int ofs = 0;
-        do {
-            unsigned run;
-            if (bpp == 2) {
-                ofs += srcbuf[0];
-                run = srcbuf[1];
-                srcbuf += 2;
-            } else {
-                ofs += ((Uint16 *) srcbuf)[0];
-                run = ((Uint16 *) srcbuf)[1];
-                srcbuf += 4;
-            }
-            if (run) {
-                srcbuf += uncopy_opaque(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            } else if (!ofs)
-                return (SDL_TRUE);
-        } while (ofs < w);
-
-        /* skip padding if needed */
-        if (bpp == 2)
-            srcbuf += (uintptr_t) srcbuf & 2;
-
-        /* copy translucent pixels */
-        ofs = 0;
-        do {
-            unsigned run;
-            ofs += ((Uint16 *) srcbuf)[0];
-            run = ((Uint16 *) srcbuf)[1];
-            srcbuf += 4;
-            if (run) {
-                srcbuf += uncopy_transl(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            }
-        } while (ofs < w);
-        dst += surface->pitch >> 2;
+    header->snapshot = (Uint8 *) SDL_malloc(size);
+    if (header->snapshot) {
+        SDL_memcpy(header->snapshot, surface->pixels, size);
+    } else {
+        /* Drop the encoding, the next blit will make a new one */
+        SDL_UnRLESurface(surface);
+        SDL_InvalidateMap(surface->map);
     }
-    /* Make the compiler happy */
-    return (SDL_TRUE);
 }
 
 void
-SDL_UnRLESurface(SDL_Surface * surface, int recode)
+SDL_UnRLESurface(SDL_Surface * surface)
 {
     if (surface->flags & SDL_RLEACCEL) {
         surface->flags &= ~SDL_RLEACCEL;
-
-        if (recode && !(surface->flags & SDL_PREALLOC)) {
-            if (surface->map->info.flags & SDL_COPY_RLE_COLORKEY) {
-                SDL_Rect full;
-
-                /* re-create the original surface */
-                surface->pixels = SDL_malloc(surface->h * surface->pitch);
-                if (!surface->pixels) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
-
-                /* fill it with the background color */
-                SDL_FillRect(surface, NULL, surface->map->info.colorkey);
-
-                /* now render the encoded surface */
-                full.x = full.y = 0;
-                full.w = surface->w;
-                full.h = surface->h;
-                SDL_RLEBlit(surface, &full, surface, &full);
-            } else {
-                if (!UnRLEAlpha(surface)) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
-            }
-        }
         surface->map->info.flags &=
             ~(SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY);
 
-        SDL_free(surface->map->data);
-        surface->map->data = NULL;
+        /* The pixels were kept, so there is nothing to decode */
+        if (surface->map->data) {
+            RLEFreeHeader(RLE_HEADER(surface->map->data));
+            surface->map->data = NULL;
+        }
     }
 }
 
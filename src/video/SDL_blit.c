@@ -21,6 +21,9 @@
 #include "../SDL_internal.h"
 
 #include "SDL_video.h"
+#include "SDL_hints.h"
+#include "SDL_thread.h"
+#include "SDL_atomic.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_blit_auto.h"
@@ -29,6 +32,251 @@
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
 
+/* Large blits are split into horizontal bands and handed to a small pool
+   of worker threads, see SDL_HINT_BLIT_THREADS.  The calling thread works
+   on the bands too, and only one blit at a time uses the pool; any other
+   thread blitting at the same time just does the work itself.
+*/
+#define SDL_BLIT_THREAD_MIN_PIXELS  (512 * 512)
+#define SDL_BLIT_THREAD_MIN_ROWS    16
+#define SDL_BLIT_MAX_THREADS        16
+
+#if !SDL_THREADS_DISABLED
+typedef struct
+{
+    SDL_mutex *job_lock;
+    SDL_mutex *lock;
+    SDL_cond *wake;
+    SDL_cond *done;
+    SDL_Thread *threads[SDL_BLIT_MAX_THREADS];
+    int num_threads;
+    SDL_bool quit;
+
+    /* The current job, protected by lock */
+    SDL_BlitBandFunc func;
+    void *data;
+    int height;
+    int band_height;
+    int next_row;
+    int pending_rows;
+} SDL_BlitPool;
+
+static SDL_BlitPool SDL_blit_pool;
+static SDL_SpinLock SDL_blit_pool_spinlock;
+
+/* Called and returns with pool->lock held */
+static void
+SDL_RunNextBand(SDL_BlitPool * pool)
+{
+    const int y = pool->next_row;
+    const int h = SDL_min(pool->band_height, pool->height - y);
+
+    pool->next_row += h;
+    SDL_UnlockMutex(pool->lock);
+
+    pool->func(pool->data, y, h);
+
+    SDL_LockMutex(pool->lock);
+    pool->pending_rows -= h;
+    if (pool->pending_rows == 0) {
+        SDL_CondSignal(pool->done);
+    }
+}
+
+static int SDLCALL
+SDL_BlitWorker(void *data)
+{
+    SDL_BlitPool *pool = (SDL_BlitPool *) data;
+
+    SDL_LockMutex(pool->lock);
+    while (!pool->quit) {
+        if (pool->next_row < pool->height) {
+            SDL_RunNextBand(pool);
+        } else {
+            SDL_CondWait(pool->wake, pool->lock);
+        }
+    }
+    SDL_UnlockMutex(pool->lock);
+    return 0;
+}
+
+static void
+SDL_StopBlitWorkers(SDL_BlitPool * pool)
+{
+    int i;
+
+    if (!pool->num_threads) {
+        return;
+    }
+    SDL_LockMutex(pool->lock);
+    pool->quit = SDL_TRUE;
+    SDL_CondBroadcast(pool->wake);
+    SDL_UnlockMutex(pool->lock);
+
+    for (i = 0; i < pool->num_threads; ++i) {
+        SDL_WaitThread(pool->threads[i], NULL);
+        pool->threads[i] = NULL;
+    }
+    pool->num_threads = 0;
+    pool->quit = SDL_FALSE;
+}
+
+/* Take ownership of the pool and make sure it has the requested number of
+   workers.  Returns the number of workers available, 0 if the pool can't
+   be used right now. */
+static int
+SDL_AcquireBlitPool(SDL_BlitPool * pool, int num_threads)
+{
+    SDL_mutex *job_lock;
+
+    SDL_AtomicLock(&SDL_blit_pool_spinlock);
+    if (!pool->job_lock) {
+        if (!pool->lock) {
+            pool->lock = SDL_CreateMutex();
+        }
+        if (!pool->wake) {
+            pool->wake = SDL_CreateCond();
+        }
+        if (!pool->done) {
+            pool->done = SDL_CreateCond();
+        }
+        if (pool->lock && pool->wake && pool->done) {
+            pool->job_lock = SDL_CreateMutex();
+        }
+    }
+    job_lock = pool->job_lock;
+    SDL_AtomicUnlock(&SDL_blit_pool_spinlock);
+
+    if (!job_lock || SDL_TryLockMutex(job_lock) != 0) {
+        return 0;
+    }
+
+    if (pool->num_threads != num_threads) {
+        SDL_StopBlitWorkers(pool);
+        while (pool->num_threads < num_threads) {
+            SDL_Thread *thread = SDL_CreateThread(SDL_BlitWorker, "SDLBlitWorker", pool);
+            if (!thread) {
+                break;
+            }
+            pool->threads[pool->num_threads++] = thread;
+        }
+    }
+    if (!pool->num_threads) {
+        SDL_UnlockMutex(pool->job_lock);
+    }
+    return pool->num_threads;
+}
+#endif /* !SDL_THREADS_DISABLED */
+
+void
+SDL_RunBlitBands(SDL_BlitBandFunc func, void *data, int w, int h)
+{
+#if !SDL_THREADS_DISABLED
+    SDL_BlitPool *pool = &SDL_blit_pool;
+    const char *hint;
+    int num_threads = 0;
+
+    if (w * (Sint64) h >= SDL_BLIT_THREAD_MIN_PIXELS &&
+        h >= 2 * SDL_BLIT_THREAD_MIN_ROWS) {
+        hint = SDL_GetHint(SDL_HINT_BLIT_THREADS);
+        if (hint) {
+            num_threads = SDL_min(SDL_atoi(hint), SDL_BLIT_MAX_THREADS);
+        }
+    }
+    if (num_threads > 0) {
+        num_threads = SDL_AcquireBlitPool(pool, num_threads);
+    }
+    if (num_threads > 0) {
+        SDL_LockMutex(pool->lock);
+        pool->func = func;
+        pool->data = data;
+        pool->height = h;
+        pool->band_height = SDL_max((h + num_threads) / (num_threads + 1),
+                                    SDL_BLIT_THREAD_MIN_ROWS);
+        pool->next_row = 0;
+        pool->pending_rows = h;
+        SDL_CondBroadcast(pool->wake);
+
+        while (pool->next_row < pool->height) {
+            SDL_RunNextBand(pool);
+        }
+        while (pool->pending_rows > 0) {
+            SDL_CondWait(pool->done, pool->lock);
+        }
+        pool->func = NULL;
+        pool->data = NULL;
+        pool->height = 0;
+        pool->next_row = 0;
+        SDL_UnlockMutex(pool->lock);
+
+        SDL_UnlockMutex(pool->job_lock);
+        return;
+    }
+#endif /* !SDL_THREADS_DISABLED */
+
+    func(data, 0, h);
+}
+
+void
+SDL_BlitThreadsQuit(void)
+{
+#if !SDL_THREADS_DISABLED
+    SDL_BlitPool *pool = &SDL_blit_pool;
+    SDL_mutex *job_lock;
+
+    SDL_AtomicLock(&SDL_blit_pool_spinlock);
+    job_lock = pool->job_lock;
+    SDL_AtomicUnlock(&SDL_blit_pool_spinlock);
+
+    /* Wait for the workers without holding the spinlock */
+    if (job_lock) {
+        SDL_LockMutex(job_lock);
+        SDL_StopBlitWorkers(pool);
+        SDL_UnlockMutex(job_lock);
+    }
+
+    SDL_AtomicLock(&SDL_blit_pool_spinlock);
+    if (pool->job_lock) {
+        SDL_DestroyMutex(pool->job_lock);
+    }
+    SDL_DestroyCond(pool->done);
+    SDL_DestroyCond(pool->wake);
+    SDL_DestroyMutex(pool->lock);
+    SDL_zerop(pool);
+    SDL_AtomicUnlock(&SDL_blit_pool_spinlock);
+#endif
+}
+
+typedef struct
+{
+    SDL_BlitFunc func;
+    const SDL_BlitInfo *info;
+} SDL_SoftBlitJob;
+
+static void
+SDL_SoftBlitBand(void *data, int y, int h)
+{
+    const SDL_SoftBlitJob *job = (const SDL_SoftBlitJob *) data;
+    SDL_BlitInfo info = *job->info;
+
+    info.src += y * info.src_pitch;
+    info.dst += y * info.dst_pitch;
+    info.src_h = h;
+    info.dst_h = h;
+    job->func(&info);
+}
+
+static SDL_bool
+SDL_BlitRangesOverlap(const SDL_BlitInfo * info)
+{
+    const Uint8 *src_end = info->src + (info->src_h - 1) * info->src_pitch +
+                           info->src_w * info->src_fmt->BytesPerPixel;
+    const Uint8 *dst_end = info->dst + (info->dst_h - 1) * info->dst_pitch +
+                           info->dst_w * info->dst_fmt->BytesPerPixel;
+
+    return (info->src < dst_end && info->dst < src_end) ? SDL_TRUE : SDL_FALSE;
+}
+
 /* The general purpose software blit routine */
 static int
 SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
@@ -84,8 +332,18 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
             info->dst_pitch - info->dst_w * info->dst_fmt->BytesPerPixel;
         RunBlit = (SDL_BlitFunc) src->map->data;
 
-        /* Run the actual software blit */
-        RunBlit(info);
+        /* Run the actual software blit.  The bands run at the same time,
+           so blits between overlapping pixels (scrolling a surface onto
+           itself) are done in a single top to bottom pass. */
+        if (info->src_w == info->dst_w && info->src_h == info->dst_h &&
+            !SDL_BlitRangesOverlap(info)) {
+            SDL_SoftBlitJob job;
+            job.func = RunBlit;
+            job.info = info;
+            SDL_RunBlitBands(SDL_SoftBlitBand, &job, info->dst_w, info->dst_h);
+        } else {
+            RunBlit(info);
+        }
     }
 
     /* We need to unlock the surfaces if they're locked */
@@ -182,7 +440,8 @@ SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
         /* Check blend flags */
         flagcheck =
             (flags &
-             (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD));
+             (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD |
+              SDL_COPY_BLEND_PREMULTIPLIED));
         if ((flagcheck & entries[i].flags) != flagcheck) {
             continue;
         }
@@ -218,10 +477,11 @@ SDL_CalculateBlit(SDL_Surface * surface)
     SDL_BlitFunc blit = NULL;
     SDL_BlitMap *map = surface->map;
     SDL_Surface *dst = map->dst;
+    int linear;
 
     /* Clean everything out to start */
     if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 1);
+        SDL_UnRLESurface(surface);
     }
     map->blit = SDL_SoftBlit;
     map->info.src_fmt = surface->format;
@@ -236,6 +496,11 @@ SDL_CalculateBlit(SDL_Surface * surface)
         }
     }
 
+    /* Linear scaling filters each row in the source format and passes it
+       on to the unscaled blitter, so choose that one as usual */
+    linear = (map->info.flags & SDL_COPY_LINEAR);
+    map->info.flags &= ~SDL_COPY_LINEAR;
+
     /* Choose a standard blit function */
     if (map->identity && !(map->info.flags & ~SDL_COPY_RLE_DESIRED)) {
         blit = SDL_BlitCopy;
@@ -245,7 +510,7 @@ SDL_CalculateBlit(SDL_Surface * surface)
     } else if (surface->format->BytesPerPixel == 1 &&
                SDL_ISPIXELFORMAT_INDEXED(surface->format->format)) {
         blit = SDL_CalculateBlit1(surface);
-    } else if (map->info.flags & SDL_COPY_BLEND) {
+    } else if (map->info.flags & (SDL_COPY_BLEND | SDL_COPY_BLEND_PREMULTIPLIED)) {
         blit = SDL_CalculateBlitA(surface);
     } else {
         blit = SDL_CalculateBlitN(surface);
@@ -274,6 +539,11 @@ SDL_CalculateBlit(SDL_Surface * surface)
     }
     map->data = blit;
 
+    if (linear) {
+        map->info.flags |= SDL_COPY_LINEAR;
+        map->blit = SDL_StretchLinearBlit;
+    }
+
     /* Make sure we have a blit function */
     if (blit == NULL) {
         SDL_InvalidateMap(map);
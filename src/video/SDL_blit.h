@@ -36,8 +36,10 @@ extern Uint8* SDL_expand_byte[9];
 #define SDL_COPY_BLEND              0x00000010
 #define SDL_COPY_ADD                0x00000020
 #define SDL_COPY_MOD                0x00000040
+#define SDL_COPY_BLEND_PREMULTIPLIED 0x00000080
 #define SDL_COPY_COLORKEY           0x00000100
 #define SDL_COPY_NEAREST            0x00000200
+#define SDL_COPY_LINEAR             0x00000400
 #define SDL_COPY_RLE_DESIRED        0x00001000
 #define SDL_COPY_RLE_COLORKEY       0x00002000
 #define SDL_COPY_RLE_ALPHAKEY       0x00004000
@@ -81,6 +83,31 @@ typedef struct
     SDL_BlitFunc func;
 } SDL_BlitFuncEntry;
 
+/* The parameters a blit mapping was calculated for */
+typedef struct
+{
+    SDL_Palette *dst_palette;
+    Uint32 dst_format;
+    Uint32 dst_palette_version;
+    Uint32 src_palette_version;
+    int flags;
+    Uint32 colorkey;
+    Uint8 r, g, b, a;
+} SDL_BlitMapKey;
+
+/* A mapping kept around after the blit map moved on to another destination.
+   It holds a reference to the destination palette, if any. */
+typedef struct
+{
+    SDL_BlitMapKey key;
+    int identity;
+    SDL_blit blit;
+    void *data;
+    Uint8 *table;
+} SDL_BlitMapCacheEntry;
+
+#define SDL_BLITMAP_CACHE_SIZE  4
+
 /* Blit mapping definition */
 typedef struct SDL_BlitMap
 {
@@ -89,16 +116,37 @@ typedef struct SDL_BlitMap
     SDL_blit blit;
     void *data;
     SDL_BlitInfo info;
+    SDL_ScaleMode scale_mode;
 
     /* the version count matches the destination; mismatch indicates
        an invalid mapping */
     Uint32 dst_palette_version;
     Uint32 src_palette_version;
+
+    /* what the current mapping was calculated for, and previous mappings
+       to other destinations, most recently used first */
+    SDL_BlitMapKey key;
+    SDL_BlitMapCacheEntry cache[SDL_BLITMAP_CACHE_SIZE];
+    int num_cached;
+
+    /* the surface's pixels have an SDL_PixelBuffer header; kept here so
+       the surface flags callers see are only the public ones */
+    SDL_bool pixelbuffer;
 } SDL_BlitMap;
 
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface * surface);
 
+/* Run a job over the rows of a blit, split in bands when it's worth it */
+typedef void (*SDL_BlitBandFunc) (void *data, int y, int h);
+extern void SDL_RunBlitBands(SDL_BlitBandFunc func, void *data, int w, int h);
+extern void SDL_BlitThreadsQuit(void);
+
+/* Functions found in SDL_stretch.c */
+extern SDL_bool SDL_CanStretchLinear(SDL_Surface * surface);
+extern int SDL_StretchLinearBlit(SDL_Surface * src, SDL_Rect * srcrect,
+                                 SDL_Surface * dst, SDL_Rect * dstrect);
+
 /* Functions found in SDL_blit_*.c */
 extern SDL_BlitFunc SDL_CalculateBlit0(SDL_Surface * surface);
 extern SDL_BlitFunc SDL_CalculateBlit1(SDL_Surface * surface);
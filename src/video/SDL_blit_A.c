@@ -1264,6 +1264,113 @@ BlitNtoNPixelAlpha(SDL_BlitInfo * info)
     }
 }
 
+/* Blend a premultiplied pixel: dst = src + dst * (255 - srcA) / 255, for the
+   alpha as well as the colors.  Each x * y / 255 is rounded as
+   (t + (t >> 8)) >> 8 with t = x * y + 128, which is exact for 8-bit values,
+   and the sum saturates in case the colors exceed their alpha. */
+static SDL_INLINE Uint32
+PremultipliedAlphaBlend(Uint32 s, Uint32 d, Uint32 inva)
+{
+    Uint32 rb = (d & 0x00ff00ff) * inva + 0x00800080;
+    Uint32 ag = ((d >> 8) & 0x00ff00ff) * inva + 0x00800080;
+    Uint32 carry;
+
+    rb = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+    ag = ((ag + ((ag >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+    rb += s & 0x00ff00ff;
+    ag += (s >> 8) & 0x00ff00ff;
+    carry = rb & 0x01000100;
+    rb = (rb | (carry - (carry >> 8))) & 0x00ff00ff;
+    carry = ag & 0x01000100;
+    ag = (ag | (carry - (carry >> 8))) & 0x00ff00ff;
+    return rb | (ag << 8);
+}
+
+/* fast RGB888->(A)RGB888 blending of premultiplied pixels, any alpha byte */
+static void
+BlitRGBtoRGBPremultipliedAlpha(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const Uint32 ashift = info->src_fmt->Ashift;
+
+    while (height--) {
+	    /* *INDENT-OFF* */
+	    DUFFS_LOOP4({
+		Uint32 s = *srcp;
+		Uint32 alpha = (s >> ashift) & 0xff;
+		if (alpha == SDL_ALPHA_OPAQUE) {
+		    *dstp = s;
+		} else if (s) {
+		    *dstp = PremultipliedAlphaBlend(s, *dstp, alpha ^ 0xff);
+		}
+		++srcp;
+		++dstp;
+	    }, width);
+	    /* *INDENT-ON* */
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+#ifdef __SSE2__
+/* The same blend as above, four pixels at a time */
+static void
+BlitRGBtoRGBPremultipliedAlphaSSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const Uint32 ashift = info->src_fmt->Ashift;
+    const __m128i shift = _mm_cvtsi32_si128((int) ashift);
+    const __m128i mask = _mm_set1_epi32(0xff);
+    const __m128i round = _mm_set1_epi16(0x80);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (height--) {
+        int n = width;
+
+        for (; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) srcp);
+            const __m128i d = _mm_loadu_si128((const __m128i *) dstp);
+            __m128i inva, lo, hi;
+
+            /* 255 - alpha, spread over the four channels of each pixel */
+            inva = _mm_andnot_si128(_mm_srl_epi32(s, shift), mask);
+            inva = _mm_or_si128(inva, _mm_slli_epi32(inva, 16));
+
+            lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero),
+                                 _mm_unpacklo_epi32(inva, inva));
+            hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero),
+                                 _mm_unpackhi_epi32(inva, inva));
+            lo = _mm_add_epi16(lo, round);
+            hi = _mm_add_epi16(hi, round);
+            lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+            _mm_storeu_si128((__m128i *) dstp,
+                             _mm_adds_epu8(s, _mm_packus_epi16(lo, hi)));
+        }
+        for (; n > 0; --n, ++srcp, ++dstp) {
+            const Uint32 s = *srcp;
+            const Uint32 alpha = (s >> ashift) & 0xff;
+            if (alpha == SDL_ALPHA_OPAQUE) {
+                *dstp = s;
+            } else if (s) {
+                *dstp = PremultipliedAlphaBlend(s, *dstp, alpha ^ 0xff);
+            }
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+#endif /* __SSE2__ */
 
 SDL_BlitFunc
 SDL_CalculateBlitA(SDL_Surface * surface)
@@ -1380,6 +1487,22 @@ SDL_CalculateBlitA(SDL_Surface * surface)
             }
         }
         break;
+
+    case SDL_COPY_BLEND_PREMULTIPLIED:
+        /* Any layout of 8-bit channels works, as long as it's the same */
+        if (sf->BytesPerPixel == 4 && df->BytesPerPixel == 4
+            && sf->Rmask == df->Rmask
+            && sf->Gmask == df->Gmask
+            && sf->Bmask == df->Bmask
+            && sf->Amask && sf->Aloss == 0
+            && (df->Amask == sf->Amask || df->Amask == 0)) {
+#ifdef __SSE2__
+            if (SDL_HasSSE2())
+                return BlitRGBtoRGBPremultipliedAlphaSSE2;
+#endif
+            return BlitRGBtoRGBPremultipliedAlpha;
+        }
+        break;
     }
 
     return NULL;
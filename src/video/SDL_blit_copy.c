@@ -25,12 +25,21 @@
 #include "SDL_blit_copy.h"
 
 
+/* Copies of at least this many bytes stream past the cache, like large
+   fills do, smaller ones are left in the cache where they're likely to be
+   used again soon */
+#define SDL_BLITCOPY_STREAM_MIN_BYTES   (512 * 1024)
+
+/* Rows narrower than this go through the cache even in large copies,
+   since partial lines flush the write combining buffers early */
+#define SDL_BLITCOPY_STREAM_MIN_ROW     256
+
 #ifdef __SSE__
 /* This assumes 16-byte aligned src and dst */
 static SDL_INLINE void
-SDL_memcpySSE(Uint8 * dst, const Uint8 * src, int len)
+SDL_memcpySSE(Uint8 * dst, const Uint8 * src, size_t len)
 {
-    int i;
+    size_t i;
 
     __m128 values[4];
     for (i = len / 64; i--;) {
@@ -50,6 +59,31 @@ SDL_memcpySSE(Uint8 * dst, const Uint8 * src, int len)
     if (len & 63)
         SDL_memcpy(dst, src, len & 63);
 }
+
+/* This assumes 16-byte aligned dst, src can be anywhere */
+static SDL_INLINE void
+SDL_memcpySSEUnalignedSrc(Uint8 * dst, const Uint8 * src, size_t len)
+{
+    size_t i;
+
+    __m128 values[4];
+    for (i = len / 64; i--;) {
+        _mm_prefetch(src, _MM_HINT_NTA);
+        values[0] = _mm_loadu_ps((const float *) (src + 0));
+        values[1] = _mm_loadu_ps((const float *) (src + 16));
+        values[2] = _mm_loadu_ps((const float *) (src + 32));
+        values[3] = _mm_loadu_ps((const float *) (src + 48));
+        _mm_stream_ps((float *) (dst + 0), values[0]);
+        _mm_stream_ps((float *) (dst + 16), values[1]);
+        _mm_stream_ps((float *) (dst + 32), values[2]);
+        _mm_stream_ps((float *) (dst + 48), values[3]);
+        src += 64;
+        dst += 64;
+    }
+
+    if (len & 63)
+        SDL_memcpy(dst, src, len & 63);
+}
 #endif /* __SSE__ */
 
 #ifdef __MMX__
@@ -118,14 +152,32 @@ SDL_BlitCopy(SDL_BlitInfo * info)
     }
 
 #ifdef __SSE__
-    if (SDL_HasSSE() &&
-        !((uintptr_t) src & 15) && !(srcskip & 15) &&
-        !((uintptr_t) dst & 15) && !(dstskip & 15)) {
-        while (h--) {
-            SDL_memcpySSE(dst, src, w);
-            src += srcskip;
-            dst += dstskip;
+    if (SDL_HasSSE() && !((uintptr_t) dst & 15) && !(dstskip & 15) &&
+        (size_t) w * h >= SDL_BLITCOPY_STREAM_MIN_BYTES &&
+        (w >= SDL_BLITCOPY_STREAM_MIN_ROW || (srcskip == w && dstskip == w))) {
+        size_t len = w;
+
+        /* Whole surfaces with no row padding are copied in one go */
+        if (srcskip == w && dstskip == w) {
+            len *= h;
+            h = 1;
+        }
+        if (!((uintptr_t) src & 15) && !(srcskip & 15)) {
+            while (h--) {
+                SDL_memcpySSE(dst, src, len);
+                src += srcskip;
+                dst += dstskip;
+            }
+        } else {
+            while (h--) {
+                SDL_memcpySSEUnalignedSrc(dst, src, len);
+                src += srcskip;
+                dst += dstskip;
+            }
         }
+        /* The streaming stores are weakly ordered, make them visible before
+           anything else touches the destination */
+        _mm_sfence();
         return;
     }
 #endif
@@ -77,13 +77,86 @@ static void CorrectAlphaChannel(SDL_Surface *surface)
     }
 }
 
+/* Memory streams are used in place instead of copying through SDL_RWread() */
+static const Uint8 *
+GetMemoryData(SDL_RWops * src, size_t *available)
+{
+    if (src->type != SDL_RWOPS_MEMORY && src->type != SDL_RWOPS_MEMORY_RO) {
+        return NULL;
+    }
+    if (SDL_RWseek(src, 0, RW_SEEK_CUR) !=
+        (Sint64) (src->hidden.mem.here - src->hidden.mem.base)) {
+        return NULL;
+    }
+    *available = (size_t) (src->hidden.mem.stop - src->hidden.mem.here);
+    return src->hidden.mem.here;
+}
+
+static void
+ExpandBMPRow(Uint8 * dst, const Uint8 * src, int w, int bits)
+{
+    int i;
+
+    if (bits == 1) {
+        for (i = 0; i + 8 <= w; i += 8) {
+            const Uint8 pixel = *src++;
+            dst[i + 0] = (pixel >> 7);
+            dst[i + 1] = (pixel >> 6) & 1;
+            dst[i + 2] = (pixel >> 5) & 1;
+            dst[i + 3] = (pixel >> 4) & 1;
+            dst[i + 4] = (pixel >> 3) & 1;
+            dst[i + 5] = (pixel >> 2) & 1;
+            dst[i + 6] = (pixel >> 1) & 1;
+            dst[i + 7] = (pixel & 1);
+        }
+        for (; i < w; ++i) {
+            dst[i] = (*src >> (7 - (i & 7))) & 1;
+        }
+    } else {
+        for (i = 0; i + 2 <= w; i += 2) {
+            const Uint8 pixel = *src++;
+            dst[i + 0] = (pixel >> 4);
+            dst[i + 1] = (pixel & 0x0F);
+        }
+        if (i < w) {
+            dst[i] = (*src >> 4);
+        }
+    }
+}
+
+/* Turn a bottom-up image read straight into the surface right side up */
+static void
+FlipRows(SDL_Surface * surface)
+{
+    Uint8 tmp[4096];
+    Uint8 *top = (Uint8 *) surface->pixels;
+    Uint8 *bottom = top + (surface->h - 1) * surface->pitch;
+
+    while (top < bottom) {
+        int offset = 0;
+        while (offset < surface->pitch) {
+            const int len = SDL_min(surface->pitch - offset, (int) sizeof(tmp));
+            SDL_memcpy(tmp, top + offset, len);
+            SDL_memcpy(top + offset, bottom + offset, len);
+            SDL_memcpy(bottom + offset, tmp, len);
+            offset += len;
+        }
+        top += surface->pitch;
+        bottom -= surface->pitch;
+    }
+}
+
 SDL_Surface *
 SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
 {
     SDL_bool was_error;
     Sint64 fp_offset = 0;
     int bmpPitch;
+    int srcPitch;
     int i, pad;
+    size_t needed, available;
+    const Uint8 *data;
+    Uint8 *buffer = NULL;
     SDL_Surface *surface;
     Uint32 Rmask = 0;
     Uint32 Gmask = 0;
@@ -91,7 +164,6 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     Uint32 Amask = 0;
     SDL_Palette *palette;
     Uint8 *bits;
-    Uint8 *top, *end;
     SDL_bool topDown;
     int ExpandBMP;
     SDL_bool haveRGBMasks = SDL_FALSE;
@@ -322,121 +394,154 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         } else if ((int) biClrUsed < palette->ncolors) {
             palette->ncolors = biClrUsed;
         }
-        if (biSize == 12) {
-            for (i = 0; i < (int) biClrUsed; ++i) {
-                SDL_RWread(src, &palette->colors[i].b, 1, 1);
-                SDL_RWread(src, &palette->colors[i].g, 1, 1);
-                SDL_RWread(src, &palette->colors[i].r, 1, 1);
-                palette->colors[i].a = SDL_ALPHA_OPAQUE;
+        if ((int) biClrUsed > 0) {
+            /* Read the whole palette at once, then unpack it */
+            const int entrySize = (biSize == 12) ? 3 : 4;
+            const Uint8 *entry;
+
+            buffer = (Uint8 *) SDL_malloc(biClrUsed * entrySize);
+            if (!buffer) {
+                SDL_OutOfMemory();
+                was_error = SDL_TRUE;
+                goto done;
             }
-        } else {
+            if (SDL_RWread(src, buffer, entrySize, biClrUsed) != biClrUsed) {
+                SDL_Error(SDL_EFREAD);
+                was_error = SDL_TRUE;
+                goto done;
+            }
+            entry = buffer;
             for (i = 0; i < (int) biClrUsed; ++i) {
-                SDL_RWread(src, &palette->colors[i].b, 1, 1);
-                SDL_RWread(src, &palette->colors[i].g, 1, 1);
-                SDL_RWread(src, &palette->colors[i].r, 1, 1);
-                SDL_RWread(src, &palette->colors[i].a, 1, 1);
+                palette->colors[i].b = entry[0];
+                palette->colors[i].g = entry[1];
+                palette->colors[i].r = entry[2];
 
                 /* According to Microsoft documentation, the fourth element
-                   is reserved and must be zero, so we shouldn't treat it as
-                   alpha.
+                   (if any) is reserved and must be zero, so we shouldn't
+                   treat it as alpha.
                 */
                 palette->colors[i].a = SDL_ALPHA_OPAQUE;
+                entry += entrySize;
             }
+            SDL_free(buffer);
+            buffer = NULL;
         }
     }
 
-    /* Read the surface pixels.  Note that the bmp image is upside down */
+    /* Read the surface pixels */
     if (SDL_RWseek(src, fp_offset + bfOffBits, RW_SEEK_SET) < 0) {
         SDL_Error(SDL_EFSEEK);
         was_error = SDL_TRUE;
         goto done;
     }
-    top = (Uint8 *)surface->pixels;
-    end = (Uint8 *)surface->pixels+(surface->h*surface->pitch);
     switch (ExpandBMP) {
     case 1:
         bmpPitch = (biWidth + 7) >> 3;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
         break;
     case 4:
         bmpPitch = (biWidth + 1) >> 1;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
         break;
     default:
-        pad = ((surface->pitch % 4) ? (4 - (surface->pitch % 4)) : 0);
+        bmpPitch = surface->w * surface->format->BytesPerPixel;
         break;
     }
-    if (topDown) {
-        bits = top;
+    pad = ((bmpPitch % 4) ? (4 - (bmpPitch % 4)) : 0);
+    srcPitch = bmpPitch + pad;
+
+    /* The padding after the last row is optional */
+    needed = 0;
+    if (surface->h > 0) {
+        needed = (size_t) srcPitch * (surface->h - 1) + bmpPitch;
+    }
+
+    /* Get all of the pixel data with a single read, straight into the
+       surface if the rows already have the right layout */
+    data = GetMemoryData(src, &available);
+    if (data) {
+        if (available < needed) {
+            SDL_Error(SDL_EFREAD);
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        SDL_RWseek(src, SDL_min(available, needed + pad), RW_SEEK_CUR);
+    } else if (!ExpandBMP && srcPitch == surface->pitch) {
+        if (SDL_RWread(src, surface->pixels, 1, needed) != needed) {
+            SDL_Error(SDL_EFREAD);
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        if (pad) {
+            /* Skip the optional padding so we're at the end of the image */
+            SDL_RWseek(src, pad, RW_SEEK_CUR);
+        }
+        if (!topDown) {
+            FlipRows(surface);
+        }
     } else {
-        bits = end - surface->pitch;
+        buffer = (Uint8 *) SDL_malloc(needed ? needed : 1);
+        if (!buffer) {
+            SDL_OutOfMemory();
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        if (SDL_RWread(src, buffer, 1, needed) != needed) {
+            SDL_Error(SDL_EFREAD);
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        if (pad) {
+            SDL_RWseek(src, pad, RW_SEEK_CUR);
+        }
+        data = buffer;
     }
-    while (bits >= top && bits < end) {
-        switch (ExpandBMP) {
-        case 1:
-        case 4:{
-                Uint8 pixel = 0;
-                int shift = (8 - ExpandBMP);
-                for (i = 0; i < surface->w; ++i) {
-                    if (i % (8 / ExpandBMP) == 0) {
-                        if (!SDL_RWread(src, &pixel, 1, 1)) {
-                            SDL_SetError("Error reading from BMP");
-                            was_error = SDL_TRUE;
-                            goto done;
-                        }
-                    }
-                    *(bits + i) = (pixel >> shift);
-                    pixel <<= ExpandBMP;
-                }
-            }
-            break;
 
-        default:
-            if (SDL_RWread(src, bits, 1, surface->pitch)
-                != surface->pitch) {
-                SDL_Error(SDL_EFREAD);
-                was_error = SDL_TRUE;
-                goto done;
+    /* Copy the rows over, note that the bmp image is upside down */
+    if (data) {
+        bits = (Uint8 *) surface->pixels;
+        for (i = 0; i < surface->h; ++i) {
+            const Uint8 *row = data + (size_t) srcPitch *
+                (topDown ? i : (surface->h - 1 - i));
+            if (ExpandBMP) {
+                ExpandBMPRow(bits, row, surface->w, ExpandBMP);
+            } else {
+                SDL_memcpy(bits, row, bmpPitch);
             }
+            bits += surface->pitch;
+        }
+    }
+
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            /* Byte-swap the pixels if needed. Note that the 24bpp
-               case has already been taken care of above. */
-            switch (biBitCount) {
-            case 15:
-            case 16:{
-                    Uint16 *pix = (Uint16 *) bits;
-                    for (i = 0; i < surface->w; i++)
-                        pix[i] = SDL_Swap16(pix[i]);
-                    break;
-                }
+    /* Byte-swap the pixels if needed. Note that the 24bpp
+       case has already been taken care of above. */
+    bits = (Uint8 *) surface->pixels;
+    for (i = 0; i < surface->h; ++i) {
+        int x;
 
-            case 32:{
-                    Uint32 *pix = (Uint32 *) bits;
-                    for (i = 0; i < surface->w; i++)
-                        pix[i] = SDL_Swap32(pix[i]);
-                    break;
-                }
+        switch (biBitCount) {
+        case 15:
+        case 16:{
+                Uint16 *pix = (Uint16 *) bits;
+                for (x = 0; x < surface->w; x++)
+                    pix[x] = SDL_Swap16(pix[x]);
+                break;
             }
-#endif
-            break;
-        }
-        /* Skip padding bytes, ugh */
-        if (pad) {
-            Uint8 padbyte;
-            for (i = 0; i < pad; ++i) {
-                SDL_RWread(src, &padbyte, 1, 1);
+
+        case 32:{
+                Uint32 *pix = (Uint32 *) bits;
+                for (x = 0; x < surface->w; x++)
+                    pix[x] = SDL_Swap32(pix[x]);
+                break;
             }
         }
-        if (topDown) {
-            bits += surface->pitch;
-        } else {
-            bits -= surface->pitch;
-        }
+        bits += surface->pitch;
     }
+#endif
+
     if (correctAlpha) {
         CorrectAlphaChannel(surface);
     }
   done:
+    SDL_free(buffer);
     if (was_error) {
         if (src) {
             SDL_RWseek(src, fp_offset, RW_SEEK_SET);
@@ -450,10 +555,40 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     return (surface);
 }
 
+#define BMP_STAGING_SIZE    (64 * 1024)
+
+static Uint8 *
+PutLE16(Uint8 * out, Uint16 value)
+{
+    out[0] = (Uint8) value;
+    out[1] = (Uint8) (value >> 8);
+    return out + 2;
+}
+
+static Uint8 *
+PutLE32(Uint8 * out, Uint32 value)
+{
+    out[0] = (Uint8) value;
+    out[1] = (Uint8) (value >> 8);
+    out[2] = (Uint8) (value >> 16);
+    out[3] = (Uint8) (value >> 24);
+    return out + 4;
+}
+
+static SDL_bool
+FlushStaging(SDL_RWops * dst, const Uint8 * staging, const Uint8 * out)
+{
+    const size_t len = (size_t) (out - staging);
+    if (len && SDL_RWwrite(dst, staging, 1, len) != len) {
+        SDL_Error(SDL_EFWRITE);
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
 int
 SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
 {
-    Sint64 fp_offset;
     int i, pad;
     SDL_Surface *surface;
     Uint8 *bits;
@@ -539,21 +674,18 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
 
     if (surface && (SDL_LockSurface(surface) == 0)) {
         const int bw = surface->w * surface->format->BytesPerPixel;
+        const int ncolors = surface->format->palette ?
+            surface->format->palette->ncolors : 0;
+        size_t stagingSize;
+        Uint8 *staging, *out;
+
+        pad = ((bw % 4) ? (4 - (bw % 4)) : 0);
 
         /* Set the BMP file header values */
-        bfSize = 0;             /* We'll write this when we're done */
         bfReserved1 = 0;
         bfReserved2 = 0;
-        bfOffBits = 0;          /* We'll write this when we're done */
-
-        /* Write the BMP file header values */
-        fp_offset = SDL_RWtell(dst);
-        SDL_ClearError();
-        SDL_RWwrite(dst, magic, 2, 1);
-        SDL_WriteLE32(dst, bfSize);
-        SDL_WriteLE16(dst, bfReserved1);
-        SDL_WriteLE16(dst, bfReserved2);
-        SDL_WriteLE32(dst, bfOffBits);
+        bfOffBits = 14 + 40 + ncolors * 4;
+        bfSize = bfOffBits + surface->h * (bw + pad);
 
         /* Set the BMP info values */
         biSize = 40;
@@ -565,76 +697,70 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
         biSizeImage = surface->h * surface->pitch;
         biXPelsPerMeter = 0;
         biYPelsPerMeter = 0;
-        if (surface->format->palette) {
-            biClrUsed = surface->format->palette->ncolors;
-        } else {
-            biClrUsed = 0;
-        }
+        biClrUsed = ncolors;
         biClrImportant = 0;
 
-        /* Write the BMP info values */
-        SDL_WriteLE32(dst, biSize);
-        SDL_WriteLE32(dst, biWidth);
-        SDL_WriteLE32(dst, biHeight);
-        SDL_WriteLE16(dst, biPlanes);
-        SDL_WriteLE16(dst, biBitCount);
-        SDL_WriteLE32(dst, biCompression);
-        SDL_WriteLE32(dst, biSizeImage);
-        SDL_WriteLE32(dst, biXPelsPerMeter);
-        SDL_WriteLE32(dst, biYPelsPerMeter);
-        SDL_WriteLE32(dst, biClrUsed);
-        SDL_WriteLE32(dst, biClrImportant);
-
-        /* Write the palette (in BGR color order) */
-        if (surface->format->palette) {
-            SDL_Color *colors;
-            int ncolors;
+        /* Everything goes through a staging buffer, which is written out
+           whenever it fills up, instead of one write per row */
+        stagingSize = SDL_max(BMP_STAGING_SIZE, bfOffBits);
+        stagingSize = SDL_max(stagingSize, (size_t) (bw + pad));
+        staging = (Uint8 *) SDL_malloc(stagingSize);
 
-            colors = surface->format->palette->colors;
-            ncolors = surface->format->palette->ncolors;
+        SDL_ClearError();
+        if (!staging) {
+            SDL_OutOfMemory();
+        } else {
+            /* The BMP file header */
+            out = staging;
+            *out++ = magic[0];
+            *out++ = magic[1];
+            out = PutLE32(out, bfSize);
+            out = PutLE16(out, bfReserved1);
+            out = PutLE16(out, bfReserved2);
+            out = PutLE32(out, bfOffBits);
+
+            /* The BMP info header */
+            out = PutLE32(out, biSize);
+            out = PutLE32(out, biWidth);
+            out = PutLE32(out, biHeight);
+            out = PutLE16(out, biPlanes);
+            out = PutLE16(out, biBitCount);
+            out = PutLE32(out, biCompression);
+            out = PutLE32(out, biSizeImage);
+            out = PutLE32(out, biXPelsPerMeter);
+            out = PutLE32(out, biYPelsPerMeter);
+            out = PutLE32(out, biClrUsed);
+            out = PutLE32(out, biClrImportant);
+
+            /* The palette (in BGR color order) */
             for (i = 0; i < ncolors; ++i) {
-                SDL_RWwrite(dst, &colors[i].b, 1, 1);
-                SDL_RWwrite(dst, &colors[i].g, 1, 1);
-                SDL_RWwrite(dst, &colors[i].r, 1, 1);
-                SDL_RWwrite(dst, &colors[i].a, 1, 1);
+                const SDL_Color *color = &surface->format->palette->colors[i];
+                *out++ = color->b;
+                *out++ = color->g;
+                *out++ = color->r;
+                *out++ = color->a;
             }
-        }
-
-        /* Write the bitmap offset */
-        bfOffBits = (Uint32)(SDL_RWtell(dst) - fp_offset);
-        if (SDL_RWseek(dst, fp_offset + 10, RW_SEEK_SET) < 0) {
-            SDL_Error(SDL_EFSEEK);
-        }
-        SDL_WriteLE32(dst, bfOffBits);
-        if (SDL_RWseek(dst, fp_offset + bfOffBits, RW_SEEK_SET) < 0) {
-            SDL_Error(SDL_EFSEEK);
-        }
 
-        /* Write the bitmap image upside down */
-        bits = (Uint8 *) surface->pixels + (surface->h * surface->pitch);
-        pad = ((bw % 4) ? (4 - (bw % 4)) : 0);
-        while (bits > (Uint8 *) surface->pixels) {
-            bits -= surface->pitch;
-            if (SDL_RWwrite(dst, bits, 1, bw) != bw) {
-                SDL_Error(SDL_EFWRITE);
-                break;
-            }
-            if (pad) {
-                const Uint8 padbyte = 0;
+            /* The bitmap image upside down */
+            bits = (Uint8 *) surface->pixels + (surface->h * surface->pitch);
+            while (bits > (Uint8 *) surface->pixels) {
+                if ((size_t) (out - staging) + bw + pad > stagingSize) {
+                    if (!FlushStaging(dst, staging, out)) {
+                        break;
+                    }
+                    out = staging;
+                }
+                bits -= surface->pitch;
+                SDL_memcpy(out, bits, bw);
+                out += bw;
                 for (i = 0; i < pad; ++i) {
-                    SDL_RWwrite(dst, &padbyte, 1, 1);
+                    *out++ = 0;
                 }
             }
-        }
-
-        /* Write the BMP file size */
-        bfSize = (Uint32)(SDL_RWtell(dst) - fp_offset);
-        if (SDL_RWseek(dst, fp_offset + 2, RW_SEEK_SET) < 0) {
-            SDL_Error(SDL_EFSEEK);
-        }
-        SDL_WriteLE32(dst, bfSize);
-        if (SDL_RWseek(dst, fp_offset + bfSize, RW_SEEK_SET) < 0) {
-            SDL_Error(SDL_EFSEEK);
+            if (bits == (Uint8 *) surface->pixels) {
+                FlushStaging(dst, staging, out);
+            }
+            SDL_free(staging);
         }
 
         /* Close it up.. */
@@ -24,41 +24,61 @@
 #include "SDL_blit.h"
 
 
+/* Fills covering at least this many bytes stream past the cache instead of
+   going through it, where they would only evict everything else */
+#define SDL_FILLRECT_STREAM_MIN_BYTES   (512 * 1024)
+
+/* Rows narrower than this are left to the cache even in streaming fills,
+   since partial lines flush the write combining buffers early */
+#define SDL_FILLRECT_STREAM_MIN_ROW     256
+
 #ifdef __SSE__
 /* *INDENT-OFF* */
 
-#ifdef _MSC_VER
+/* Broadcast from a register; building the vector in memory stalls the
+   load on the four smaller stores before it */
 #define SSE_BEGIN \
     __m128 c128; \
-    c128.m128_u32[0] = color; \
-    c128.m128_u32[1] = color; \
-    c128.m128_u32[2] = color; \
-    c128.m128_u32[3] = color;
-#else
-#define SSE_BEGIN \
-    __m128 c128; \
-    DECLARE_ALIGNED(Uint32, cccc[4], 16); \
-    cccc[0] = color; \
-    cccc[1] = color; \
-    cccc[2] = color; \
-    cccc[3] = color; \
-    c128 = *(__m128 *)cccc;
-#endif
+    union { Uint32 u; float f; } cccc; \
+    cccc.u = color; \
+    c128 = _mm_set_ps1(cccc.f);
 
-#define SSE_WORK \
+#define SSE_WORK(store) \
     for (i = n / 64; i--;) { \
-        _mm_stream_ps((float *)(p+0), c128); \
-        _mm_stream_ps((float *)(p+16), c128); \
-        _mm_stream_ps((float *)(p+32), c128); \
-        _mm_stream_ps((float *)(p+48), c128); \
+        store((float *)(p+0), c128); \
+        store((float *)(p+16), c128); \
+        store((float *)(p+32), c128); \
+        store((float *)(p+48), c128); \
         p += 64; \
+    } \
+    for (i = (n & 63) / 16; i--;) { \
+        store((float *)p, c128); \
+        p += 16; \
     }
 
-#define SSE_END
+/* The streaming stores have to be visible before the fill is done,
+   which matters when other threads did part of it */
+#define SSE_END_STREAM \
+    _mm_sfence();
+
+#define SSE_END_STORE
+
+/* Fill 'count' pixels one at a time, or with memset for bytes */
+#define SSE_FILL_SCALAR(bpp, type, count) \
+    if (bpp == 1) { \
+        SDL_memset(p, color, count); \
+        p += count; \
+    } else { \
+        int j = count; \
+        while (j--) { \
+            *((type *)p) = (type)color; \
+            p += bpp; \
+        } \
+    }
 
-#define DEFINE_SSE_FILLRECT(bpp, type) \
+#define DEFINE_SSE_FILLRECT_FUNC(bpp, type, suffix, store, end) \
 static void \
-SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+SDL_FillRect##bpp##suffix(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
 { \
     int i, n; \
     Uint8 *p = NULL; \
@@ -71,59 +91,33 @@ SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
  \
         if (n > 63) { \
             int adjust = 16 - ((uintptr_t)p & 15); \
-            if (adjust < 16) { \
-                n -= adjust; \
-                adjust /= bpp; \
-                while (adjust--) { \
-                    *((type *)p) = (type)color; \
-                    p += bpp; \
+            if ((uintptr_t)p & (bpp - 1)) { \
+                /* The stores can't be aligned */ \
+                SSE_FILL_SCALAR(bpp, type, n / bpp); \
+                n = 0; \
+            } else { \
+                if (adjust < 16) { \
+                    n -= adjust; \
+                    SSE_FILL_SCALAR(bpp, type, adjust / bpp); \
                 } \
+                SSE_WORK(store); \
+                n &= 15; \
             } \
-            SSE_WORK; \
         } \
         if (n & 63) { \
-            int remainder = (n & 63); \
-            remainder /= bpp; \
-            while (remainder--) { \
-                *((type *)p) = (type)color; \
-                p += bpp; \
-            } \
+            SSE_FILL_SCALAR(bpp, type, (n & 63) / bpp); \
         } \
         pixels += pitch; \
     } \
  \
-    SSE_END; \
+    end; \
 }
 
-static void
-SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
-{
-    int i, n;
-
-    SSE_BEGIN;
-    while (h--) {
-        Uint8 *p = pixels;
-        n = w;
-
-        if (n > 63) {
-            int adjust = 16 - ((uintptr_t)p & 15);
-            if (adjust) {
-                n -= adjust;
-                SDL_memset(p, color, adjust);
-                p += adjust;
-            }
-            SSE_WORK;
-        }
-        if (n & 63) {
-            int remainder = (n & 63);
-            SDL_memset(p, color, remainder);
-        }
-        pixels += pitch;
-    }
+#define DEFINE_SSE_FILLRECT(bpp, type) \
+    DEFINE_SSE_FILLRECT_FUNC(bpp, type, SSE, _mm_store_ps, SSE_END_STORE) \
+    DEFINE_SSE_FILLRECT_FUNC(bpp, type, SSEStream, _mm_stream_ps, SSE_END_STREAM)
 
-    SSE_END;
-}
-/* DEFINE_SSE_FILLRECT(1, Uint8) */
+DEFINE_SSE_FILLRECT(1, Uint8)
 DEFINE_SSE_FILLRECT(2, Uint16)
 DEFINE_SSE_FILLRECT(4, Uint32)
 
@@ -224,23 +218,127 @@ SDL_FillRect4(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
     }
 }
 
-/* 
- * This function performs a fast fill of the given rectangle with 'color'
- */
-int
-SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
+typedef void (*SDL_FillRectFunc) (Uint8 * pixels, int pitch, Uint32 color,
+                                  int w, int h);
+
+typedef struct
 {
-    SDL_Rect clipped;
+    SDL_FillRectFunc func;
     Uint8 *pixels;
+    int pitch;
+    Uint32 color;
+    int w;
+} SDL_FillRectJob;
+
+static void
+SDL_FillRectBand(void *data, int y, int h)
+{
+    const SDL_FillRectJob *job = (const SDL_FillRectJob *) data;
 
+    job->func(job->pixels + y * job->pitch, job->pitch, job->color, job->w, h);
+}
+
+static int
+SDL_CheckFillSurface(SDL_Surface * dst)
+{
     if (!dst) {
         return SDL_SetError("Passed NULL destination surface");
     }
 
     /* This function doesn't work on surfaces < 8 bpp */
-    if (dst->format->BitsPerPixel < 8) {
+    if (dst->format->BitsPerPixel < 8 || dst->format->BytesPerPixel > 4) {
         return SDL_SetError("SDL_FillRect(): Unsupported surface format");
     }
+    return 0;
+}
+
+/* Replicate the color across 32 bits for the row functions */
+static Uint32
+SDL_GetFillColor(int bpp, Uint32 color)
+{
+    switch (bpp) {
+    case 1:
+        color &= 0xFF;
+        color |= (color << 8);
+        color |= (color << 16);
+        break;
+    case 2:
+        color &= 0xFFFF;
+        color |= (color << 16);
+        break;
+    }
+    return color;
+}
+
+/* Pick the row function for a rectangle that is part of a fill covering
+   'bytes' bytes in all */
+static SDL_FillRectFunc
+SDL_GetFillRectFunc(int bpp, int w, Sint64 bytes)
+{
+#ifdef __SSE__
+    const SDL_bool stream = (bytes >= SDL_FILLRECT_STREAM_MIN_BYTES &&
+                             w * bpp >= SDL_FILLRECT_STREAM_MIN_ROW);
+#endif
+
+    switch (bpp) {
+    case 1:
+#ifdef __SSE__
+        if (SDL_HasSSE()) {
+            return stream ? SDL_FillRect1SSEStream : SDL_FillRect1SSE;
+        }
+#endif
+        return SDL_FillRect1;
+
+    case 2:
+#ifdef __SSE__
+        if (SDL_HasSSE()) {
+            return stream ? SDL_FillRect2SSEStream : SDL_FillRect2SSE;
+        }
+#endif
+        return SDL_FillRect2;
+
+    case 3:
+        /* 24-bit RGB is a slow path, at least for now. */
+        return SDL_FillRect3;
+
+    default:
+#ifdef __SSE__
+        if (SDL_HasSSE()) {
+            return stream ? SDL_FillRect4SSEStream : SDL_FillRect4SSE;
+        }
+#endif
+        return SDL_FillRect4;
+    }
+}
+
+/* Fill a rectangle that is already clipped to the surface */
+static void
+SDL_FillClippedRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color,
+                    Sint64 bytes)
+{
+    const int bpp = dst->format->BytesPerPixel;
+    SDL_FillRectJob job;
+
+    job.func = SDL_GetFillRectFunc(bpp, rect->w, bytes);
+    job.pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch + rect->x * bpp;
+    job.pitch = dst->pitch;
+    job.color = color;
+    job.w = rect->w;
+
+    SDL_RunBlitBands(SDL_FillRectBand, &job, rect->w, rect->h);
+}
+
+/* 
+ * This function performs a fast fill of the given rectangle with 'color'
+ */
+int
+SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
+{
+    SDL_Rect clipped;
+
+    if (SDL_CheckFillSurface(dst) < 0) {
+        return -1;
+    }
 
     /* If 'rect' == NULL, then fill the whole surface */
     if (rect) {
@@ -262,58 +360,34 @@ SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
         return SDL_SetError("SDL_FillRect(): You must lock the surface");
     }
 
-    pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch +
-                                     rect->x * dst->format->BytesPerPixel;
-
-    switch (dst->format->BytesPerPixel) {
-    case 1:
-        {
-            color |= (color << 8);
-            color |= (color << 16);
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect1SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect1(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
+    /* RLE surfaces keep their pixels, locking lets them see the change */
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_LockSurface(dst);
+    }
+    SDL_FillClippedRect(dst, rect,
+                        SDL_GetFillColor(dst->format->BytesPerPixel, color),
+                        (Sint64) rect->w * rect->h * dst->format->BytesPerPixel);
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_UnlockSurface(dst);
+    }
 
-    case 2:
-        {
-            color |= (color << 16);
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect2SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect2(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
+    /* We're done! */
+    return 0;
+}
 
-    case 3:
-        /* 24-bit RGB is a slow path, at least for now. */
-        {
-            SDL_FillRect3(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
+/* Order rectangles by the address of their first pixel */
+static int
+SDL_CompareFillRects(const void *a, const void *b)
+{
+    const SDL_Rect *A = (const SDL_Rect *) a;
+    const SDL_Rect *B = (const SDL_Rect *) b;
 
-    case 4:
-        {
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect4SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect4(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
+    if (A->y != B->y) {
+        return (A->y < B->y) ? -1 : 1;
+    }
+    if (A->x != B->x) {
+        return (A->x < B->x) ? -1 : 1;
     }
-
-    /* We're done! */
     return 0;
 }
 
@@ -321,17 +395,64 @@ int
 SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
               Uint32 color)
 {
-    int i;
-    int status = 0;
+    SDL_Rect *clipped;
+    Sint64 bytes = 0;
+    int bpp, i, n = 0;
 
     if (!rects) {
         return SDL_SetError("SDL_FillRects() passed NULL rects");
     }
+    if (count <= 0) {
+        return 0;
+    }
+    if (count == 1) {
+        return SDL_FillRect(dst, rects, color);
+    }
+    if (SDL_CheckFillSurface(dst) < 0) {
+        return -1;
+    }
+
+    clipped = (SDL_Rect *) SDL_malloc(count * sizeof(*clipped));
+    if (!clipped) {
+        return SDL_OutOfMemory();
+    }
 
+    bpp = dst->format->BytesPerPixel;
     for (i = 0; i < count; ++i) {
-        status += SDL_FillRect(dst, &rects[i], color);
+        if (SDL_IntersectRect(&rects[i], &dst->clip_rect, &clipped[n])) {
+            bytes += (Sint64) clipped[n].w * clipped[n].h * bpp;
+            ++n;
+        }
+    }
+    if (n > 0 && !dst->pixels) {
+        SDL_free(clipped);
+        return SDL_SetError("SDL_FillRect(): You must lock the surface");
+    }
+
+    /* The color is the same for all of them, so a batch too big for the
+       cache can be filled in memory order.  The whole batch also decides
+       whether to stream. */
+    if (bytes >= SDL_FILLRECT_STREAM_MIN_BYTES) {
+        for (i = 1; i < n; ++i) {
+            if (SDL_CompareFillRects(&clipped[i - 1], &clipped[i]) > 0) {
+                SDL_qsort(clipped, n, sizeof(*clipped), SDL_CompareFillRects);
+                break;
+            }
+        }
+    }
+    color = SDL_GetFillColor(bpp, color);
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_LockSurface(dst);
     }
-    return status;
+    for (i = 0; i < n; ++i) {
+        SDL_FillClippedRect(dst, &clipped[i], color, bytes);
+    }
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_UnlockSurface(dst);
+    }
+
+    SDL_free(clipped);
+    return 0;
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
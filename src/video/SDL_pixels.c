@@ -699,6 +699,8 @@ SDL_SetPaletteColors(SDL_Palette * palette, const SDL_Color * colors,
     return status;
 }
 
+static void SDL_FreeInverseColorMap(SDL_Palette * pal);
+
 void
 SDL_FreePalette(SDL_Palette * palette)
 {
@@ -709,6 +711,7 @@ SDL_FreePalette(SDL_Palette * palette)
     if (--palette->refcount > 0) {
         return;
     }
+    SDL_FreeInverseColorMap(palette);
     SDL_free(palette->colors);
     SDL_free(palette);
 }
@@ -765,6 +768,187 @@ SDL_CalculatePitch(SDL_Surface * surface)
     return (pitch);
 }
 
+/*
+ * Inverse color maps for palettes that are looked up a lot.
+ *
+ * The color space is split into cells of 16 levels per channel, and each
+ * cell lists the palette entries that are nearest to some opaque color in
+ * it, in palette order.  Searching that list gives exactly the same result
+ * as searching the whole palette.
+ */
+#define INVERSE_CELL_BITS       4
+#define INVERSE_CELL_LEVELS     (1 << INVERSE_CELL_BITS)
+#define INVERSE_CELL_SIZE       (256 >> INVERSE_CELL_BITS)
+#define INVERSE_CELLS           (INVERSE_CELL_LEVELS * INVERSE_CELL_LEVELS * INVERSE_CELL_LEVELS)
+#define INVERSE_MAX_PALETTES    4
+
+/* Palettes smaller than this are quicker to search directly */
+#define INVERSE_MIN_COLORS      32
+
+/* Lookups per palette color before a map is built, which costs about
+   as much as searching the palette INVERSE_CELLS times */
+#define INVERSE_LOOKUPS_PER_COLOR   16
+
+typedef struct
+{
+    SDL_Palette *palette;
+    Uint32 version;
+    Uint32 lookups;
+    Uint32 last_used;
+    Uint32 *cells;      /* INVERSE_CELLS + 1 offsets into entries */
+    Uint8 *entries;
+} SDL_InverseColorMap;
+
+static SDL_SpinLock SDL_inverse_lock;
+static SDL_InverseColorMap SDL_inverse_maps[INVERSE_MAX_PALETTES];
+static Uint32 SDL_inverse_clock;
+
+static void
+SDL_ResetInverseColorMap(SDL_InverseColorMap * map, SDL_Palette * palette)
+{
+    SDL_free(map->cells);
+    SDL_free(map->entries);
+    SDL_zerop(map);
+    map->palette = palette;
+    map->version = palette ? palette->version : 0;
+}
+
+static SDL_bool
+SDL_BuildInverseColorMap(SDL_InverseColorMap * map)
+{
+    const SDL_Palette *pal = map->palette;
+    const int ncolors = SDL_min(pal->ncolors, 256);
+    unsigned int *nearest, *farthest, bound;
+    Uint32 *cells;
+    Uint8 *entries;
+    size_t count = 0, size;
+    int channel, level, cell, i;
+
+    /* Squared distances from each palette color to the closest and the
+       farthest point of each cell along each channel */
+    nearest = (unsigned int *) SDL_malloc(3 * INVERSE_CELL_LEVELS * 256 * 2 * sizeof(*nearest));
+    cells = (Uint32 *) SDL_malloc((INVERSE_CELLS + 1) * sizeof(*cells));
+    size = INVERSE_CELLS * 16;
+    entries = (Uint8 *) SDL_malloc(size);
+    if (!nearest || !cells || !entries) {
+        SDL_free(nearest);
+        SDL_free(cells);
+        SDL_free(entries);
+        return SDL_FALSE;
+    }
+    farthest = nearest + 3 * INVERSE_CELL_LEVELS * 256;
+
+    for (channel = 0; channel < 3; ++channel) {
+        for (level = 0; level < INVERSE_CELL_LEVELS; ++level) {
+            const int lo = level * INVERSE_CELL_SIZE;
+            const int hi = lo + INVERSE_CELL_SIZE - 1;
+            for (i = 0; i < ncolors; ++i) {
+                const int c = (channel == 0) ? pal->colors[i].r :
+                              (channel == 1) ? pal->colors[i].g :
+                                               pal->colors[i].b;
+                const int n = (c < lo) ? (lo - c) : (c > hi) ? (c - hi) : 0;
+                const int f = SDL_max(c - lo, hi - c);
+                nearest[(channel * INVERSE_CELL_LEVELS + level) * 256 + i] = n * n;
+                farthest[(channel * INVERSE_CELL_LEVELS + level) * 256 + i] = f * f;
+            }
+        }
+    }
+
+    for (cell = 0; cell < INVERSE_CELLS; ++cell) {
+        const int rl = cell >> (2 * INVERSE_CELL_BITS);
+        const int gl = (cell >> INVERSE_CELL_BITS) & (INVERSE_CELL_LEVELS - 1);
+        const int bl = cell & (INVERSE_CELL_LEVELS - 1);
+        const unsigned int *rn = &nearest[(0 * INVERSE_CELL_LEVELS + rl) * 256];
+        const unsigned int *gn = &nearest[(1 * INVERSE_CELL_LEVELS + gl) * 256];
+        const unsigned int *bn = &nearest[(2 * INVERSE_CELL_LEVELS + bl) * 256];
+        const unsigned int *rf = &farthest[(0 * INVERSE_CELL_LEVELS + rl) * 256];
+        const unsigned int *gf = &farthest[(1 * INVERSE_CELL_LEVELS + gl) * 256];
+        const unsigned int *bf = &farthest[(2 * INVERSE_CELL_LEVELS + bl) * 256];
+
+        /* No color in the cell is farther than this from its nearest entry */
+        bound = ~0u;
+        for (i = 0; i < ncolors; ++i) {
+            const int ad = pal->colors[i].a - SDL_ALPHA_OPAQUE;
+            const unsigned int d = rf[i] + gf[i] + bf[i] + ad * ad;
+            if (d < bound) {
+                bound = d;
+            }
+        }
+
+        cells[cell] = (Uint32) count;
+        if (count + ncolors > size) {
+            Uint8 *more;
+            size = SDL_max(size * 2, count + ncolors);
+            more = (Uint8 *) SDL_realloc(entries, size);
+            if (!more) {
+                SDL_free(nearest);
+                SDL_free(cells);
+                SDL_free(entries);
+                return SDL_FALSE;
+            }
+            entries = more;
+        }
+        for (i = 0; i < ncolors; ++i) {
+            const int ad = pal->colors[i].a - SDL_ALPHA_OPAQUE;
+            if (rn[i] + gn[i] + bn[i] + ad * ad <= bound) {
+                entries[count++] = (Uint8) i;
+            }
+        }
+    }
+    cells[INVERSE_CELLS] = (Uint32) count;
+
+    SDL_free(nearest);
+    map->cells = cells;
+    map->entries = entries;
+    return SDL_TRUE;
+}
+
+/* Find the inverse color map for a palette, building it once the palette
+   has been looked up enough.  Call with SDL_inverse_lock held. */
+static SDL_InverseColorMap *
+SDL_GetInverseColorMap(SDL_Palette * pal)
+{
+    SDL_InverseColorMap *map = NULL;
+    int i;
+
+    for (i = 0; i < INVERSE_MAX_PALETTES; ++i) {
+        if (SDL_inverse_maps[i].palette == pal) {
+            map = &SDL_inverse_maps[i];
+            break;
+        }
+        if (!map || SDL_inverse_maps[i].last_used < map->last_used) {
+            map = &SDL_inverse_maps[i];
+        }
+    }
+    if (map->palette != pal || map->version != pal->version) {
+        SDL_ResetInverseColorMap(map, pal);
+    }
+    map->last_used = ++SDL_inverse_clock;
+
+    if (!map->cells &&
+        ++map->lookups >= (Uint32) pal->ncolors * INVERSE_LOOKUPS_PER_COLOR) {
+        if (!SDL_BuildInverseColorMap(map)) {
+            /* Try again later */
+            map->lookups = 0;
+        }
+    }
+    return map;
+}
+
+static void
+SDL_FreeInverseColorMap(SDL_Palette * pal)
+{
+    int i;
+
+    SDL_AtomicLock(&SDL_inverse_lock);
+    for (i = 0; i < INVERSE_MAX_PALETTES; ++i) {
+        if (SDL_inverse_maps[i].palette == pal) {
+            SDL_ResetInverseColorMap(&SDL_inverse_maps[i], NULL);
+        }
+    }
+    SDL_AtomicUnlock(&SDL_inverse_lock);
+}
+
 /*
  * Match an RGB value to a particular palette index
  */
@@ -778,6 +962,41 @@ SDL_FindColor(SDL_Palette * pal, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
     int i;
     Uint8 pixel = 0;
 
+    if (a == SDL_ALPHA_OPAQUE && pal->ncolors >= INVERSE_MIN_COLORS &&
+        pal->ncolors <= 256) {
+        SDL_InverseColorMap *map;
+
+        SDL_AtomicLock(&SDL_inverse_lock);
+        map = SDL_GetInverseColorMap(pal);
+        if (map->cells) {
+            const int cell = ((r >> (8 - INVERSE_CELL_BITS)) << (2 * INVERSE_CELL_BITS)) |
+                             ((g >> (8 - INVERSE_CELL_BITS)) << INVERSE_CELL_BITS) |
+                             (b >> (8 - INVERSE_CELL_BITS));
+            const Uint8 *entry = map->entries + map->cells[cell];
+            const Uint8 *end = map->entries + map->cells[cell + 1];
+
+            smallest = ~0;
+            for (; entry < end; ++entry) {
+                const SDL_Color *color = &pal->colors[*entry];
+                rd = color->r - r;
+                gd = color->g - g;
+                bd = color->b - b;
+                ad = color->a - a;
+                distance = (rd * rd) + (gd * gd) + (bd * bd) + (ad * ad);
+                if (distance < smallest) {
+                    pixel = *entry;
+                    if (distance == 0) {        /* Perfect match! */
+                        break;
+                    }
+                    smallest = distance;
+                }
+            }
+            SDL_AtomicUnlock(&SDL_inverse_lock);
+            return (pixel);
+        }
+        SDL_AtomicUnlock(&SDL_inverse_lock);
+    }
+
     smallest = ~0;
     for (i = 0; i < pal->ncolors; ++i) {
         rd = pal->colors[i].r - r;
@@ -970,6 +1189,131 @@ SDL_AllocBlitMap(void)
     return (map);
 }
 
+static void
+SDL_GetBlitMapKey(SDL_BlitMap * map, SDL_PixelFormat * srcfmt,
+                  SDL_PixelFormat * dstfmt, SDL_BlitMapKey * key)
+{
+    key->dst_palette = dstfmt->palette;
+    key->dst_format = dstfmt->format;
+    key->dst_palette_version = dstfmt->palette ? dstfmt->palette->version : 0;
+    key->src_palette_version = srcfmt->palette ? srcfmt->palette->version : 0;
+    key->flags = map->info.flags;
+    key->colorkey = map->info.colorkey;
+    /* The modulation values only affect the blit when their flag is set */
+    if (map->info.flags & SDL_COPY_MODULATE_COLOR) {
+        key->r = map->info.r;
+        key->g = map->info.g;
+        key->b = map->info.b;
+    } else {
+        key->r = key->g = key->b = 0xFF;
+    }
+    if (map->info.flags & SDL_COPY_MODULATE_ALPHA) {
+        key->a = map->info.a;
+    } else {
+        key->a = 0xFF;
+    }
+}
+
+static SDL_bool
+SDL_MatchBlitMapKey(const SDL_BlitMapKey * a, const SDL_BlitMapKey * b)
+{
+    return (a->dst_palette == b->dst_palette &&
+            a->dst_format == b->dst_format &&
+            a->dst_palette_version == b->dst_palette_version &&
+            a->src_palette_version == b->src_palette_version &&
+            a->flags == b->flags &&
+            a->colorkey == b->colorkey &&
+            a->r == b->r && a->g == b->g && a->b == b->b && a->a == b->a);
+}
+
+static void
+SDL_FreeBlitMapCacheEntry(SDL_BlitMapCacheEntry * entry)
+{
+    if (entry->key.dst_palette) {
+        SDL_FreePalette(entry->key.dst_palette);
+    }
+    SDL_free(entry->table);
+}
+
+/* Keep the current mapping around in case we blit to this kind of
+   destination again. RLE data is tied to a single destination format and
+   is rebuilt by the surface itself, so it isn't cached. */
+static void
+SDL_CacheBlitMap(SDL_BlitMap * map)
+{
+    SDL_PixelFormat *dstfmt = map->dst->format;
+    SDL_BlitMapCacheEntry *entry;
+
+    if (!map->data || (map->key.flags & SDL_COPY_RLE_MASK)) {
+        return;
+    }
+    if (dstfmt->palette != map->key.dst_palette ||
+        (dstfmt->palette &&
+         dstfmt->palette->version != map->key.dst_palette_version)) {
+        /* The destination palette changed, this mapping is stale */
+        return;
+    }
+
+    if (map->num_cached == SDL_BLITMAP_CACHE_SIZE) {
+        SDL_FreeBlitMapCacheEntry(&map->cache[--map->num_cached]);
+    }
+    SDL_memmove(&map->cache[1], &map->cache[0],
+                map->num_cached * sizeof(map->cache[0]));
+    ++map->num_cached;
+
+    entry = &map->cache[0];
+    entry->key = map->key;
+    if (entry->key.dst_palette) {
+        ++entry->key.dst_palette->refcount;
+    }
+    entry->identity = map->identity;
+    entry->blit = map->blit;
+    entry->data = map->data;
+    entry->table = map->info.table;
+    map->info.table = NULL;
+}
+
+static SDL_bool
+SDL_RestoreBlitMap(SDL_BlitMap * map, const SDL_BlitMapKey * key)
+{
+    SDL_BlitMapCacheEntry *entry;
+    int i;
+
+    for (i = 0; i < map->num_cached; ++i) {
+        if (SDL_MatchBlitMapKey(&map->cache[i].key, key)) {
+            break;
+        }
+    }
+    if (i == map->num_cached) {
+        return SDL_FALSE;
+    }
+
+    entry = &map->cache[i];
+    map->key = entry->key;
+    map->identity = entry->identity;
+    map->blit = entry->blit;
+    map->data = entry->data;
+    map->info.table = entry->table;
+    entry->table = NULL;
+    SDL_FreeBlitMapCacheEntry(entry);
+
+    --map->num_cached;
+    SDL_memmove(&map->cache[i], &map->cache[i + 1],
+                (map->num_cached - i) * sizeof(map->cache[0]));
+    return SDL_TRUE;
+}
+
+void
+SDL_ClearBlitMapCache(SDL_BlitMap * map)
+{
+    if (!map) {
+        return;
+    }
+    while (map->num_cached > 0) {
+        SDL_FreeBlitMapCacheEntry(&map->cache[--map->num_cached]);
+    }
+}
+
 void
 SDL_InvalidateMap(SDL_BlitMap * map)
 {
@@ -977,8 +1321,10 @@ SDL_InvalidateMap(SDL_BlitMap * map)
         return;
     }
     if (map->dst) {
+        SDL_CacheBlitMap(map);
+
         /* Release our reference to the surface - see the note below */
-        if (--map->dst->refcount <= 0) {
+        if (map->dst->map != map && --map->dst->refcount <= 0) {
             SDL_FreeSurface(map->dst);
         }
     }
@@ -995,18 +1341,36 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
     SDL_PixelFormat *srcfmt;
     SDL_PixelFormat *dstfmt;
     SDL_BlitMap *map;
+    SDL_BlitMapKey key;
 
     /* Clear out any previous mapping */
     map = src->map;
     if ((src->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(src, 1);
+        SDL_UnRLESurface(src);
     }
     SDL_InvalidateMap(map);
 
-    /* Figure out what kind of mapping we're doing */
-    map->identity = 0;
     srcfmt = src->format;
     dstfmt = dst->format;
+    SDL_GetBlitMapKey(map, srcfmt, dstfmt, &key);
+
+    /* See if we've already mapped to this kind of destination */
+    if (SDL_RestoreBlitMap(map, &key)) {
+        map->dst = dst;
+        if (dst != src) {
+            ++map->dst->refcount;
+        }
+        map->dst_palette_version = key.dst_palette_version;
+        map->src_palette_version = key.src_palette_version;
+        map->info.src_fmt = srcfmt;
+        map->info.src_pitch = src->pitch;
+        map->info.dst_fmt = dstfmt;
+        map->info.dst_pitch = dst->pitch;
+        return 0;
+    }
+
+    /* Figure out what kind of mapping we're doing */
+    map->identity = 0;
     if (SDL_ISPIXELFORMAT_INDEXED(srcfmt->format)) {
         if (SDL_ISPIXELFORMAT_INDEXED(dstfmt->format)) {
             /* Palette --> Palette */
@@ -1020,10 +1384,10 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
             if (srcfmt->BitsPerPixel != dstfmt->BitsPerPixel)
                 map->identity = 0;
         } else {
-            /* Palette --> BitField */
-            map->info.table =
-                Map1toN(srcfmt, src->map->info.r, src->map->info.g,
-                        src->map->info.b, src->map->info.a, dstfmt);
+            /* Palette --> BitField, with the same modulation as the cache key */
+            SDL_BlitMapKey mod;
+            SDL_GetBlitMapKey(src->map, srcfmt, dstfmt, &mod);
+            map->info.table = Map1toN(srcfmt, mod.r, mod.g, mod.b, mod.a, dstfmt);
             if (map->info.table == NULL) {
                 return (-1);
             }
@@ -1048,13 +1412,16 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
 
     map->dst = dst;
 
-    if (map->dst) {
+    if (map->dst && map->dst != src) {
         /* Keep a reference to this surface so it doesn't get deleted
            while we're still pointing at it.
 
            A better method would be for the destination surface to keep
            track of surfaces that are mapped to it and automatically
            invalidate them when it is freed, but this will do for now.
+
+           A surface blitting onto itself doesn't take a reference, or
+           it could never be freed.
         */
         ++map->dst->refcount;
     }
@@ -1072,6 +1439,7 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
     }
 
     /* Choose your blitters wisely */
+    map->key = key;
     return (SDL_CalculateBlit(src));
 }
 
@@ -1080,6 +1448,7 @@ SDL_FreeBlitMap(SDL_BlitMap * map)
 {
     if (map) {
         SDL_InvalidateMap(map);
+        SDL_ClearBlitMapCache(map);
         SDL_free(map);
     }
 }
@@ -30,9 +30,14 @@ extern int SDL_InitFormat(SDL_PixelFormat * format, Uint32 pixel_format);
 /* Blit mapping functions */
 extern SDL_BlitMap *SDL_AllocBlitMap(void);
 extern void SDL_InvalidateMap(SDL_BlitMap * map);
+extern void SDL_ClearBlitMapCache(SDL_BlitMap * map);
 extern int SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst);
 extern void SDL_FreeBlitMap(SDL_BlitMap * map);
 
+/* Surface pixel allocation, from SDL_surface.c */
+extern void *SDL_AllocSurfacePixels(SDL_SurfacePool * pool, size_t size);
+extern void SDL_FreeSurfacePixels(void *pixels);
+
 /* Miscellaneous functions */
 extern int SDL_CalculatePitch(SDL_Surface * surface);
 extern void SDL_DitherColors(SDL_Color * colors, int bpp);
@@ -522,4 +522,713 @@ SDL_GetSpanEnclosingRect(int width, int height,
     return SDL_FALSE;
 }
 
+/* Regions are kept as y-x banded lists of rectangles, the same layout
+   pixman and the X server use: every operation is a single top to bottom
+   sweep over both inputs, so it runs in time linear in their size.
+ */
+struct SDL_Region
+{
+    SDL_Rect *rects;
+    int numrects;
+    int maxrects;
+    SDL_Rect bounds;
+};
+
+/* Sentinels past any coordinate a rectangle can have */
+#define REGION_MAX_COORD    0x7FFFFFFF
+#define REGION_MIN_COORD    (-0x7FFFFFFF - 1)
+
+typedef enum
+{
+    SDL_REGION_UNION,
+    SDL_REGION_INTERSECT,
+    SDL_REGION_SUBTRACT
+} SDL_RegionOpType;
+
+static int
+SDL_ReserveRegion(SDL_Region * region, int count)
+{
+    if (count > region->maxrects) {
+        int maxrects = SDL_max(count, region->maxrects * 2);
+        SDL_Rect *rects;
+
+        maxrects = SDL_max(maxrects, 8);
+        rects = (SDL_Rect *) SDL_realloc(region->rects,
+                                         maxrects * sizeof(*rects));
+        if (!rects) {
+            return SDL_OutOfMemory();
+        }
+        region->rects = rects;
+        region->maxrects = maxrects;
+    }
+    return 0;
+}
+
+static void
+SDL_UpdateRegionBounds(SDL_Region * region)
+{
+    const SDL_Rect *rects = region->rects;
+    int i, x1, x2;
+
+    if (region->numrects == 0) {
+        SDL_zero(region->bounds);
+        return;
+    }
+
+    x1 = rects[0].x;
+    x2 = rects[0].x + rects[0].w;
+    for (i = 1; i < region->numrects; ++i) {
+        x1 = SDL_min(x1, rects[i].x);
+        x2 = SDL_max(x2, rects[i].x + rects[i].w);
+    }
+    region->bounds.x = x1;
+    region->bounds.y = rects[0].y;
+    region->bounds.w = x2 - x1;
+    region->bounds.h = rects[region->numrects - 1].y +
+                       rects[region->numrects - 1].h - rects[0].y;
+}
+
+/* Return the index just past the band starting at rects[start] */
+static int
+SDL_RegionBandEnd(const SDL_Rect * rects, int count, int start)
+{
+    int y = rects[start].y;
+    int end = start + 1;
+
+    while (end < count && rects[end].y == y) {
+        ++end;
+    }
+    return end;
+}
+
+/* Combine the spans of one band of each input between ytop and ybot,
+   merging the result into the previous band when they are identical.
+ */
+static void
+SDL_RegionOpBand(SDL_Region * result, int *prev,
+                 const SDL_Rect * a, int na, const SDL_Rect * b, int nb,
+                 int ytop, int ybot, SDL_RegionOpType op)
+{
+    SDL_bool ina = SDL_FALSE, inb = SDL_FALSE, in = SDL_FALSE, now;
+    int first = result->numrects;
+    int i = 0, j = 0, start = 0, count;
+
+    /* Walk the span edges of both bands in x order */
+    while (i < 2 * na || j < 2 * nb) {
+        int xa = REGION_MAX_COORD, xb = REGION_MAX_COORD, x;
+
+        if (i < 2 * na) {
+            xa = a[i / 2].x + ((i & 1) ? a[i / 2].w : 0);
+        }
+        if (j < 2 * nb) {
+            xb = b[j / 2].x + ((j & 1) ? b[j / 2].w : 0);
+        }
+        x = SDL_min(xa, xb);
+        if (xa == x) {
+            ina = !ina;
+            ++i;
+        }
+        if (xb == x) {
+            inb = !inb;
+            ++j;
+        }
+
+        switch (op) {
+        case SDL_REGION_UNION:
+            now = (ina || inb);
+            break;
+        case SDL_REGION_INTERSECT:
+            now = (ina && inb);
+            break;
+        default:
+            now = (ina && !inb);
+            break;
+        }
+        if (now != in) {
+            if (now) {
+                start = x;
+            } else {
+                SDL_Rect *rect = &result->rects[result->numrects++];
+                rect->x = start;
+                rect->y = ytop;
+                rect->w = x - start;
+                rect->h = ybot - ytop;
+            }
+            in = now;
+        }
+    }
+
+    count = result->numrects - first;
+    if (count == 0) {
+        return;
+    }
+    if (*prev >= 0 && first - *prev == count &&
+        result->rects[*prev].y + result->rects[*prev].h == ytop) {
+        SDL_Rect *above = &result->rects[*prev];
+        SDL_Rect *below = &result->rects[first];
+
+        for (i = 0; i < count; ++i) {
+            if (above[i].x != below[i].x || above[i].w != below[i].w) {
+                break;
+            }
+        }
+        if (i == count) {
+            for (i = 0; i < count; ++i) {
+                above[i].h += ybot - ytop;
+            }
+            result->numrects = first;
+            return;
+        }
+    }
+    *prev = first;
+}
+
+/* Replace dst with (a op b).  a or b may point into dst. */
+static int
+SDL_RegionOp(SDL_Region * dst, const SDL_Rect * a, int na,
+             const SDL_Rect * b, int nb, SDL_RegionOpType op)
+{
+    SDL_Region result;
+    int ia = 0, ib = 0, ea = 0, eb = 0;
+    int y = REGION_MIN_COORD;
+    int prev = -1;
+
+    SDL_zero(result);
+    while (ia < na || ib < nb) {
+        int atop, abot, btop, bbot, ytop, ybot;
+        SDL_bool ina, inb, emit;
+
+        if (op == SDL_REGION_INTERSECT && (ia == na || ib == nb)) {
+            break;
+        }
+        if (op == SDL_REGION_SUBTRACT && ia == na) {
+            break;
+        }
+
+        atop = abot = btop = bbot = REGION_MAX_COORD;
+        if (ia < na) {
+            if (ea <= ia) {
+                ea = SDL_RegionBandEnd(a, na, ia);
+            }
+            atop = a[ia].y;
+            abot = atop + a[ia].h;
+        }
+        if (ib < nb) {
+            if (eb <= ib) {
+                eb = SDL_RegionBandEnd(b, nb, ib);
+            }
+            btop = b[ib].y;
+            bbot = btop + b[ib].h;
+        }
+
+        /* The next band runs from here until some input band starts or ends */
+        ytop = SDL_max(y, SDL_min(atop, btop));
+        ina = (atop <= ytop);
+        inb = (btop <= ytop);
+        ybot = SDL_min(ina ? abot : atop, inb ? bbot : btop);
+
+        switch (op) {
+        case SDL_REGION_UNION:
+            emit = (ina || inb);
+            break;
+        case SDL_REGION_INTERSECT:
+            emit = (ina && inb);
+            break;
+        default:
+            emit = ina;
+            break;
+        }
+        if (emit) {
+            int na_band = ina ? ea - ia : 0;
+            int nb_band = inb ? eb - ib : 0;
+
+            if (SDL_ReserveRegion(&result, result.numrects + na_band + nb_band) < 0) {
+                SDL_free(result.rects);
+                return -1;
+            }
+            SDL_RegionOpBand(&result, &prev, &a[ia], na_band, &b[ib], nb_band,
+                             ytop, ybot, op);
+        }
+
+        y = ybot;
+        if (ina && abot == ybot) {
+            ia = ea;
+        }
+        if (inb && bbot == ybot) {
+            ib = eb;
+        }
+    }
+
+    SDL_free(dst->rects);
+    dst->rects = result.rects;
+    dst->numrects = result.numrects;
+    dst->maxrects = result.maxrects;
+    SDL_UpdateRegionBounds(dst);
+    return 0;
+}
+
+/* Build a region from unsorted rectangles by merging halves */
+static int
+SDL_RegionFromRects(SDL_Region * dst, const SDL_Rect * rects, int count)
+{
+    SDL_Region right;
+    int half, status;
+
+    if (count <= 1) {
+        dst->numrects = 0;
+        if (count == 1 && !SDL_RectEmpty(rects)) {
+            if (SDL_ReserveRegion(dst, 1) < 0) {
+                return -1;
+            }
+            dst->rects[0] = *rects;
+            dst->numrects = 1;
+        }
+        SDL_UpdateRegionBounds(dst);
+        return 0;
+    }
+
+    half = count / 2;
+    SDL_zero(right);
+    if (SDL_RegionFromRects(dst, rects, half) < 0 ||
+        SDL_RegionFromRects(&right, rects + half, count - half) < 0) {
+        SDL_free(right.rects);
+        return -1;
+    }
+    status = SDL_RegionOp(dst, dst->rects, dst->numrects,
+                          right.rects, right.numrects, SDL_REGION_UNION);
+    SDL_free(right.rects);
+    return status;
+}
+
+/* Merge vertically adjacent bands with identical spans */
+static void
+SDL_CoalesceRegion(SDL_Region * region)
+{
+    SDL_Rect *rects = region->rects;
+    int i, j, end, prev = -1, prevcount = 0, numrects = 0;
+
+    for (i = 0; i < region->numrects; i = end) {
+        int count;
+
+        end = SDL_RegionBandEnd(rects, region->numrects, i);
+        count = end - i;
+        if (prev >= 0 && count == prevcount &&
+            rects[prev].y + rects[prev].h == rects[i].y) {
+            for (j = 0; j < count; ++j) {
+                if (rects[prev + j].x != rects[i + j].x ||
+                    rects[prev + j].w != rects[i + j].w) {
+                    break;
+                }
+            }
+            if (j == count) {
+                for (j = 0; j < count; ++j) {
+                    rects[prev + j].h += rects[i + j].h;
+                }
+                continue;
+            }
+        }
+        SDL_memmove(&rects[numrects], &rects[i], count * sizeof(*rects));
+        prev = numrects;
+        prevcount = count;
+        numrects += count;
+    }
+    region->numrects = numrects;
+}
+
+typedef struct
+{
+    Sint64 cost;
+    int index;
+} SDL_RegionMerge;
+
+static int
+SDL_CompareRegionMerge(const void *a, const void *b)
+{
+    const SDL_RegionMerge *A = (const SDL_RegionMerge *) a;
+    const SDL_RegionMerge *B = (const SDL_RegionMerge *) b;
+
+    if (A->cost != B->cost) {
+        return (A->cost < B->cost) ? -1 : 1;
+    }
+    return A->index - B->index;
+}
+
+SDL_Region *
+SDL_CreateRegion(void)
+{
+    SDL_Region *region = (SDL_Region *) SDL_calloc(1, sizeof(*region));
+
+    if (!region) {
+        SDL_OutOfMemory();
+    }
+    return region;
+}
+
+void
+SDL_FreeRegion(SDL_Region * region)
+{
+    if (region) {
+        SDL_free(region->rects);
+        SDL_free(region);
+    }
+}
+
+void
+SDL_ClearRegion(SDL_Region * region)
+{
+    if (region) {
+        region->numrects = 0;
+        SDL_zero(region->bounds);
+    }
+}
+
+int
+SDL_AddRectToRegion(SDL_Region * region, const SDL_Rect * rect)
+{
+    const SDL_Rect *bounds;
+
+    if (!region) {
+        return SDL_InvalidParamError("region");
+    }
+    if (!rect) {
+        return SDL_InvalidParamError("rect");
+    }
+    if (SDL_RectEmpty(rect)) {
+        return 0;
+    }
+
+    /* Adding a rectangle that covers everything is common for full redraws */
+    bounds = &region->bounds;
+    if (region->numrects == 0 ||
+        (rect->x <= bounds->x && rect->y <= bounds->y &&
+         rect->x + rect->w >= bounds->x + bounds->w &&
+         rect->y + rect->h >= bounds->y + bounds->h)) {
+        if (SDL_ReserveRegion(region, 1) < 0) {
+            return -1;
+        }
+        region->rects[0] = *rect;
+        region->numrects = 1;
+        region->bounds = *rect;
+        return 0;
+    }
+    return SDL_RegionOp(region, region->rects, region->numrects,
+                        rect, 1, SDL_REGION_UNION);
+}
+
+int
+SDL_AddRectsToRegion(SDL_Region * region, const SDL_Rect * rects, int count)
+{
+    SDL_Region added;
+    int status;
+
+    if (!region) {
+        return SDL_InvalidParamError("region");
+    }
+    if (!rects) {
+        return SDL_InvalidParamError("rects");
+    }
+    if (count < 0) {
+        return SDL_InvalidParamError("count");
+    }
+    if (count == 0) {
+        return 0;
+    }
+    if (count == 1) {
+        return SDL_AddRectToRegion(region, rects);
+    }
+
+    SDL_zero(added);
+    if (SDL_RegionFromRects(&added, rects, count) < 0) {
+        SDL_free(added.rects);
+        return -1;
+    }
+    if (region->numrects == 0) {
+        SDL_free(region->rects);
+        *region = added;
+        return 0;
+    }
+    status = SDL_RegionOp(region, region->rects, region->numrects,
+                          added.rects, added.numrects, SDL_REGION_UNION);
+    SDL_free(added.rects);
+    return status;
+}
+
+int
+SDL_SubtractRectFromRegion(SDL_Region * region, const SDL_Rect * rect)
+{
+    if (!region) {
+        return SDL_InvalidParamError("region");
+    }
+    if (!rect) {
+        return SDL_InvalidParamError("rect");
+    }
+    if (region->numrects == 0 || !SDL_HasIntersection(rect, &region->bounds)) {
+        return 0;
+    }
+    return SDL_RegionOp(region, region->rects, region->numrects,
+                        rect, 1, SDL_REGION_SUBTRACT);
+}
+
+int
+SDL_IntersectRegionWithRect(SDL_Region * region, const SDL_Rect * rect)
+{
+    if (!region) {
+        return SDL_InvalidParamError("region");
+    }
+    if (!rect) {
+        return SDL_InvalidParamError("rect");
+    }
+    if (region->numrects == 0) {
+        return 0;
+    }
+    if (!SDL_HasIntersection(rect, &region->bounds)) {
+        SDL_ClearRegion(region);
+        return 0;
+    }
+    return SDL_RegionOp(region, region->rects, region->numrects,
+                        rect, 1, SDL_REGION_INTERSECT);
+}
+
+int
+SDL_UnionRegion(SDL_Region * dst, const SDL_Region * src)
+{
+    if (!dst) {
+        return SDL_InvalidParamError("dst");
+    }
+    if (!src) {
+        return SDL_InvalidParamError("src");
+    }
+    if (src->numrects == 0 || dst == src) {
+        return 0;
+    }
+    return SDL_RegionOp(dst, dst->rects, dst->numrects,
+                        src->rects, src->numrects, SDL_REGION_UNION);
+}
+
+int
+SDL_SubtractRegion(SDL_Region * dst, const SDL_Region * src)
+{
+    if (!dst) {
+        return SDL_InvalidParamError("dst");
+    }
+    if (!src) {
+        return SDL_InvalidParamError("src");
+    }
+    if (dst->numrects == 0 || src->numrects == 0 ||
+        !SDL_HasIntersection(&dst->bounds, &src->bounds)) {
+        return 0;
+    }
+    return SDL_RegionOp(dst, dst->rects, dst->numrects,
+                        src->rects, src->numrects, SDL_REGION_SUBTRACT);
+}
+
+int
+SDL_IntersectRegion(SDL_Region * dst, const SDL_Region * src)
+{
+    if (!dst) {
+        return SDL_InvalidParamError("dst");
+    }
+    if (!src) {
+        return SDL_InvalidParamError("src");
+    }
+    if (dst->numrects == 0 || dst == src) {
+        return 0;
+    }
+    if (!SDL_HasIntersection(&dst->bounds, &src->bounds)) {
+        SDL_ClearRegion(dst);
+        return 0;
+    }
+    return SDL_RegionOp(dst, dst->rects, dst->numrects,
+                        src->rects, src->numrects, SDL_REGION_INTERSECT);
+}
+
+int
+SDL_SimplifyRegion(SDL_Region * region, int maxrects)
+{
+    SDL_RegionMerge *merges;
+    SDL_Rect *rects;
+    Uint8 *join;
+    int i, end, nmerges, needed, numrects;
+
+    if (!region) {
+        return SDL_InvalidParamError("region");
+    }
+    if (maxrects < 1) {
+        return SDL_InvalidParamError("maxrects");
+    }
+    if (region->numrects <= maxrects) {
+        return 0;
+    }
+
+    merges = (SDL_RegionMerge *) SDL_malloc(region->numrects * sizeof(*merges));
+    join = (Uint8 *) SDL_malloc(region->numrects);
+    if (!merges || !join) {
+        SDL_free(merges);
+        SDL_free(join);
+        return SDL_OutOfMemory();
+    }
+    rects = region->rects;
+
+    /* First close the cheapest gaps between rectangles in the same band */
+    nmerges = 0;
+    for (i = 0; i < region->numrects; i = end) {
+        int j;
+
+        end = SDL_RegionBandEnd(rects, region->numrects, i);
+        for (j = i; j < end - 1; ++j) {
+            int gap = rects[j + 1].x - (rects[j].x + rects[j].w);
+            merges[nmerges].cost = (Sint64) gap * rects[j].h;
+            merges[nmerges].index = j;
+            ++nmerges;
+        }
+    }
+    needed = SDL_min(nmerges, region->numrects - maxrects);
+    if (needed > 0) {
+        SDL_qsort(merges, nmerges, sizeof(*merges), SDL_CompareRegionMerge);
+        SDL_memset(join, 0, region->numrects);
+        for (i = 0; i < needed; ++i) {
+            join[merges[i].index] = 1;
+        }
+        numrects = 0;
+        for (i = 0; i < region->numrects; ++i) {
+            if (i > 0 && join[i - 1]) {
+                SDL_Rect *last = &rects[numrects - 1];
+                last->w = rects[i].x + rects[i].w - last->x;
+            } else {
+                rects[numrects++] = rects[i];
+            }
+        }
+        region->numrects = numrects;
+        SDL_CoalesceRegion(region);
+    }
+
+    /* Every band is a single rectangle now, so merge neighbouring bands.
+       Each round merges disjoint pairs cheapest first, at least halving
+       the excess, so this stays O(n log n) overall.
+     */
+    while (region->numrects > maxrects) {
+        needed = region->numrects - maxrects;
+        nmerges = region->numrects - 1;
+        for (i = 0; i < nmerges; ++i) {
+            SDL_Rect merged;
+
+            SDL_UnionRect(&rects[i], &rects[i + 1], &merged);
+            merges[i].cost = (Sint64) merged.w * merged.h -
+                             (Sint64) rects[i].w * rects[i].h -
+                             (Sint64) rects[i + 1].w * rects[i + 1].h;
+            merges[i].index = i;
+        }
+        SDL_qsort(merges, nmerges, sizeof(*merges), SDL_CompareRegionMerge);
+
+        /* join[i] is 1 if rects[i] merges with rects[i + 1], 2 if it is taken */
+        SDL_memset(join, 0, region->numrects);
+        for (i = 0; i < nmerges && needed > 0; ++i) {
+            int index = merges[i].index;
+            if (!join[index] && !join[index + 1]) {
+                join[index] = 1;
+                join[index + 1] = 2;
+                --needed;
+            }
+        }
+        numrects = 0;
+        for (i = 0; i < region->numrects; ++i) {
+            if (join[i] == 1) {
+                SDL_UnionRect(&rects[i], &rects[i + 1], &rects[numrects++]);
+                ++i;
+            } else {
+                rects[numrects++] = rects[i];
+            }
+        }
+        region->numrects = numrects;
+    }
+    SDL_CoalesceRegion(region);
+    SDL_UpdateRegionBounds(region);
+
+    SDL_free(merges);
+    SDL_free(join);
+    return 0;
+}
+
+int
+SDL_AppendRegionBand(SDL_Region * region, const SDL_Rect * rects, int count)
+{
+    int i, last;
+
+    if (count <= 0) {
+        return 0;
+    }
+
+    /* Grow the last band instead if it's directly above with the same spans */
+    last = region->numrects;
+    while (last > 0 && region->rects[last - 1].y == region->rects[region->numrects - 1].y) {
+        --last;
+    }
+    if (region->numrects - last == count &&
+        region->rects[last].y + region->rects[last].h == rects[0].y) {
+        for (i = 0; i < count; ++i) {
+            if (region->rects[last + i].x != rects[i].x ||
+                region->rects[last + i].w != rects[i].w) {
+                break;
+            }
+        }
+        if (i == count) {
+            for (i = 0; i < count; ++i) {
+                region->rects[last + i].h += rects[0].h;
+            }
+            region->bounds.h += rects[0].h;
+            return 0;
+        }
+    }
+
+    if (SDL_ReserveRegion(region, region->numrects + count) < 0) {
+        return -1;
+    }
+    SDL_memcpy(&region->rects[region->numrects], rects, count * sizeof(*rects));
+    if (region->numrects == 0) {
+        region->bounds = rects[0];
+    } else {
+        SDL_UnionRect(&region->bounds, &rects[0], &region->bounds);
+    }
+    SDL_UnionRect(&region->bounds, &rects[count - 1], &region->bounds);
+    region->numrects += count;
+    return 0;
+}
+
+SDL_bool
+SDL_RegionEmpty(const SDL_Region * region)
+{
+    return (!region || region->numrects == 0) ? SDL_TRUE : SDL_FALSE;
+}
+
+SDL_bool
+SDL_GetRegionBounds(const SDL_Region * region, SDL_Rect * rect)
+{
+    if (!region) {
+        SDL_InvalidParamError("region");
+        return SDL_FALSE;
+    }
+    if (!rect) {
+        SDL_InvalidParamError("rect");
+        return SDL_FALSE;
+    }
+    *rect = region->bounds;
+    return (region->numrects > 0) ? SDL_TRUE : SDL_FALSE;
+}
+
+const SDL_Rect *
+SDL_GetRegionRects(const SDL_Region * region, int *count)
+{
+    if (!region) {
+        SDL_InvalidParamError("region");
+        if (count) {
+            *count = 0;
+        }
+        return NULL;
+    }
+    if (count) {
+        *count = region->numrects;
+    }
+    return region->rects;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
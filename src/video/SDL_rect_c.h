@@ -22,4 +22,8 @@
 
 extern SDL_bool SDL_GetSpanEnclosingRect(int width, int height, int numrects, const SDL_Rect * rects, SDL_Rect *span);
 
+/* Append a band below everything in the region.  The rects must share y
+   and h, be sorted by x and not touch, which is what a scanline gives. */
+extern int SDL_AppendRegionBand(SDL_Region * region, const SDL_Rect * rects, int count);
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -28,6 +28,7 @@
 #include "SDL_surface.h"
 #include "SDL_shape.h"
 #include "SDL_shape_internals.h"
+#include "SDL_rect_c.h"
 
 SDL_Window*
 SDL_CreateShapedWindow(const char *title,unsigned int x,unsigned int y,unsigned int w,unsigned int h,Uint32 flags)
@@ -35,6 +36,12 @@ SDL_CreateShapedWindow(const char *title,unsigned int x,unsigned int y,unsigned
     SDL_Window *result = NULL;
     result = SDL_CreateWindow(title,-1000,-1000,w,h,(flags | SDL_WINDOW_BORDERLESS) & (~SDL_WINDOW_FULLSCREEN) & (~SDL_WINDOW_RESIZABLE) /* & (~SDL_WINDOW_SHOWN) */);
     if(result != NULL) {
+        if(SDL_GetVideoDevice()->shape_driver.CreateShaper == NULL) {
+            /* The video driver has no shaped window support at all. */
+            SDL_DestroyWindow(result);
+            SDL_Unsupported();
+            return NULL;
+        }
         result->shaper = SDL_GetVideoDevice()->shape_driver.CreateShaper(result);
         if(result->shaper != NULL) {
             result->shaper->userx = x;
@@ -62,107 +69,290 @@ SDL_IsShapedWindow(const SDL_Window *window)
         return (SDL_bool)(window->shaper != NULL);
 }
 
-/* REQUIRES that bitmap point to a w-by-h bitmap with ppb pixels-per-byte. */
+/* How the pixels of a shape surface map to opaque or transparent, worked out
+   once per shape so the mask builders can test raw pixel values. */
+typedef struct {
+    int bpp;
+    /* Color keys compare pixels directly: opaque if (pixel & mask) != key */
+    SDL_bool keyed;
+    Uint32 mask;
+    Uint32 key;
+    /* Anything else looks up table[(pixel & mask) >> shift], which for the
+       alpha modes is 1 exactly between lo and hi */
+    int shift;
+    SDL_bool interval;
+    int lo,hi;
+    Uint8 table[256];
+} SDL_ShapeTest;
+
+typedef void(*SDL_ShapeRunFunction)(int y,int x1,int x2,void* closure);
+
+static Uint8
+SDL_ShapePixelOpaque(SDL_WindowShapeMode mode,Uint8 r,Uint8 g,Uint8 b,Uint8 a)
+{
+    switch(mode.mode) {
+        case(ShapeModeDefault):
+            return (a >= 1 ? 1 : 0);
+        case(ShapeModeBinarizeAlpha):
+            return (a >= mode.parameters.binarizationCutoff ? 1 : 0);
+        case(ShapeModeReverseBinarizeAlpha):
+            return (a <= mode.parameters.binarizationCutoff ? 1 : 0);
+        case(ShapeModeColorKey):
+            return ((mode.parameters.colorKey.r != r || mode.parameters.colorKey.g != g || mode.parameters.colorKey.b != b) ? 1 : 0);
+    }
+    return 0;
+}
+
+static void
+SDL_InitShapeTest(SDL_ShapeTest *test,SDL_WindowShapeMode mode,const SDL_PixelFormat *format)
+{
+    Uint8 r = 0,g = 0,b = 0,a = 0;
+    int i,count;
+
+    SDL_zerop(test);
+    test->bpp = format->BytesPerPixel;
+
+    if(mode.mode == ShapeModeColorKey && format->palette == NULL) {
+        const SDL_Color key = mode.parameters.colorKey;
+
+        /* Every channel expands to 8 bits one to one, so comparing the raw
+           color bits is the same as comparing the colors */
+        test->keyed = SDL_TRUE;
+        test->mask = format->Rmask | format->Gmask | format->Bmask;
+        test->key = SDL_MapRGB(format,key.r,key.g,key.b) & test->mask;
+        SDL_GetRGB(test->key,format,&r,&g,&b);
+        if(r != key.r || g != key.g || b != key.b) {
+            /* No pixel can match the key, everything is opaque */
+            test->mask = 0;
+            test->key = 1;
+        }
+        return;
+    }
+
+    if(format->palette != NULL) {
+        test->mask = 0xFF;
+        test->shift = 0;
+    }
+    else {
+        test->mask = format->Amask;
+        test->shift = format->Ashift;
+    }
+    count = (int)(test->mask >> test->shift) + 1;
+    for(i = 0;i < count;i++) {
+        SDL_GetRGBA((Uint32)i << test->shift,format,&r,&g,&b,&a);
+        test->table[i] = SDL_ShapePixelOpaque(mode,r,g,b,a);
+    }
+
+    /* See if the opaque values form one range, so they can be tested with compares */
+    test->lo = 0;
+    while(test->lo < count && !test->table[test->lo])
+        test->lo++;
+    test->hi = count - 1;
+    while(test->hi >= 0 && !test->table[test->hi])
+        test->hi--;
+    test->interval = SDL_TRUE;
+    for(i = test->lo;i <= test->hi;i++) {
+        if(!test->table[i])
+            test->interval = SDL_FALSE;
+    }
+}
+
+static SDL_INLINE Uint32
+SDL_GetShapePixel(const Uint8 *pixel,int bpp)
+{
+    switch(bpp) {
+        case(1):
+            return *pixel;
+        case(2):
+            return *(const Uint16 *)pixel;
+        case(3):
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            return pixel[0] | (pixel[1] << 8) | (pixel[2] << 16);
+#else
+            return (pixel[0] << 16) | (pixel[1] << 8) | pixel[2];
+#endif
+        default:
+            return *(const Uint32 *)pixel;
+    }
+}
+
+#define SHAPE_OPAQUE(test,pixel) \
+    ((test)->keyed ? (((pixel) & (test)->mask) != (test)->key) : \
+                     (test)->table[((pixel) & (test)->mask) >> (test)->shift])
+
+/* Call function for each run of opaque pixels in row y of the shape */
+static void
+SDL_ShapeRowRuns(const SDL_ShapeTest *test,const SDL_Surface *shape,int y,SDL_ShapeRunFunction function,void* closure)
+{
+    const Uint8 *row = (const Uint8 *)shape->pixels + y * shape->pitch;
+    const int w = shape->w;
+    int x = 0,start = 0;
+    SDL_bool in = SDL_FALSE,opaque;
+
+#ifdef __SSE2__
+    /* Test four pixels at a time, and skip them while nothing changes */
+    if(test->bpp == 4 && (test->keyed || test->interval) && SDL_HasSSE2()) {
+        const __m128i mask = _mm_set1_epi32((int)test->mask);
+        const __m128i key = _mm_set1_epi32((int)test->key);
+        const __m128i shift = _mm_cvtsi32_si128(test->shift);
+        const __m128i lo = _mm_set1_epi32(test->lo);
+        const __m128i hi = _mm_set1_epi32(test->hi);
+        int i,bits;
+
+        for(;x + 4 <= w;x += 4) {
+            __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i *)(row + x * 4)),mask);
+            if(test->keyed) {
+                v = _mm_cmpeq_epi32(v,key);
+            }
+            else {
+                v = _mm_srl_epi32(v,shift);
+                v = _mm_or_si128(_mm_cmplt_epi32(v,lo),_mm_cmpgt_epi32(v,hi));
+            }
+            /* A set bit is a transparent pixel */
+            bits = _mm_movemask_ps(_mm_castsi128_ps(v)) ^ 0xF;
+            if(bits == (in ? 0xF : 0))
+                continue;
+            for(i = 0;i < 4;i++) {
+                opaque = (bits >> i) & 1 ? SDL_TRUE : SDL_FALSE;
+                if(opaque != in) {
+                    if(opaque)
+                        start = x + i;
+                    else
+                        function(y,start,x + i,closure);
+                    in = opaque;
+                }
+            }
+        }
+    }
+#endif
+
+    for(;x < w;x++) {
+        Uint32 pixel = SDL_GetShapePixel(row + x * test->bpp,test->bpp);
+        opaque = SHAPE_OPAQUE(test,pixel) ? SDL_TRUE : SDL_FALSE;
+        if(opaque != in) {
+            if(opaque)
+                start = x;
+            else
+                function(y,start,x,closure);
+            in = opaque;
+        }
+    }
+    if(in)
+        function(y,start,w,closure);
+}
+
+typedef struct {
+    Uint8 *bitmap;
+    int pitch;
+    Uint8 ppb;
+} SDL_ShapeBitmap;
+
+static void
+SetShapeBitmapRun(int y,int x1,int x2,void* closure)
+{
+    const SDL_ShapeBitmap *bitmap = (const SDL_ShapeBitmap *)closure;
+    const Uint8 ppb = bitmap->ppb;
+    Uint8 *row = bitmap->bitmap + y * bitmap->pitch;
+
+    if(ppb == 8) {
+        /* Whole bytes at once in the middle of the run */
+        for(;x1 < x2 && (x1 & 7);x1++)
+            row[x1 >> 3] |= 1 << (x1 & 7);
+        if(x2 - x1 >= 8) {
+            SDL_memset(row + (x1 >> 3),0xFF,(x2 - x1) >> 3);
+            x1 += (x2 - x1) & ~7;
+        }
+    }
+    /* The first pixel in a byte takes bit 8 - ppb */
+    for(;x1 < x2;x1++)
+        row[x1 / ppb] |= 1 << (8 - ppb + x1 % ppb);
+}
+
+/* REQUIRES that bitmap point to a w-by-h bitmap with ppb pixels-per-byte,
+   where each row starts on a new byte. */
 void
 SDL_CalculateShapeBitmap(SDL_WindowShapeMode mode,SDL_Surface *shape,Uint8* bitmap,Uint8 ppb)
 {
-    int x = 0;
-    int y = 0;
-    Uint8 r = 0,g = 0,b = 0,alpha = 0;
-    Uint8* pixel = NULL;
-    Uint32 bitmap_pixel,pixel_value = 0,mask_value = 0;
-    SDL_Color key;
+    SDL_ShapeTest test;
+    SDL_ShapeBitmap closure;
+    int y;
+
+    closure.bitmap = bitmap;
+    closure.pitch = (shape->w + ppb - 1) / ppb;
+    closure.ppb = ppb;
+    SDL_memset(bitmap,0,closure.pitch * shape->h);
+
+    SDL_InitShapeTest(&test,mode,shape->format);
     if(SDL_MUSTLOCK(shape))
         SDL_LockSurface(shape);
-    for(y = 0;y<shape->h;y++) {
-        for(x=0;x<shape->w;x++) {
-            alpha = 0;
-            pixel_value = 0;
-            pixel = (Uint8 *)(shape->pixels) + (y*shape->pitch) + (x*shape->format->BytesPerPixel);
-            switch(shape->format->BytesPerPixel) {
-                case(1):
-                    pixel_value = *(Uint8*)pixel;
-                    break;
-                case(2):
-                    pixel_value = *(Uint16*)pixel;
-                    break;
-                case(3):
-                    pixel_value = *(Uint32*)pixel & (~shape->format->Amask);
-                    break;
-                case(4):
-                    pixel_value = *(Uint32*)pixel;
-                    break;
-            }
-            SDL_GetRGBA(pixel_value,shape->format,&r,&g,&b,&alpha);
-            bitmap_pixel = y*shape->w + x;
-            switch(mode.mode) {
-                case(ShapeModeDefault):
-                    mask_value = (alpha >= 1 ? 1 : 0);
-                    break;
-                case(ShapeModeBinarizeAlpha):
-                    mask_value = (alpha >= mode.parameters.binarizationCutoff ? 1 : 0);
-                    break;
-                case(ShapeModeReverseBinarizeAlpha):
-                    mask_value = (alpha <= mode.parameters.binarizationCutoff ? 1 : 0);
-                    break;
-                case(ShapeModeColorKey):
-                    key = mode.parameters.colorKey;
-                    mask_value = ((key.r != r || key.g != g || key.b != b) ? 1 : 0);
-                    break;
-            }
-            bitmap[bitmap_pixel / ppb] |= mask_value << (7 - ((ppb - 1) - (bitmap_pixel % ppb)));
-        }
+    for(y = 0;y<shape->h;y++)
+        SDL_ShapeRowRuns(&test,shape,y,SetShapeBitmapRun,&closure);
+    if(SDL_MUSTLOCK(shape))
+        SDL_UnlockSurface(shape);
+}
+
+typedef struct {
+    SDL_Rect *rects;
+    int count;
+} SDL_ShapeRow;
+
+static void
+AddShapeRegionRun(int y,int x1,int x2,void* closure)
+{
+    SDL_ShapeRow *row = (SDL_ShapeRow *)closure;
+    SDL_Rect *rect = &row->rects[row->count++];
+
+    rect->x = x1;
+    rect->y = y;
+    rect->w = x2 - x1;
+    rect->h = 1;
+}
+
+int
+SDL_CalculateShapeRegion(SDL_WindowShapeMode mode,SDL_Surface *shape,SDL_Region *region)
+{
+    SDL_ShapeTest test;
+    SDL_ShapeRow row;
+    int y,result = 0;
+
+    SDL_ClearRegion(region);
+
+    /* A row can't have more runs than this */
+    row.rects = (SDL_Rect *)SDL_malloc(((shape->w + 1) / 2 + 1) * sizeof(SDL_Rect));
+    if(row.rects == NULL)
+        return SDL_OutOfMemory();
+
+    SDL_InitShapeTest(&test,mode,shape->format);
+    if(SDL_MUSTLOCK(shape))
+        SDL_LockSurface(shape);
+    /* Rows come out top to bottom with sorted runs, so they append as bands */
+    for(y = 0;y<shape->h && result == 0;y++) {
+        row.count = 0;
+        SDL_ShapeRowRuns(&test,shape,y,AddShapeRegionRun,&row);
+        result = SDL_AppendRegionBand(region,row.rects,row.count);
     }
     if(SDL_MUSTLOCK(shape))
         SDL_UnlockSurface(shape);
+
+    SDL_free(row.rects);
+    return result;
 }
 
 static SDL_ShapeTree*
-RecursivelyCalculateShapeTree(SDL_WindowShapeMode mode,SDL_Surface* mask,SDL_Rect dimensions) {
+RecursivelyCalculateShapeTree(const SDL_ShapeTest *test,SDL_Surface* mask,SDL_Rect dimensions) {
     int x = 0,y = 0;
     Uint8* pixel = NULL;
     Uint32 pixel_value = 0;
-    Uint8 r = 0,g = 0,b = 0,a = 0;
     SDL_bool pixel_opaque = SDL_FALSE;
     int last_opaque = -1;
-    SDL_Color key;
     SDL_ShapeTree* result = (SDL_ShapeTree*)SDL_malloc(sizeof(SDL_ShapeTree));
     SDL_Rect next = {0,0,0,0};
 
     for(y=dimensions.y;y<dimensions.y + dimensions.h;y++) {
-        for(x=dimensions.x;x<dimensions.x + dimensions.w;x++) {
-            pixel_value = 0;
-            pixel = (Uint8 *)(mask->pixels) + (y*mask->pitch) + (x*mask->format->BytesPerPixel);
-            switch(mask->format->BytesPerPixel) {
-                case(1):
-                    pixel_value = *(Uint8*)pixel;
-                    break;
-                case(2):
-                    pixel_value = *(Uint16*)pixel;
-                    break;
-                case(3):
-                    pixel_value = *(Uint32*)pixel & (~mask->format->Amask);
-                    break;
-                case(4):
-                    pixel_value = *(Uint32*)pixel;
-                    break;
-            }
-            SDL_GetRGBA(pixel_value,mask->format,&r,&g,&b,&a);
-            switch(mode.mode) {
-                case(ShapeModeDefault):
-                    pixel_opaque = (a >= 1 ? SDL_TRUE : SDL_FALSE);
-                    break;
-                case(ShapeModeBinarizeAlpha):
-                    pixel_opaque = (a >= mode.parameters.binarizationCutoff ? SDL_TRUE : SDL_FALSE);
-                    break;
-                case(ShapeModeReverseBinarizeAlpha):
-                    pixel_opaque = (a <= mode.parameters.binarizationCutoff ? SDL_TRUE : SDL_FALSE);
-                    break;
-                case(ShapeModeColorKey):
-                    key = mode.parameters.colorKey;
-                    pixel_opaque = ((key.r != r || key.g != g || key.b != b) ? SDL_TRUE : SDL_FALSE);
-                    break;
-            }
+        pixel = (Uint8 *)(mask->pixels) + (y*mask->pitch) + (dimensions.x*test->bpp);
+        for(x=dimensions.x;x<dimensions.x + dimensions.w;x++,pixel += test->bpp) {
+            pixel_value = SDL_GetShapePixel(pixel,test->bpp);
+            pixel_opaque = SHAPE_OPAQUE(test,pixel_value) ? SDL_TRUE : SDL_FALSE;
             if(last_opaque == -1)
                 last_opaque = pixel_opaque;
             if(last_opaque != pixel_opaque) {
@@ -175,21 +365,21 @@ RecursivelyCalculateShapeTree(SDL_WindowShapeMode mode,SDL_Surface* mask,SDL_Rec
                 next.y = dimensions.y;
                 next.w = halfwidth;
                 next.h = halfheight;
-                result->data.children.upleft = (struct SDL_ShapeTree *)RecursivelyCalculateShapeTree(mode,mask,next);
+                result->data.children.upleft = (struct SDL_ShapeTree *)RecursivelyCalculateShapeTree(test,mask,next);
 
                 next.x = dimensions.x + halfwidth;
                 next.w = dimensions.w - halfwidth;
-                result->data.children.upright = (struct SDL_ShapeTree *)RecursivelyCalculateShapeTree(mode,mask,next);
+                result->data.children.upright = (struct SDL_ShapeTree *)RecursivelyCalculateShapeTree(test,mask,next);
 
                 next.x = dimensions.x;
                 next.w = halfwidth;
                 next.y = dimensions.y + halfheight;
                 next.h = dimensions.h - halfheight;
-                result->data.children.downleft = (struct SDL_ShapeTree *)RecursivelyCalculateShapeTree(mode,mask,next);
+                result->data.children.downleft = (struct SDL_ShapeTree *)RecursivelyCalculateShapeTree(test,mask,next);
 
                 next.x = dimensions.x + halfwidth;
                 next.w = dimensions.w - halfwidth;
-                result->data.children.downright = (struct SDL_ShapeTree *)RecursivelyCalculateShapeTree(mode,mask,next);
+                result->data.children.downright = (struct SDL_ShapeTree *)RecursivelyCalculateShapeTree(test,mask,next);
 
                 return result;
             }
@@ -208,9 +398,12 @@ SDL_CalculateShapeTree(SDL_WindowShapeMode mode,SDL_Surface* shape)
 {
     SDL_Rect dimensions = {0,0,shape->w,shape->h};
     SDL_ShapeTree* result = NULL;
+    SDL_ShapeTest test;
+
+    SDL_InitShapeTest(&test,mode,shape->format);
     if(SDL_MUSTLOCK(shape))
         SDL_LockSurface(shape);
-    result = RecursivelyCalculateShapeTree(mode,shape,dimensions);
+    result = RecursivelyCalculateShapeTree(&test,shape,dimensions);
     if(SDL_MUSTLOCK(shape))
         SDL_UnlockSurface(shape);
     return result;
@@ -28,196 +28,132 @@
 
 #include "SDL_video.h"
 #include "SDL_blit.h"
+#include "SDL_blit_copy.h"
 
-/* This isn't ready for general consumption yet - it should be folded
-   into the general blitting mechanism.
+/* Nearest neighbour stretching.  The source column of every destination
+   pixel is computed once per blit and each row is then gathered through
+   that table, so no code has to be generated at runtime.  Destination rows
+   which sample the same source row as the row above are simply copied.
 */
 
-#if ((defined(_MFC_VER) && defined(_M_IX86)) || \
-     defined(__WATCOMC__) || \
-     (defined(__GNUC__) && defined(__i386__))) && SDL_ASSEMBLY_ROUTINES
-/* There's a bug with gcc 4.4.1 and -O2 where srcp doesn't get the correct
- * value after the first scanline.  FIXME? */
-/* #define USE_ASM_STRETCH */
-#endif
-
-#ifdef USE_ASM_STRETCH
+static void
+stretch_row1(const Uint8 * src, Uint8 * dst, int w, const int *xofs)
+{
+    int i;
 
-#ifdef HAVE_MPROTECT
-#include <sys/types.h>
-#include <sys/mman.h>
-#endif
-#ifdef __GNUC__
-#define PAGE_ALIGNED __attribute__((__aligned__(4096)))
-#else
-#define PAGE_ALIGNED
-#endif
+    for (i = 0; i + 4 <= w; i += 4) {
+        dst[i + 0] = src[xofs[i + 0]];
+        dst[i + 1] = src[xofs[i + 1]];
+        dst[i + 2] = src[xofs[i + 2]];
+        dst[i + 3] = src[xofs[i + 3]];
+    }
+    for (; i < w; ++i) {
+        dst[i] = src[xofs[i]];
+    }
+}
 
-#if defined(_M_IX86) || defined(i386)
-#define PREFIX16    0x66
-#define STORE_BYTE  0xAA
-#define STORE_WORD  0xAB
-#define LOAD_BYTE   0xAC
-#define LOAD_WORD   0xAD
-#define RETURN      0xC3
-#else
-#error Need assembly opcodes for this architecture
-#endif
+static void
+stretch_row2(const Uint8 * src, Uint8 * dst, int w, const int *xofs)
+{
+    Uint16 *d = (Uint16 *) dst;
+    int i;
 
-static unsigned char copy_row[4096] PAGE_ALIGNED;
+    for (i = 0; i + 4 <= w; i += 4) {
+        d[i + 0] = *(const Uint16 *) (src + xofs[i + 0]);
+        d[i + 1] = *(const Uint16 *) (src + xofs[i + 1]);
+        d[i + 2] = *(const Uint16 *) (src + xofs[i + 2]);
+        d[i + 3] = *(const Uint16 *) (src + xofs[i + 3]);
+    }
+    for (; i < w; ++i) {
+        d[i] = *(const Uint16 *) (src + xofs[i]);
+    }
+}
 
-static int
-generate_rowbytes(int src_w, int dst_w, int bpp)
+static void
+stretch_row3(const Uint8 * src, Uint8 * dst, int w, const int *xofs)
 {
-    static struct
-    {
-        int bpp;
-        int src_w;
-        int dst_w;
-        int status;
-    } last;
-
     int i;
-    int pos, inc;
-    unsigned char *eip, *fence;
-    unsigned char load, store;
 
-    /* See if we need to regenerate the copy buffer */
-    if ((src_w == last.src_w) && (dst_w == last.dst_w) && (bpp == last.bpp)) {
-        return (last.status);
+    for (i = 0; i < w; ++i) {
+        const Uint8 *p = src + xofs[i];
+        dst[0] = p[0];
+        dst[1] = p[1];
+        dst[2] = p[2];
+        dst += 3;
     }
-    last.bpp = bpp;
-    last.src_w = src_w;
-    last.dst_w = dst_w;
-    last.status = -1;
+}
 
-    switch (bpp) {
-    case 1:
-        load = LOAD_BYTE;
-        store = STORE_BYTE;
-        break;
-    case 2:
-    case 4:
-        load = LOAD_WORD;
-        store = STORE_WORD;
-        break;
-    default:
-        return SDL_SetError("ASM stretch of %d bytes isn't supported\n", bpp);
-    }
-#ifdef HAVE_MPROTECT
-    /* Make the code writeable */
-    if (mprotect(copy_row, sizeof(copy_row), PROT_READ | PROT_WRITE) < 0) {
-        return SDL_SetError("Couldn't make copy buffer writeable");
-    }
-#endif
-    pos = 0x10000;
-    inc = (src_w << 16) / dst_w;
-    eip = copy_row;
-    fence = copy_row + sizeof(copy_row)-2;
-    for (i = 0; i < dst_w; ++i) {
-        while (pos >= 0x10000L) {
-            if (eip == fence) {
-                return -1;
-            }
-            if (bpp == 2) {
-                *eip++ = PREFIX16;
-            }
-            *eip++ = load;
-            pos -= 0x10000L;
-        }
-        if (eip == fence) {
-            return -1;
-        }
-        if (bpp == 2) {
-            *eip++ = PREFIX16;
-        }
-        *eip++ = store;
-        pos += inc;
-    }
-    *eip++ = RETURN;
+static void
+stretch_row4(const Uint8 * src, Uint8 * dst, int w, const int *xofs)
+{
+    Uint32 *d = (Uint32 *) dst;
+    int i;
 
-#ifdef HAVE_MPROTECT
-    /* Make the code executable but not writeable */
-    if (mprotect(copy_row, sizeof(copy_row), PROT_READ | PROT_EXEC) < 0) {
-        return SDL_SetError("Couldn't make copy buffer executable");
+    for (i = 0; i + 4 <= w; i += 4) {
+        d[i + 0] = *(const Uint32 *) (src + xofs[i + 0]);
+        d[i + 1] = *(const Uint32 *) (src + xofs[i + 1]);
+        d[i + 2] = *(const Uint32 *) (src + xofs[i + 2]);
+        d[i + 3] = *(const Uint32 *) (src + xofs[i + 3]);
+    }
+    for (; i < w; ++i) {
+        d[i] = *(const Uint32 *) (src + xofs[i]);
     }
-#endif
-    last.status = 0;
-    return (0);
 }
 
-#endif /* USE_ASM_STRETCH */
-
-#define DEFINE_COPY_ROW(name, type)         \
-static void name(type *src, int src_w, type *dst, int dst_w)    \
-{                                           \
-    int i;                                  \
-    int pos, inc;                           \
-    type pixel = 0;                         \
-                                            \
-    pos = 0x10000;                          \
-    inc = (src_w << 16) / dst_w;            \
-    for ( i=dst_w; i>0; --i ) {             \
-        while ( pos >= 0x10000L ) {         \
-            pixel = *src++;                 \
-            pos -= 0x10000L;                \
-        }                                   \
-        *dst++ = pixel;                     \
-        pos += inc;                         \
-    }                                       \
+#ifdef __SSE2__
+/* Gather a full register of pixels and write it with a single store */
+static void
+stretch_row2_SSE2(const Uint8 * src, Uint8 * dst, int w, const int *xofs)
+{
+    int i;
+
+    for (i = 0; i + 8 <= w; i += 8) {
+        __m128i v = _mm_cvtsi32_si128(*(const Uint16 *) (src + xofs[i]));
+        v = _mm_insert_epi16(v, *(const Uint16 *) (src + xofs[i + 1]), 1);
+        v = _mm_insert_epi16(v, *(const Uint16 *) (src + xofs[i + 2]), 2);
+        v = _mm_insert_epi16(v, *(const Uint16 *) (src + xofs[i + 3]), 3);
+        v = _mm_insert_epi16(v, *(const Uint16 *) (src + xofs[i + 4]), 4);
+        v = _mm_insert_epi16(v, *(const Uint16 *) (src + xofs[i + 5]), 5);
+        v = _mm_insert_epi16(v, *(const Uint16 *) (src + xofs[i + 6]), 6);
+        v = _mm_insert_epi16(v, *(const Uint16 *) (src + xofs[i + 7]), 7);
+        _mm_storeu_si128((__m128i *) (dst + i * 2), v);
+    }
+    stretch_row2(src, dst + i * 2, w - i, xofs + i);
 }
-/* *INDENT-OFF* */
-DEFINE_COPY_ROW(copy_row1, Uint8)
-DEFINE_COPY_ROW(copy_row2, Uint16)
-DEFINE_COPY_ROW(copy_row4, Uint32)
-/* *INDENT-ON* */
 
-/* The ASM code doesn't handle 24-bpp stretch blits */
 static void
-copy_row3(Uint8 * src, int src_w, Uint8 * dst, int dst_w)
+stretch_row4_SSE2(const Uint8 * src, Uint8 * dst, int w, const int *xofs)
 {
     int i;
-    int pos, inc;
-    Uint8 pixel[3] = { 0, 0, 0 };
-
-    pos = 0x10000;
-    inc = (src_w << 16) / dst_w;
-    for (i = dst_w; i > 0; --i) {
-        while (pos >= 0x10000L) {
-            pixel[0] = *src++;
-            pixel[1] = *src++;
-            pixel[2] = *src++;
-            pos -= 0x10000L;
-        }
-        *dst++ = pixel[0];
-        *dst++ = pixel[1];
-        *dst++ = pixel[2];
-        pos += inc;
+
+    for (i = 0; i + 4 <= w; i += 4) {
+        const __m128i p01 =
+            _mm_unpacklo_epi32(_mm_cvtsi32_si128(*(const int *) (src + xofs[i])),
+                               _mm_cvtsi32_si128(*(const int *) (src + xofs[i + 1])));
+        const __m128i p23 =
+            _mm_unpacklo_epi32(_mm_cvtsi32_si128(*(const int *) (src + xofs[i + 2])),
+                               _mm_cvtsi32_si128(*(const int *) (src + xofs[i + 3])));
+        _mm_storeu_si128((__m128i *) (dst + i * 4), _mm_unpacklo_epi64(p01, p23));
     }
+    stretch_row4(src, dst + i * 4, w - i, xofs + i);
 }
+#endif /* __SSE2__ */
 
-/* Perform a stretch blit between two surfaces of the same format.
-   NOTE:  This function is not safe to call from multiple threads!
-*/
+/* Perform a stretch blit between two surfaces of the same format. */
 int
 SDL_SoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
                 SDL_Surface * dst, const SDL_Rect * dstrect)
 {
+    void (*stretch_row) (const Uint8 *, Uint8 *, int, const int *);
     int src_locked;
     int dst_locked;
-    int pos, inc;
-    int dst_maxrow;
-    int src_row, dst_row;
-    Uint8 *srcp = NULL;
+    Sint64 pos, inc;
+    int i, src_row, last_row;
+    int *xofs;
+    const Uint8 *srcp;
     Uint8 *dstp;
     SDL_Rect full_src;
     SDL_Rect full_dst;
-#ifdef USE_ASM_STRETCH
-    SDL_bool use_asm = SDL_TRUE;
-#ifdef __GNUC__
-    int u1, u2;
-#endif
-#endif /* USE_ASM_STRETCH */
     const int bpp = dst->format->BytesPerPixel;
 
     if (src->format->format != dst->format->format) {
@@ -252,10 +188,52 @@ SDL_SoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
         dstrect = &full_dst;
     }
 
+    if (SDL_RectEmpty(srcrect) || SDL_RectEmpty(dstrect)) {
+        return 0;
+    }
+
+    switch (bpp) {
+    case 1:
+        stretch_row = stretch_row1;
+        break;
+    case 2:
+        stretch_row = stretch_row2;
+#ifdef __SSE2__
+        if (SDL_HasSSE2()) {
+            stretch_row = stretch_row2_SSE2;
+        }
+#endif
+        break;
+    case 3:
+        stretch_row = stretch_row3;
+        break;
+    case 4:
+        stretch_row = stretch_row4;
+#ifdef __SSE2__
+        if (SDL_HasSSE2()) {
+            stretch_row = stretch_row4_SSE2;
+        }
+#endif
+        break;
+    default:
+        return SDL_SetError("Stretch of %d bytes per pixel isn't supported", bpp);
+    }
+
+    /* Byte offset of the source pixel for each destination column */
+    xofs = (int *) SDL_malloc(dstrect->w * sizeof(*xofs));
+    if (!xofs) {
+        return SDL_OutOfMemory();
+    }
+    inc = ((Sint64) srcrect->w << 16) / dstrect->w;
+    for (i = 0, pos = 0; i < dstrect->w; ++i, pos += inc) {
+        xofs[i] = (int) (pos >> 16) * bpp;
+    }
+
     /* Lock the destination if it's in hardware */
     dst_locked = 0;
     if (SDL_MUSTLOCK(dst)) {
         if (SDL_LockSurface(dst) < 0) {
+            SDL_free(xofs);
             return SDL_SetError("Unable to lock destination surface");
         }
         dst_locked = 1;
@@ -267,87 +245,298 @@ SDL_SoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
             if (dst_locked) {
                 SDL_UnlockSurface(dst);
             }
+            SDL_free(xofs);
             return SDL_SetError("Unable to lock source surface");
         }
         src_locked = 1;
     }
 
-    /* Set up the data... */
-    pos = 0x10000;
-    inc = (srcrect->h << 16) / dstrect->h;
-    src_row = srcrect->y;
-    dst_row = dstrect->y;
+    /* Perform the stretch blit */
+    inc = ((Sint64) srcrect->h << 16) / dstrect->h;
+    last_row = -1;
+    dstp = (Uint8 *) dst->pixels + dstrect->y * dst->pitch + dstrect->x * bpp;
+    for (i = 0, pos = 0; i < dstrect->h; ++i, pos += inc) {
+        src_row = (int) (pos >> 16);
+        if (src_row == last_row) {
+            SDL_memcpy(dstp, dstp - dst->pitch, dstrect->w * bpp);
+        } else {
+            srcp = (const Uint8 *) src->pixels +
+                (srcrect->y + src_row) * src->pitch + srcrect->x * bpp;
+            stretch_row(srcp, dstp, dstrect->w, xofs);
+            last_row = src_row;
+        }
+        dstp += dst->pitch;
+    }
 
-#ifdef USE_ASM_STRETCH
-    /* Write the opcodes for this stretch */
-    if ((bpp == 3) || (generate_rowbytes(srcrect->w, dstrect->w, bpp) < 0)) {
-        use_asm = SDL_FALSE;
+    /* We need to unlock the surfaces if they're locked */
+    if (dst_locked) {
+        SDL_UnlockSurface(dst);
+    }
+    if (src_locked) {
+        SDL_UnlockSurface(src);
+    }
+    SDL_free(xofs);
+    return (0);
+}
+
+/* Bilinear stretching of 32-bit surfaces, used for SDL_COPY_LINEAR blits.
+
+   Sample positions are kept in 16.16 fixed point and the filter weights
+   are cut down to 8 bits, so every channel is computed as
+   (a * (256 - w) + b * w) >> 8, which never leaves a 16-bit lane.  The
+   pixels are filtered as four opaque bytes, so this works for any of the
+   8888 layouts without looking at the channel masks.
+*/
+
+SDL_bool
+SDL_CanStretchLinear(SDL_Surface * surface)
+{
+    const SDL_PixelFormat *fmt = surface->format;
+
+    if (fmt->BytesPerPixel != 4 ||
+        SDL_ISPIXELFORMAT_INDEXED(fmt->format) ||
+        SDL_ISPIXELFORMAT_FOURCC(fmt->format)) {
+        return SDL_FALSE;
+    }
+    /* Filtering would blend the color key into the neighbouring pixels */
+    if (surface->map->info.flags & SDL_COPY_COLORKEY) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static SDL_INLINE Uint32
+lerp_pixel(Uint32 a, Uint32 b, Uint32 w)
+{
+    const Uint32 iw = 256 - w;
+    const Uint32 rb = ((a & 0x00FF00FF) * iw + (b & 0x00FF00FF) * w) >> 8;
+    const Uint32 ga = ((a >> 8) & 0x00FF00FF) * iw + ((b >> 8) & 0x00FF00FF) * w;
+
+    return (rb & 0x00FF00FF) | (ga & 0xFF00FF00);
+}
+
+static void
+filter_row_v(const Uint32 * a, const Uint32 * b, Uint32 * dst, int n, Uint32 w)
+{
+    int i;
+
+    for (i = 0; i < n; ++i) {
+        dst[i] = lerp_pixel(a[i], b[i], w);
+    }
+}
+
+static void
+filter_row_h(const Uint32 * src, Uint32 * dst, int n,
+             const int *xofs, const Uint8 * xweight)
+{
+    int i;
+
+    for (i = 0; i < n; ++i) {
+        const Uint32 *p = src + xofs[i];
+        dst[i] = lerp_pixel(p[0], p[1], xweight[i]);
+    }
+}
+
+#ifdef __SSE2__
+static void
+filter_row_v_SSE2(const Uint32 * a, const Uint32 * b, Uint32 * dst, int n, Uint32 w)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w0 = _mm_set1_epi16((short)(256 - w));
+    const __m128i w1 = _mm_set1_epi16((short)w);
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        const __m128i pa = _mm_loadu_si128((const __m128i *)(a + i));
+        const __m128i pb = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i lo, hi;
+
+        lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pa, zero), w0),
+                           _mm_mullo_epi16(_mm_unpacklo_epi8(pb, zero), w1));
+        hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pa, zero), w0),
+                           _mm_mullo_epi16(_mm_unpackhi_epi8(pb, zero), w1));
+        lo = _mm_srli_epi16(lo, 8);
+        hi = _mm_srli_epi16(hi, 8);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    filter_row_v(a + i, b + i, dst + i, n - i, w);
+}
+
+static void
+filter_row_h_SSE2(const Uint32 * src, Uint32 * dst, int n,
+                  const int *xofs, const Uint8 * xweight)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int i;
+
+    for (i = 0; i + 2 <= n; i += 2) {
+        const short w0 = xweight[i], w1 = xweight[i + 1];
+        /* Each register holds a pixel and its right neighbour */
+        __m128i p0 = _mm_loadl_epi64((const __m128i *)(src + xofs[i]));
+        __m128i p1 = _mm_loadl_epi64((const __m128i *)(src + xofs[i + 1]));
+        __m128i sum;
+
+        p0 = _mm_mullo_epi16(_mm_unpacklo_epi8(p0, zero),
+                             _mm_set_epi16(w0, w0, w0, w0,
+                                           256 - w0, 256 - w0, 256 - w0, 256 - w0));
+        p1 = _mm_mullo_epi16(_mm_unpacklo_epi8(p1, zero),
+                             _mm_set_epi16(w1, w1, w1, w1,
+                                           256 - w1, 256 - w1, 256 - w1, 256 - w1));
+        sum = _mm_add_epi16(_mm_unpacklo_epi64(p0, p1), _mm_unpackhi_epi64(p0, p1));
+        sum = _mm_srli_epi16(sum, 8);
+        _mm_storel_epi64((__m128i *)(dst + i), _mm_packus_epi16(sum, sum));
+    }
+    filter_row_h(src, dst + i, n - i, xofs + i, xweight + i);
+}
+#endif /* __SSE2__ */
+
+/* Map destination samples onto the source, aligning pixel centers */
+static SDL_INLINE void
+linear_step(int src_len, int dst_len, Sint64 * pos, Sint64 * inc)
+{
+    *inc = ((Sint64) src_len << 16) / dst_len;
+    *pos = *inc / 2 - 0x8000;
+}
+
+static SDL_INLINE int
+linear_sample(Sint64 pos, int src_len, Uint32 * weight)
+{
+    int i;
+
+    if (pos < 0) {
+        *weight = 0;
+        return 0;
+    }
+    i = (int) (pos >> 16);
+    if (i >= src_len - 1) {
+        *weight = 0;
+        return src_len - 1;
+    }
+    *weight = (Uint32) (pos >> 8) & 0xFF;
+    return i;
+}
+
+/* The blit function for SDL_COPY_LINEAR.  Every destination row is filtered
+   in the source format and then passed to the unscaled blitter chosen for
+   the surface, so modulation and blending behave just like a normal blit.
+   Plain copies are filtered straight into the destination.
+*/
+int
+SDL_StretchLinearBlit(SDL_Surface * src, SDL_Rect * srcrect,
+                      SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    SDL_BlitInfo *info = &src->map->info;
+    SDL_BlitFunc RunBlit = (SDL_BlitFunc) src->map->data;
+    void (*filter_v) (const Uint32 *, const Uint32 *, Uint32 *, int, Uint32);
+    void (*filter_h) (const Uint32 *, Uint32 *, int, const int *, const Uint8 *);
+    const int src_w = srcrect->w;
+    const int src_h = srcrect->h;
+    const int dst_w = dstrect->w;
+    const int dst_h = dstrect->h;
+    const int dstbpp = dst->format->BytesPerPixel;
+    const SDL_bool direct = (RunBlit == SDL_BlitCopy);
+    Uint8 *work;
+    Uint32 *row, *out;
+    Uint8 *xweight;
+    int *xofs;
+    Sint64 pos, inc;
+    int x, y;
+    int src_locked = 0;
+    int dst_locked = 0;
+    int status = 0;
+
+    if (SDL_RectEmpty(srcrect) || SDL_RectEmpty(dstrect)) {
+        return 0;
+    }
+
+    /* The vertically filtered source row gets one extra pixel on the right,
+       so the horizontal filter can always read a pixel and its neighbour */
+    work = (Uint8 *) SDL_malloc((src_w + 1) * sizeof(Uint32) +
+                                (direct ? 0 : dst_w * sizeof(Uint32)) +
+                                dst_w * (sizeof(int) + 1));
+    if (!work) {
+        return SDL_OutOfMemory();
+    }
+    row = (Uint32 *) work;
+    out = row + src_w + 1;
+    xofs = (int *) (direct ? out : out + dst_w);
+    xweight = (Uint8 *) (xofs + dst_w);
+
+    linear_step(src_w, dst_w, &pos, &inc);
+    for (x = 0; x < dst_w; ++x, pos += inc) {
+        Uint32 weight;
+        xofs[x] = linear_sample(pos, src_w, &weight);
+        xweight[x] = (Uint8) weight;
+    }
+
+    filter_v = filter_row_v;
+    filter_h = filter_row_h;
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        filter_v = filter_row_v_SSE2;
+        filter_h = filter_row_h_SSE2;
     }
 #endif
 
-    /* Perform the stretch blit */
-    for (dst_maxrow = dst_row + dstrect->h; dst_row < dst_maxrow; ++dst_row) {
-        dstp = (Uint8 *) dst->pixels + (dst_row * dst->pitch)
-            + (dstrect->x * bpp);
-        while (pos >= 0x10000L) {
-            srcp = (Uint8 *) src->pixels + (src_row * src->pitch)
-                + (srcrect->x * bpp);
-            ++src_row;
-            pos -= 0x10000L;
+    if (SDL_MUSTLOCK(dst)) {
+        if (SDL_LockSurface(dst) < 0) {
+            status = -1;
+        } else {
+            dst_locked = 1;
+        }
+    }
+    if (SDL_MUSTLOCK(src)) {
+        if (SDL_LockSurface(src) < 0) {
+            status = -1;
+        } else {
+            src_locked = 1;
         }
-#ifdef USE_ASM_STRETCH
-        if (use_asm) {
-#ifdef __GNUC__
-            __asm__ __volatile__("call *%4":"=&D"(u1), "=&S"(u2)
-                                 :"0"(dstp), "1"(srcp), "r"(copy_row)
-                                 :"memory");
-#elif defined(_MSC_VER) || defined(__WATCOMC__)
-            /* *INDENT-OFF* */
-            {
-                void *code = copy_row;
-                __asm {
-                    push edi
-                    push esi
-                    mov edi, dstp
-                    mov esi, srcp
-                    call dword ptr code
-                    pop esi
-                    pop edi
-                }
-            }
-            /* *INDENT-ON* */
-#else
-#error Need inline assembly for this compiler
-#endif
-        } else
-#endif
-            switch (bpp) {
-            case 1:
-                copy_row1(srcp, srcrect->w, dstp, dstrect->w);
-                break;
-            case 2:
-                copy_row2((Uint16 *) srcp, srcrect->w,
-                          (Uint16 *) dstp, dstrect->w);
-                break;
-            case 3:
-                copy_row3(srcp, srcrect->w, dstp, dstrect->w);
-                break;
-            case 4:
-                copy_row4((Uint32 *) srcp, srcrect->w,
-                          (Uint32 *) dstp, dstrect->w);
-                break;
-            }
-        pos += inc;
     }
 
-    /* We need to unlock the surfaces if they're locked */
+    linear_step(src_h, dst_h, &pos, &inc);
+    for (y = 0; status == 0 && y < dst_h; ++y, pos += inc) {
+        Uint32 weight;
+        const int sy = linear_sample(pos, src_h, &weight);
+        const Uint32 *row0 = (const Uint32 *) ((Uint8 *) src->pixels +
+                              (srcrect->y + sy) * src->pitch) + srcrect->x;
+        Uint8 *dstp = (Uint8 *) dst->pixels +
+                      (dstrect->y + y) * dst->pitch + dstrect->x * dstbpp;
+
+        if (weight) {
+            const Uint32 *row1 = (const Uint32 *) ((const Uint8 *) row0 + src->pitch);
+            filter_v(row0, row1, row, src_w, weight);
+        } else {
+            SDL_memcpy(row, row0, src_w * sizeof(Uint32));
+        }
+        row[src_w] = row[src_w - 1];
+
+        if (direct) {
+            filter_h(row, (Uint32 *) dstp, dst_w, xofs, xweight);
+            continue;
+        }
+
+        filter_h(row, out, dst_w, xofs, xweight);
+        info->src = (Uint8 *) out;
+        info->src_w = dst_w;
+        info->src_h = 1;
+        info->src_pitch = dst_w * sizeof(Uint32);
+        info->src_skip = 0;
+        info->dst = dstp;
+        info->dst_w = dst_w;
+        info->dst_h = 1;
+        info->dst_pitch = dst->pitch;
+        info->dst_skip = dst->pitch - dst_w * dstbpp;
+        RunBlit(info);
+    }
+
     if (dst_locked) {
         SDL_UnlockSurface(dst);
     }
     if (src_locked) {
         SDL_UnlockSurface(src);
     }
-    return (0);
+    SDL_free(work);
+    return status;
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -21,25 +21,240 @@
 #include "../SDL_internal.h"
 
 #include "SDL_video.h"
+#include "SDL_atomic.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
+#include "SDL_yuv_c.h"
+
+/*
+ * Aligned and pooled surface pixels are allocated on an SDL_SURFACE_ALIGNMENT
+ * boundary, with a header right in front of them recording the allocation and
+ * the pool the buffer goes back to when the surface is freed.  Other surfaces
+ * keep plain heap pixels, which applications are allowed to free or replace.
+ */
+typedef struct SDL_PixelBuffer
+{
+    void *allocation;
+    SDL_SurfacePool *pool;
+    size_t size;
+    struct SDL_PixelBuffer *next;
+} SDL_PixelBuffer;
+
+/* Four size classes per power of two, so at most a fifth of a buffer is wasted */
+#define SDL_POOL_MIN_CLASS  256
+#define SDL_POOL_CLASSES    (4 * (int) (sizeof(size_t) * 8 - 8) + 1)
+
+struct SDL_SurfacePool
+{
+    SDL_SpinLock lock;
+    SDL_bool freed;
+    int refcount;               /* the pool itself, and each buffer handed out */
+    size_t max_bytes;
+    size_t free_bytes;
+    SDL_PixelBuffer *free[SDL_POOL_CLASSES];
+};
+
+static size_t
+SDL_GetPoolSizeClass(size_t size, int *index)
+{
+    size_t base = SDL_POOL_MIN_CLASS;
+    size_t step;
+    int steps;
+
+    *index = 0;
+    if (size <= base) {
+        return base;
+    }
+    while (base < size / 2) {
+        base *= 2;
+        *index += 4;
+    }
+    step = base / 4;
+    steps = (int) ((size - base + step - 1) / step);
+    *index += steps;
+    return base + steps * step;
+}
+
+static SDL_PixelBuffer *
+SDL_NewPixelBuffer(SDL_SurfacePool * pool, size_t size)
+{
+    const size_t overhead = sizeof(SDL_PixelBuffer) + SDL_SURFACE_ALIGNMENT - 1;
+    SDL_PixelBuffer *buffer;
+    Uint8 *allocation;
+    uintptr_t pixels;
+
+    if (size > ((size_t) -1) - overhead) {
+        return NULL;
+    }
+    allocation = (Uint8 *) SDL_calloc(1, overhead + size);
+    if (!allocation) {
+        return NULL;
+    }
+    pixels = (uintptr_t) (allocation + overhead) & ~(uintptr_t) (SDL_SURFACE_ALIGNMENT - 1);
+    buffer = (SDL_PixelBuffer *) pixels - 1;
+    buffer->allocation = allocation;
+    buffer->pool = pool;
+    buffer->size = size;
+    buffer->next = NULL;
+    return buffer;
+}
+
+static void
+SDL_UnrefSurfacePool(SDL_SurfacePool * pool)
+{
+    SDL_bool last;
+
+    SDL_AtomicLock(&pool->lock);
+    last = (--pool->refcount == 0);
+    SDL_AtomicUnlock(&pool->lock);
+    if (last) {
+        SDL_free(pool);
+    }
+}
+
+/*
+ * Allocate zeroed pixels for a surface, from a pool if there is one
+ */
+void *
+SDL_AllocSurfacePixels(SDL_SurfacePool * pool, size_t size)
+{
+    SDL_PixelBuffer *buffer = NULL;
+    size_t class_size = size;
+    int index = 0;
+
+    if (pool) {
+        class_size = SDL_GetPoolSizeClass(size, &index);
+        if (index >= SDL_POOL_CLASSES || class_size < size) {
+            /* Too large to be worth recycling */
+            pool = NULL;
+            class_size = size;
+        }
+    }
+    if (pool) {
+        SDL_AtomicLock(&pool->lock);
+        buffer = pool->free[index];
+        if (buffer) {
+            pool->free[index] = buffer->next;
+            pool->free_bytes -= buffer->size;
+        }
+        ++pool->refcount;
+        SDL_AtomicUnlock(&pool->lock);
+    }
+    if (buffer) {
+        /* This is important for bitmaps */
+        SDL_memset(buffer + 1, 0, size);
+    } else {
+        /* New buffers come zeroed from the heap */
+        buffer = SDL_NewPixelBuffer(pool, class_size);
+        if (!buffer) {
+            if (pool) {
+                SDL_UnrefSurfacePool(pool);
+            }
+            SDL_OutOfMemory();
+            return NULL;
+        }
+    }
+    return buffer + 1;
+}
+
+/*
+ * Release pixels from SDL_AllocSurfacePixels() to the heap or their pool
+ */
+void
+SDL_FreeSurfacePixels(void *pixels)
+{
+    SDL_PixelBuffer *buffer;
+    SDL_SurfacePool *pool;
+
+    if (!pixels) {
+        return;
+    }
+    buffer = (SDL_PixelBuffer *) pixels - 1;
+    pool = buffer->pool;
+    if (pool) {
+        SDL_bool kept = SDL_FALSE;
+        int index;
+
+        SDL_GetPoolSizeClass(buffer->size, &index);
+        SDL_AtomicLock(&pool->lock);
+        if (!pool->freed &&
+            (!pool->max_bytes ||
+             pool->free_bytes + buffer->size <= pool->max_bytes)) {
+            buffer->next = pool->free[index];
+            pool->free[index] = buffer;
+            pool->free_bytes += buffer->size;
+            kept = SDL_TRUE;
+        }
+        SDL_AtomicUnlock(&pool->lock);
+        if (!kept) {
+            SDL_free(buffer->allocation);
+        }
+        SDL_UnrefSurfacePool(pool);
+    } else {
+        SDL_free(buffer->allocation);
+    }
+}
 
 /* Public routines */
+
+SDL_SurfacePool *
+SDL_CreateSurfacePool(size_t max_bytes)
+{
+    SDL_SurfacePool *pool;
+
+    pool = (SDL_SurfacePool *) SDL_calloc(1, sizeof(*pool));
+    if (!pool) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    pool->refcount = 1;
+    pool->max_bytes = max_bytes;
+    return pool;
+}
+
+void
+SDL_FreeSurfacePool(SDL_SurfacePool * pool)
+{
+    SDL_PixelBuffer *unused[SDL_POOL_CLASSES];
+    int i;
+
+    if (!pool) {
+        return;
+    }
+
+    SDL_AtomicLock(&pool->lock);
+    pool->freed = SDL_TRUE;
+    SDL_memcpy(unused, pool->free, sizeof(unused));
+    SDL_zero(pool->free);
+    pool->free_bytes = 0;
+    SDL_AtomicUnlock(&pool->lock);
+
+    for (i = 0; i < SDL_POOL_CLASSES; ++i) {
+        while (unused[i]) {
+            SDL_PixelBuffer *buffer = unused[i];
+            unused[i] = buffer->next;
+            SDL_free(buffer->allocation);
+        }
+    }
+    SDL_UnrefSurfacePool(pool);
+}
+
 /*
  * Create an empty RGB surface of the appropriate depth
  */
 SDL_Surface *
-SDL_CreateRGBSurface(Uint32 flags,
-                     int width, int height, int depth,
-                     Uint32 Rmask, Uint32 Gmask, Uint32 Bmask, Uint32 Amask)
+SDL_CreateRGBSurfaceFromPool(SDL_SurfacePool * pool, Uint32 flags,
+                             int width, int height, int depth,
+                             Uint32 Rmask, Uint32 Gmask, Uint32 Bmask,
+                             Uint32 Amask)
 {
     SDL_Surface *surface;
     Uint32 format;
 
-    /* The flags are no longer used, make the compiler happy */
-    (void)flags;
+    /* Only the alignment flag can be requested */
+    flags &= SDL_SIMD_ALIGNED;
 
     /* Get the pixel format */
     format = SDL_MasksToPixelFormatEnum(depth, Rmask, Gmask, Bmask, Amask);
@@ -60,9 +275,14 @@ SDL_CreateRGBSurface(Uint32 flags,
         SDL_FreeSurface(surface);
         return NULL;
     }
+    surface->flags = flags;
     surface->w = width;
     surface->h = height;
     surface->pitch = SDL_CalculatePitch(surface);
+    if (flags & SDL_SIMD_ALIGNED) {
+        surface->pitch = (surface->pitch + SDL_SURFACE_ALIGNMENT - 1) &
+                         ~(SDL_SURFACE_ALIGNMENT - 1);
+    }
     SDL_SetClipRect(surface, NULL);
 
     if (SDL_ISPIXELFORMAT_INDEXED(surface->format->format)) {
@@ -85,18 +305,6 @@ SDL_CreateRGBSurface(Uint32 flags,
         SDL_FreePalette(palette);
     }
 
-    /* Get the pixels */
-    if (surface->w && surface->h) {
-        surface->pixels = SDL_malloc(surface->h * surface->pitch);
-        if (!surface->pixels) {
-            SDL_FreeSurface(surface);
-            SDL_OutOfMemory();
-            return NULL;
-        }
-        /* This is important for bitmaps */
-        SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
-    }
-
     /* Allocate an empty mapping */
     surface->map = SDL_AllocBlitMap();
     if (!surface->map) {
@@ -104,6 +312,29 @@ SDL_CreateRGBSurface(Uint32 flags,
         return NULL;
     }
 
+    /* Get the pixels */
+    if (surface->w && surface->h) {
+        const size_t size = (size_t) surface->h * surface->pitch;
+
+        if (pool || (flags & SDL_SIMD_ALIGNED)) {
+            surface->pixels = SDL_AllocSurfacePixels(pool, size);
+            if (!surface->pixels) {
+                SDL_FreeSurface(surface);
+                return NULL;
+            }
+            surface->map->pixelbuffer = SDL_TRUE;
+        } else {
+            surface->pixels = SDL_malloc(size);
+            if (!surface->pixels) {
+                SDL_FreeSurface(surface);
+                SDL_OutOfMemory();
+                return NULL;
+            }
+            /* This is important for bitmaps */
+            SDL_memset(surface->pixels, 0, size);
+        }
+    }
+
     /* By default surface with an alpha mask are set up for blending */
     if (Amask) {
         SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
@@ -114,6 +345,15 @@ SDL_CreateRGBSurface(Uint32 flags,
     return surface;
 }
 
+SDL_Surface *
+SDL_CreateRGBSurface(Uint32 flags,
+                     int width, int height, int depth,
+                     Uint32 Rmask, Uint32 Gmask, Uint32 Bmask, Uint32 Amask)
+{
+    return SDL_CreateRGBSurfaceFromPool(NULL, flags, width, height, depth,
+                                        Rmask, Gmask, Bmask, Amask);
+}
+
 /*
  * Create an RGB surface from an existing memory buffer
  */
@@ -148,6 +388,7 @@ SDL_SetSurfacePalette(SDL_Surface * surface, SDL_Palette * palette)
         return -1;
     }
     SDL_InvalidateMap(surface->map);
+    SDL_ClearBlitMapCache(surface->map);
 
     return 0;
 }
@@ -399,7 +640,8 @@ SDL_SetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode blendMode)
     status = 0;
     flags = surface->map->info.flags;
     surface->map->info.flags &=
-        ~(SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD);
+        ~(SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD |
+          SDL_COPY_BLEND_PREMULTIPLIED);
     switch (blendMode) {
     case SDL_BLENDMODE_NONE:
         break;
@@ -412,6 +654,9 @@ SDL_SetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode blendMode)
     case SDL_BLENDMODE_MOD:
         surface->map->info.flags |= SDL_COPY_MOD;
         break;
+    case SDL_BLENDMODE_PREMULTIPLIED:
+        surface->map->info.flags |= SDL_COPY_BLEND_PREMULTIPLIED;
+        break;
     default:
         status = SDL_Unsupported();
         break;
@@ -436,7 +681,8 @@ SDL_GetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode *blendMode)
     }
 
     switch (surface->map->
-            info.flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD)) {
+            info.flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD |
+                          SDL_COPY_BLEND_PREMULTIPLIED)) {
     case SDL_COPY_BLEND:
         *blendMode = SDL_BLENDMODE_BLEND;
         break;
@@ -446,6 +692,9 @@ SDL_GetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode *blendMode)
     case SDL_COPY_MOD:
         *blendMode = SDL_BLENDMODE_MOD;
         break;
+    case SDL_COPY_BLEND_PREMULTIPLIED:
+        *blendMode = SDL_BLENDMODE_PREMULTIPLIED;
+        break;
     default:
         *blendMode = SDL_BLENDMODE_NONE;
         break;
@@ -453,6 +702,39 @@ SDL_GetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode *blendMode)
     return 0;
 }
 
+int
+SDL_SetSurfaceScaleMode(SDL_Surface * surface, SDL_ScaleMode scaleMode)
+{
+    if (!surface) {
+        return -1;
+    }
+
+    switch (scaleMode) {
+    case SDL_SCALEMODE_NEAREST:
+    case SDL_SCALEMODE_LINEAR:
+        break;
+    default:
+        return SDL_Unsupported();
+    }
+
+    /* The scaled blit picks up the new filter the next time it runs */
+    surface->map->scale_mode = scaleMode;
+    return 0;
+}
+
+int
+SDL_GetSurfaceScaleMode(SDL_Surface * surface, SDL_ScaleMode *scaleMode)
+{
+    if (!surface) {
+        return -1;
+    }
+
+    if (scaleMode) {
+        *scaleMode = surface->map->scale_mode;
+    }
+    return 0;
+}
+
 SDL_bool
 SDL_SetClipRect(SDL_Surface * surface, const SDL_Rect * rect)
 {
@@ -601,8 +883,8 @@ SDL_UpperBlit(SDL_Surface * src, const SDL_Rect * srcrect,
     }
 
     /* Switch back to a fast blit if we were previously stretching */
-    if (src->map->info.flags & SDL_COPY_NEAREST) {
-        src->map->info.flags &= ~SDL_COPY_NEAREST;
+    if (src->map->info.flags & (SDL_COPY_NEAREST | SDL_COPY_LINEAR)) {
+        src->map->info.flags &= ~(SDL_COPY_NEAREST | SDL_COPY_LINEAR);
         SDL_InvalidateMap(src->map);
     }
 
@@ -779,15 +1061,24 @@ SDL_LowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
     static const Uint32 complex_copy_flags = (
         SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA |
         SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD |
-        SDL_COPY_COLORKEY
+        SDL_COPY_BLEND_PREMULTIPLIED | SDL_COPY_COLORKEY
     );
 
-    if (!(src->map->info.flags & SDL_COPY_NEAREST)) {
-        src->map->info.flags |= SDL_COPY_NEAREST;
+    Uint32 scale_flag = SDL_COPY_NEAREST;
+
+    if (src->map->scale_mode == SDL_SCALEMODE_LINEAR &&
+        SDL_CanStretchLinear(src)) {
+        scale_flag = SDL_COPY_LINEAR;
+    }
+
+    if ((src->map->info.flags & (SDL_COPY_NEAREST | SDL_COPY_LINEAR)) != scale_flag) {
+        src->map->info.flags &= ~(SDL_COPY_NEAREST | SDL_COPY_LINEAR);
+        src->map->info.flags |= scale_flag;
         SDL_InvalidateMap(src->map);
     }
 
-    if ( !(src->map->info.flags & complex_copy_flags) &&
+    if ( scale_flag == SDL_COPY_NEAREST &&
+         !(src->map->info.flags & complex_copy_flags) &&
          src->format->format == dst->format->format &&
          !SDL_ISPIXELFORMAT_INDEXED(src->format->format) ) {
         return SDL_SoftStretch( src, srcrect, dst, dstrect );
@@ -805,8 +1096,7 @@ SDL_LockSurface(SDL_Surface * surface)
     if (!surface->locked) {
         /* Perform the lock */
         if (surface->flags & SDL_RLEACCEL) {
-            SDL_UnRLESurface(surface, 1);
-            surface->flags |= SDL_RLEACCEL;     /* save accel'd state */
+            SDL_LockRLESurface(surface);
         }
     }
 
@@ -828,11 +1118,7 @@ SDL_UnlockSurface(SDL_Surface * surface)
         return;
     }
 
-    /* Update RLE encoded surface with new data */
-    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        surface->flags &= ~SDL_RLEACCEL;        /* stop lying */
-        SDL_RLESurface(surface);
-    }
+    /* RLE encoded surfaces pick up the new data on their next blit */
 }
 
 /*
@@ -904,9 +1190,10 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
     convert->map->info.g = copy_color.g;
     convert->map->info.b = copy_color.b;
     convert->map->info.a = copy_color.a;
+    convert->map->scale_mode = surface->map->scale_mode;
     convert->map->info.flags =
         (copy_flags &
-         ~(SDL_COPY_COLORKEY | SDL_COPY_BLEND
+         ~(SDL_COPY_COLORKEY | SDL_COPY_BLEND | SDL_COPY_BLEND_PREMULTIPLIED
            | SDL_COPY_RLE_DESIRED | SDL_COPY_RLE_COLORKEY |
            SDL_COPY_RLE_ALPHAKEY));
     surface->map->info.r = copy_color.r;
@@ -948,11 +1235,15 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
     }
     SDL_SetClipRect(convert, &surface->clip_rect);
 
+    /* The pixels are copied as they are, so they stay premultiplied */
+    convert->flags |= (surface->flags & SDL_PREMULTIPLIED);
+
     /* Enable alpha blending by default if the new surface has an
      * alpha channel or alpha modulation */
     if ((surface->format->Amask && format->Amask) ||
         (copy_flags & (SDL_COPY_COLORKEY|SDL_COPY_MODULATE_ALPHA))) {
-        SDL_SetSurfaceBlendMode(convert, SDL_BLENDMODE_BLEND);
+        SDL_SetSurfaceBlendMode(convert, (convert->flags & SDL_PREMULTIPLIED) ?
+                                SDL_BLENDMODE_PREMULTIPLIED : SDL_BLENDMODE_BLEND);
     }
     if ((copy_flags & SDL_COPY_RLE_DESIRED) || (flags & SDL_RLEACCEL)) {
         SDL_SetSurfaceRLE(convert, SDL_RLEACCEL);
@@ -1046,6 +1337,8 @@ int SDL_ConvertPixels(int width, int height,
             case SDL_PIXELFORMAT_YUY2:
             case SDL_PIXELFORMAT_UYVY:
             case SDL_PIXELFORMAT_YVYU:
+                /* Pixels are stored in pairs */
+                width = (width + 1) & ~1;
                 bpp = 2;
                 break;
             case SDL_PIXELFORMAT_YV12:
@@ -1070,18 +1363,22 @@ int SDL_ConvertPixels(int width, int height,
 
         if (src_format == SDL_PIXELFORMAT_YV12 || src_format == SDL_PIXELFORMAT_IYUV) {
             /* U and V planes are a quarter the size of the Y plane */
-            width /= 2;
-            height /= 2;
-            src_pitch /= 2;
-            dst_pitch /= 2;
+            width = (width + 1) / 2;
+            height = (height + 1) / 2;
+            src_pitch = (src_pitch + 1) / 2;
+            dst_pitch = (dst_pitch + 1) / 2;
             for (i = height * 2; i--;) {
                 SDL_memcpy(dst, src, width);
                 src = (Uint8*)src + src_pitch;
                 dst = (Uint8*)dst + dst_pitch;
             }
         } else if (src_format == SDL_PIXELFORMAT_NV12 || src_format == SDL_PIXELFORMAT_NV21) {
-            /* U/V plane is half the height of the Y plane */
-            height /= 2;
+            /* U/V plane is half the height of the Y plane, and its rows
+               are padded to an even length like in SDL_InitYUVImage() */
+            width = (width + 1) & ~1;
+            height = (height + 1) / 2;
+            src_pitch = (src_pitch + 1) & ~1;
+            dst_pitch = (dst_pitch + 1) & ~1;
             for (i = height; i--;) {
                 SDL_memcpy(dst, src, width);
                 src = (Uint8*)src + src_pitch;
@@ -1091,6 +1388,12 @@ int SDL_ConvertPixels(int width, int height,
         return 0;
     }
 
+    if (SDL_ISPIXELFORMAT_FOURCC(src_format) ||
+        SDL_ISPIXELFORMAT_FOURCC(dst_format)) {
+        return SDL_ConvertPixels_YUV(width, height, src_format, src, src_pitch,
+                                     dst_format, dst, dst_pitch);
+    }
+
     if (!SDL_CreateSurfaceOnStack(width, height, src_format, nonconst_src,
                                   src_pitch,
                                   &src_surface, &src_fmt, &src_blitmap)) {
@@ -1109,12 +1412,254 @@ int SDL_ConvertPixels(int width, int height,
     return SDL_LowerBlit(&src_surface, &rect, &dst_surface, &rect);
 }
 
+/*
+ * Find the alpha channel of a format that can be premultiplied
+ */
+static int
+SDL_GetPremultipliedAlphaShift(Uint32 format)
+{
+    int bpp, shift;
+    Uint32 Rmask, Gmask, Bmask, Amask;
+
+    if (!SDL_ISPIXELFORMAT_FOURCC(format) &&
+        SDL_PixelFormatEnumToMasks(format, &bpp, &Rmask, &Gmask, &Bmask, &Amask) &&
+        bpp == 32) {
+        for (shift = 0; shift < 32; shift += 8) {
+            if (Amask == (0xFFu << shift)) {
+                return shift;
+            }
+        }
+    }
+    return SDL_SetError("Premultiplied alpha needs a 32-bit format with an 8-bit alpha channel");
+}
+
+/* Multiply the other channels by the alpha, x * a / 255 rounded as
+   (t + (t >> 8)) >> 8 with t = x * a + 128, two channels at a time */
+static SDL_INLINE Uint32
+SDL_PremultiplyPixel(Uint32 pixel, int ashift)
+{
+    const Uint32 amask = 0xFFu << ashift;
+    const Uint32 a = (pixel >> ashift) & 0xFF;
+    Uint32 rb = (pixel & 0x00FF00FF) * a + 0x00800080;
+    Uint32 ag = ((pixel >> 8) & 0x00FF00FF) * a + 0x00800080;
+
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    ag = ((ag + ((ag >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    return ((rb | (ag << 8)) & ~amask) | (pixel & amask);
+}
+
+static void
+SDL_PremultiplyAlpha32(int width, int height, int ashift,
+                       const Uint8 * src, int src_pitch,
+                       Uint8 * dst, int dst_pitch)
+{
+#ifdef __SSE2__
+    const SDL_bool sse2 = SDL_HasSSE2();
+    const __m128i shift = _mm_cvtsi32_si128(ashift);
+    const __m128i amask = _mm_set1_epi32((int) (0xFFu << ashift));
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i round = _mm_set1_epi16(0x80);
+    const __m128i zero = _mm_setzero_si128();
+#endif
+    int x, y;
+
+    for (y = 0; y < height; ++y) {
+        const Uint32 *srcp = (const Uint32 *) (src + y * src_pitch);
+        Uint32 *dstp = (Uint32 *) (dst + y * dst_pitch);
+
+        x = 0;
+#ifdef __SSE2__
+        if (sse2) {
+            for (; x + 4 <= width; x += 4) {
+                const __m128i p = _mm_loadu_si128((const __m128i *) (srcp + x));
+                __m128i a, lo, hi;
+
+                /* The alpha of each pixel, spread over its four channels */
+                a = _mm_and_si128(_mm_srl_epi32(p, shift), mask);
+                a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+
+                lo = _mm_mullo_epi16(_mm_unpacklo_epi8(p, zero),
+                                     _mm_unpacklo_epi32(a, a));
+                hi = _mm_mullo_epi16(_mm_unpackhi_epi8(p, zero),
+                                     _mm_unpackhi_epi32(a, a));
+                lo = _mm_add_epi16(lo, round);
+                hi = _mm_add_epi16(hi, round);
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+                _mm_storeu_si128((__m128i *) (dstp + x),
+                                 _mm_or_si128(_mm_andnot_si128(amask, _mm_packus_epi16(lo, hi)),
+                                              _mm_and_si128(amask, p)));
+            }
+        }
+#endif
+        for (; x < width; ++x) {
+            dstp[x] = SDL_PremultiplyPixel(srcp[x], ashift);
+        }
+    }
+}
+
+static void
+SDL_UnpremultiplyAlpha32(int width, int height, int ashift,
+                         const Uint8 * src, int src_pitch,
+                         Uint8 * dst, int dst_pitch)
+{
+    const Uint32 amask = 0xFFu << ashift;
+    Uint32 scale[256];
+    int x, y, i;
+
+    /* 16.16 fixed point factors of 255 / alpha */
+    scale[0] = 0;
+    for (i = 1; i < 256; ++i) {
+        scale[i] = (255 * 65536 + i / 2) / i;
+    }
+
+    for (y = 0; y < height; ++y) {
+        const Uint32 *srcp = (const Uint32 *) (src + y * src_pitch);
+        Uint32 *dstp = (Uint32 *) (dst + y * dst_pitch);
+
+        for (x = 0; x < width; ++x) {
+            const Uint32 pixel = srcp[x];
+            const Uint32 a = (pixel >> ashift) & 0xFF;
+            Uint32 result = pixel & amask;
+
+            if (a == 0xFF) {
+                result = pixel;
+            } else if (a) {
+                for (i = 0; i < 32; i += 8) {
+                    if (i != ashift) {
+                        Uint32 c = ((((pixel >> i) & 0xFF) * scale[a]) + 0x8000) >> 16;
+                        result |= ((c > 0xFF) ? 0xFF : c) << i;
+                    }
+                }
+            }
+            dstp[x] = result;
+        }
+    }
+}
+
+static int
+SDL_ConvertPremultipliedAlpha(int width, int height,
+                              Uint32 src_format, const void * src, int src_pitch,
+                              Uint32 dst_format, void * dst, int dst_pitch,
+                              SDL_bool premultiply)
+{
+    const int ashift = SDL_GetPremultipliedAlphaShift(dst_format);
+
+    if (ashift < 0) {
+        return -1;
+    }
+    if (!src) {
+        return SDL_InvalidParamError("src");
+    }
+    if (!dst) {
+        return SDL_InvalidParamError("dst");
+    }
+
+    /* Convert first, then work on the destination in place */
+    if (src_format != dst_format) {
+        if (SDL_ConvertPixels(width, height, src_format, src, src_pitch,
+                              dst_format, dst, dst_pitch) < 0) {
+            return -1;
+        }
+        src = dst;
+        src_pitch = dst_pitch;
+    }
+
+    if (premultiply) {
+        SDL_PremultiplyAlpha32(width, height, ashift, (const Uint8 *) src,
+                               src_pitch, (Uint8 *) dst, dst_pitch);
+    } else {
+        SDL_UnpremultiplyAlpha32(width, height, ashift, (const Uint8 *) src,
+                                 src_pitch, (Uint8 *) dst, dst_pitch);
+    }
+    return 0;
+}
+
+int
+SDL_PremultiplyAlpha(int width, int height,
+                     Uint32 src_format, const void * src, int src_pitch,
+                     Uint32 dst_format, void * dst, int dst_pitch)
+{
+    return SDL_ConvertPremultipliedAlpha(width, height, src_format, src,
+                                         src_pitch, dst_format, dst, dst_pitch,
+                                         SDL_TRUE);
+}
+
+int
+SDL_UnpremultiplyAlpha(int width, int height,
+                       Uint32 src_format, const void * src, int src_pitch,
+                       Uint32 dst_format, void * dst, int dst_pitch)
+{
+    return SDL_ConvertPremultipliedAlpha(width, height, src_format, src,
+                                         src_pitch, dst_format, dst, dst_pitch,
+                                         SDL_FALSE);
+}
+
+static int
+SDL_SetSurfacePremultiplied(SDL_Surface * surface, SDL_bool premultiply)
+{
+    SDL_BlendMode blendMode;
+    int status;
+
+    if (!surface) {
+        return SDL_InvalidParamError("surface");
+    }
+    if (!(surface->flags & SDL_PREMULTIPLIED) == !premultiply) {
+        return 0;
+    }
+    if (SDL_GetPremultipliedAlphaShift(surface->format->format) < 0) {
+        return -1;
+    }
+
+    if (SDL_LockSurface(surface) < 0) {
+        return -1;
+    }
+    status = SDL_ConvertPremultipliedAlpha(surface->w, surface->h,
+                                           surface->format->format,
+                                           surface->pixels, surface->pitch,
+                                           surface->format->format,
+                                           surface->pixels, surface->pitch,
+                                           premultiply);
+    SDL_UnlockSurface(surface);
+    if (status < 0) {
+        return -1;
+    }
+
+    SDL_GetSurfaceBlendMode(surface, &blendMode);
+    if (premultiply) {
+        surface->flags |= SDL_PREMULTIPLIED;
+        if (blendMode == SDL_BLENDMODE_BLEND) {
+            SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_PREMULTIPLIED);
+        }
+    } else {
+        surface->flags &= ~SDL_PREMULTIPLIED;
+        if (blendMode == SDL_BLENDMODE_PREMULTIPLIED) {
+            SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
+        }
+    }
+    return 0;
+}
+
+int
+SDL_PremultiplySurfaceAlpha(SDL_Surface * surface)
+{
+    return SDL_SetSurfacePremultiplied(surface, SDL_TRUE);
+}
+
+int
+SDL_UnpremultiplySurfaceAlpha(SDL_Surface * surface)
+{
+    return SDL_SetSurfacePremultiplied(surface, SDL_FALSE);
+}
+
 /*
  * Free a surface created by the above function.
  */
 void
 SDL_FreeSurface(SDL_Surface * surface)
 {
+    SDL_bool pixelbuffer;
+
     if (surface == NULL) {
         return;
     }
@@ -1128,18 +1673,23 @@ SDL_FreeSurface(SDL_Surface * surface)
         SDL_UnlockSurface(surface);
     }
     if (surface->flags & SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 0);
+        SDL_UnRLESurface(surface);
     }
     if (surface->format) {
         SDL_SetSurfacePalette(surface, NULL);
         SDL_FreeFormat(surface->format);
         surface->format = NULL;
     }
+    pixelbuffer = (surface->map != NULL && surface->map->pixelbuffer);
     if (surface->map != NULL) {
         SDL_FreeBlitMap(surface->map);
         surface->map = NULL;
     }
-    if (!(surface->flags & SDL_PREALLOC)) {
+    if (surface->flags & SDL_PREALLOC) {
+        /* Don't free */
+    } else if (pixelbuffer) {
+        SDL_FreeSurfacePixels(surface->pixels);
+    } else {
         SDL_free(surface->pixels);
     }
     SDL_free(surface);
@@ -243,6 +243,12 @@ struct SDL_VideoDevice
      */
     void (*PumpEvents) (_THIS);
 
+    /* How long SDL_WaitEvent() may sleep on the file descriptors the driver
+       registered with SDL_AddEventFD() before it has to pump events again,
+       in milliseconds, or -1 until one of them becomes readable.  Drivers
+       without this are pumped every few milliseconds while waiting. */
+    int (*GetEventWaitTimeout) (_THIS);
+
     /* Suspend the screensaver */
     void (*SuspendScreenSaver) (_THIS);
 
@@ -2016,6 +2016,26 @@ SDL_UpdateWindowSurfaceRects(SDL_Window * window, const SDL_Rect * rects,
     return _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
 }
 
+int
+SDL_UpdateWindowSurfaceRegion(SDL_Window * window, const SDL_Region * region)
+{
+    const SDL_Rect *rects;
+    int numrects;
+
+    CHECK_WINDOW_MAGIC(window, -1);
+
+    if (!region) {
+        return SDL_InvalidParamError("region");
+    }
+
+    rects = SDL_GetRegionRects(region, &numrects);
+    if (numrects == 0) {
+        /* Nothing changed, nothing to push to the screen */
+        return 0;
+    }
+    return SDL_UpdateWindowSurfaceRects(window, rects, numrects);
+}
+
 int
 SDL_SetWindowBrightness(SDL_Window * window, float brightness)
 {
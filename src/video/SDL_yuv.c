@@ -0,0 +1,1218 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2014 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Conversions between YUV and RGB images */
+
+#include "SDL_assert.h"
+#include "SDL_hints.h"
+#include "SDL_video.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_blit.h"
+#include "SDL_yuv_c.h"
+
+
+/* Output rows are built from rows holding one Y, U and V sample for each
+   output pixel.  These are gathered from the YUV planes a chunk at a time,
+   and nearest neighbor scaling is done while gathering, so clipped and
+   stretched copies go straight to the destination.
+
+   The YUV to RGB math is done in 16-bit fixed point, with the matrix
+   coefficients in 3.13 format and the channels computed with 5 fractional
+   bits.  RGB to YUV uses 2.14 coefficients and 32-bit sums.  The scalar and
+   SIMD versions do exactly the same operations, so they give identical
+   results.
+ */
+
+#define YUV_CHUNK_SIZE  256
+
+typedef struct
+{
+    const char *name;
+
+    /* YUV to RGB, in 3.13 fixed point */
+    int yoffset;
+    Sint16 ycoef, crv, cgu, cgv, cbu;
+
+    /* RGB to YUV, in 2.14 fixed point */
+    Sint16 y[3], u[3], v[3];
+} SDL_YUVMatrix;
+
+static const SDL_YUVMatrix SDL_YUVMatrices[] = {
+    /* Full range BT.601, as used by JPEG */
+    { "JPEG", 0, 8192, 11485, 2819, 5850, 14516,
+      { 4899, 9617, 1868 }, { -2765, -5427, 8192 }, { 8192, -6860, -1332 } },
+    /* Limited range BT.601, standard definition video */
+    { "BT601", 16, 9539, 13075, 3209, 6660, 16525,
+      { 4207, 8260, 1604 }, { -2428, -4768, 7196 }, { 7196, -6026, -1170 } },
+    /* Limited range BT.709, high definition video */
+    { "BT709", 16, 9539, 14686, 1747, 4366, 17305,
+      { 2991, 10064, 1016 }, { -1649, -5547, 7196 }, { 7196, -6536, -660 } },
+    /* Full range BT.709 */
+    { "BT709_FULL", 0, 8192, 12901, 1535, 3835, 15201,
+      { 3483, 11718, 1183 }, { -1877, -6315, 8192 }, { 8192, -7441, -751 } },
+};
+
+static const SDL_YUVMatrix *
+SDL_GetYUVMatrix(int h)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_YUV_CONVERSION_MODE);
+    int i;
+
+    if (hint) {
+        if (SDL_strcasecmp(hint, "AUTOMATIC") == 0) {
+            /* Video up to PAL resolution is standard definition */
+            return &SDL_YUVMatrices[(h <= 576) ? 1 : 2];
+        }
+        for (i = 0; i < SDL_arraysize(SDL_YUVMatrices); ++i) {
+            if (SDL_strcasecmp(hint, SDL_YUVMatrices[i].name) == 0) {
+                return &SDL_YUVMatrices[i];
+            }
+        }
+    }
+    return &SDL_YUVMatrices[0];
+}
+
+static SDL_bool
+SDL_GetYUVChromaLinear(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_YUV_CHROMA_FILTER);
+
+    if (hint && SDL_strcasecmp(hint, "NEAREST") == 0) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+SDL_bool
+SDL_IsPlanarYUV(Uint32 format)
+{
+    switch (format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        return SDL_TRUE;
+    default:
+        return SDL_FALSE;
+    }
+}
+
+size_t
+SDL_CalculateYUVSize(Uint32 format, int w, int h, int pitch)
+{
+    switch (format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+        return (size_t) pitch * h + 2 * (size_t) ((pitch + 1) / 2) * ((h + 1) / 2);
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        /* The interleaved chroma rows hold a pair for every two columns */
+        return (size_t) pitch * h + (size_t) ((pitch + 1) & ~1) * ((h + 1) / 2);
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+        return (size_t) pitch * h;
+    default:
+        return 0;
+    }
+}
+
+int
+SDL_InitYUVImage(SDL_YUVImage * image, Uint32 format, int w, int h,
+                 void *pixels, int pitch)
+{
+    SDL_zerop(image);
+    image->format = format;
+    image->w = w;
+    image->h = h;
+
+    /* Find the pitch and offset values for the planes */
+    switch (format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+        image->pitches[0] = pitch;
+        image->pitches[1] = (pitch + 1) / 2;
+        image->pitches[2] = (pitch + 1) / 2;
+        image->planes[0] = (Uint8 *) pixels;
+        image->planes[1] = image->planes[0] + image->pitches[0] * h;
+        image->planes[2] = image->planes[1] + image->pitches[1] * ((h + 1) / 2);
+        break;
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+        image->pitches[0] = pitch;
+        image->planes[0] = (Uint8 *) pixels;
+        break;
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        image->pitches[0] = pitch;
+        image->pitches[1] = (pitch + 1) & ~1;
+        image->planes[0] = (Uint8 *) pixels;
+        image->planes[1] = image->planes[0] + image->pitches[0] * h;
+        break;
+    default:
+        return SDL_SetError("Unsupported YUV format");
+    }
+
+    /* Find where the Y, U and V samples are */
+    switch (format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+        image->samples[0] = image->planes[0];
+        if (format == SDL_PIXELFORMAT_YV12) {
+            image->samples[1] = image->planes[2];
+            image->samples[2] = image->planes[1];
+        } else {
+            image->samples[1] = image->planes[1];
+            image->samples[2] = image->planes[2];
+        }
+        image->sample_pitches[0] = image->pitches[0];
+        image->sample_pitches[1] = image->pitches[1];
+        image->sample_pitches[2] = image->pitches[2];
+        image->steps[0] = 1;
+        image->steps[1] = 1;
+        image->chroma_shift = 1;
+        break;
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+        if (format == SDL_PIXELFORMAT_YUY2) {
+            image->samples[0] = image->planes[0];
+            image->samples[1] = image->planes[0] + 1;
+            image->samples[2] = image->planes[0] + 3;
+        } else if (format == SDL_PIXELFORMAT_UYVY) {
+            image->samples[0] = image->planes[0] + 1;
+            image->samples[1] = image->planes[0];
+            image->samples[2] = image->planes[0] + 2;
+        } else {
+            image->samples[0] = image->planes[0];
+            image->samples[1] = image->planes[0] + 3;
+            image->samples[2] = image->planes[0] + 1;
+        }
+        image->sample_pitches[0] = image->pitches[0];
+        image->sample_pitches[1] = image->pitches[0];
+        image->sample_pitches[2] = image->pitches[0];
+        image->steps[0] = 2;
+        image->steps[1] = 4;
+        image->chroma_shift = 0;
+        break;
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        image->samples[0] = image->planes[0];
+        if (format == SDL_PIXELFORMAT_NV12) {
+            image->samples[1] = image->planes[1];
+            image->samples[2] = image->planes[1] + 1;
+        } else {
+            image->samples[1] = image->planes[1] + 1;
+            image->samples[2] = image->planes[1];
+        }
+        image->sample_pitches[0] = image->pitches[0];
+        image->sample_pitches[1] = image->pitches[1];
+        image->sample_pitches[2] = image->pitches[1];
+        image->steps[0] = 1;
+        image->steps[1] = 2;
+        image->chroma_shift = 1;
+        break;
+    }
+    return 0;
+}
+
+
+/* YUV to RGB */
+
+static SDL_INLINE Uint8
+SDL_ClampYUVChannel(int value)
+{
+    value = (value + 16) >> 5;
+    if (value < 0) {
+        return 0;
+    }
+    if (value > 255) {
+        return 255;
+    }
+    return (Uint8) value;
+}
+
+static void
+SDL_ConvertYUVRow(const SDL_YUVToRGB * conv, const Uint8 * yrow,
+                  const Uint8 * urow, const Uint8 * vrow, Uint8 * dst, int w)
+{
+    const int bpp = SDL_BYTESPERPIXEL(conv->dst_format);
+    int i;
+
+    for (i = 0; i < w; ++i) {
+        const int Y = ((yrow[i] << 8) * conv->ycoef >> 16) - conv->ybias;
+        const int U = (urow[i] - 128) * 256;
+        const int V = (vrow[i] - 128) * 256;
+        const Uint32 r = SDL_ClampYUVChannel(Y + (V * conv->crv >> 16));
+        const Uint32 g = SDL_ClampYUVChannel(Y - (U * conv->cgu >> 16) -
+                                             (V * conv->cgv >> 16));
+        const Uint32 b = SDL_ClampYUVChannel(Y + (U * conv->cbu >> 16));
+        const Uint32 pixel = ((r >> conv->Rloss) << conv->Rshift) |
+                             ((g >> conv->Gloss) << conv->Gshift) |
+                             ((b >> conv->Bloss) << conv->Bshift) |
+                             conv->Amask;
+
+        switch (bpp) {
+        case 2:
+            *(Uint16 *) dst = (Uint16) pixel;
+            break;
+        case 3:
+            dst[0] = (Uint8) pixel;
+            dst[1] = (Uint8) (pixel >> 8);
+            dst[2] = (Uint8) (pixel >> 16);
+            break;
+        default:
+            *(Uint32 *) dst = pixel;
+            break;
+        }
+        dst += bpp;
+    }
+}
+
+#ifdef __SSE2__
+/* Convert 8 pixels, leaving the channels clamped to 0-255 in 16-bit lanes */
+#define SSE2_CONVERT_YUV(yrow, urow, vrow, r, g, b)                         \
+{                                                                           \
+    const __m128i yuv_zero = _mm_setzero_si128();                           \
+    const __m128i bias = _mm_set1_epi16(-0x8000);                           \
+    const __m128i round = _mm_set1_epi16(16);                               \
+    __m128i Y = _mm_unpacklo_epi8(yuv_zero, _mm_loadl_epi64((const __m128i *) (yrow))); \
+    __m128i U = _mm_unpacklo_epi8(yuv_zero, _mm_loadl_epi64((const __m128i *) (urow))); \
+    __m128i V = _mm_unpacklo_epi8(yuv_zero, _mm_loadl_epi64((const __m128i *) (vrow))); \
+    Y = _mm_sub_epi16(_mm_mulhi_epu16(Y, ycoef), ybias);                    \
+    U = _mm_add_epi16(U, bias);                                             \
+    V = _mm_add_epi16(V, bias);                                             \
+    r = _mm_add_epi16(Y, _mm_mulhi_epi16(V, crv));                          \
+    g = _mm_sub_epi16(_mm_sub_epi16(Y, _mm_mulhi_epi16(U, cgu)),            \
+                      _mm_mulhi_epi16(V, cgv));                             \
+    b = _mm_add_epi16(Y, _mm_mulhi_epi16(U, cbu));                          \
+    r = _mm_srai_epi16(_mm_add_epi16(r, round), 5);                         \
+    g = _mm_srai_epi16(_mm_add_epi16(g, round), 5);                         \
+    b = _mm_srai_epi16(_mm_add_epi16(b, round), 5);                         \
+    r = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), yuv_zero);                \
+    g = _mm_unpacklo_epi8(_mm_packus_epi16(g, g), yuv_zero);                \
+    b = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), yuv_zero);                \
+}
+
+#define SSE2_YUV_COEFFICIENTS                                               \
+    const __m128i ycoef = _mm_set1_epi16(conv->ycoef);                      \
+    const __m128i ybias = _mm_set1_epi16(conv->ybias);                      \
+    const __m128i crv = _mm_set1_epi16(conv->crv);                          \
+    const __m128i cgu = _mm_set1_epi16(conv->cgu);                          \
+    const __m128i cgv = _mm_set1_epi16(conv->cgv);                          \
+    const __m128i cbu = _mm_set1_epi16(conv->cbu)
+
+/* 32-bit destinations with 8 bits per channel, in any order */
+static void
+SDL_ConvertYUVRow8888_SSE2(const SDL_YUVToRGB * conv, const Uint8 * yrow,
+                           const Uint8 * urow, const Uint8 * vrow,
+                           Uint8 * dst, int w)
+{
+    SSE2_YUV_COEFFICIENTS;
+    const int rbyte = conv->Rshift / 8;
+    const int gbyte = conv->Gshift / 8;
+    const int bbyte = conv->Bshift / 8;
+    const int abyte = 6 - rbyte - gbyte - bbyte;
+    int i;
+
+    for (i = 0; i + 8 <= w; i += 8) {
+        __m128i channels[4], lo, hi;
+
+        /* Put each channel in its byte of the pixel, and the alpha
+           (or unused) channel in the remaining one */
+        SSE2_CONVERT_YUV(yrow + i, urow + i, vrow + i,
+                         channels[rbyte], channels[gbyte], channels[bbyte]);
+        channels[abyte] = _mm_set1_epi16(conv->Amask ? 0xFF : 0);
+        lo = _mm_or_si128(channels[0], _mm_slli_epi16(channels[1], 8));
+        hi = _mm_or_si128(channels[2], _mm_slli_epi16(channels[3], 8));
+        _mm_storeu_si128((__m128i *) (dst + i * 4), _mm_unpacklo_epi16(lo, hi));
+        _mm_storeu_si128((__m128i *) (dst + i * 4 + 16), _mm_unpackhi_epi16(lo, hi));
+    }
+    if (i < w) {
+        SDL_ConvertYUVRow(conv, yrow + i, urow + i, vrow + i, dst + i * 4, w - i);
+    }
+}
+
+/* Any 16-bit destination, such as RGB565 */
+static void
+SDL_ConvertYUVRow16_SSE2(const SDL_YUVToRGB * conv, const Uint8 * yrow,
+                         const Uint8 * urow, const Uint8 * vrow,
+                         Uint8 * dst, int w)
+{
+    SSE2_YUV_COEFFICIENTS;
+    const __m128i amask = _mm_set1_epi16((short) conv->Amask);
+    const __m128i rloss = _mm_cvtsi32_si128(conv->Rloss);
+    const __m128i gloss = _mm_cvtsi32_si128(conv->Gloss);
+    const __m128i bloss = _mm_cvtsi32_si128(conv->Bloss);
+    const __m128i rshift = _mm_cvtsi32_si128(conv->Rshift);
+    const __m128i gshift = _mm_cvtsi32_si128(conv->Gshift);
+    const __m128i bshift = _mm_cvtsi32_si128(conv->Bshift);
+    int i;
+
+    for (i = 0; i + 8 <= w; i += 8) {
+        __m128i r, g, b, pixels;
+
+        SSE2_CONVERT_YUV(yrow + i, urow + i, vrow + i, r, g, b);
+        pixels = _mm_or_si128(_mm_sll_epi16(_mm_srl_epi16(r, rloss), rshift),
+                              _mm_sll_epi16(_mm_srl_epi16(g, gloss), gshift));
+        pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(b, bloss), bshift));
+        _mm_storeu_si128((__m128i *) (dst + i * 2), _mm_or_si128(pixels, amask));
+    }
+    if (i < w) {
+        SDL_ConvertYUVRow(conv, yrow + i, urow + i, vrow + i, dst + i * 2, w - i);
+    }
+}
+#endif /* __SSE2__ */
+
+/* Gather the samples for w pixels starting at source position pos, given
+   in 16.16 fixed point and advancing by inc for each pixel */
+static void
+SDL_GatherYUV(const SDL_YUVImage * image, const Uint8 * Y, const Uint8 * U,
+              const Uint8 * V, Sint64 pos, Sint64 inc,
+              Uint8 * yrow, Uint8 * urow, Uint8 * vrow, int w)
+{
+    const int ystep = image->steps[0];
+    const int cstep = image->steps[1];
+    int i;
+
+    for (i = 0; i < w; ++i, pos += inc) {
+        const int x = (int) (pos >> 16);
+        const int c = (x >> 1) * cstep;
+
+        yrow[i] = Y[x * ystep];
+        urow[i] = U[c];
+        vrow[i] = V[c];
+    }
+}
+
+/* Gather the Y samples for w unscaled pixels starting at pixel x */
+static const Uint8 *
+SDL_GetYRow(const SDL_YUVImage * image, const Uint8 * Y, int x,
+            Uint8 * yrow, int w)
+{
+    const int ystep = image->steps[0];
+    int i;
+
+    if (ystep == 1) {
+        return Y + x;
+    }
+    Y += x * ystep;
+    for (i = 0; i < w; ++i) {
+        yrow[i] = Y[i * ystep];
+    }
+    return yrow;
+}
+
+/* Upsample the chroma for w unscaled pixels, starting at an even pixel x */
+static void
+SDL_ExpandChroma(SDL_bool has_sse2, const SDL_YUVImage * image,
+                 const Uint8 * U, const Uint8 * V, int x,
+                 Uint8 * urow, Uint8 * vrow, int w)
+{
+    const int cstep = image->steps[1];
+    int i = 0;
+
+    U += (x >> 1) * cstep;
+    V += (x >> 1) * cstep;
+
+#ifdef __SSE2__
+    if (has_sse2 && cstep == 1) {
+        for (; i + 16 <= w; i += 16) {
+            __m128i u = _mm_loadl_epi64((const __m128i *) (U + i / 2));
+            __m128i v = _mm_loadl_epi64((const __m128i *) (V + i / 2));
+            _mm_storeu_si128((__m128i *) (urow + i), _mm_unpacklo_epi8(u, u));
+            _mm_storeu_si128((__m128i *) (vrow + i), _mm_unpacklo_epi8(v, v));
+        }
+    } else if (has_sse2 && cstep == 2) {
+        /* The second plane of the pair would read one byte past the
+           samples on the last iteration, so stop one pixel short */
+        const __m128i mask = _mm_set1_epi16(0x00FF);
+        for (; i + 16 < w; i += 16) {
+            __m128i u = _mm_and_si128(_mm_loadu_si128((const __m128i *) (U + i)), mask);
+            __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i *) (V + i)), mask);
+            _mm_storeu_si128((__m128i *) (urow + i), _mm_or_si128(u, _mm_slli_epi16(u, 8)));
+            _mm_storeu_si128((__m128i *) (vrow + i), _mm_or_si128(v, _mm_slli_epi16(v, 8)));
+        }
+    }
+#endif
+    for (; i < w; ++i) {
+        urow[i] = U[(i >> 1) * cstep];
+        vrow[i] = V[(i >> 1) * cstep];
+    }
+}
+
+/* Interpolate the chroma for pixel px from the nearest chroma row C0 and
+   its neighbor C1, clamping the horizontal neighbor to the image */
+static SDL_INLINE Uint8
+SDL_InterpolateChromaSample(const Uint8 * C0, const Uint8 * C1,
+                            int cstep, int last, int px)
+{
+    const int c = px >> 1;
+    int n = (px & 1) ? c + 1 : c - 1;
+    int value;
+
+    if (n < 0) {
+        n = 0;
+    } else if (n > last) {
+        n = last;
+    }
+    value = 9 * C0[c * cstep] + 3 * C0[n * cstep] +
+            3 * C1[c * cstep] + C1[n * cstep];
+    return (Uint8) ((value + 8) >> 4);
+}
+
+/* Upsample one chroma plane for w unscaled pixels starting at an even
+   pixel x, interpolating between the nearest chroma row C0 and its
+   neighbor C1, with the chroma samples centered between the pixels they
+   cover.  This blends each sample 3:1 with its neighbors, vertically and
+   then horizontally. */
+static void
+SDL_InterpolateChroma(SDL_bool has_sse2, const SDL_YUVImage * image,
+                      const Uint8 * C0, const Uint8 * C1, int x,
+                      Uint8 * row, int w)
+{
+    const int cstep = image->steps[1];
+    const int last = (image->w - 1) >> 1;
+    int i = 0;
+
+    /* The first chroma pair of the image has no left neighbor, so do it
+       here and let the SIMD loop start right after it */
+    for (; x + i < 2 && i < w; ++i) {
+        row[i] = SDL_InterpolateChromaSample(C0, C1, cstep, last, x + i);
+    }
+
+#ifdef __SSE2__
+    if (has_sse2) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i mask16 = _mm_set1_epi16(0x00FF);
+        const __m128i mask32 = _mm_set1_epi32(0x000000FF);
+        const __m128i round = _mm_set1_epi16(8);
+        const __m128i three = _mm_set1_epi16(3);
+
+/* Load 8 chroma samples into 16-bit lanes */
+#define SSE2_LOAD_CHROMA(p)                                             \
+    ((cstep == 1) ?                                                     \
+        _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (p)), zero) : \
+     (cstep == 2) ?                                                     \
+        _mm_and_si128(_mm_loadu_si128((const __m128i *) (p)), mask16) : \
+        _mm_packs_epi32(                                                \
+            _mm_and_si128(_mm_loadu_si128((const __m128i *) (p)), mask32), \
+            _mm_and_si128(_mm_loadu_si128((const __m128i *) ((p) + 16)), mask32)))
+
+/* Blend 8 samples 3:1 with the ones in the neighboring row */
+#define SSE2_BLEND_CHROMA(c)                                            \
+    _mm_add_epi16(_mm_mullo_epi16(SSE2_LOAD_CHROMA(C0 + (c) * cstep), three), \
+                  SSE2_LOAD_CHROMA(C1 + (c) * cstep))
+
+        /* Stay clear of the right edge, where the neighbors are clamped */
+        for (; ((x + i) >> 1) + 9 <= last && i + 16 <= w; i += 16) {
+            const int c = (x + i) >> 1;
+            const __m128i prev = SSE2_BLEND_CHROMA(c - 1);
+            const __m128i next = SSE2_BLEND_CHROMA(c + 1);
+            const __m128i cur = _mm_mullo_epi16(SSE2_BLEND_CHROMA(c), three);
+            __m128i even = _mm_add_epi16(_mm_add_epi16(cur, prev), round);
+            __m128i odd = _mm_add_epi16(_mm_add_epi16(cur, next), round);
+
+            even = _mm_srli_epi16(even, 4);
+            odd = _mm_srli_epi16(odd, 4);
+            _mm_storeu_si128((__m128i *) (row + i),
+                             _mm_packus_epi16(_mm_unpacklo_epi16(even, odd),
+                                              _mm_unpackhi_epi16(even, odd)));
+        }
+#undef SSE2_BLEND_CHROMA
+#undef SSE2_LOAD_CHROMA
+    }
+#endif
+    for (; i < w; ++i) {
+        row[i] = SDL_InterpolateChromaSample(C0, C1, cstep, last, x + i);
+    }
+}
+
+typedef struct
+{
+    const SDL_YUVToRGB *conv;
+    const SDL_YUVImage *image;
+    SDL_Rect srcrect;
+    SDL_bool linear_chroma;
+    int w, h;
+    Uint8 *pixels;
+    int pitch;
+} SDL_YUVToRGBJob;
+
+static void
+SDL_ConvertYUVToRGBBand(void *data, int y, int h)
+{
+    SDL_YUVToRGBJob *job = (SDL_YUVToRGBJob *) data;
+    const SDL_YUVToRGB *conv = job->conv;
+    const SDL_YUVImage *image = job->image;
+    const int bpp = SDL_BYTESPERPIXEL(conv->dst_format);
+    const int last_cy = (image->h - 1) >> image->chroma_shift;
+    const Sint64 xinc = ((Sint64) job->srcrect.w << 16) / job->w;
+    const Sint64 yinc = ((Sint64) job->srcrect.h << 16) / job->h;
+    const SDL_bool scaled = (job->srcrect.w != job->w || (job->srcrect.x & 1));
+    Uint8 yrow[YUV_CHUNK_SIZE], urow[YUV_CHUNK_SIZE], vrow[YUV_CHUNK_SIZE];
+    Uint8 *dst = job->pixels + y * job->pitch;
+    int last_sy = -1;
+    int i, x, n;
+
+    for (i = y; i < y + h; ++i, dst += job->pitch) {
+        const int sy = job->srcrect.y + (int) ((i * yinc) >> 16);
+        const int cy = sy >> image->chroma_shift;
+        const Uint8 *Y = image->samples[0] + sy * image->sample_pitches[0];
+        const Uint8 *U = image->samples[1] + cy * image->sample_pitches[1];
+        const Uint8 *V = image->samples[2] + cy * image->sample_pitches[2];
+        const Uint8 *U1 = U;
+        const Uint8 *V1 = V;
+
+        if (sy == last_sy) {
+            /* Repeat the previous row */
+            SDL_memcpy(dst, dst - job->pitch, job->w * bpp);
+            continue;
+        }
+        last_sy = sy;
+
+        if (image->chroma_shift) {
+            int ny = (sy & 1) ? cy + 1 : cy - 1;
+            ny = SDL_max(0, SDL_min(ny, last_cy));
+            U1 = image->samples[1] + ny * image->sample_pitches[1];
+            V1 = image->samples[2] + ny * image->sample_pitches[2];
+        }
+
+        for (x = 0; x < job->w; x += n) {
+            n = SDL_min(job->w - x, YUV_CHUNK_SIZE);
+            if (scaled) {
+                SDL_GatherYUV(image, Y, U, V,
+                              ((Sint64) job->srcrect.x << 16) + x * xinc,
+                              xinc, yrow, urow, vrow, n);
+                conv->ConvertRow(conv, yrow, urow, vrow, dst + x * bpp, n);
+            } else {
+                const int sx = job->srcrect.x + x;
+
+                if (job->linear_chroma) {
+                    SDL_InterpolateChroma(conv->has_sse2, image, U, U1, sx, urow, n);
+                    SDL_InterpolateChroma(conv->has_sse2, image, V, V1, sx, vrow, n);
+                } else {
+                    SDL_ExpandChroma(conv->has_sse2, image, U, V, sx, urow, vrow, n);
+                }
+                conv->ConvertRow(conv, SDL_GetYRow(image, Y, sx, yrow, n),
+                                 urow, vrow, dst + x * bpp, n);
+            }
+        }
+    }
+}
+
+void
+SDL_InitYUVToRGB(SDL_YUVToRGB * conv, int h)
+{
+    const SDL_YUVMatrix *matrix = SDL_GetYUVMatrix(h);
+
+    SDL_zerop(conv);
+    conv->ycoef = matrix->ycoef;
+    conv->ybias = (Sint16) (((matrix->yoffset << 8) * matrix->ycoef) >> 16);
+    conv->crv = matrix->crv;
+    conv->cgu = matrix->cgu;
+    conv->cgv = matrix->cgv;
+    conv->cbu = matrix->cbu;
+    conv->has_sse2 = SDL_HasSSE2();
+}
+
+int
+SDL_SetYUVToRGBFormat(SDL_YUVToRGB * conv, Uint32 dst_format)
+{
+    SDL_PixelFormat *format;
+
+    if (SDL_BYTESPERPIXEL(dst_format) < 2 ||
+        SDL_ISPIXELFORMAT_FOURCC(dst_format) ||
+        SDL_ISPIXELFORMAT_INDEXED(dst_format)) {
+        return SDL_SetError("Unsupported YUV destination format");
+    }
+    format = SDL_AllocFormat(dst_format);
+    if (!format) {
+        return -1;
+    }
+    if (format->Rloss > 8 || format->Gloss > 8 || format->Bloss > 8) {
+        /* More than 8 bits per channel, such as ARGB2101010 */
+        SDL_FreeFormat(format);
+        return SDL_SetError("Unsupported YUV destination format");
+    }
+    conv->dst_format = dst_format;
+    conv->Rloss = format->Rloss;
+    conv->Gloss = format->Gloss;
+    conv->Bloss = format->Bloss;
+    conv->Rshift = format->Rshift;
+    conv->Gshift = format->Gshift;
+    conv->Bshift = format->Bshift;
+    conv->Amask = format->Amask;
+    SDL_FreeFormat(format);
+
+    /* You have chosen wisely... */
+    conv->ConvertRow = SDL_ConvertYUVRow;
+#ifdef __SSE2__
+    if (conv->has_sse2) {
+        if (SDL_BYTESPERPIXEL(dst_format) == 4 &&
+            !conv->Rloss && !conv->Gloss && !conv->Bloss) {
+            conv->ConvertRow = SDL_ConvertYUVRow8888_SSE2;
+        } else if (SDL_BYTESPERPIXEL(dst_format) == 2) {
+            conv->ConvertRow = SDL_ConvertYUVRow16_SSE2;
+        }
+    }
+#endif
+    return 0;
+}
+
+void
+SDL_ConvertYUVToRGB(const SDL_YUVToRGB * conv, const SDL_YUVImage * image,
+                    const SDL_Rect * srcrect, int w, int h,
+                    void *pixels, int pitch)
+{
+    SDL_YUVToRGBJob job;
+
+    if (w <= 0 || h <= 0 || srcrect->w <= 0 || srcrect->h <= 0) {
+        return;
+    }
+
+    job.conv = conv;
+    job.image = image;
+    job.srcrect = *srcrect;
+    job.linear_chroma = SDL_FALSE;
+    job.w = w;
+    job.h = h;
+    job.pixels = (Uint8 *) pixels;
+    job.pitch = pitch;
+    SDL_RunBlitBands(SDL_ConvertYUVToRGBBand, &job, w, h);
+}
+
+
+/* RGB to YUV
+
+   Pixels are read as 32-bit values with 8-bit channels at the given shifts,
+   two rows at a time.  Each Y sample is computed from its own pixel, and
+   each chroma sample from the average of the 2x2 (or 2x1) block of pixels
+   it covers, or from the top left pixel of the block.
+ */
+
+typedef struct
+{
+    const SDL_YUVMatrix *matrix;
+    SDL_bool linear_chroma;
+    SDL_bool has_sse2;
+    int Rshift, Gshift, Bshift;
+} SDL_RGBToYUV;
+
+static SDL_INLINE Uint8
+SDL_ClampRGBToYUV(int value)
+{
+    value >>= 14;
+    if (value > 255) {
+        return 255;
+    }
+    return (Uint8) value;
+}
+
+/* Convert the pixels of row0 and row1 to Y samples in yrow0 and yrow1, and
+   the chroma for both rows to (w + 1) / 2 samples in urow and vrow */
+static void
+SDL_ConvertRGBToYUVRows(const SDL_RGBToYUV * conv, const Uint32 * row0,
+                        const Uint32 * row1, Uint8 * yrow0, Uint8 * yrow1,
+                        Uint8 * urow, Uint8 * vrow, int w)
+{
+    const Sint16 *cy = conv->matrix->y;
+    const Sint16 *cu = conv->matrix->u;
+    const Sint16 *cv = conv->matrix->v;
+    const int yconst = (conv->matrix->yoffset << 14) + 8192;
+    const int cconst = (128 << 14) + 8192;
+    int i, j;
+
+    for (i = 0; i < w; i += 2) {
+        const int n = SDL_min(w - i, 2);
+        int r = 0, g = 0, b = 0;
+
+        for (j = 0; j < n; ++j) {
+            const Uint32 p0 = row0[i + j];
+            const Uint32 p1 = row1[i + j];
+            const int r0 = (p0 >> conv->Rshift) & 0xFF;
+            const int g0 = (p0 >> conv->Gshift) & 0xFF;
+            const int b0 = (p0 >> conv->Bshift) & 0xFF;
+            const int r1 = (p1 >> conv->Rshift) & 0xFF;
+            const int g1 = (p1 >> conv->Gshift) & 0xFF;
+            const int b1 = (p1 >> conv->Bshift) & 0xFF;
+
+            yrow0[i + j] = SDL_ClampRGBToYUV(cy[0] * r0 + cy[1] * g0 + cy[2] * b0 + yconst);
+            yrow1[i + j] = SDL_ClampRGBToYUV(cy[0] * r1 + cy[1] * g1 + cy[2] * b1 + yconst);
+            if (!conv->linear_chroma) {
+                if (j == 0) {
+                    r = r0;
+                    g = g0;
+                    b = b0;
+                }
+            } else {
+                r += r0 + r1;
+                g += g0 + g1;
+                b += b0 + b1;
+            }
+        }
+        if (conv->linear_chroma) {
+            if (n == 2) {
+                r = (r + 2) >> 2;
+                g = (g + 2) >> 2;
+                b = (b + 2) >> 2;
+            } else {
+                r = (r + 1) >> 1;
+                g = (g + 1) >> 1;
+                b = (b + 1) >> 1;
+            }
+        }
+        urow[i / 2] = SDL_ClampRGBToYUV(cu[0] * r + cu[1] * g + cu[2] * b + cconst);
+        vrow[i / 2] = SDL_ClampRGBToYUV(cv[0] * r + cv[1] * g + cv[2] * b + cconst);
+    }
+}
+
+#ifdef __SSE2__
+/* A pair of 16-bit coefficients in each 32-bit lane, for _mm_madd_epi16() */
+#define SSE2_COEFFICIENT_PAIR(a, b) \
+    _mm_set1_epi32((int) (((Uint32) (Uint16) (b) << 16) | (Uint16) (a)))
+
+/* Extract a channel of 8 pixels into 16-bit lanes */
+#define SSE2_EXTRACT_CHANNEL(lo, hi, shift) \
+    _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(lo, shift), mask),  \
+                    _mm_and_si128(_mm_srl_epi32(hi, shift), mask))
+
+/* Compute 8 Y samples from channels in 16-bit lanes, pairing the blue
+   channel with 256 so the rounding and offset fold into the madd */
+#define SSE2_RGB_TO_Y(R, G, B, dst)                                         \
+{                                                                           \
+    const __m128i k256 = _mm_set1_epi16(256);                               \
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(R, G), cy_rg),  \
+                               _mm_madd_epi16(_mm_unpacklo_epi16(B, k256), cy_b1)); \
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(R, G), cy_rg),  \
+                               _mm_madd_epi16(_mm_unpackhi_epi16(B, k256), cy_b1)); \
+    lo = _mm_packs_epi32(_mm_srai_epi32(lo, 14), _mm_srai_epi32(hi, 14));  \
+    _mm_storel_epi64((__m128i *) (dst), _mm_packus_epi16(lo, lo));          \
+}
+
+/* Compute 4 chroma samples from (R, G) and (B, 256) pairs in 32-bit lanes */
+#define SSE2_RGB_TO_C(rg, b1, c_rg, c_b1, dst)                              \
+{                                                                           \
+    __m128i c = _mm_add_epi32(_mm_madd_epi16(rg, c_rg), _mm_madd_epi16(b1, c_b1)); \
+    c = _mm_packs_epi32(_mm_srai_epi32(c, 14), _mm_srai_epi32(c, 14));      \
+    *(int *) (dst) = _mm_cvtsi128_si32(_mm_packus_epi16(c, c));             \
+}
+
+static void
+SDL_ConvertRGBToYUVRows_SSE2(const SDL_RGBToYUV * conv, const Uint32 * row0,
+                             const Uint32 * row1, Uint8 * yrow0, Uint8 * yrow1,
+                             Uint8 * urow, Uint8 * vrow, int w)
+{
+    const SDL_YUVMatrix *matrix = conv->matrix;
+    const __m128i cy_rg = SSE2_COEFFICIENT_PAIR(matrix->y[0], matrix->y[1]);
+    const __m128i cy_b1 = SSE2_COEFFICIENT_PAIR(matrix->y[2], (matrix->yoffset << 6) + 32);
+    const __m128i cu_rg = SSE2_COEFFICIENT_PAIR(matrix->u[0], matrix->u[1]);
+    const __m128i cu_b1 = SSE2_COEFFICIENT_PAIR(matrix->u[2], (128 << 6) + 32);
+    const __m128i cv_rg = SSE2_COEFFICIENT_PAIR(matrix->v[0], matrix->v[1]);
+    const __m128i cv_b1 = SSE2_COEFFICIENT_PAIR(matrix->v[2], (128 << 6) + 32);
+    const __m128i rshift = _mm_cvtsi32_si128(conv->Rshift);
+    const __m128i gshift = _mm_cvtsi32_si128(conv->Gshift);
+    const __m128i bshift = _mm_cvtsi32_si128(conv->Bshift);
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i low16 = _mm_set1_epi32(0xFFFF);
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i two = _mm_set1_epi32(2);
+    const __m128i b256 = _mm_set1_epi32(256 << 16);
+    int i;
+
+    for (i = 0; i + 8 <= w; i += 8) {
+        const __m128i lo0 = _mm_loadu_si128((const __m128i *) (row0 + i));
+        const __m128i hi0 = _mm_loadu_si128((const __m128i *) (row0 + i + 4));
+        const __m128i lo1 = _mm_loadu_si128((const __m128i *) (row1 + i));
+        const __m128i hi1 = _mm_loadu_si128((const __m128i *) (row1 + i + 4));
+        const __m128i R0 = SSE2_EXTRACT_CHANNEL(lo0, hi0, rshift);
+        const __m128i G0 = SSE2_EXTRACT_CHANNEL(lo0, hi0, gshift);
+        const __m128i B0 = SSE2_EXTRACT_CHANNEL(lo0, hi0, bshift);
+        const __m128i R1 = SSE2_EXTRACT_CHANNEL(lo1, hi1, rshift);
+        const __m128i G1 = SSE2_EXTRACT_CHANNEL(lo1, hi1, gshift);
+        const __m128i B1 = SSE2_EXTRACT_CHANNEL(lo1, hi1, bshift);
+        __m128i r, g, b, rg, b1;
+
+        SSE2_RGB_TO_Y(R0, G0, B0, yrow0 + i);
+        SSE2_RGB_TO_Y(R1, G1, B1, yrow1 + i);
+
+        if (conv->linear_chroma) {
+            /* Sum each 2x2 block into a 32-bit lane and average it */
+            r = _mm_madd_epi16(_mm_add_epi16(R0, R1), ones);
+            g = _mm_madd_epi16(_mm_add_epi16(G0, G1), ones);
+            b = _mm_madd_epi16(_mm_add_epi16(B0, B1), ones);
+            r = _mm_srli_epi32(_mm_add_epi32(r, two), 2);
+            g = _mm_srli_epi32(_mm_add_epi32(g, two), 2);
+            b = _mm_srli_epi32(_mm_add_epi32(b, two), 2);
+        } else {
+            /* Take the even pixels of the first row */
+            r = _mm_and_si128(R0, low16);
+            g = _mm_and_si128(G0, low16);
+            b = _mm_and_si128(B0, low16);
+        }
+        rg = _mm_or_si128(r, _mm_slli_epi32(g, 16));
+        b1 = _mm_or_si128(b, b256);
+        SSE2_RGB_TO_C(rg, b1, cu_rg, cu_b1, urow + i / 2);
+        SSE2_RGB_TO_C(rg, b1, cv_rg, cv_b1, vrow + i / 2);
+    }
+    if (i < w) {
+        SDL_ConvertRGBToYUVRows(conv, row0 + i, row1 + i, yrow0 + i, yrow1 + i,
+                                urow + i / 2, vrow + i / 2, w - i);
+    }
+}
+#endif /* __SSE2__ */
+
+/* Store a row of Y samples, and if urow is set, the row of chroma samples
+   covering it, for pixel row y of an image */
+static void
+SDL_StoreYUVRow(const SDL_YUVImage * image, int y, const Uint8 * yrow,
+                const Uint8 * urow, const Uint8 * vrow)
+{
+    const int ystep = image->steps[0];
+    const int cstep = image->steps[1];
+    const int cw = (image->w + 1) / 2;
+    Uint8 *Y = image->samples[0] + y * image->sample_pitches[0];
+    int i;
+
+    if (ystep == 1) {
+        SDL_memcpy(Y, yrow, image->w);
+    } else {
+        for (i = 0; i < image->w; ++i) {
+            Y[i * ystep] = yrow[i];
+        }
+    }
+
+    if (urow) {
+        const int cy = y >> image->chroma_shift;
+        Uint8 *U = image->samples[1] + cy * image->sample_pitches[1];
+        Uint8 *V = image->samples[2] + cy * image->sample_pitches[2];
+
+        if (cstep == 1) {
+            SDL_memcpy(U, urow, cw);
+            SDL_memcpy(V, vrow, cw);
+        } else {
+            for (i = 0; i < cw; ++i) {
+                U[i * cstep] = urow[i];
+                V[i * cstep] = vrow[i];
+            }
+        }
+        if ((image->w & 1) && ystep == 2) {
+            /* Packed formats store a Y sample for the missing pixel */
+            Y[image->w * ystep] = yrow[image->w - 1];
+        }
+    }
+}
+
+static int
+SDL_ConvertPixels_RGB_to_YUV(int width, int height, Uint32 src_format,
+                             const void *src, int src_pitch,
+                             const SDL_YUVImage * dst)
+{
+    const int cw = (width + 1) / 2;
+    SDL_RGBToYUV conv;
+    SDL_bool convert = SDL_FALSE;
+    Uint8 *buffer;
+    Uint32 *rgb = NULL;
+    Uint8 *yrow0, *yrow1, *urow, *vrow;
+    void (*ConvertRows) (const SDL_RGBToYUV *, const Uint32 *, const Uint32 *,
+                         Uint8 *, Uint8 *, Uint8 *, Uint8 *, int);
+    int y;
+
+    conv.matrix = SDL_GetYUVMatrix(height);
+    conv.linear_chroma = SDL_GetYUVChromaLinear();
+    conv.has_sse2 = SDL_HasSSE2();
+
+    /* Formats with 8-bit channels in 32-bit pixels are read directly,
+       and anything else is converted to ARGB8888 a row pair at a time */
+    switch (src_format) {
+    case SDL_PIXELFORMAT_RGB888:
+    case SDL_PIXELFORMAT_ARGB8888:
+        conv.Rshift = 16;
+        conv.Gshift = 8;
+        conv.Bshift = 0;
+        break;
+    case SDL_PIXELFORMAT_BGR888:
+    case SDL_PIXELFORMAT_ABGR8888:
+        conv.Rshift = 0;
+        conv.Gshift = 8;
+        conv.Bshift = 16;
+        break;
+    case SDL_PIXELFORMAT_RGBX8888:
+    case SDL_PIXELFORMAT_RGBA8888:
+        conv.Rshift = 24;
+        conv.Gshift = 16;
+        conv.Bshift = 8;
+        break;
+    case SDL_PIXELFORMAT_BGRX8888:
+    case SDL_PIXELFORMAT_BGRA8888:
+        conv.Rshift = 8;
+        conv.Gshift = 16;
+        conv.Bshift = 24;
+        break;
+    default:
+        conv.Rshift = 16;
+        conv.Gshift = 8;
+        conv.Bshift = 0;
+        convert = SDL_TRUE;
+        break;
+    }
+
+    buffer = (Uint8 *) SDL_malloc(width * 2 + cw * 2 + (convert ? width * 8 : 0));
+    if (!buffer) {
+        return SDL_OutOfMemory();
+    }
+    yrow0 = buffer;
+    yrow1 = yrow0 + width;
+    urow = yrow1 + width;
+    vrow = urow + cw;
+    if (convert) {
+        rgb = (Uint32 *) (vrow + cw);
+    }
+
+    ConvertRows = SDL_ConvertRGBToYUVRows;
+#ifdef __SSE2__
+    if (conv.has_sse2) {
+        ConvertRows = SDL_ConvertRGBToYUVRows_SSE2;
+    }
+#endif
+
+    /* Planar destinations get chroma for each pair of rows, packed ones
+       for each row */
+    for (y = 0; y < height; y += (1 << dst->chroma_shift)) {
+        const int n = SDL_min(height - y, 1 << dst->chroma_shift);
+        const Uint32 *row0, *row1;
+
+        if (convert) {
+            if (SDL_ConvertPixels(width, n, src_format,
+                                  (const Uint8 *) src + y * src_pitch, src_pitch,
+                                  SDL_PIXELFORMAT_ARGB8888, rgb, width * 4) < 0) {
+                SDL_free(buffer);
+                return -1;
+            }
+            row0 = rgb;
+            row1 = rgb + (n - 1) * width;
+        } else {
+            row0 = (const Uint32 *) ((const Uint8 *) src + y * src_pitch);
+            row1 = (const Uint32 *) ((const Uint8 *) row0 + (n - 1) * src_pitch);
+        }
+
+        ConvertRows(&conv, row0, row1, yrow0, yrow1, urow, vrow, width);
+        SDL_StoreYUVRow(dst, y, yrow0, urow, vrow);
+        if (n > 1) {
+            SDL_StoreYUVRow(dst, y + 1, yrow1, NULL, NULL);
+        }
+    }
+    SDL_free(buffer);
+    return 0;
+}
+
+static int
+SDL_ConvertPixels_YUV_to_RGB(int width, int height, const SDL_YUVImage * src,
+                             Uint32 dst_format, void *dst, int dst_pitch,
+                             SDL_bool in_place)
+{
+    SDL_YUVToRGB conv;
+    SDL_YUVToRGBJob job;
+    Uint32 *rgb = NULL;
+    int retval = 0;
+
+    SDL_InitYUVToRGB(&conv, height);
+    if (SDL_SetYUVToRGBFormat(&conv, dst_format) < 0) {
+        /* Go through ARGB8888 for any other format */
+        rgb = (Uint32 *) SDL_malloc((size_t) width * height * 4);
+        if (!rgb) {
+            return SDL_OutOfMemory();
+        }
+        SDL_SetYUVToRGBFormat(&conv, SDL_PIXELFORMAT_ARGB8888);
+    }
+
+    job.conv = &conv;
+    job.image = src;
+    job.srcrect.x = 0;
+    job.srcrect.y = 0;
+    job.srcrect.w = width;
+    job.srcrect.h = height;
+    job.linear_chroma = SDL_GetYUVChromaLinear();
+    job.w = width;
+    job.h = height;
+    job.pixels = rgb ? (Uint8 *) rgb : (Uint8 *) dst;
+    job.pitch = rgb ? width * 4 : dst_pitch;
+    if (in_place) {
+        /* The rows have to be converted in order */
+        SDL_ConvertYUVToRGBBand(&job, 0, height);
+    } else {
+        SDL_RunBlitBands(SDL_ConvertYUVToRGBBand, &job, width, height);
+    }
+
+    if (rgb) {
+        retval = SDL_ConvertPixels(width, height, SDL_PIXELFORMAT_ARGB8888,
+                                   rgb, width * 4, dst_format, dst, dst_pitch);
+        SDL_free(rgb);
+    }
+    return retval;
+}
+
+/* Downsample a row pair of full resolution chroma to (w + 1) / 2 samples */
+static void
+SDL_SubsampleChroma(SDL_bool linear, const Uint8 * row0, const Uint8 * row1,
+                    Uint8 * dst, int w)
+{
+    int i;
+
+    for (i = 0; i < w; i += 2) {
+        if (!linear) {
+            dst[i / 2] = row0[i];
+        } else if (i + 1 < w) {
+            dst[i / 2] = (Uint8) ((row0[i] + row0[i + 1] +
+                                   row1[i] + row1[i + 1] + 2) >> 2);
+        } else {
+            dst[i / 2] = (Uint8) ((row0[i] + row1[i] + 1) >> 1);
+        }
+    }
+}
+
+static int
+SDL_ConvertPixels_YUV_to_YUV(int width, int height, const SDL_YUVImage * src,
+                             const SDL_YUVImage * dst)
+{
+    const int cw = (width + 1) / 2;
+    const SDL_bool linear = SDL_GetYUVChromaLinear();
+    const SDL_bool has_sse2 = SDL_HasSSE2();
+    const Uint8 *yrows[2];
+    Uint8 *buffer, *ybuffers[2], *urows[2], *vrows[2], *urow, *vrow;
+    int y, j;
+
+    buffer = (Uint8 *) SDL_malloc(width * 6 + cw * 2);
+    if (!buffer) {
+        return SDL_OutOfMemory();
+    }
+    for (j = 0; j < 2; ++j) {
+        ybuffers[j] = buffer + width * j * 3;
+        urows[j] = ybuffers[j] + width;
+        vrows[j] = urows[j] + width;
+    }
+    urow = buffer + width * 6;
+    vrow = urow + cw;
+
+    /* Gather full resolution rows from the source, using the nearest
+       chroma, and subsample them again for the destination */
+    for (y = 0; y < height; y += (1 << dst->chroma_shift)) {
+        const int n = SDL_min(height - y, 1 << dst->chroma_shift);
+
+        for (j = 0; j < n; ++j) {
+            const int sy = y + j;
+            const int cy = sy >> src->chroma_shift;
+            const Uint8 *Y = src->samples[0] + sy * src->sample_pitches[0];
+            const Uint8 *U = src->samples[1] + cy * src->sample_pitches[1];
+            const Uint8 *V = src->samples[2] + cy * src->sample_pitches[2];
+
+            yrows[j] = SDL_GetYRow(src, Y, 0, ybuffers[j], width);
+            SDL_ExpandChroma(has_sse2, src, U, V, 0, urows[j], vrows[j], width);
+        }
+        SDL_SubsampleChroma(linear, urows[0], urows[n - 1], urow, width);
+        SDL_SubsampleChroma(linear, vrows[0], vrows[n - 1], vrow, width);
+        SDL_StoreYUVRow(dst, y, yrows[0], urow, vrow);
+        if (n > 1) {
+            SDL_StoreYUVRow(dst, y + 1, yrows[1], NULL, NULL);
+        }
+    }
+    SDL_free(buffer);
+    return 0;
+}
+
+int
+SDL_ConvertPixels_YUV(int width, int height,
+                      Uint32 src_format, const void *src, int src_pitch,
+                      Uint32 dst_format, void *dst, int dst_pitch)
+{
+    const SDL_bool src_yuv = SDL_ISPIXELFORMAT_FOURCC(src_format);
+    const SDL_bool dst_yuv = SDL_ISPIXELFORMAT_FOURCC(dst_format);
+    const int src_bpp = src_yuv ? 2 : SDL_BYTESPERPIXEL(src_format);
+    const int dst_bpp = dst_yuv ? 2 : SDL_BYTESPERPIXEL(dst_format);
+    size_t src_size, dst_size;
+    SDL_YUVImage src_image, dst_image;
+    SDL_bool in_place = SDL_FALSE;
+    void *copy = NULL;
+    int retval;
+
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+    if (src_yuv) {
+        src_size = SDL_CalculateYUVSize(src_format, width, height, src_pitch);
+    } else {
+        src_size = (size_t) src_pitch * (height - 1) + width * src_bpp;
+    }
+    if (dst_yuv) {
+        dst_size = SDL_CalculateYUVSize(dst_format, width, height, dst_pitch);
+    } else {
+        dst_size = (size_t) dst_pitch * (height - 1) + width * dst_bpp;
+    }
+    if (!src_size || !dst_size) {
+        return SDL_SetError("Unsupported YUV format");
+    }
+
+    /* Rows are converted from the top down, each one read before it is
+       written, so converting in place works when the formats are packed,
+       the destination rows aren't longer than the source ones and the
+       pixels don't grow.  YUV to RGB is done in chunks, so interpolating
+       the chroma would read samples that were already overwritten.
+       Otherwise overlapping pixels are converted from a copy of the source. */
+    if ((const Uint8 *) src < (Uint8 *) dst + dst_size &&
+        (Uint8 *) dst < (const Uint8 *) src + src_size) {
+        if (src == dst && !SDL_IsPlanarYUV(src_format) &&
+            !SDL_IsPlanarYUV(dst_format) &&
+            dst_pitch <= src_pitch && dst_bpp <= src_bpp &&
+            (!src_yuv || dst_yuv || !SDL_GetYUVChromaLinear())) {
+            in_place = SDL_TRUE;
+        } else {
+            copy = SDL_malloc(src_size);
+            if (!copy) {
+                return SDL_OutOfMemory();
+            }
+            SDL_memcpy(copy, src, src_size);
+            src = copy;
+        }
+    }
+
+    if (src_yuv) {
+        SDL_InitYUVImage(&src_image, src_format, width, height, (void *) src, src_pitch);
+    }
+    if (dst_yuv) {
+        SDL_InitYUVImage(&dst_image, dst_format, width, height, dst, dst_pitch);
+    }
+
+    if (src_yuv && dst_yuv) {
+        retval = SDL_ConvertPixels_YUV_to_YUV(width, height, &src_image, &dst_image);
+    } else if (src_yuv) {
+        retval = SDL_ConvertPixels_YUV_to_RGB(width, height, &src_image,
+                                              dst_format, dst, dst_pitch, in_place);
+    } else {
+        retval = SDL_ConvertPixels_RGB_to_YUV(width, height, src_format,
+                                              src, src_pitch, &dst_image);
+    }
+    SDL_free(copy);
+    return retval;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,99 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2014 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#ifndef _SDL_yuv_c_h
+#define _SDL_yuv_c_h
+
+#include "SDL_pixels.h"
+#include "SDL_rect.h"
+
+/* YUV conversion functions, shared by SDL_ConvertPixels() and the
+   software implementation of YUV textures */
+
+/* The layout of a YUV image in memory */
+typedef struct
+{
+    Uint32 format;
+    int w, h;
+    Uint8 *planes[3];
+    int pitches[3];
+
+    /* Where the Y, U and V samples are, the distance between horizontally
+       adjacent Y samples and chroma samples, and the vertical subsampling */
+    Uint8 *samples[3];
+    int sample_pitches[3];
+    int steps[2];
+    int chroma_shift;
+} SDL_YUVImage;
+
+typedef struct SDL_YUVToRGB SDL_YUVToRGB;
+
+/* The state needed to convert YUV images to a given RGB format */
+struct SDL_YUVToRGB
+{
+    Uint32 dst_format;
+    SDL_bool has_sse2;
+
+    /* The conversion matrix, in 3.13 fixed point */
+    Sint16 ycoef, ybias;
+    Sint16 crv, cgu, cgv, cbu;
+
+    /* The destination pixel layout */
+    int Rloss, Gloss, Bloss;
+    int Rshift, Gshift, Bshift;
+    Uint32 Amask;
+    void (*ConvertRow) (const SDL_YUVToRGB * conv,
+                        const Uint8 * yrow, const Uint8 * urow,
+                        const Uint8 * vrow, Uint8 * dst, int w);
+};
+
+/* Return whether format stores the chroma in planes separate from Y */
+extern SDL_bool SDL_IsPlanarYUV(Uint32 format);
+
+/* Return the size of a YUV image, or 0 if format isn't a YUV format */
+extern size_t SDL_CalculateYUVSize(Uint32 format, int w, int h, int pitch);
+
+/* Set up image for YUV pixels with the layout used by SDL_ConvertPixels() */
+extern int SDL_InitYUVImage(SDL_YUVImage * image, Uint32 format, int w, int h,
+                            void *pixels, int pitch);
+
+/* Set up conv with the matrix selected by SDL_HINT_YUV_CONVERSION_MODE
+   for images of the given height */
+extern void SDL_InitYUVToRGB(SDL_YUVToRGB * conv, int h);
+
+/* Select the RGB format conv converts to */
+extern int SDL_SetYUVToRGBFormat(SDL_YUVToRGB * conv, Uint32 dst_format);
+
+/* Convert srcrect of image, scaling it to w x h pixels */
+extern void SDL_ConvertYUVToRGB(const SDL_YUVToRGB * conv,
+                                const SDL_YUVImage * image,
+                                const SDL_Rect * srcrect, int w, int h,
+                                void *pixels, int pitch);
+
+/* SDL_ConvertPixels() for conversions to or from YUV formats */
+extern int SDL_ConvertPixels_YUV(int width, int height,
+                                 Uint32 src_format, const void *src, int src_pitch,
+                                 Uint32 dst_format, void *dst, int dst_pitch);
+
+#endif /* _SDL_yuv_c_h */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -36,6 +36,13 @@ DUMMY_PumpEvents(_THIS)
     /* do nothing. */
 }
 
+int
+DUMMY_GetEventWaitTimeout(_THIS)
+{
+    /* Only other threads can send events, so there's no need to wake up */
+    return -1;
+}
+
 #endif /* SDL_VIDEO_DRIVER_DUMMY */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -23,5 +23,6 @@
 #include "SDL_nullvideo.h"
 
 extern void DUMMY_PumpEvents(_THIS);
+extern int DUMMY_GetEventWaitTimeout(_THIS);
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -78,6 +78,16 @@ Wayland_PumpEvents(_THIS)
         WAYLAND_wl_display_dispatch_pending(d->display);
 }
 
+int
+Wayland_GetEventWaitTimeout(_THIS)
+{
+    SDL_VideoData *d = _this->driverdata;
+
+    /* Send any buffered requests, or the compositor may never answer them */
+    WAYLAND_wl_display_flush(d->display);
+    return -1;
+}
+
 static void
 pointer_handle_enter(void *data, struct wl_pointer *pointer,
                      uint32_t serial, struct wl_surface *surface,
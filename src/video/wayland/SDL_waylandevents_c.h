@@ -28,6 +28,7 @@
 #include "SDL_waylandwindow.h"
 
 extern void Wayland_PumpEvents(_THIS);
+extern int Wayland_GetEventWaitTimeout(_THIS);
 
 extern void Wayland_display_add_input(SDL_VideoData *d, uint32_t id);
 extern void Wayland_display_destroy_input(SDL_VideoData *d);
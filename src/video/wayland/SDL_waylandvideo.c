@@ -103,6 +103,7 @@ Wayland_CreateDevice(int devindex)
     device->GetWindowWMInfo = Wayland_GetWindowWMInfo;
 
     device->PumpEvents = Wayland_PumpEvents;
+    device->GetEventWaitTimeout = Wayland_GetEventWaitTimeout;
 
     device->GL_SwapWindow = Wayland_GLES_SwapWindow;
     device->GL_GetSwapInterval = Wayland_GLES_GetSwapInterval;
@@ -310,6 +311,9 @@ Wayland_VideoInit(_THIS)
 
     WAYLAND_wl_display_flush(data->display);
 
+    /* Let SDL_WaitEvent() sleep until the compositor sends something */
+    SDL_AddEventFD(WAYLAND_wl_display_get_fd(data->display), SDL_EVENTFD_VIDEO);
+
     return 0;
 }
 
@@ -372,6 +376,7 @@ Wayland_VideoQuit(_THIS)
         wl_registry_destroy(data->registry);
 
     if (data->display) {
+        SDL_DelEventFD(WAYLAND_wl_display_get_fd(data->display));
         WAYLAND_wl_display_flush(data->display);
         WAYLAND_wl_display_disconnect(data->display);
     }
@@ -1322,6 +1322,51 @@ X11_PumpEvents(_THIS)
     X11_HandleFocusChanges(_this);
 }
 
+/* Shorten the wait in 'timeout' so it ends by 'deadline' */
+static int
+X11_WaitUntil(int timeout, Uint32 now, Uint32 deadline)
+{
+    const int left = SDL_TICKS_PASSED(now, deadline) ? 0 : (int) (deadline - now);
+    return (timeout < 0 || left < timeout) ? left : timeout;
+}
+
+int
+X11_GetEventWaitTimeout(_THIS)
+{
+    SDL_VideoData *data = (SDL_VideoData *) _this->driverdata;
+    const Uint32 now = SDL_GetTicks();
+    int timeout = -1;
+    int i;
+
+    /* Events Xlib already read won't make the connection readable */
+    X11_XFlush(data->display);
+    if (X11_XEventsQueued(data->display, QueuedAlready)) {
+        return 0;
+    }
+
+#ifdef SDL_USE_IBUS
+    /* IBus talks to us over D-Bus, which has to be polled */
+    if (SDL_GetEventState(SDL_TEXTINPUT) == SDL_ENABLE) {
+        timeout = 10;
+    }
+#endif
+
+    if (data->last_mode_change_deadline) {
+        timeout = X11_WaitUntil(timeout, now, data->last_mode_change_deadline);
+    }
+    if (_this->suspend_screensaver) {
+        timeout = X11_WaitUntil(timeout, now, data->screensaver_activity + 30000);
+    }
+    if (data->windowlist) {
+        for (i = 0; i < data->numwindows; ++i) {
+            SDL_WindowData *windata = data->windowlist[i];
+            if (windata && windata->pending_focus != PENDING_FOCUS_NONE) {
+                timeout = X11_WaitUntil(timeout, now, windata->pending_focus_time);
+            }
+        }
+    }
+    return timeout;
+}
 
 void
 X11_SuspendScreenSaver(_THIS)
@@ -24,6 +24,7 @@
 #define _SDL_x11events_h
 
 extern void X11_PumpEvents(_THIS);
+extern int X11_GetEventWaitTimeout(_THIS);
 extern void X11_SuspendScreenSaver(_THIS);
 
 #endif /* _SDL_x11events_h */
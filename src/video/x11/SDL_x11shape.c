@@ -36,11 +36,12 @@ X11_CreateShapedWindow(const char *title,unsigned int x,unsigned int y,unsigned
 SDL_WindowShaper*
 X11_CreateShaper(SDL_Window* window) {
     SDL_WindowShaper* result = NULL;
-    SDL_ShapeData* data = NULL;
-    int resized_properly;
 
 #if SDL_VIDEO_DRIVER_X11_XSHAPE
     if (SDL_X11_HAVE_XSHAPE) {  /* Make sure X server supports it. */
+        SDL_ShapeData* data = NULL;
+        int resized_properly;
+
         result = malloc(sizeof(SDL_WindowShaper));
         result->window = window;
         result->mode.mode = ShapeModeDefault;
@@ -48,8 +49,8 @@ X11_CreateShaper(SDL_Window* window) {
         result->userx = result->usery = 0;
         data = SDL_malloc(sizeof(SDL_ShapeData));
         result->driverdata = data;
-        data->bitmapsize = 0;
-        data->bitmap = NULL;
+        data->region = SDL_CreateRegion();
+        data->hasregion = SDL_FALSE;
         window->shaper = result;
         resized_properly = X11_ResizeWindowShape(window);
         SDL_assert(resized_properly == 0);
@@ -62,22 +63,14 @@ X11_CreateShaper(SDL_Window* window) {
 int
 X11_ResizeWindowShape(SDL_Window* window) {
     SDL_ShapeData* data = window->shaper->driverdata;
-    unsigned int bitmapsize = window->w / 8;
     SDL_assert(data != NULL);
 
-    if(window->w % 8 > 0)
-        bitmapsize += 1;
-    bitmapsize *= window->h;
-    if(data->bitmapsize != bitmapsize || data->bitmap == NULL) {
-        data->bitmapsize = bitmapsize;
-        if(data->bitmap != NULL)
-            free(data->bitmap);
-        data->bitmap = malloc(data->bitmapsize);
-        if(data->bitmap == NULL) {
-            return SDL_SetError("Could not allocate memory for shaped-window bitmap.");
-        }
+    if(data->region == NULL) {
+        return SDL_SetError("Could not allocate memory for shaped-window region.");
     }
-    memset(data->bitmap,0,data->bitmapsize);
+    /* The next shape is sent whole */
+    SDL_ClearRegion(data->region);
+    data->hasregion = SDL_FALSE;
 
     window->shaper->userx = window->x;
     window->shaper->usery = window->y;
@@ -86,12 +79,44 @@ X11_ResizeWindowShape(SDL_Window* window) {
     return 0;
 }
 
+#if SDL_VIDEO_DRIVER_X11_XSHAPE
+static int
+X11_CombineShapeRegion(SDL_WindowData *windowdata,const SDL_Region *region,int op) {
+    const SDL_Rect *rects;
+    XRectangle *xrects = NULL;
+    int i,count;
+
+    rects = SDL_GetRegionRects(region,&count);
+    if(count == 0 && op != ShapeSet)
+        return 0;
+    if(count > 0) {
+        xrects = (XRectangle *)SDL_malloc(count * sizeof(XRectangle));
+        if(xrects == NULL)
+            return SDL_OutOfMemory();
+        for(i = 0;i < count;i++) {
+            xrects[i].x = rects[i].x;
+            xrects[i].y = rects[i].y;
+            xrects[i].width = rects[i].w;
+            xrects[i].height = rects[i].h;
+        }
+    }
+    /* SDL regions are banded the same way X regions are */
+    X11_XShapeCombineRectangles(windowdata->videodata->display,windowdata->xwindow,ShapeBounding,0,0,xrects,count,op,YXBanded);
+    SDL_free(xrects);
+    return 0;
+}
+#endif
+
 int
 X11_SetWindowShape(SDL_WindowShaper *shaper,SDL_Surface *shape,SDL_WindowShapeMode *shape_mode) {
+    int result = 0;
+#if SDL_VIDEO_DRIVER_X11_XSHAPE
     SDL_ShapeData *data = NULL;
     SDL_WindowData *windowdata = NULL;
-    Pixmap shapemask;
-    
+    SDL_Region *region = NULL,*added = NULL,*removed = NULL;
+    int count,changed;
+#endif
+
     if(shaper == NULL || shape == NULL || shaper->driverdata == NULL)
         return -1;
 
@@ -101,20 +126,61 @@ X11_SetWindowShape(SDL_WindowShaper *shaper,SDL_Surface *shape,SDL_WindowShapeMo
     if(shape->w != shaper->window->w || shape->h != shaper->window->h)
         return -3;
     data = shaper->driverdata;
+    windowdata = (SDL_WindowData*)(shaper->window->driverdata);
 
     /* Assume that shaper->alphacutoff already has a value, because SDL_SetWindowShape() should have given it one. */
-    SDL_CalculateShapeBitmap(shaper->mode,shape,data->bitmap,8);
-
-    windowdata = (SDL_WindowData*)(shaper->window->driverdata);
-    shapemask = X11_XCreateBitmapFromData(windowdata->videodata->display,windowdata->xwindow,data->bitmap,shaper->window->w,shaper->window->h);
+    region = SDL_CreateRegion();
+    if(region == NULL || SDL_CalculateShapeRegion(shaper->mode,shape,region) < 0) {
+        SDL_FreeRegion(region);
+        return -1;
+    }
 
-    X11_XShapeCombineMask(windowdata->videodata->display,windowdata->xwindow, ShapeBounding, 0, 0,shapemask, ShapeSet);
+    if(data->hasregion) {
+        /* Only send what changed since the last shape, if that's smaller */
+        added = SDL_CreateRegion();
+        removed = SDL_CreateRegion();
+        if(added != NULL && removed != NULL &&
+           SDL_UnionRegion(added,region) == 0 && SDL_SubtractRegion(added,data->region) == 0 &&
+           SDL_UnionRegion(removed,data->region) == 0 && SDL_SubtractRegion(removed,region) == 0) {
+            SDL_GetRegionRects(added,&changed);
+            SDL_GetRegionRects(removed,&count);
+            changed += count;
+            SDL_GetRegionRects(region,&count);
+            if(changed == 0) {
+                /* Same shape as before, nothing to tell the X server */
+                SDL_FreeRegion(added);
+                SDL_FreeRegion(removed);
+                SDL_FreeRegion(region);
+                return 0;
+            }
+            if(changed < count) {
+                /* Adding first means no pixel that stays visible flickers */
+                if(X11_CombineShapeRegion(windowdata,added,ShapeUnion) < 0 ||
+                   X11_CombineShapeRegion(windowdata,removed,ShapeSubtract) < 0) {
+                    result = -1;
+                }
+            }
+            else {
+                result = X11_CombineShapeRegion(windowdata,region,ShapeSet);
+            }
+        }
+        else {
+            result = X11_CombineShapeRegion(windowdata,region,ShapeSet);
+        }
+        SDL_FreeRegion(added);
+        SDL_FreeRegion(removed);
+    }
+    else {
+        result = X11_CombineShapeRegion(windowdata,region,ShapeSet);
+    }
     X11_XSync(windowdata->videodata->display,False);
 
-    X11_XFreePixmap(windowdata->videodata->display,shapemask);
+    SDL_FreeRegion(data->region);
+    data->region = region;
+    data->hasregion = (result == 0) ? SDL_TRUE : SDL_FALSE;
 #endif
 
-    return 0;
+    return result;
 }
 
 #endif /* SDL_VIDEO_DRIVER_X11 */
@@ -28,8 +28,8 @@
 #include "../SDL_sysvideo.h"
 
 typedef struct {
-    void* bitmap;
-    Uint32 bitmapsize;
+    SDL_Region* region;     /* The shape the X server has, when hasregion is set */
+    SDL_bool hasregion;
 } SDL_ShapeData;
 
 extern SDL_Window* X11_CreateShapedWindow(const char *title,unsigned int x,unsigned int y,unsigned int w,unsigned int h,Uint32 flags);
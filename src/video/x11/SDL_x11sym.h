@@ -285,6 +285,7 @@ SDL_X11_SYM(void,XScreenSaverSuspend,(Display *dpy,Bool suspend),(dpy,suspend),r
 #if SDL_VIDEO_DRIVER_X11_XSHAPE
 SDL_X11_MODULE(XSHAPE)
 SDL_X11_SYM(void,XShapeCombineMask,(Display *dpy,Window dest,int dest_kind,int x_off,int y_off,Pixmap src,int op),(dpy,dest,dest_kind,x_off,y_off,src,op),)
+SDL_X11_SYM(void,XShapeCombineRectangles,(Display *dpy,Window dest,int dest_kind,int x_off,int y_off,XRectangle *rectangles,int n_rects,int op,int ordering),(dpy,dest,dest_kind,x_off,y_off,rectangles,n_rects,op,ordering),)
 #endif
 
 #if SDL_VIDEO_DRIVER_X11_XVIDMODE
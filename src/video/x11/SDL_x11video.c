@@ -28,6 +28,7 @@
 #include "SDL_mouse.h"
 #include "../SDL_sysvideo.h"
 #include "../SDL_pixels_c.h"
+#include "../../events/SDL_events_c.h"
 
 #include "SDL_x11video.h"
 #include "SDL_x11framebuffer.h"
@@ -219,6 +220,7 @@ X11_CreateDevice(int devindex)
     device->SetDisplayMode = X11_SetDisplayMode;
     device->SuspendScreenSaver = X11_SuspendScreenSaver;
     device->PumpEvents = X11_PumpEvents;
+    device->GetEventWaitTimeout = X11_GetEventWaitTimeout;
 
     device->CreateWindow = X11_CreateWindow;
     device->CreateWindowFrom = X11_CreateWindowFrom;
@@ -428,6 +430,9 @@ X11_VideoInit(_THIS)
     SDL_DBus_Init();
 #endif
 
+    /* Let SDL_WaitEvent() sleep until the server sends something */
+    SDL_AddEventFD(ConnectionNumber(data->display), SDL_EVENTFD_VIDEO);
+
     return 0;
 }
 
@@ -436,6 +441,8 @@ X11_VideoQuit(_THIS)
 {
     SDL_VideoData *data = (SDL_VideoData *) _this->driverdata;
 
+    SDL_DelEventFD(ConnectionNumber(data->display));
+
     SDL_free(data->classname);
 #ifdef X_HAVE_UTF8_STRING
     if (data->im) {
@@ -175,6 +175,180 @@ events_addDelEventWatchWithUserdata(void *arg)
 }
 
 
+/**
+ * @brief Pushes more user events than fit in one batch and checks they come back in order.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PushEvent
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PeepEvents
+ */
+int
+events_pushManyAndPollInOrder(void *arg)
+{
+   SDL_Event event;
+   const int total = 3000;
+   int i, next, result, outoforder;
+
+   SDL_FlushEvent(SDL_USEREVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvent()");
+
+   /* Interleave pushes with peeks so queued events are mixed with new ones */
+   for (i = 0; i < total; ++i) {
+      SDL_zero(event);
+      event.type = SDL_USEREVENT;
+      event.user.code = i;
+      SDL_PushEvent(&event);
+      if ((i % 700) == 0) {
+         result = SDL_PeepEvents(&event, 1, SDL_PEEKEVENT, SDL_USEREVENT, SDL_USEREVENT);
+         SDLTest_AssertCheck(result == 1, "Check result from SDL_PeepEvents, expected: 1, got: %d", result);
+      }
+   }
+   SDLTest_AssertPass("Call to SDL_PushEvent() %d times", total);
+   SDLTest_AssertCheck(SDL_HasEvent(SDL_USEREVENT), "Check SDL_HasEvent(SDL_USEREVENT)");
+
+   next = 0;
+   outoforder = 0;
+   while (SDL_PeepEvents(&event, 1, SDL_GETEVENT, SDL_USEREVENT, SDL_USEREVENT) == 1) {
+      if (event.user.code != next) {
+         ++outoforder;
+      }
+      next = event.user.code + 1;
+   }
+   SDLTest_AssertCheck(next == total, "Check last event code, expected: %d, got: %d", total - 1, next - 1);
+   SDLTest_AssertCheck(outoforder == 0, "Check events came back in order, expected: 0 out of order, got: %d", outoforder);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Checks type filtered queries on a queue of mixed event types.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_HasEvent
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PeepEvents
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_FlushEvent
+ */
+int
+events_filterMixedTypes(void *arg)
+{
+   const Uint32 types[] = { SDL_USEREVENT, SDL_KEYDOWN, SDL_MOUSEMOTION, SDL_USEREVENT + 1, SDL_KEYUP };
+   SDL_Event event, events[8];
+   int i, result, last, count, outoforder;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvents()");
+
+   for (i = 0; i < 1000; ++i) {
+      SDL_zero(event);
+      event.type = types[i % SDL_arraysize(types)];
+      event.user.code = i;
+      SDL_PeepEvents(&event, 1, SDL_ADDEVENT, 0, 0);
+   }
+   SDLTest_AssertPass("Call to SDL_PeepEvents(SDL_ADDEVENT) 1000 times");
+
+   SDLTest_AssertCheck(SDL_HasEvent(SDL_KEYUP), "Check SDL_HasEvent(SDL_KEYUP)");
+   SDLTest_AssertCheck(!SDL_HasEvent(SDL_QUIT), "Check !SDL_HasEvent(SDL_QUIT)");
+   SDLTest_AssertCheck(!SDL_HasEvents(SDL_MOUSEBUTTONDOWN, SDL_MOUSEWHEEL), "Check !SDL_HasEvents(SDL_MOUSEBUTTONDOWN, SDL_MOUSEWHEEL)");
+
+   /* Events from two type ranges have to come back merged in queue order */
+   last = -1;
+   count = 0;
+   outoforder = 0;
+   while ((result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_KEYDOWN, SDL_MOUSEMOTION)) > 0) {
+      for (i = 0; i < result; ++i) {
+         if (events[i].user.code <= last) {
+            ++outoforder;
+         }
+         last = events[i].user.code;
+         ++count;
+      }
+   }
+   SDLTest_AssertCheck(count == 600, "Check number of key and mouse events, expected: 600, got: %d", count);
+   SDLTest_AssertCheck(outoforder == 0, "Check key and mouse events came back in order, expected: 0 out of order, got: %d", outoforder);
+   SDLTest_AssertCheck(!SDL_HasEvents(SDL_KEYDOWN, SDL_MOUSEMOTION), "Check key and mouse events are gone");
+
+   SDL_FlushEvent(SDL_USEREVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvent(SDL_USEREVENT)");
+   SDLTest_AssertCheck(!SDL_HasEvent(SDL_USEREVENT), "Check !SDL_HasEvent(SDL_USEREVENT)");
+   SDLTest_AssertCheck(SDL_HasEvent(SDL_USEREVENT + 1), "Check SDL_HasEvent(SDL_USEREVENT + 1)");
+
+   result = SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 1, "Check SDL_PeepEvents(NULL) finds events, expected: 1, got: %d", result);
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   return TEST_COMPLETED;
+}
+
+/* Delay before _events_delayedPushUserevent() pushes its event, in milliseconds */
+#define EVENTS_PUSH_DELAY 50
+
+/* Thread that pushes a user event with the code it was given after a short delay */
+int SDLCALL _events_delayedPushUserevent(void *arg)
+{
+   SDL_Event event;
+
+   SDL_Delay(EVENTS_PUSH_DELAY);
+   SDL_zero(event);
+   event.type = SDL_USEREVENT;
+   event.user.code = *(int *)arg;
+   return SDL_PushEvent(&event);
+}
+
+/**
+ * @brief Checks that SDL_WaitEventTimeout() sleeps until an event arrives or the timeout passes.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_WaitEventTimeout
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PushEvent
+ */
+int
+events_waitEventTimeout(void *arg)
+{
+   const int timeout = 200;
+   const int longTimeout = 5000;
+   SDL_Event event;
+   SDL_Thread *thread;
+   Uint32 start, elapsed;
+   int code, result, status;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvents()");
+
+   /* Nothing to wait for: only returns once the timeout is up */
+   start = SDL_GetTicks();
+   result = SDL_WaitEventTimeout(&event, timeout);
+   elapsed = SDL_GetTicks() - start;
+   SDLTest_AssertPass("Call to SDL_WaitEventTimeout(%d) on an empty queue", timeout);
+   SDLTest_AssertCheck(result == 0, "Check result from SDL_WaitEventTimeout, expected: 0, got: %d", result);
+   SDLTest_AssertCheck(elapsed + 1 >= (Uint32)timeout, "Check SDL_WaitEventTimeout waited for the timeout, expected: >= %d ms, got: %d ms", timeout, (int)elapsed);
+   SDLTest_AssertCheck(elapsed < (Uint32)longTimeout, "Check SDL_WaitEventTimeout returned after the timeout, expected: < %d ms, got: %d ms", longTimeout, (int)elapsed);
+
+   /* An event pushed by another thread wakes the waiting thread up */
+   code = SDLTest_RandomSint32();
+   start = SDL_GetTicks();
+   thread = SDL_CreateThread(_events_delayedPushUserevent, "PushUserevent", &code);
+   SDLTest_AssertPass("Call to SDL_CreateThread()");
+   SDLTest_AssertCheck(thread != NULL, "Check thread was created, expected: non-NULL, got: %s", (thread != NULL) ? "non-NULL" : "NULL");
+   if (thread == NULL) {
+      return TEST_ABORTED;
+   }
+   result = SDL_WaitEventTimeout(&event, longTimeout);
+   elapsed = SDL_GetTicks() - start;
+   SDLTest_AssertPass("Call to SDL_WaitEventTimeout(%d) while another thread pushes an event", longTimeout);
+   SDLTest_AssertCheck(result == 1, "Check result from SDL_WaitEventTimeout, expected: 1, got: %d", result);
+   if (result == 1) {
+      SDLTest_AssertCheck(event.type == SDL_USEREVENT, "Check event type, expected: %d, got: %d", SDL_USEREVENT, event.type);
+      SDLTest_AssertCheck(event.user.code == code, "Check event code, expected: %d, got: %d", code, event.user.code);
+   }
+   SDLTest_AssertCheck(elapsed + 1 >= EVENTS_PUSH_DELAY, "Check SDL_WaitEventTimeout waited for the event, expected: >= %d ms, got: %d ms", EVENTS_PUSH_DELAY, (int)elapsed);
+   SDLTest_AssertCheck(elapsed < (Uint32)longTimeout, "Check event arrived before the timeout, expected: < %d ms, got: %d ms", longTimeout, (int)elapsed);
+
+   SDL_WaitThread(thread, &status);
+   SDLTest_AssertPass("Call to SDL_WaitThread()");
+   SDLTest_AssertCheck(status == 1, "Check SDL_PushEvent result in thread, expected: 1, got: %d", status);
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Events test cases */
@@ -187,9 +361,18 @@ static const SDLTest_TestCaseReference eventsTest2 =
 static const SDLTest_TestCaseReference eventsTest3 =
         { (SDLTest_TestCaseFp)events_addDelEventWatchWithUserdata, "events_addDelEventWatchWithUserdata", "Adds and deletes an event watch function with userdata", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference eventsTest4 =
+        { (SDLTest_TestCaseFp)events_pushManyAndPollInOrder, "events_pushManyAndPollInOrder", "Pushes many user events and checks they are polled in order", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest5 =
+        { (SDLTest_TestCaseFp)events_filterMixedTypes, "events_filterMixedTypes", "Checks type filtered queries on mixed event types", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest6 =
+        { (SDLTest_TestCaseFp)events_waitEventTimeout, "events_waitEventTimeout", "Waits for an event pushed from another thread and for the timeout on an empty queue", TEST_ENABLED };
+
 /* Sequence of Events test cases */
 static const SDLTest_TestCaseReference *eventsTests[] =  {
-    &eventsTest1, &eventsTest2, &eventsTest3, NULL
+    &eventsTest1, &eventsTest2, &eventsTest3, &eventsTest4, &eventsTest5, &eventsTest6, NULL
 };
 
 /* Events test suite (global) */
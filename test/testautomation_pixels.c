@@ -500,6 +500,296 @@ pixels_calcGammaRamp(void *arg)
   return TEST_COMPLETED;
 }
 
+/* Helper to reverse the rows of a tightly packed YUV image of even width */
+static void
+_mirrorYUV(Uint32 format, Uint8 *yuv, int w, int h)
+{
+  Uint8 *row, tmp[4];
+  int x, y, rows, bytes, size;
+
+  if (format == SDL_PIXELFORMAT_YUY2 || format == SDL_PIXELFORMAT_UYVY || format == SDL_PIXELFORMAT_YVYU) {
+    const int ypos = (format == SDL_PIXELFORMAT_UYVY) ? 1 : 0;
+    for (y = 0; y < h; y++) {
+      row = yuv + y * w * 2;
+      for (x = 0; x < w / 2; x += 2) {
+        SDL_memcpy(tmp, row + x * 2, 4);
+        SDL_memcpy(row + x * 2, row + (w - 2 - x) * 2, 4);
+        SDL_memcpy(row + (w - 2 - x) * 2, tmp, 4);
+      }
+      /* The two luma samples of each pair swap places too */
+      for (x = 0; x < w * 2; x += 4) {
+        tmp[0] = row[x + ypos];
+        row[x + ypos] = row[x + ypos + 2];
+        row[x + ypos + 2] = tmp[0];
+      }
+    }
+    return;
+  }
+
+  /* The luma plane, then the chroma in samples of one or two bytes */
+  rows = h;
+  bytes = w;
+  size = 1;
+  while (rows > 0) {
+    for (y = 0; y < rows; y++) {
+      row = yuv + y * bytes;
+      for (x = 0; x < bytes / 2; x += size) {
+        SDL_memcpy(tmp, row + x, size);
+        SDL_memcpy(row + x, row + bytes - size - x, size);
+        SDL_memcpy(row + bytes - size - x, tmp, size);
+      }
+    }
+    yuv += rows * bytes;
+    if (size == 1 && bytes == w) {
+      rows = (h + 1) / 2;
+      if (format == SDL_PIXELFORMAT_NV12 || format == SDL_PIXELFORMAT_NV21) {
+        size = 2;
+      } else {
+        rows *= 2;
+        bytes = w / 2;
+      }
+    } else {
+      rows = 0;
+    }
+  }
+}
+
+/**
+ * @brief Convert RGB pixels to each YUV format and back with SDL_ConvertPixels
+ *
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_ConvertPixels
+ */
+int
+pixels_convertYUV(void *arg)
+{
+  /* Sizes are odd and even, and wider than one chunk of conversion */
+  const int sizes[][2] = { { 34, 6 }, { 35, 7 }, { 5, 3 }, { 301, 5 } };
+  const int maxW = 302, maxH = 8;
+  const int maxDelta = 4;
+  Uint32 *rgb, *result, *mirrored;
+  Uint8 *yuv;
+  int i, j, c, s, w, h, x, y, pitch, delta, maxFound, ret, linear;
+  Uint32 format;
+
+  rgb = (Uint32 *)SDL_malloc(maxW * maxH * 4);
+  result = (Uint32 *)SDL_malloc(maxW * maxH * 4);
+  mirrored = (Uint32 *)SDL_malloc(maxW * maxH * 4);
+  yuv = (Uint8 *)SDL_malloc(maxW * maxH * 4);
+  SDLTest_AssertCheck(rgb != NULL && result != NULL && mirrored != NULL && yuv != NULL, "Verify buffers were allocated");
+  if (rgb == NULL || result == NULL || mirrored == NULL || yuv == NULL) {
+    SDL_free(rgb);
+    SDL_free(result);
+    SDL_free(mirrored);
+    SDL_free(yuv);
+    return TEST_ABORTED;
+  }
+
+  SDL_SetHint(SDL_HINT_YUV_CONVERSION_MODE, "BT601");
+  for (linear = 0; linear <= 1; linear++) {
+    SDL_SetHint(SDL_HINT_YUV_CHROMA_FILTER, linear ? "LINEAR" : "NEAREST");
+    for (s = 0; s < SDL_arraysize(sizes); s++) {
+      w = sizes[s][0];
+      h = sizes[s][1];
+      for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+          if (linear) {
+            /* A smooth gradient survives chroma interpolation */
+            rgb[y * w + x] = 0xFF000000 | ((40 + x / 2) << 16) | ((200 - y * 3) << 8) | (60 + x / 3 + y * 2);
+          } else {
+            /* Blocks of 2x2 pixels with the same color survive chroma subsampling */
+            rgb[y * w + x] = 0xFF000000 | ((40 + (x / 2) * 11 % 190) << 16) | ((200 - (y / 2) * 37) << 8) | (60 + (x / 2) * 3 % 150 + (y / 2) * 29);
+          }
+        }
+      }
+
+      for (i = 0; i < _numNonRGBPixelFormats; i++) {
+        format = _nonRGBPixelFormats[i];
+        pitch = (format == SDL_PIXELFORMAT_YUY2 || format == SDL_PIXELFORMAT_UYVY || format == SDL_PIXELFORMAT_YVYU) ? ((w + 1) & ~1) * 2 : w;
+
+        ret = SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_ARGB8888, rgb, w * 4, format, yuv, pitch);
+        SDLTest_AssertPass("Call to SDL_ConvertPixels(ARGB8888 to %s) at %dx%d", _nonRGBPixelFormatsVerbose[i], w, h);
+        SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %d", ret);
+        ret = SDL_ConvertPixels(w, h, format, yuv, pitch, SDL_PIXELFORMAT_ARGB8888, result, w * 4);
+        SDLTest_AssertPass("Call to SDL_ConvertPixels(%s to ARGB8888) at %dx%d", _nonRGBPixelFormatsVerbose[i], w, h);
+        SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %d", ret);
+
+        maxFound = 0;
+        for (j = 0; j < w * h; j++) {
+          for (c = 0; c < 32; c += 8) {
+            delta = SDL_abs((int)((rgb[j] >> c) & 0xFF) - (int)((result[j] >> c) & 0xFF));
+            maxFound = SDL_max(maxFound, delta);
+          }
+        }
+        SDLTest_AssertCheck(maxFound <= maxDelta, "Verify %s round trip through %s at %dx%d; expected difference <= %d, got: %d", linear ? "LINEAR" : "NEAREST", _nonRGBPixelFormatsVerbose[i], w, h, maxDelta, maxFound);
+      }
+    }
+  }
+
+  /* Chroma interpolation is symmetric, so converting a mirrored image must
+     give the mirrored result, wherever the conversion is split into chunks */
+  w = maxW - 2;
+  h = 4;
+  for (i = 0; i < _numNonRGBPixelFormats; i++) {
+    format = _nonRGBPixelFormats[i];
+    pitch = (format == SDL_PIXELFORMAT_YUY2 || format == SDL_PIXELFORMAT_UYVY || format == SDL_PIXELFORMAT_YVYU) ? w * 2 : w;
+    for (j = 0; j < w * h * 2; j++) {
+      yuv[j] = SDLTest_RandomUint8();
+    }
+    ret = SDL_ConvertPixels(w, h, format, yuv, pitch, SDL_PIXELFORMAT_ARGB8888, result, w * 4);
+    SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %d", ret);
+    _mirrorYUV(format, yuv, w, h);
+    ret = SDL_ConvertPixels(w, h, format, yuv, pitch, SDL_PIXELFORMAT_ARGB8888, mirrored, w * 4);
+    SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %d", ret);
+
+    for (j = 0; j < w * h; j++) {
+      if (result[j] != mirrored[(j / w) * w + (w - 1 - j % w)]) {
+        break;
+      }
+    }
+    SDLTest_AssertCheck(j == w * h, "Verify mirrored %s conversion matches; first mismatch at pixel %d", _nonRGBPixelFormatsVerbose[i], j);
+  }
+
+  /* Packed formats can be converted in place */
+  w = sizes[0][0];
+  h = sizes[0][1];
+  SDL_SetHint(SDL_HINT_YUV_CHROMA_FILTER, "NEAREST");
+  SDL_memcpy(result, rgb, w * h * 4);
+  ret = SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_ARGB8888, rgb, w * 4, SDL_PIXELFORMAT_YUY2, yuv, w * 2);
+  SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %d", ret);
+  ret = SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_ARGB8888, result, w * 4, SDL_PIXELFORMAT_YUY2, result, w * 2);
+  SDLTest_AssertPass("Call to SDL_ConvertPixels(ARGB8888 to YUY2) in place");
+  SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %d", ret);
+  SDLTest_AssertCheck(SDL_memcmp(result, yuv, w * h * 2) == 0, "Verify in place conversion matches");
+
+  /* Copies between odd pitches must put the chroma rows where the
+     converters look for them */
+  w = sizes[1][0];
+  h = sizes[1][1];
+  for (y = 0; y < h; y++) {
+    for (x = 0; x < w; x++) {
+      rgb[y * w + x] = 0xFF000000 | ((40 + (x / 2) * 11 % 190) << 16) | ((200 - (y / 2) * 37) << 8) | (60 + (x / 2) * 3 % 150 + (y / 2) * 29);
+    }
+  }
+  for (i = 0; i < _numNonRGBPixelFormats; i++) {
+    format = _nonRGBPixelFormats[i];
+    if (format != SDL_PIXELFORMAT_NV12 && format != SDL_PIXELFORMAT_NV21) {
+      continue;
+    }
+    ret = SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_ARGB8888, rgb, w * 4, format, yuv, w + 2);
+    SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %d", ret);
+    ret = SDL_ConvertPixels(w, h, format, yuv, w + 2, format, mirrored, w + 4);
+    SDLTest_AssertPass("Call to SDL_ConvertPixels(%s to %s) with pitches %d and %d", _nonRGBPixelFormatsVerbose[i], _nonRGBPixelFormatsVerbose[i], w + 2, w + 4);
+    SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %d", ret);
+    ret = SDL_ConvertPixels(w, h, format, mirrored, w + 4, SDL_PIXELFORMAT_ARGB8888, result, w * 4);
+    SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %d", ret);
+
+    maxFound = 0;
+    for (j = 0; j < w * h; j++) {
+      for (c = 0; c < 32; c += 8) {
+        delta = SDL_abs((int)((rgb[j] >> c) & 0xFF) - (int)((result[j] >> c) & 0xFF));
+        maxFound = SDL_max(maxFound, delta);
+      }
+    }
+    SDLTest_AssertCheck(maxFound <= maxDelta, "Verify %s round trip through a copy with odd pitches; expected difference <= %d, got: %d", _nonRGBPixelFormatsVerbose[i], maxDelta, maxFound);
+  }
+
+  SDL_SetHint(SDL_HINT_YUV_CONVERSION_MODE, "JPEG");
+  SDL_SetHint(SDL_HINT_YUV_CHROMA_FILTER, "LINEAR");
+  SDL_free(rgb);
+  SDL_free(result);
+  SDL_free(mirrored);
+  SDL_free(yuv);
+
+  return TEST_COMPLETED;
+}
+
+/* Helper to find the nearest opaque palette color by searching all of them */
+static Uint32
+_nearestPaletteColor(const SDL_Palette *palette, Uint8 r, Uint8 g, Uint8 b)
+{
+  unsigned int smallest = ~0u;
+  Uint32 pixel = 0;
+  int i;
+
+  for (i = 0; i < palette->ncolors; i++) {
+    const int rd = palette->colors[i].r - r;
+    const int gd = palette->colors[i].g - g;
+    const int bd = palette->colors[i].b - b;
+    const int ad = palette->colors[i].a - SDL_ALPHA_OPAQUE;
+    const unsigned int distance = rd * rd + gd * gd + bd * bd + ad * ad;
+    if (distance < smallest) {
+      smallest = distance;
+      pixel = i;
+    }
+  }
+  return pixel;
+}
+
+/**
+ * @brief Check that palette lookups find the nearest color, also after the
+ *        palette has been used enough to get an inverse color map.
+ */
+int
+pixels_mapRGBPalette(void *arg)
+{
+  SDL_Surface *surface;
+  SDL_Palette *palette;
+  SDL_Color colors[256];
+  Uint32 expected, result;
+  int variation, i, mismatches;
+  Uint8 r, g, b;
+
+  surface = SDL_CreateRGBSurface(0, 1, 1, 8, 0, 0, 0, 0);
+  SDLTest_AssertCheck(surface != NULL, "Verify 8-bit surface is not NULL");
+  if (surface == NULL) {
+    return TEST_ABORTED;
+  }
+  palette = surface->format->palette;
+
+  for (variation = 1; variation <= 3; variation++) {
+    for (i = 0; i < 256; i++) {
+      colors[i].r = SDLTest_RandomUint8();
+      colors[i].g = SDLTest_RandomUint8();
+      colors[i].b = SDLTest_RandomUint8();
+      colors[i].a = SDL_ALPHA_OPAQUE;
+      switch (variation) {
+        /* Pairs of identical colors */
+        case 2:
+          if (i & 1) {
+            colors[i] = colors[i - 1];
+          }
+          break;
+        /* Some translucent colors */
+        case 3:
+          if (i % 5 == 0) {
+            colors[i].a = SDLTest_RandomUint8();
+          }
+          break;
+      }
+    }
+    SDL_SetPaletteColors(palette, colors, 0, 256);
+    SDLTest_AssertPass("Call to SDL_SetPaletteColors()");
+
+    mismatches = 0;
+    for (i = 0; i < 20000; i++) {
+      r = SDLTest_RandomUint8();
+      g = SDLTest_RandomUint8();
+      b = SDLTest_RandomUint8();
+      result = SDL_MapRGB(surface->format, r, g, b);
+      expected = _nearestPaletteColor(palette, r, g, b);
+      if (result != expected) {
+        SDLTest_LogError("SDL_MapRGB(%u,%u,%u) returned %u, expected %u", r, g, b, result, expected);
+        mismatches++;
+      }
+    }
+    SDLTest_AssertCheck(mismatches == 0, "Verify SDL_MapRGB results in variation %d; expected: 0 mismatches, got %d", variation, mismatches);
+  }
+
+  SDL_FreeSurface(surface);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Pixels test cases */
@@ -515,9 +805,15 @@ static const SDLTest_TestCaseReference pixelsTest3 =
 static const SDLTest_TestCaseReference pixelsTest4 =
         { (SDLTest_TestCaseFp)pixels_getPixelFormatName, "pixels_getPixelFormatName", "Call to SDL_GetPixelFormatName", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference pixelsTest5 =
+        { (SDLTest_TestCaseFp)pixels_convertYUV, "pixels_convertYUV", "Call to SDL_ConvertPixels with YUV formats", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference pixelsTest6 =
+        { (SDLTest_TestCaseFp)pixels_mapRGBPalette, "pixels_mapRGBPalette", "Call to SDL_MapRGB with 8-bit palettes", TEST_ENABLED };
+
 /* Sequence of Pixels test cases */
 static const SDLTest_TestCaseReference *pixelsTests[] =  {
-    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, NULL
+    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, &pixelsTest5, &pixelsTest6, NULL
 };
 
 /* Pixels test suite (global) */
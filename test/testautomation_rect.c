@@ -1574,6 +1574,303 @@ int rect_testRectEqualsParam(void *arg)
     return TEST_COMPLETED;
 }
 
+/* Helpers for the region tests: regions are checked against a plain
+   pixel mask covering a small grid.
+ */
+#define REGION_GRID 64
+
+static void
+_randomRegionRect(SDL_Rect *rect)
+{
+    /* Stays within the grid, which covers -8 to REGION_GRID - 9 */
+    rect->x = SDLTest_RandomIntegerInRange(-8, REGION_GRID - 24);
+    rect->y = SDLTest_RandomIntegerInRange(-8, REGION_GRID - 24);
+    rect->w = SDLTest_RandomIntegerInRange(0, 16);
+    rect->h = SDLTest_RandomIntegerInRange(0, 16);
+}
+
+static void
+_maskRect(Uint8 *mask, const SDL_Rect *rect, int op)
+{
+    int x, y;
+
+    for (y = 0; y < REGION_GRID; ++y) {
+        for (x = 0; x < REGION_GRID; ++x) {
+            SDL_Point p;
+            SDL_bool in;
+            p.x = x - 8;
+            p.y = y - 8;
+            in = SDL_PointInRect(&p, rect);
+            switch (op) {
+            case 0: if (in) mask[y * REGION_GRID + x] = 1; break;
+            case 1: if (in) mask[y * REGION_GRID + x] = 0; break;
+            default: if (!in) mask[y * REGION_GRID + x] = 0; break;
+            }
+        }
+    }
+}
+
+/* Check the banding invariants, and that the region covers exactly the mask */
+static void
+_validateRegion(const SDL_Region *region, const Uint8 *mask, const char *what)
+{
+    Uint8 covered[REGION_GRID * REGION_GRID];
+    const SDL_Rect *rects;
+    SDL_Rect bounds, expected;
+    SDL_bool banded = SDL_TRUE, overlap = SDL_FALSE, matches = SDL_TRUE;
+    SDL_bool haveBounds = SDL_FALSE;
+    int i, count, x, y;
+
+    rects = SDL_GetRegionRects(region, &count);
+    SDL_memset(covered, 0, sizeof(covered));
+    for (i = 0; i < count; ++i) {
+        const SDL_Rect *r = &rects[i];
+        if (SDL_RectEmpty(r)) {
+            banded = SDL_FALSE;
+        }
+        if (i > 0) {
+            const SDL_Rect *q = &rects[i - 1];
+            if (q->y == r->y) {
+                /* Same band: same height, sorted, not touching */
+                if (q->h != r->h || q->x + q->w >= r->x) {
+                    banded = SDL_FALSE;
+                }
+            } else if (q->y + q->h > r->y) {
+                banded = SDL_FALSE;
+            }
+        }
+        for (y = r->y; y < r->y + r->h; ++y) {
+            for (x = r->x; x < r->x + r->w; ++x) {
+                int gx = x + 8, gy = y + 8;
+                if (gx < 0 || gy < 0 || gx >= REGION_GRID || gy >= REGION_GRID) {
+                    matches = SDL_FALSE;
+                    continue;
+                }
+                if (covered[gy * REGION_GRID + gx]) {
+                    overlap = SDL_TRUE;
+                }
+                covered[gy * REGION_GRID + gx] = 1;
+            }
+        }
+    }
+    SDL_zero(expected);
+    for (y = 0; y < REGION_GRID; ++y) {
+        for (x = 0; x < REGION_GRID; ++x) {
+            if (covered[y * REGION_GRID + x] != mask[y * REGION_GRID + x]) {
+                matches = SDL_FALSE;
+            }
+            if (mask[y * REGION_GRID + x]) {
+                SDL_Rect pixel;
+                pixel.x = x - 8;
+                pixel.y = y - 8;
+                pixel.w = pixel.h = 1;
+                if (haveBounds) {
+                    SDL_UnionRect(&expected, &pixel, &expected);
+                } else {
+                    expected = pixel;
+                    haveBounds = SDL_TRUE;
+                }
+            }
+        }
+    }
+    SDLTest_AssertCheck(banded, "%s: check that rects are y-x banded", what);
+    SDLTest_AssertCheck(!overlap, "%s: check that rects don't overlap", what);
+    SDLTest_AssertCheck(matches, "%s: check that the region covers exactly the expected pixels", what);
+    SDLTest_AssertCheck(SDL_GetRegionBounds(region, &bounds) == haveBounds &&
+                        (!haveBounds || SDL_RectEquals(&bounds, &expected)),
+        "%s: check bounds, got (%d,%d,%d,%d) expected (%d,%d,%d,%d)", what,
+        bounds.x, bounds.y, bounds.w, bounds.h,
+        expected.x, expected.y, expected.w, expected.h);
+    SDLTest_AssertCheck(SDL_RegionEmpty(region) == !haveBounds, "%s: check SDL_RegionEmpty", what);
+}
+
+/* !
+ * \brief Tests the region operations against a pixel mask
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_AddRectToRegion
+ * http://wiki.libsdl.org/moin.cgi/SDL_SubtractRectFromRegion
+ * http://wiki.libsdl.org/moin.cgi/SDL_IntersectRegion
+ */
+int rect_testRegionOps(void *arg)
+{
+    Uint8 mask[REGION_GRID * REGION_GRID], other[REGION_GRID * REGION_GRID];
+    SDL_Region *region = SDL_CreateRegion();
+    SDL_Region *region2 = SDL_CreateRegion();
+    SDL_Rect rects[16], rect;
+    int i, j, op, count, result;
+
+    SDLTest_AssertCheck(region != NULL && region2 != NULL, "Check that SDL_CreateRegion succeeds");
+    if (!region || !region2) {
+        SDL_FreeRegion(region);
+        SDL_FreeRegion(region2);
+        return TEST_ABORTED;
+    }
+
+    SDL_memset(mask, 0, sizeof(mask));
+    _validateRegion(region, mask, "Empty region");
+
+    for (i = 0; i < 200; ++i) {
+        op = SDLTest_RandomIntegerInRange(0, 6);
+        switch (op) {
+        case 0:
+        case 1:
+            _randomRegionRect(&rect);
+            result = SDL_AddRectToRegion(region, &rect);
+            _maskRect(mask, &rect, 0);
+            break;
+        case 2:
+            _randomRegionRect(&rect);
+            result = SDL_SubtractRectFromRegion(region, &rect);
+            _maskRect(mask, &rect, 1);
+            break;
+        case 3:
+            rect.x = SDLTest_RandomIntegerInRange(-8, 16);
+            rect.y = SDLTest_RandomIntegerInRange(-8, 16);
+            rect.w = SDLTest_RandomIntegerInRange(24, REGION_GRID);
+            rect.h = SDLTest_RandomIntegerInRange(24, REGION_GRID);
+            result = SDL_IntersectRegionWithRect(region, &rect);
+            _maskRect(mask, &rect, 2);
+            break;
+        default:
+            count = SDLTest_RandomIntegerInRange(1, SDL_arraysize(rects));
+            SDL_memset(other, 0, sizeof(other));
+            for (j = 0; j < count; ++j) {
+                _randomRegionRect(&rects[j]);
+                _maskRect(other, &rects[j], 0);
+            }
+            SDL_ClearRegion(region2);
+            result = SDL_AddRectsToRegion(region2, rects, count);
+            SDLTest_AssertCheck(result == 0, "Check that SDL_AddRectsToRegion succeeds");
+            _validateRegion(region2, other, "SDL_AddRectsToRegion");
+            if (op == 4) {
+                result = SDL_UnionRegion(region, region2);
+                for (j = 0; j < REGION_GRID * REGION_GRID; ++j) mask[j] |= other[j];
+            } else if (op == 5) {
+                result = SDL_SubtractRegion(region, region2);
+                for (j = 0; j < REGION_GRID * REGION_GRID; ++j) mask[j] &= !other[j];
+            } else {
+                result = SDL_IntersectRegion(region, region2);
+                for (j = 0; j < REGION_GRID * REGION_GRID; ++j) mask[j] &= other[j];
+            }
+            break;
+        }
+        SDLTest_AssertCheck(result == 0, "Check that region operation %d succeeds", op);
+        _validateRegion(region, mask, "Region operation");
+    }
+
+    /* Operations on the region itself */
+    SDL_memcpy(other, mask, sizeof(mask));
+    SDL_UnionRegion(region, region);
+    _validateRegion(region, mask, "Union with itself");
+    SDL_IntersectRegion(region, region);
+    _validateRegion(region, mask, "Intersection with itself");
+    SDL_SubtractRegion(region, region);
+    SDL_memset(mask, 0, sizeof(mask));
+    _validateRegion(region, mask, "Subtraction from itself");
+
+    SDL_FreeRegion(region);
+    SDL_FreeRegion(region2);
+    return TEST_COMPLETED;
+}
+
+/* !
+ * \brief Tests SDL_SimplifyRegion
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_SimplifyRegion
+ */
+int rect_testSimplifyRegion(void *arg)
+{
+    Uint8 mask[REGION_GRID * REGION_GRID];
+    SDL_Region *region = SDL_CreateRegion();
+    const SDL_Rect *rects;
+    SDL_Rect rect, before, after;
+    int i, j, x, y, count, maxrects, result;
+    SDL_bool covers;
+
+    SDLTest_AssertCheck(region != NULL, "Check that SDL_CreateRegion succeeds");
+    if (!region) {
+        return TEST_ABORTED;
+    }
+
+    /* A grid of separate 2x2 squares */
+    for (y = 0; y < 8; ++y) {
+        for (x = 0; x < 8; ++x) {
+            rect.x = x * 4;
+            rect.y = y * 4;
+            rect.w = rect.h = 2;
+            SDL_AddRectToRegion(region, &rect);
+        }
+    }
+    SDL_GetRegionRects(region, &count);
+    SDLTest_AssertCheck(count == 64, "Check that 64 separate squares make 64 rects, got %d", count);
+
+    for (j = 0; j < 20; ++j) {
+        SDL_ClearRegion(region);
+        SDL_memset(mask, 0, sizeof(mask));
+        for (i = 0; i < 24; ++i) {
+            _randomRegionRect(&rect);
+            SDL_AddRectToRegion(region, &rect);
+            _maskRect(mask, &rect, 0);
+        }
+        SDL_GetRegionBounds(region, &before);
+        maxrects = SDLTest_RandomIntegerInRange(1, 12);
+        result = SDL_SimplifyRegion(region, maxrects);
+        SDLTest_AssertCheck(result == 0, "Check that SDL_SimplifyRegion succeeds");
+
+        rects = SDL_GetRegionRects(region, &count);
+        SDLTest_AssertCheck(count <= maxrects, "Check that the region has at most %d rects, got %d", maxrects, count);
+
+        /* Everything that was covered must still be covered */
+        for (i = 0; i < count; ++i) {
+            _maskRect(mask, &rects[i], 1);
+        }
+        covers = SDL_TRUE;
+        for (i = 0; i < REGION_GRID * REGION_GRID; ++i) {
+            if (mask[i]) {
+                covers = SDL_FALSE;
+            }
+        }
+        SDLTest_AssertCheck(covers, "Check that the simplified region covers the original");
+
+        SDL_GetRegionBounds(region, &after);
+        SDLTest_AssertCheck(SDL_RectEquals(&before, &after), "Check that simplifying keeps the bounds");
+
+        if (maxrects == 1 && count == 1) {
+            SDLTest_AssertCheck(SDL_RectEquals(&rects[0], &before), "Check that simplifying to one rect gives the bounds");
+        }
+    }
+
+    SDL_FreeRegion(region);
+    return TEST_COMPLETED;
+}
+
+/* !
+ * \brief Negative tests against the region functions with invalid parameters
+ */
+int rect_testRegionParam(void *arg)
+{
+    SDL_Region *region = SDL_CreateRegion();
+    SDL_Rect rect = { 0, 0, 4, 4 };
+    int count = -1;
+
+    SDLTest_AssertCheck(SDL_AddRectToRegion(NULL, &rect) == -1, "Check that SDL_AddRectToRegion fails with a NULL region");
+    SDLTest_AssertCheck(SDL_AddRectToRegion(region, NULL) == -1, "Check that SDL_AddRectToRegion fails with a NULL rect");
+    SDLTest_AssertCheck(SDL_AddRectsToRegion(region, &rect, -1) == -1, "Check that SDL_AddRectsToRegion fails with a negative count");
+    SDLTest_AssertCheck(SDL_UnionRegion(region, NULL) == -1, "Check that SDL_UnionRegion fails with a NULL source");
+    SDLTest_AssertCheck(SDL_SimplifyRegion(region, 0) == -1, "Check that SDL_SimplifyRegion fails with maxrects 0");
+    SDLTest_AssertCheck(SDL_GetRegionRects(NULL, &count) == NULL && count == 0, "Check that SDL_GetRegionRects returns nothing for a NULL region");
+    SDLTest_AssertCheck(SDL_RegionEmpty(NULL) == SDL_TRUE, "Check that a NULL region is empty");
+
+    rect.w = 0;
+    SDLTest_AssertCheck(SDL_AddRectToRegion(region, &rect) == 0 && SDL_RegionEmpty(region), "Check that adding an empty rect does nothing");
+
+    SDL_FreeRegion(region);
+    SDL_FreeRegion(NULL);
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Rect test cases */
@@ -1673,6 +1970,17 @@ static const SDLTest_TestCaseReference rectTest28 =
 static const SDLTest_TestCaseReference rectTest29 =
         { (SDLTest_TestCaseFp)rect_testRectEqualsParam, "rect_testRectEqualsParam", "Negative tests against SDL_RectEquals with invalid parameters", TEST_ENABLED };
 
+/* SDL_Region */
+
+static const SDLTest_TestCaseReference rectTest30 =
+        { (SDLTest_TestCaseFp)rect_testRegionOps, "rect_testRegionOps", "Tests region operations against a pixel mask", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rectTest31 =
+        { (SDLTest_TestCaseFp)rect_testSimplifyRegion, "rect_testSimplifyRegion", "Tests SDL_SimplifyRegion", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rectTest32 =
+        { (SDLTest_TestCaseFp)rect_testRegionParam, "rect_testRegionParam", "Negative tests against the region functions with invalid parameters", TEST_ENABLED };
+
 
 /* !
  * \brief Sequence of Rect test cases; functions that handle simple rectangles including overlaps and merges.
@@ -1683,7 +1991,7 @@ static const SDLTest_TestCaseReference rectTest29 =
 static const SDLTest_TestCaseReference *rectTests[] =  {
     &rectTest1, &rectTest2, &rectTest3, &rectTest4, &rectTest5, &rectTest6, &rectTest7, &rectTest8, &rectTest9, &rectTest10, &rectTest11, &rectTest12, &rectTest13, &rectTest14,
     &rectTest15, &rectTest16, &rectTest17, &rectTest18, &rectTest19, &rectTest20, &rectTest21, &rectTest22, &rectTest23, &rectTest24, &rectTest25, &rectTest26, &rectTest27,
-    &rectTest28, &rectTest29, NULL
+    &rectTest28, &rectTest29, &rectTest30, &rectTest31, &rectTest32, NULL
 };
 
 
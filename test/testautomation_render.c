@@ -1058,6 +1058,795 @@ _clearScreen(void)
    return 0;
 }
 
+/**
+ * @brief Tests YUV textures on the software renderer, which converts them.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CreateSoftwareRenderer
+ * http://wiki.libsdl.org/moin.cgi/SDL_UpdateTexture
+ */
+int
+render_testYUVTextures(void *arg)
+{
+   const Uint32 formats[] = {
+      SDL_PIXELFORMAT_YV12, SDL_PIXELFORMAT_IYUV, SDL_PIXELFORMAT_NV12,
+      SDL_PIXELFORMAT_NV21, SDL_PIXELFORMAT_YUY2, SDL_PIXELFORMAT_UYVY,
+      SDL_PIXELFORMAT_YVYU
+   };
+   /* Limited range BT.601 red */
+   const Uint8 Y = 81, U = 90, V = 240;
+   const int w = 32, h = 16;
+   SDL_Surface *target;
+   SDL_Renderer *swrenderer;
+   SDL_Texture *texture;
+   Uint8 *pixels;
+   Uint32 pixel;
+   Uint8 r, g, b;
+   int ret, i, x, y;
+
+   target = SDL_CreateRGBSurface(0, w * 2, h * 2, 32, RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK, RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(target != NULL, "Verify target surface is not NULL");
+   if (target == NULL) {
+      return TEST_ABORTED;
+   }
+   swrenderer = SDL_CreateSoftwareRenderer(target);
+   SDLTest_AssertCheck(swrenderer != NULL, "Verify SDL_CreateSoftwareRenderer result");
+   pixels = (Uint8 *)SDL_malloc(w * h * 2);
+   if (swrenderer == NULL || pixels == NULL) {
+      SDL_free(pixels);
+      SDL_FreeSurface(target);
+      return TEST_ABORTED;
+   }
+
+   SDL_SetHint(SDL_HINT_YUV_CONVERSION_MODE, "BT601");
+   for (i = 0; i < SDL_arraysize(formats); ++i) {
+      /* Fill the texture with a single color */
+      switch (formats[i]) {
+      case SDL_PIXELFORMAT_YV12:
+      case SDL_PIXELFORMAT_IYUV:
+         SDL_memset(pixels, Y, w * h);
+         SDL_memset(pixels + w * h, formats[i] == SDL_PIXELFORMAT_YV12 ? V : U, w * h / 4);
+         SDL_memset(pixels + w * h + w * h / 4, formats[i] == SDL_PIXELFORMAT_YV12 ? U : V, w * h / 4);
+         break;
+      case SDL_PIXELFORMAT_NV12:
+      case SDL_PIXELFORMAT_NV21:
+         SDL_memset(pixels, Y, w * h);
+         for (x = 0; x < w * h / 2; x += 2) {
+            pixels[w * h + x] = (formats[i] == SDL_PIXELFORMAT_NV12) ? U : V;
+            pixels[w * h + x + 1] = (formats[i] == SDL_PIXELFORMAT_NV12) ? V : U;
+         }
+         break;
+      default:
+         for (x = 0; x < w * h * 2; x += 4) {
+            const Uint8 yuy2[4] = { Y, U, Y, V };
+            const Uint8 uyvy[4] = { U, Y, V, Y };
+            const Uint8 yvyu[4] = { Y, V, Y, U };
+            const Uint8 *macropixel = (formats[i] == SDL_PIXELFORMAT_YUY2) ? yuy2 :
+                                      (formats[i] == SDL_PIXELFORMAT_UYVY) ? uyvy : yvyu;
+            SDL_memcpy(pixels + x, macropixel, 4);
+         }
+         break;
+      }
+
+      texture = SDL_CreateTexture(swrenderer, formats[i], SDL_TEXTUREACCESS_STREAMING, w, h);
+      SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture result for %s", SDL_GetPixelFormatName(formats[i]));
+      if (texture == NULL) {
+         continue;
+      }
+      ret = SDL_UpdateTexture(texture, NULL, pixels, (SDL_ISPIXELFORMAT_FOURCC(formats[i]) && formats[i] != SDL_PIXELFORMAT_YUY2 && formats[i] != SDL_PIXELFORMAT_UYVY && formats[i] != SDL_PIXELFORMAT_YVYU) ? w : w * 2);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+
+      /* Draw it stretched over the whole target */
+      SDL_SetRenderDrawColor(swrenderer, 0, 0, 0, 255);
+      SDL_RenderClear(swrenderer);
+      ret = SDL_RenderCopy(swrenderer, texture, NULL, NULL);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderCopy, expected: 0, got: %i", ret);
+
+      for (y = 0; y < target->h; y += 7) {
+         for (x = 0; x < target->w; x += 5) {
+            pixel = *(Uint32 *)((Uint8 *)target->pixels + y * target->pitch + x * 4);
+            SDL_GetRGB(pixel, target->format, &r, &g, &b);
+            if (r < 250 || g > 5 || b > 5) {
+               break;
+            }
+         }
+         if (x < target->w) {
+            break;
+         }
+      }
+      SDLTest_AssertCheck(y >= target->h, "Verify %s texture renders as red, got: (%d,%d,%d)", SDL_GetPixelFormatName(formats[i]), r, g, b);
+
+      SDL_DestroyTexture(texture);
+   }
+   SDL_SetHint(SDL_HINT_YUV_CONVERSION_MODE, "JPEG");
+
+   SDL_free(pixels);
+   SDL_DestroyRenderer(swrenderer);
+   SDL_FreeSurface(target);
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests NV12 and NV21 textures with odd sizes, whose chroma rows are padded to an even length.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_UpdateTexture
+ * http://wiki.libsdl.org/moin.cgi/SDL_ConvertPixels
+ */
+int
+render_testYUVOddSize(void *arg)
+{
+   const Uint32 formats[] = { SDL_PIXELFORMAT_NV12, SDL_PIXELFORMAT_NV21 };
+   const int sizes[][2] = { { 3, 2 }, { 5, 3 }, { 2, 5 }, { 7, 7 } };
+   const int maxDelta = 4;
+   SDL_Surface *target;
+   SDL_Renderer *swrenderer;
+   SDL_Texture *texture;
+   Uint32 *rgb;
+   Uint8 *yuv;
+   Uint32 pixel;
+   Uint8 r, g, b;
+   int ret, i, s, x, y, w, h, delta, maxFound;
+
+   rgb = (Uint32 *)SDL_malloc(8 * 8 * 4);
+   SDLTest_AssertCheck(rgb != NULL, "Verify buffer was allocated");
+   if (rgb == NULL) {
+      return TEST_ABORTED;
+   }
+
+   SDL_SetHint(SDL_HINT_YUV_CONVERSION_MODE, "BT601");
+   SDL_SetHint(SDL_HINT_YUV_CHROMA_FILTER, "NEAREST");
+   for (s = 0; s < SDL_arraysize(sizes); ++s) {
+      w = sizes[s][0];
+      h = sizes[s][1];
+
+      /* Blocks of 2x2 pixels with the same color survive chroma subsampling */
+      for (y = 0; y < h; ++y) {
+         for (x = 0; x < w; ++x) {
+            rgb[y * w + x] = 0xFF000000 | ((40 + x / 2 * 53) << 16) | ((200 - y / 2 * 61) << 8) | (60 + (x / 2) * 17 + (y / 2) * 29);
+         }
+      }
+
+      target = SDL_CreateRGBSurface(0, w, h, 32, RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK, RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+      SDLTest_AssertCheck(target != NULL, "Verify target surface is not NULL");
+      if (target == NULL) {
+         break;
+      }
+      swrenderer = SDL_CreateSoftwareRenderer(target);
+      SDLTest_AssertCheck(swrenderer != NULL, "Verify SDL_CreateSoftwareRenderer result");
+
+      for (i = 0; swrenderer != NULL && i < SDL_arraysize(formats); ++i) {
+         /* Exactly the size of the image, with even length chroma rows */
+         yuv = (Uint8 *)SDL_malloc(w * h + ((w + 1) & ~1) * ((h + 1) / 2));
+         if (yuv == NULL) {
+            break;
+         }
+         ret = SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_ARGB8888, rgb, w * 4, formats[i], yuv, w);
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_ConvertPixels(ARGB8888 to %s), expected: 0, got: %i", SDL_GetPixelFormatName(formats[i]), ret);
+
+         texture = SDL_CreateTexture(swrenderer, formats[i], SDL_TEXTUREACCESS_STREAMING, w, h);
+         SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture result for %ix%i %s", w, h, SDL_GetPixelFormatName(formats[i]));
+         if (texture == NULL) {
+            SDL_free(yuv);
+            continue;
+         }
+         ret = SDL_UpdateTexture(texture, NULL, yuv, w);
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+         ret = SDL_RenderCopy(swrenderer, texture, NULL, NULL);
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderCopy, expected: 0, got: %i", ret);
+
+         maxFound = 0;
+         for (y = 0; y < h; ++y) {
+            for (x = 0; x < w; ++x) {
+               pixel = *(Uint32 *)((Uint8 *)target->pixels + y * target->pitch + x * 4);
+               SDL_GetRGB(pixel, target->format, &r, &g, &b);
+               delta = SDL_abs((int)r - (int)((rgb[y * w + x] >> 16) & 0xFF));
+               delta = SDL_max(delta, SDL_abs((int)g - (int)((rgb[y * w + x] >> 8) & 0xFF)));
+               delta = SDL_max(delta, SDL_abs((int)b - (int)(rgb[y * w + x] & 0xFF)));
+               maxFound = SDL_max(maxFound, delta);
+            }
+         }
+         SDLTest_AssertCheck(maxFound <= maxDelta, "Verify round trip through %ix%i %s texture; expected difference <= %d, got: %d", w, h, SDL_GetPixelFormatName(formats[i]), maxDelta, maxFound);
+
+         SDL_DestroyTexture(texture);
+         SDL_free(yuv);
+      }
+
+      if (swrenderer != NULL) {
+         SDL_DestroyRenderer(swrenderer);
+      }
+      SDL_FreeSurface(target);
+   }
+   SDL_SetHint(SDL_HINT_YUV_CONVERSION_MODE, "JPEG");
+   SDL_SetHint(SDL_HINT_YUV_CHROMA_FILTER, "LINEAR");
+
+   SDL_free(rgb);
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests locking a streaming texture repeatedly, with several backing buffers.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_LockTexture
+ * http://wiki.libsdl.org/moin.cgi/SDL_UnlockTexture
+ */
+int
+render_testStreamingTexture(void *arg)
+{
+   const Uint32 colors[] = { 0xFFFF0000, 0xFF00FF00, 0xFF0000FF, 0xFFFFFF00, 0xFF00FFFF };
+   /* SDL_HINT_RENDER_STREAMING_BUFFERS is only used by the OpenGL renderer */
+   const int buffers = 3;
+   const int frames = 3 * buffers + 1;
+   const int w = 16, h = 16;
+   SDL_RendererInfo info;
+   SDL_Texture *texture;
+   SDL_Rect rect;
+   char hint[16];
+   Uint32 *pixels, *output;
+   Uint32 pixel;
+   int pitch, ret, i, x, y, outw, outh;
+
+   ret = SDL_GetRendererInfo(renderer, &info);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_GetRendererInfo, expected: 0, got: %i", ret);
+   if (ret < 0 || SDL_strcmp(info.name, "opengl") != 0) {
+      SDLTest_Log("Skipping streaming buffer test, the %s renderer doesn't use them", ret < 0 ? "current" : info.name);
+      return TEST_SKIPPED;
+   }
+
+   SDL_GetRendererOutputSize(renderer, &outw, &outh);
+   output = (Uint32 *)SDL_malloc(outw * outh * 4);
+   if (output == NULL) {
+      return TEST_ABORTED;
+   }
+
+   SDL_snprintf(hint, sizeof(hint), "%d", buffers);
+   SDL_SetHint(SDL_HINT_RENDER_STREAMING_BUFFERS, hint);
+   texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+   SDL_SetHint(SDL_HINT_RENDER_STREAMING_BUFFERS, "1");
+   SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture result");
+   if (texture == NULL) {
+      SDL_free(output);
+      return TEST_ABORTED;
+   }
+
+   /* Each frame has to show up in full, even after every buffer in the
+      ring has been reused several times */
+   for (i = 0; i < frames; ++i) {
+      const Uint32 color = colors[i % SDL_arraysize(colors)];
+
+      ret = SDL_LockTexture(texture, NULL, (void **)&pixels, &pitch);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_LockTexture, expected: 0, got: %i", ret);
+      if (ret < 0) {
+         break;
+      }
+      for (y = 0; y < h; ++y) {
+         for (x = 0; x < w; ++x) {
+            pixels[y * (pitch / 4) + x] = color;
+         }
+      }
+      SDL_UnlockTexture(texture);
+
+      ret = SDL_RenderCopy(renderer, texture, NULL, NULL);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderCopy, expected: 0, got: %i", ret);
+      ret = SDL_RenderReadPixels(renderer, NULL, RENDER_COMPARE_FORMAT, output, outw * 4);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+      for (x = 0; x < outw * outh; ++x) {
+         if (output[x] != color) {
+            break;
+         }
+      }
+      SDLTest_AssertCheck(x == outw * outh, "Verify frame %d, expected: 0x%.8x, got: 0x%.8x", i, color, x < outw * outh ? output[x] : color);
+   }
+   SDL_free(output);
+
+   /* Locking part of the texture leaves the rest alone */
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = w / 2;
+   rect.h = h;
+   ret = SDL_LockTexture(texture, &rect, (void **)&pixels, &pitch);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_LockTexture, expected: 0, got: %i", ret);
+   if (ret == 0) {
+      for (y = 0; y < rect.h; ++y) {
+         for (x = 0; x < rect.w; ++x) {
+            pixels[y * (pitch / 4) + x] = colors[0];
+         }
+      }
+      SDL_UnlockTexture(texture);
+
+      SDL_RenderCopy(renderer, texture, NULL, NULL);
+      SDL_GetRendererOutputSize(renderer, &x, &y);
+      rect.x = 1;
+      rect.y = y / 2;
+      rect.w = 1;
+      rect.h = 1;
+      SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, &pixel, 4);
+      SDLTest_AssertCheck(pixel == colors[0], "Verify locked half, expected: 0x%.8x, got: 0x%.8x", colors[0], pixel);
+      rect.x = x - 2;
+      SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, &pixel, 4);
+      SDLTest_AssertCheck(pixel == colors[(frames - 1) % SDL_arraysize(colors)], "Verify unlocked half, expected: 0x%.8x, got: 0x%.8x", colors[(frames - 1) % SDL_arraysize(colors)], pixel);
+   }
+
+   SDL_DestroyTexture(texture);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests reading pixels asynchronously
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderReadPixelsAsync
+ */
+int
+render_testReadPixelsAsync(void *arg)
+{
+   SDL_RenderReadback *readback, *clipped, *unused;
+   SDL_Rect rect;
+   Uint32 *pixels;
+   Uint32 row[8];
+   int w, h, ret, i;
+
+   SDL_GetRendererOutputSize(renderer, &w, &h);
+   pixels = (Uint32 *)SDL_malloc(w * h * sizeof(*pixels));
+   SDLTest_AssertCheck(pixels != NULL, "Verify pixel buffer allocation");
+   if (pixels == NULL) {
+      return TEST_ABORTED;
+   }
+
+   /* Red on the left, green on the right */
+   SDL_SetRenderDrawColor(renderer, 0, 255, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(renderer);
+   SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = w / 2;
+   rect.h = h;
+   SDL_RenderFillRect(renderer, &rect);
+
+   readback = SDL_RenderReadPixelsAsync(renderer, NULL, RENDER_COMPARE_FORMAT);
+   SDLTest_AssertCheck(readback != NULL, "Verify result from SDL_RenderReadPixelsAsync, got: %s", SDL_GetError());
+
+   /* Part of this one is outside the render target, and it needs converting */
+   rect.x = -4;
+   rect.y = 1;
+   rect.w = SDL_arraysize(row);
+   rect.h = 1;
+   clipped = SDL_RenderReadPixelsAsync(renderer, &rect, SDL_PIXELFORMAT_ABGR8888);
+   SDLTest_AssertCheck(clipped != NULL, "Verify result from SDL_RenderReadPixelsAsync with a clipped rect");
+
+   unused = SDL_RenderReadPixelsAsync(renderer, NULL, SDL_PIXELFORMAT_RGB565);
+   SDLTest_AssertCheck(unused != NULL, "Verify result from SDL_RenderReadPixelsAsync with RGB565");
+
+   /* Drawing after the request doesn't change what's read */
+   SDL_SetRenderDrawColor(renderer, 0, 0, 255, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(renderer);
+
+   if (readback) {
+      for (i = 0; i < 1000 && !SDL_PollRenderReadback(readback); ++i) {
+         SDL_Delay(1);
+      }
+      SDLTest_AssertCheck(SDL_PollRenderReadback(readback), "Verify SDL_PollRenderReadback finishes");
+
+      ret = SDL_WaitRenderReadback(readback, pixels, w * sizeof(*pixels));
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_WaitRenderReadback, expected: 0, got: %i", ret);
+      SDLTest_AssertCheck(pixels[1] == 0xFFFF0000, "Verify left pixel, expected: 0xffff0000, got: 0x%.8x", pixels[1]);
+      SDLTest_AssertCheck(pixels[w * h - 2] == 0xFF00FF00, "Verify right pixel, expected: 0xff00ff00, got: 0x%.8x", pixels[w * h - 2]);
+      SDL_DestroyRenderReadback(readback);
+   }
+
+   if (clipped) {
+      SDL_memset(row, 0, sizeof(row));
+      ret = SDL_WaitRenderReadback(clipped, row, sizeof(row));
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_WaitRenderReadback, expected: 0, got: %i", ret);
+      for (i = 0; i < SDL_arraysize(row); ++i) {
+         Uint32 expected = (i < 4) ? 0 : 0xFF0000FF;
+         SDLTest_AssertCheck(row[i] == expected, "Verify clipped pixel %d, expected: 0x%.8x, got: 0x%.8x", i, expected, row[i]);
+      }
+      SDL_DestroyRenderReadback(clipped);
+   }
+
+   /* Readbacks can be destroyed without waiting for them */
+   SDL_DestroyRenderReadback(unused);
+
+   ret = SDL_WaitRenderReadback(NULL, pixels, w * sizeof(*pixels));
+   SDLTest_AssertCheck(ret == -1, "Verify SDL_WaitRenderReadback with NULL readback, expected: -1, got: %i", ret);
+
+   SDL_free(pixels);
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests rotated and flipped copies on the software renderer.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderCopyEx
+ */
+int
+render_testSoftwareRotation(void *arg)
+{
+   /* Red, green, blue, white on top of black, yellow, cyan, magenta */
+   Uint32 colors[8] = {
+      0xFFFF0000, 0xFF00FF00, 0xFF0000FF, 0xFFFFFFFF,
+      0xFF000000, 0xFFFFFF00, 0xFF00FFFF, 0xFFFF00FF
+   };
+   SDL_Surface *target;
+   SDL_Renderer *swrenderer;
+   SDL_Texture *texture;
+   SDL_Rect rect;
+   SDL_Point center;
+   Uint32 pixel = 0, expected = 0;
+   int ret, i, x, y;
+
+   target = SDL_CreateRGBSurface(0, 32, 32, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+   SDLTest_AssertCheck(target != NULL, "Verify target surface is not NULL");
+   if (target == NULL) {
+      return TEST_ABORTED;
+   }
+   swrenderer = SDL_CreateSoftwareRenderer(target);
+   SDLTest_AssertCheck(swrenderer != NULL, "Verify SDL_CreateSoftwareRenderer result");
+   texture = swrenderer ? SDL_CreateTexture(swrenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 4, 2) : NULL;
+   SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture result");
+   if (texture == NULL) {
+      if (swrenderer) {
+         SDL_DestroyRenderer(swrenderer);
+      }
+      SDL_FreeSurface(target);
+      return TEST_ABORTED;
+   }
+   ret = SDL_UpdateTexture(texture, NULL, colors, 4 * sizeof(Uint32));
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+
+   /* Flipped both ways, scaled up four times */
+   SDL_SetRenderDrawColor(swrenderer, 0, 0, 0, 0);
+   SDL_RenderClear(swrenderer);
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = 16;
+   rect.h = 8;
+   ret = SDL_RenderCopyEx(swrenderer, texture, NULL, &rect, 0.0, NULL, SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderCopyEx, expected: 0, got: %i", ret);
+   for (y = 0; y < rect.h; ++y) {
+      for (x = 0; x < rect.w; ++x) {
+         pixel = *((Uint32 *)((Uint8 *)target->pixels + y * target->pitch) + x);
+         expected = colors[7 - (y / 4) * 4 - x / 4];
+         if (pixel != expected) {
+            break;
+         }
+      }
+      if (x < rect.w) {
+         break;
+      }
+   }
+   SDLTest_AssertCheck(y == rect.h, "Verify flipped copy, expected: 0x%.8x, got: 0x%.8x", expected, pixel);
+
+   /* Rotated a quarter turn clockwise around the top left corner, then again
+      to check that a repeat draws the same thing, and after an update */
+   for (i = 0; i < 3; ++i) {
+      if (i == 2) {
+         colors[0] = 0xFF808080;
+         ret = SDL_UpdateTexture(texture, NULL, colors, 4 * sizeof(Uint32));
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+      }
+      SDL_RenderClear(swrenderer);
+      rect.x = 16;
+      rect.y = 16;
+      center.x = 0;
+      center.y = 0;
+      ret = SDL_RenderCopyEx(swrenderer, texture, NULL, &rect, 90.0, &center, SDL_FLIP_NONE);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderCopyEx, expected: 0, got: %i", ret);
+      for (x = 0; x < rect.h; ++x) {
+         for (y = 0; y < rect.w; ++y) {
+            pixel = *((Uint32 *)((Uint8 *)target->pixels + (rect.y + y) * target->pitch) + rect.x - 1 - x);
+            expected = colors[(x / 4) * 4 + y / 4];
+            if (pixel != expected) {
+               break;
+            }
+         }
+         if (y < rect.w) {
+            break;
+         }
+      }
+      SDLTest_AssertCheck(x == rect.h, "Verify rotated copy %d, expected: 0x%.8x, got: 0x%.8x", i, expected, pixel);
+      pixel = *((Uint32 *)((Uint8 *)target->pixels + rect.y * target->pitch) + rect.x);
+      SDLTest_AssertCheck(pixel == 0, "Verify pixel outside the rotated copy, expected: 0x00000000, got: 0x%.8x", pixel);
+   }
+
+   SDL_DestroyTexture(texture);
+   SDL_DestroyRenderer(swrenderer);
+   SDL_FreeSurface(target);
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests that tinted copies on the software renderer look the same with the modulation cache.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetTextureColorMod
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetTextureAlphaMod
+ */
+int
+render_testSoftwareModulateCache(void *arg)
+{
+   const char *sizes[] = { "0", "64" };
+   /* Textures without alpha still have to keep their alpha modulation */
+   const Uint32 formats[] = { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888 };
+   const int w = 8, h = 8;
+   Uint32 pixels[8 * 8];
+   Uint32 results[2][16 * 16];
+   SDL_Surface *target;
+   SDL_Renderer *swrenderer;
+   SDL_Texture *texture;
+   SDL_Rect rect;
+   int ret, i, j, f;
+
+   for (f = 0; f < SDL_arraysize(formats); ++f) {
+      for (i = 0; i < SDL_arraysize(sizes); ++i) {
+         SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_MODULATE_CACHE, sizes[i]);
+         target = SDL_CreateRGBSurface(0, 16, 16, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+         SDLTest_AssertCheck(target != NULL, "Verify target surface is not NULL");
+         if (target == NULL) {
+            SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_MODULATE_CACHE, "0");
+            return TEST_ABORTED;
+         }
+         swrenderer = SDL_CreateSoftwareRenderer(target);
+         SDLTest_AssertCheck(swrenderer != NULL, "Verify SDL_CreateSoftwareRenderer result");
+         texture = swrenderer ? SDL_CreateTexture(swrenderer, formats[f], SDL_TEXTUREACCESS_STATIC, w, h) : NULL;
+         SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture result");
+         if (texture == NULL) {
+            if (swrenderer) {
+               SDL_DestroyRenderer(swrenderer);
+            }
+            SDL_FreeSurface(target);
+            SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_MODULATE_CACHE, "0");
+            return TEST_ABORTED;
+         }
+
+         for (j = 0; j < w * h; ++j) {
+            pixels[j] = ((Uint32)(j * 4) << 24) | ((Uint32)(255 - j) << 16) | ((Uint32)(j * 3) << 8) | 0x80;
+         }
+         ret = SDL_UpdateTexture(texture, NULL, pixels, w * sizeof(Uint32));
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+         SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+         SDL_SetRenderDrawColor(swrenderer, 40, 80, 120, 255);
+         SDL_RenderClear(swrenderer);
+
+         /* The same tint twice, a different one, then the first again after an update */
+         rect.w = w;
+         rect.h = h;
+         for (j = 0; j < 4; ++j) {
+            if (j == 3) {
+               pixels[0] = 0xFFFFFFFF;
+               ret = SDL_UpdateTexture(texture, NULL, pixels, w * sizeof(Uint32));
+               SDLTest_AssertCheck(ret == 0, "Verify result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+            }
+            SDL_SetTextureColorMod(texture, 255, (j == 2) ? 20 : 128, 64);
+            SDL_SetTextureAlphaMod(texture, (j == 2) ? 255 : 200);
+            rect.x = (j % 2) * w;
+            rect.y = (j / 2) * h;
+            ret = SDL_RenderCopy(swrenderer, texture, NULL, &rect);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderCopy, expected: 0, got: %i", ret);
+         }
+         for (j = 0; j < 16; ++j) {
+            SDL_memcpy(&results[i][j * 16], (Uint8 *)target->pixels + j * target->pitch, 16 * sizeof(Uint32));
+         }
+
+         SDL_DestroyTexture(texture);
+         SDL_DestroyRenderer(swrenderer);
+         SDL_FreeSurface(target);
+      }
+      SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_MODULATE_CACHE, "0");
+
+      /* The plain blitters may round blending slightly differently */
+      for (j = 0; j < 16 * 16; ++j) {
+         for (i = 0; i < 32; i += 8) {
+            const int c0 = (int)((results[0][j] >> i) & 0xFF);
+            const int c1 = (int)((results[1][j] >> i) & 0xFF);
+            if (c0 - c1 > 2 || c1 - c0 > 2) {
+               break;
+            }
+         }
+         if (i < 32) {
+            break;
+         }
+      }
+      SDLTest_AssertCheck(j == 16 * 16, "Verify cached modulation of %s matches, differs at pixel %d", SDL_GetPixelFormatName(formats[f]), j);
+   }
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests creating textures from surfaces of various formats on the software renderer.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CreateTextureFromSurface
+ */
+int
+render_testTextureFromSurfaceFormats(void *arg)
+{
+   const Uint32 formats[] = {
+      SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_BGR24, SDL_PIXELFORMAT_RGB565,
+      SDL_PIXELFORMAT_RGB555, SDL_PIXELFORMAT_ARGB4444, SDL_PIXELFORMAT_ABGR8888,
+      SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_ARGB8888
+   };
+   /* Tall enough to be uploaded in more than one strip */
+   const int w = 256, h = 1100;
+   SDL_Surface *target, *source, *reference;
+   SDL_Renderer *swrenderer;
+   SDL_Texture *texture;
+   Uint32 format, Rmask, Gmask, Bmask, Amask;
+   int ret, i, x, y, bpp;
+
+   target = SDL_CreateRGBSurface(0, w, h, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+   SDLTest_AssertCheck(target != NULL, "Verify target surface is not NULL");
+   if (target == NULL) {
+      return TEST_ABORTED;
+   }
+   swrenderer = SDL_CreateSoftwareRenderer(target);
+   SDLTest_AssertCheck(swrenderer != NULL, "Verify SDL_CreateSoftwareRenderer result");
+   if (swrenderer == NULL) {
+      SDL_FreeSurface(target);
+      return TEST_ABORTED;
+   }
+
+   for (i = 0; i < SDL_arraysize(formats); ++i) {
+      SDL_PixelFormatEnumToMasks(formats[i], &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+      source = SDL_CreateRGBSurface(0, w, h, bpp, Rmask, Gmask, Bmask, Amask);
+      SDLTest_AssertCheck(source != NULL, "Verify source surface for %s is not NULL", SDL_GetPixelFormatName(formats[i]));
+      if (source == NULL) {
+         continue;
+      }
+      for (y = 0; y < h; ++y) {
+         Uint8 *row = (Uint8 *)source->pixels + y * source->pitch;
+         for (x = 0; x < w * source->format->BytesPerPixel; ++x) {
+            row[x] = (Uint8)(x * 7 + y * 13 + (x * y >> 3));
+         }
+      }
+      reference = SDL_ConvertSurfaceFormat(source, SDL_PIXELFORMAT_ARGB8888, 0);
+      texture = SDL_CreateTextureFromSurface(swrenderer, source);
+      SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTextureFromSurface result for %s", SDL_GetPixelFormatName(formats[i]));
+      if (texture != NULL && reference != NULL) {
+         if (formats[i] == SDL_PIXELFORMAT_ABGR8888 || formats[i] == SDL_PIXELFORMAT_ARGB8888) {
+            SDL_QueryTexture(texture, &format, NULL, NULL, NULL);
+            SDLTest_AssertCheck(format == formats[i], "Verify supported format %s is kept, got %s",
+               SDL_GetPixelFormatName(formats[i]), SDL_GetPixelFormatName(format));
+         }
+         SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+         ret = SDL_RenderCopy(swrenderer, texture, NULL, NULL);
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderCopy, expected: 0, got: %i", ret);
+         for (y = 0; y < h; ++y) {
+            if (SDL_memcmp((Uint8 *)target->pixels + y * target->pitch,
+                           (Uint8 *)reference->pixels + y * reference->pitch, w * 4) != 0) {
+               break;
+            }
+         }
+         SDLTest_AssertCheck(y == h, "Verify texture created from %s matches the converted surface, differs at row %d",
+            SDL_GetPixelFormatName(formats[i]), y);
+      }
+      if (texture != NULL) {
+         SDL_DestroyTexture(texture);
+      }
+      SDL_FreeSurface(reference);
+      SDL_FreeSurface(source);
+   }
+
+   SDL_DestroyRenderer(swrenderer);
+   SDL_FreeSurface(target);
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests that blended lines and rect outlines on the software renderer touch each pixel once.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderDrawLine
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderDrawRects
+ */
+int
+render_testSoftwareLines(void *arg)
+{
+   const Uint32 background = 0xFF204060;
+   SDL_Surface *target;
+   SDL_Renderer *swrenderer;
+   SDL_Rect rects[3];
+   Uint32 pixel, blended;
+   int ret, i, x, y, count, errors;
+
+   target = SDL_CreateRGBSurface(0, 64, 48, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+   SDLTest_AssertCheck(target != NULL, "Verify target surface is not NULL");
+   if (target == NULL) {
+      return TEST_ABORTED;
+   }
+   swrenderer = SDL_CreateSoftwareRenderer(target);
+   SDLTest_AssertCheck(swrenderer != NULL, "Verify SDL_CreateSoftwareRenderer result");
+   if (swrenderer == NULL) {
+      SDL_FreeSurface(target);
+      return TEST_ABORTED;
+   }
+
+   /* Work out what a single blend over the background gives */
+   SDL_FillRect(target, NULL, background);
+   SDL_SetRenderDrawBlendMode(swrenderer, SDL_BLENDMODE_BLEND);
+   SDL_SetRenderDrawColor(swrenderer, 200, 150, 100, 128);
+   ret = SDL_RenderDrawPoint(swrenderer, 0, 0);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderDrawPoint, expected: 0, got: %i", ret);
+   blended = *(Uint32 *)target->pixels;
+   SDLTest_AssertCheck(blended != background, "Verify blended point, got: 0x%.8x", blended);
+
+   /* A shallow line covers every column it spans exactly once */
+   SDL_FillRect(target, NULL, background);
+   ret = SDL_RenderDrawLine(swrenderer, 2, 10, 61, 17);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderDrawLine, expected: 0, got: %i", ret);
+   errors = 0;
+   for (x = 0; x < target->w; ++x) {
+      count = 0;
+      for (y = 0; y < target->h; ++y) {
+         pixel = *((Uint32 *)((Uint8 *)target->pixels + y * target->pitch) + x);
+         if (pixel == blended) {
+            ++count;
+         } else if (pixel != background) {
+            ++errors;
+         }
+      }
+      if (count != ((x >= 2 && x <= 61) ? 1 : 0)) {
+         ++errors;
+      }
+   }
+   SDLTest_AssertCheck(errors == 0, "Verify shallow blended line, expected: 0 errors, got: %i", errors);
+
+   /* Rect outlines, one of them clipped, blend each outline pixel once */
+   SDL_FillRect(target, NULL, background);
+   rects[0].x = 4;
+   rects[0].y = 4;
+   rects[0].w = 20;
+   rects[0].h = 10;
+   rects[1].x = 30;
+   rects[1].y = 20;
+   rects[1].w = 40;
+   rects[1].h = 2;
+   rects[2].x = 10;
+   rects[2].y = 30;
+   rects[2].w = 1;
+   rects[2].h = 8;
+   ret = SDL_RenderDrawRects(swrenderer, rects, SDL_arraysize(rects));
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderDrawRects, expected: 0, got: %i", ret);
+   errors = 0;
+   for (y = 0; y < target->h; ++y) {
+      for (x = 0; x < target->w; ++x) {
+         SDL_bool outline = SDL_FALSE;
+         for (i = 0; i < SDL_arraysize(rects); ++i) {
+            const SDL_Rect *r = &rects[i];
+            if (x >= r->x && x < r->x + r->w && y >= r->y && y < r->y + r->h &&
+                (x == r->x || x == r->x + r->w - 1 || y == r->y || y == r->y + r->h - 1)) {
+               outline = SDL_TRUE;
+            }
+         }
+         pixel = *((Uint32 *)((Uint8 *)target->pixels + y * target->pitch) + x);
+         if (pixel != (outline ? blended : background)) {
+            ++errors;
+         }
+      }
+   }
+   SDLTest_AssertCheck(errors == 0, "Verify blended rect outlines, expected: 0 errors, got: %i", errors);
+
+   SDL_DestroyRenderer(swrenderer);
+   SDL_FreeSurface(target);
+   return TEST_COMPLETED;
+}
+
+
 /* ================= Test References ================== */
 
 /* Render test cases */
@@ -1085,9 +1874,33 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testYUVTextures, "render_testYUVTextures", "Tests YUV textures on the software renderer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest9 =
+        { (SDLTest_TestCaseFp)render_testStreamingTexture, "render_testStreamingTexture", "Tests locking streaming textures with several buffers", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest10 =
+        { (SDLTest_TestCaseFp)render_testReadPixelsAsync, "render_testReadPixelsAsync", "Tests reading pixels asynchronously", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest11 =
+        { (SDLTest_TestCaseFp)render_testSoftwareRotation, "render_testSoftwareRotation", "Tests rotated copies on the software renderer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest12 =
+        { (SDLTest_TestCaseFp)render_testSoftwareModulateCache, "render_testSoftwareModulateCache", "Tests the software renderer's modulated texture cache", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest13 =
+        { (SDLTest_TestCaseFp)render_testTextureFromSurfaceFormats, "render_testTextureFromSurfaceFormats", "Tests creating textures from surfaces of various formats", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest14 =
+        { (SDLTest_TestCaseFp)render_testSoftwareLines, "render_testSoftwareLines", "Tests blended lines and rect outlines on the software renderer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest15 =
+        { (SDLTest_TestCaseFp)render_testYUVOddSize, "render_testYUVOddSize", "Tests odd sized NV12 and NV21 textures on the software renderer", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, &renderTest9, &renderTest10, &renderTest11, &renderTest12, &renderTest13, &renderTest14, &renderTest15, NULL
 };
 
 /* Render test suite (global) */
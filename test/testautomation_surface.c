@@ -588,6 +588,996 @@ surface_testBlitBlendLoop(void *arg) {
 
 }
 
+/**
+ * @brief Tests scaled blitting with linear filtering.
+ */
+int
+surface_testBlitScaledLinear(void *arg)
+{
+   int ret, i;
+   SDL_ScaleMode scaleMode;
+   SDL_Surface *source, *target, *uniform;
+   Uint32 *pixels;
+   Uint32 expected;
+   SDL_Rect rect;
+   int intermediate = 0;
+
+   source = SDL_CreateRGBSurface(0, 2, 1, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+   SDLTest_AssertCheck(source != NULL, "Verify source surface is not NULL");
+   target = SDL_CreateRGBSurface(0, 16, 4, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+   SDLTest_AssertCheck(target != NULL, "Verify target surface is not NULL");
+   if (source == NULL || target == NULL) {
+      SDL_FreeSurface(source);
+      SDL_FreeSurface(target);
+      return TEST_ABORTED;
+   }
+   ((Uint32 *)source->pixels)[0] = 0xFF000000;
+   ((Uint32 *)source->pixels)[1] = 0xFFFFFFFF;
+
+   /* Default is nearest sampling */
+   ret = SDL_GetSurfaceScaleMode(source, &scaleMode);
+   SDLTest_AssertPass("Call to SDL_GetSurfaceScaleMode()");
+   SDLTest_AssertCheck(ret == 0 && scaleMode == SDL_SCALEMODE_NEAREST, "Verify default scale mode, expected: %i, got: %i", SDL_SCALEMODE_NEAREST, scaleMode);
+
+   ret = SDL_SetSurfaceScaleMode(source, SDL_SCALEMODE_LINEAR);
+   SDLTest_AssertPass("Call to SDL_SetSurfaceScaleMode(SDL_SCALEMODE_LINEAR)");
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetSurfaceScaleMode, expected: 0, got: %i", ret);
+   ret = SDL_GetSurfaceScaleMode(source, &scaleMode);
+   SDLTest_AssertCheck(ret == 0 && scaleMode == SDL_SCALEMODE_LINEAR, "Verify scale mode, expected: %i, got: %i", SDL_SCALEMODE_LINEAR, scaleMode);
+
+   /* A black to white ramp has to be filtered into intermediate grays */
+   ret = SDL_BlitScaled(source, NULL, target, NULL);
+   SDLTest_AssertPass("Call to SDL_BlitScaled()");
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitScaled, expected: 0, got: %i", ret);
+   pixels = (Uint32 *)target->pixels;
+   SDLTest_AssertCheck(pixels[0] == 0xFF000000, "Verify left edge, expected: 0xFF000000, got: 0x%08x", pixels[0]);
+   SDLTest_AssertCheck(pixels[target->w - 1] == 0xFFFFFFFF, "Verify right edge, expected: 0xFFFFFFFF, got: 0x%08x", pixels[target->w - 1]);
+   for (i = 1; i < target->w; ++i) {
+      Uint32 gray = pixels[i] & 0xFF;
+      if (gray > 0 && gray < 0xFF) {
+         ++intermediate;
+      }
+      if (gray < (pixels[i - 1] & 0xFF) || pixels[i] != pixels[i + 3 * target->w]) {
+         break;
+      }
+   }
+   SDLTest_AssertCheck(i == target->w, "Verify the ramp is monotonic and equal on every row");
+   SDLTest_AssertCheck(intermediate > 0, "Verify filtered pixels were produced, got %i", intermediate);
+
+   /* Back to nearest sampling, only the source colors may appear */
+   ret = SDL_SetSurfaceScaleMode(source, SDL_SCALEMODE_NEAREST);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetSurfaceScaleMode, expected: 0, got: %i", ret);
+   ret = SDL_BlitScaled(source, NULL, target, NULL);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitScaled, expected: 0, got: %i", ret);
+   for (i = 0; i < target->w; ++i) {
+      if (pixels[i] != 0xFF000000 && pixels[i] != 0xFFFFFFFF) {
+         break;
+      }
+   }
+   SDLTest_AssertCheck(i == target->w, "Verify nearest sampling produced no filtered pixels");
+
+   /* Blending a filtered uniform color has to match an unscaled blend */
+   uniform = SDL_CreateRGBSurface(0, 3, 3, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+   SDLTest_AssertCheck(uniform != NULL, "Verify uniform surface is not NULL");
+   if (uniform != NULL) {
+      SDL_FillRect(uniform, NULL, 0x80FF4020);
+      SDL_SetSurfaceBlendMode(uniform, SDL_BLENDMODE_BLEND);
+      SDL_FillRect(target, NULL, 0xFF000000);
+      rect.x = rect.y = 0;
+      rect.w = rect.h = 1;
+      ret = SDL_BlitSurface(uniform, &rect, target, &rect);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+      expected = pixels[0];
+      SDL_FillRect(target, NULL, 0xFF000000);
+      ret = SDL_SetSurfaceScaleMode(uniform, SDL_SCALEMODE_LINEAR);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetSurfaceScaleMode, expected: 0, got: %i", ret);
+      ret = SDL_BlitScaled(uniform, NULL, target, NULL);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitScaled, expected: 0, got: %i", ret);
+      for (i = 0; i < target->w * target->h; ++i) {
+         if (pixels[i] != expected) {
+            break;
+         }
+      }
+      SDLTest_AssertCheck(i == target->w * target->h, "Verify blended pixels, expected: 0x%08x, got: 0x%08x", expected, pixels[i < target->w * target->h ? i : 0]);
+      SDL_FreeSurface(uniform);
+   }
+
+   SDL_FreeSurface(source);
+   SDL_FreeSurface(target);
+
+   return TEST_COMPLETED;
+}
+
+/* Nearest neighbour reference for stretched blits.  The source is stepped
+   through in 16.16 fixed point, the way SDL has always sampled it. */
+static void
+_stretchReference(SDL_Surface *src, const SDL_Rect *srcrect,
+                  Uint8 *dst, int dstpitch, const SDL_Rect *dstrect)
+{
+   const int bpp = src->format->BytesPerPixel;
+   const Sint64 xinc = ((Sint64)srcrect->w << 16) / dstrect->w;
+   const Sint64 yinc = ((Sint64)srcrect->h << 16) / dstrect->h;
+   int x, y, sx, sy;
+
+   for (y = 0; y < dstrect->h; ++y) {
+      sy = srcrect->y + (int)((y * yinc) >> 16);
+      for (x = 0; x < dstrect->w; ++x) {
+         sx = srcrect->x + (int)((x * xinc) >> 16);
+         SDL_memcpy(dst + (dstrect->y + y) * dstpitch + (dstrect->x + x) * bpp,
+                    (Uint8 *)src->pixels + sy * src->pitch + sx * bpp, bpp);
+      }
+   }
+}
+
+/* Compares a surface against an expected copy of its pixels, row by row */
+static int
+_compareStretched(SDL_Surface *dst, const Uint8 *expected)
+{
+   int y;
+
+   for (y = 0; y < dst->h; ++y) {
+      if (SDL_memcmp((Uint8 *)dst->pixels + y * dst->pitch, expected + y * dst->pitch,
+                     dst->w * dst->format->BytesPerPixel) != 0) {
+         return y;
+      }
+   }
+   return -1;
+}
+
+/**
+ * @brief Tests SDL_SoftStretch() and SDL_BlitScaled() against a nearest neighbour reference.
+ */
+int
+surface_testSoftStretch(void *arg)
+{
+   const Uint32 formats[] = {
+      SDL_PIXELFORMAT_INDEX8, SDL_PIXELFORMAT_RGB565,
+      SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_ARGB8888
+   };
+   /* Source rect, destination rect: up, down and mixed scaling */
+   const SDL_Rect cases[][2] = {
+      { { 0, 0, 13, 11 }, { 3, 2, 29, 17 } },
+      { { 2, 1, 11, 9 }, { 0, 0, 5, 4 } },
+      { { 1, 3, 12, 7 }, { 4, 1, 20, 3 } },
+      { { 0, 0, 13, 11 }, { 1, 1, 7, 30 } },
+      { { 5, 4, 3, 2 }, { 0, 0, 31, 19 } }
+   };
+   /* Blits that stick out of the destination or its clip rectangle.  The
+      scale is 1.5, so the clipped source rectangle comes out exact. */
+   const struct {
+      SDL_Rect src;
+      SDL_Rect dst;
+      SDL_Rect clip;
+      SDL_Rect final_src;
+      SDL_Rect final_dst;
+   } clipped[] = {
+      { { 0, 0, 6, 6 }, { -3, -6, 9, 9 }, { 0, 0, 40, 36 }, { 2, 4, 4, 2 }, { 0, 0, 6, 3 } },
+      { { 0, 0, 6, 6 }, { 4, 4, 9, 9 }, { 0, 0, 10, 10 }, { 0, 0, 4, 4 }, { 4, 4, 6, 6 } },
+      { { 2, 2, 6, 6 }, { 30, 1, 9, 9 }, { 2, 3, 34, 30 }, { 2, 3, 4, 5 }, { 30, 3, 6, 7 } }
+   };
+   SDL_Surface *src, *dst;
+   Uint8 *expected;
+   Uint32 Rmask, Gmask, Bmask, Amask;
+   SDL_Rect srcrect, dstrect;
+   int i, c, y, bpp, ret, row;
+
+   for (i = 0; i < SDL_arraysize(formats); ++i) {
+      SDL_PixelFormatEnumToMasks(formats[i], &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+      src = SDL_CreateRGBSurface(0, 19, 17, bpp, Rmask, Gmask, Bmask, Amask);
+      dst = SDL_CreateRGBSurface(0, 40, 36, bpp, Rmask, Gmask, Bmask, Amask);
+      SDLTest_AssertCheck(src != NULL && dst != NULL, "Verify %s surfaces are not NULL", SDL_GetPixelFormatName(formats[i]));
+      if (src == NULL || dst == NULL) {
+         SDL_FreeSurface(src);
+         SDL_FreeSurface(dst);
+         return TEST_ABORTED;
+      }
+      if (dst->format->palette) {
+         SDL_SetSurfacePalette(dst, src->format->palette);
+      }
+      SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+      for (y = 0; y < src->h * src->pitch; ++y) {
+         ((Uint8 *)src->pixels)[y] = SDLTest_RandomUint8();
+      }
+      expected = (Uint8 *)SDL_malloc(dst->h * dst->pitch);
+      if (expected == NULL) {
+         SDL_FreeSurface(src);
+         SDL_FreeSurface(dst);
+         return TEST_ABORTED;
+      }
+
+      for (c = 0; c < SDL_arraysize(cases); ++c) {
+         SDL_memset(dst->pixels, 0x5A, dst->h * dst->pitch);
+         SDL_memcpy(expected, dst->pixels, dst->h * dst->pitch);
+         _stretchReference(src, &cases[c][0], expected, dst->pitch, &cases[c][1]);
+
+         srcrect = cases[c][0];
+         dstrect = cases[c][1];
+         ret = SDL_SoftStretch(src, &srcrect, dst, &dstrect);
+         row = _compareStretched(dst, expected);
+         SDLTest_AssertCheck(ret == 0 && row < 0, "Verify SDL_SoftStretch of %s case %i, result: %i, first bad row: %i", SDL_GetPixelFormatName(formats[i]), c, ret, row);
+
+         /* Indexed surfaces are scaled by the generic blitter instead */
+         if (bpp > 8) {
+            SDL_memset(dst->pixels, 0x5A, dst->h * dst->pitch);
+            ret = SDL_BlitScaled(src, &srcrect, dst, &dstrect);
+            row = _compareStretched(dst, expected);
+            SDLTest_AssertCheck(ret == 0 && row < 0, "Verify SDL_BlitScaled of %s case %i, result: %i, first bad row: %i", SDL_GetPixelFormatName(formats[i]), c, ret, row);
+         }
+      }
+
+      for (c = 0; bpp > 8 && c < SDL_arraysize(clipped); ++c) {
+         SDL_memset(dst->pixels, 0x5A, dst->h * dst->pitch);
+         SDL_memcpy(expected, dst->pixels, dst->h * dst->pitch);
+         _stretchReference(src, &clipped[c].final_src, expected, dst->pitch, &clipped[c].final_dst);
+
+         SDL_SetClipRect(dst, &clipped[c].clip);
+         srcrect = clipped[c].src;
+         dstrect = clipped[c].dst;
+         ret = SDL_BlitScaled(src, &srcrect, dst, &dstrect);
+         SDL_SetClipRect(dst, NULL);
+         row = _compareStretched(dst, expected);
+         SDLTest_AssertCheck(ret == 0 && row < 0, "Verify clipped SDL_BlitScaled of %s case %i, result: %i, first bad row: %i", SDL_GetPixelFormatName(formats[i]), c, ret, row);
+         SDLTest_AssertCheck(SDL_RectEquals(&dstrect, &clipped[c].final_dst),
+                             "Verify clipped destination, expected: %i,%i %ix%i, got: %i,%i %ix%i",
+                             clipped[c].final_dst.x, clipped[c].final_dst.y, clipped[c].final_dst.w, clipped[c].final_dst.h,
+                             dstrect.x, dstrect.y, dstrect.w, dstrect.h);
+      }
+
+      SDL_free(expected);
+      SDL_FreeSurface(src);
+      SDL_FreeSurface(dst);
+   }
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that blits split across worker threads match single threaded ones.
+ */
+int
+surface_testBlitThreads(void *arg)
+{
+   int ret, y;
+   SDL_Surface *source;
+   SDL_Surface *results[2] = { NULL, NULL };
+   SDL_Surface *scroll;
+   SDL_Rect rect;
+   const char *threads[] = { "0", "3" };
+   int i, wrong;
+
+   source = SDL_CreateRGBSurface(0, 1024, 768, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+   SDLTest_AssertCheck(source != NULL, "Verify source surface is not NULL");
+   if (source == NULL) {
+      return TEST_ABORTED;
+   }
+   for (y = 0; y < source->h; ++y) {
+      Uint32 *row = (Uint32 *)((Uint8 *)source->pixels + y * source->pitch);
+      int x;
+      for (x = 0; x < source->w; ++x) {
+         row[x] = (Uint32)(x * 2654435761u) ^ (Uint32)(y * 40503u);
+      }
+   }
+
+   for (i = 0; i < 2; ++i) {
+      SDL_SetHint(SDL_HINT_BLIT_THREADS, threads[i]);
+      SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_BLIT_THREADS, \"%s\")", threads[i]);
+
+      /* Conversion, then a large fill and a blended blit on top */
+      results[i] = SDL_ConvertSurfaceFormat(source, SDL_PIXELFORMAT_RGB565, 0);
+      SDLTest_AssertCheck(results[i] != NULL, "Verify converted surface is not NULL");
+      if (results[i] == NULL) {
+         break;
+      }
+      rect.x = 10;
+      rect.y = 20;
+      rect.w = 900;
+      rect.h = 600;
+      ret = SDL_FillRect(results[i], &rect, 0x1234);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRect, expected: 0, got: %i", ret);
+      SDL_SetSurfaceBlendMode(source, SDL_BLENDMODE_BLEND);
+      ret = SDL_BlitSurface(source, NULL, results[i], &rect);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+      SDL_SetSurfaceBlendMode(source, SDL_BLENDMODE_NONE);
+
+      /* Scroll a surface up by 24 rows onto itself */
+      scroll = SDL_CreateRGBSurface(0, 1024, 1024, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+      SDLTest_AssertCheck(scroll != NULL, "Verify scroll surface is not NULL");
+      if (scroll == NULL) {
+         continue;
+      }
+      for (y = 0; y < scroll->h; ++y) {
+         Uint32 *row = (Uint32 *)((Uint8 *)scroll->pixels + y * scroll->pitch);
+         int x;
+         for (x = 0; x < scroll->w; ++x) {
+            row[x] = ((Uint32)(x * 2654435761u) ^ (Uint32)(y * 40503u)) & 0x00FFFFFF;
+         }
+      }
+      rect.x = 0;
+      rect.y = 24;
+      rect.w = scroll->w;
+      rect.h = scroll->h - 24;
+      ret = SDL_BlitSurface(scroll, &rect, scroll, NULL);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+      wrong = 0;
+      for (y = 0; y < scroll->h - 24; ++y) {
+         const Uint32 *row = (const Uint32 *)((const Uint8 *)scroll->pixels + y * scroll->pitch);
+         int x;
+         for (x = 0; x < scroll->w; ++x) {
+            if (row[x] != (((Uint32)(x * 2654435761u) ^ (Uint32)((y + 24) * 40503u)) & 0x00FFFFFF)) {
+               ++wrong;
+               break;
+            }
+         }
+      }
+      SDLTest_AssertCheck(wrong == 0, "Verify scrolled rows with %s blit threads, expected: 0 wrong, got: %i", threads[i], wrong);
+      SDL_FreeSurface(scroll);
+   }
+   SDL_SetHint(SDL_HINT_BLIT_THREADS, "0");
+
+   if (results[0] != NULL && results[1] != NULL) {
+      ret = SDLTest_CompareSurfaces(results[1], results[0], 0);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+   }
+
+   SDL_FreeSurface(source);
+   SDL_FreeSurface(results[0]);
+   SDL_FreeSurface(results[1]);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests blitting one surface to several destinations in turn,
+ * with the source palette changing in between.
+ */
+int
+surface_testBlitAlternateDestinations(void *arg)
+{
+   int ret, i, round;
+   SDL_Surface *source;
+   SDL_Surface *targets[3] = { NULL, NULL, NULL };
+   const Uint32 formats[3] = { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_ARGB8888 };
+   SDL_Color color;
+   Uint32 Rmask, Gmask, Bmask, Amask, pixel;
+   int bpp;
+   Uint8 r, g, b;
+
+   source = SDL_CreateRGBSurface(0, 4, 4, 8, 0, 0, 0, 0);
+   SDLTest_AssertCheck(source != NULL, "Verify source surface is not NULL");
+   if (source == NULL) {
+      return TEST_ABORTED;
+   }
+   SDL_memset(source->pixels, 1, source->pitch * source->h);
+   for (i = 0; i < 3; ++i) {
+      SDL_PixelFormatEnumToMasks(formats[i], &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+      targets[i] = SDL_CreateRGBSurface(0, 4, 4, bpp, Rmask, Gmask, Bmask, Amask);
+      SDLTest_AssertCheck(targets[i] != NULL, "Verify target surface %d is not NULL", i);
+      if (targets[i] == NULL) {
+         goto done;
+      }
+   }
+
+   for (round = 0; round < 4; ++round) {
+      /* Change the source palette every other round */
+      color.r = (Uint8)(round * 64);
+      color.g = 0xFF;
+      color.b = (Uint8)(0xFF - round * 64);
+      color.a = 0xFF;
+      if ((round % 2) == 0) {
+         ret = SDL_SetPaletteColors(source->format->palette, &color, 1, 1);
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetPaletteColors, expected: 0, got: %i", ret);
+      } else {
+         color.r = (Uint8)((round - 1) * 64);
+         color.b = (Uint8)(0xFF - (round - 1) * 64);
+      }
+
+      for (i = 0; i < 3; ++i) {
+         ret = SDL_BlitSurface(source, NULL, targets[i], NULL);
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+         if (targets[i]->format->BytesPerPixel == 2) {
+            pixel = *(Uint16 *)targets[i]->pixels;
+         } else {
+            pixel = *(Uint32 *)targets[i]->pixels;
+         }
+         SDL_GetRGB(pixel, targets[i]->format, &r, &g, &b);
+         SDLTest_AssertCheck(SDL_abs(r - color.r) <= 8 && g == 0xFF && SDL_abs(b - color.b) <= 8,
+                             "Verify blitted color in round %d, target %d, expected: (%d,%d,%d), got: (%d,%d,%d)",
+                             round, i, color.r, color.g, color.b, r, g, b);
+      }
+   }
+
+done:
+   SDL_FreeSurface(source);
+   for (i = 0; i < 3; ++i) {
+      SDL_FreeSurface(targets[i]);
+   }
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests premultiplying surfaces and blitting them with the premultiplied blend mode.
+ */
+int
+surface_testPremultipliedAlpha(void *arg)
+{
+   int ret, i, x, maxdiff = 0;
+   SDL_Surface *source = NULL, *target = NULL;
+   SDL_BlendMode blendMode;
+   Uint32 *src, *dst, orig[37], bg[37];
+
+   source = SDL_CreateRGBSurface(0, 37, 1, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+   target = SDL_CreateRGBSurface(0, 37, 1, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+   SDLTest_AssertCheck(source != NULL && target != NULL, "Verify surfaces are not NULL");
+   if (source == NULL || target == NULL) {
+      goto done;
+   }
+
+   /* Include fully transparent and fully opaque pixels */
+   src = (Uint32 *)source->pixels;
+   dst = (Uint32 *)target->pixels;
+   for (i = 0; i < 37; ++i) {
+      orig[i] = src[i] = (Uint32)SDLTest_RandomUint32();
+      bg[i] = dst[i] = (Uint32)SDLTest_RandomUint32();
+   }
+   orig[0] = src[0] = 0;
+   orig[1] = src[1] |= 0xFF000000;
+
+   ret = SDL_PremultiplySurfaceAlpha(source);
+   SDLTest_AssertPass("Call to SDL_PremultiplySurfaceAlpha()");
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PremultiplySurfaceAlpha, expected: 0, got: %i", ret);
+   SDL_GetSurfaceBlendMode(source, &blendMode);
+   SDLTest_AssertCheck(blendMode == SDL_BLENDMODE_PREMULTIPLIED, "Verify blend mode, expected: %i, got: %i", SDL_BLENDMODE_PREMULTIPLIED, blendMode);
+   for (i = 0; i < 37; ++i) {
+      const Uint32 a = orig[i] >> 24;
+      Uint32 expected = a << 24;
+      for (x = 0; x < 24; x += 8) {
+         expected |= ((((orig[i] >> x) & 0xFF) * a + 127) / 255) << x;
+      }
+      SDLTest_AssertCheck(src[i] == expected, "Verify premultiplied pixel %d, expected: 0x%.8x, got: 0x%.8x", i, expected, src[i]);
+   }
+
+   ret = SDL_BlitSurface(source, NULL, target, NULL);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+   for (i = 0; i < 37; ++i) {
+      const Uint32 inva = 255 - (src[i] >> 24);
+      Uint32 expected = 0;
+      for (x = 0; x < 32; x += 8) {
+         Uint32 c = ((src[i] >> x) & 0xFF) + (((bg[i] >> x) & 0xFF) * inva + 127) / 255;
+         expected |= SDL_min(c, 255) << x;
+      }
+      SDLTest_AssertCheck(dst[i] == expected, "Verify blended pixel %d, expected: 0x%.8x, got: 0x%.8x", i, expected, dst[i]);
+   }
+
+   ret = SDL_UnpremultiplySurfaceAlpha(source);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_UnpremultiplySurfaceAlpha, expected: 0, got: %i", ret);
+   SDL_GetSurfaceBlendMode(source, &blendMode);
+   SDLTest_AssertCheck(blendMode == SDL_BLENDMODE_BLEND, "Verify blend mode, expected: %i, got: %i", SDL_BLENDMODE_BLEND, blendMode);
+   for (i = 0; i < 37; ++i) {
+      const Uint32 a = orig[i] >> 24;
+      if (a < 64) {
+         continue;
+      }
+      for (x = 0; x < 32; x += 8) {
+         maxdiff = SDL_max(maxdiff, SDL_abs((int)((src[i] >> x) & 0xFF) - (int)((orig[i] >> x) & 0xFF)));
+      }
+   }
+   SDLTest_AssertCheck(maxdiff <= 2, "Verify round trip for alpha >= 64, expected difference <= 2, got: %d", maxdiff);
+
+   ret = SDL_PremultiplyAlpha(1, 1, SDL_PIXELFORMAT_ARGB8888, orig, 4, SDL_PIXELFORMAT_RGB888, dst, 4);
+   SDLTest_AssertCheck(ret == -1, "Verify result from SDL_PremultiplyAlpha without alpha, expected: -1, got: %i", ret);
+
+done:
+   SDL_FreeSurface(source);
+   SDL_FreeSurface(target);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that batched fills match filling the rectangles one at a time.
+ */
+int
+surface_testFillRects(void *arg)
+{
+   const int bpps[4] = { 8, 16, 24, 32 };
+   SDL_Surface *batched, *single;
+   SDL_Rect rects[64];
+   int ret, i, k, round, count;
+   Uint32 color;
+
+   for (k = 0; k < SDL_arraysize(bpps); ++k) {
+      batched = SDL_CreateRGBSurface(0, 1000, 600, bpps[k], 0, 0, 0, 0);
+      single = SDL_CreateRGBSurface(0, 1000, 600, bpps[k], 0, 0, 0, 0);
+      SDLTest_AssertCheck(batched != NULL && single != NULL, "Verify %d bpp surfaces are not NULL", bpps[k]);
+      if (batched == NULL || single == NULL) {
+         SDL_FreeSurface(batched);
+         SDL_FreeSurface(single);
+         return TEST_ABORTED;
+      }
+
+      /* Small batches stay in the cache, the larger ones stream and get sorted */
+      for (round = 0; round < 8; ++round) {
+         count = SDLTest_RandomIntegerInRange(2, SDL_arraysize(rects));
+         color = (Uint32)SDLTest_RandomUint32();
+         for (i = 0; i < count; ++i) {
+            rects[i].x = SDLTest_RandomIntegerInRange(-50, 1000);
+            rects[i].y = SDLTest_RandomIntegerInRange(-50, 600);
+            rects[i].w = SDLTest_RandomIntegerInRange(0, (round < 4) ? 80 : 900);
+            rects[i].h = SDLTest_RandomIntegerInRange(0, (round < 4) ? 20 : 500);
+            ret = SDL_FillRect(single, &rects[i], color);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRect, expected: 0, got: %i", ret);
+         }
+         ret = SDL_FillRects(batched, rects, count, color);
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRects, expected: 0, got: %i", ret);
+         ret = SDL_memcmp(batched->pixels, single->pixels, single->pitch * single->h);
+         SDLTest_AssertCheck(ret == 0, "Verify %d bpp fill of %d rectangles in round %d matches", bpps[k], count, round);
+      }
+
+      SDL_FreeSurface(batched);
+      SDL_FreeSurface(single);
+   }
+
+   return TEST_COMPLETED;
+}
+
+/* A stream that isn't memory backed, counting the reads made on it */
+static int bmpReads;
+
+static Sint64 SDLCALL
+_countingSeek(SDL_RWops *context, Sint64 offset, int whence)
+{
+   return SDL_RWseek((SDL_RWops *)context->hidden.unknown.data1, offset, whence);
+}
+
+static size_t SDLCALL
+_countingRead(SDL_RWops *context, void *ptr, size_t size, size_t maxnum)
+{
+   ++bmpReads;
+   return SDL_RWread((SDL_RWops *)context->hidden.unknown.data1, ptr, size, maxnum);
+}
+
+static SDL_Surface *
+_loadBMPBothWays(Uint8 *data, int size, const char *what)
+{
+   SDL_RWops *mem, *rw;
+   SDL_Surface *mapped, *streamed;
+   int y;
+
+   mapped = SDL_LoadBMP_RW(SDL_RWFromConstMem(data, size), 1);
+   SDLTest_AssertCheck(mapped != NULL, "Verify %s loads from memory", what);
+
+   mem = SDL_RWFromConstMem(data, size);
+   rw = SDL_AllocRW();
+   rw->seek = _countingSeek;
+   rw->read = _countingRead;
+   rw->hidden.unknown.data1 = mem;
+   bmpReads = 0;
+   streamed = SDL_LoadBMP_RW(rw, 0);
+   SDLTest_AssertCheck(streamed != NULL, "Verify %s loads from a stream", what);
+   SDLTest_AssertCheck(bmpReads < 32, "Verify %s stream is read in bulk, got %d reads", what, bmpReads);
+   SDL_RWclose(mem);
+   SDL_FreeRW(rw);
+
+   if (mapped != NULL && streamed != NULL) {
+      for (y = 0; y < mapped->h; ++y) {
+         if (SDL_memcmp((Uint8 *)mapped->pixels + y * mapped->pitch,
+                        (Uint8 *)streamed->pixels + y * streamed->pitch,
+                        mapped->w * mapped->format->BytesPerPixel) != 0) {
+            break;
+         }
+      }
+      SDLTest_AssertCheck(y == mapped->h, "Verify %s loads the same both ways", what);
+   }
+   SDL_FreeSurface(streamed);
+   return mapped;
+}
+
+/**
+ * @brief Tests saving and loading bitmaps in every depth through memory streams.
+ */
+int
+surface_testBMPRoundTrip(void *arg)
+{
+   /* 4x3 4 bpp and 10x2 1 bpp bottom-up images, with two palette entries each */
+   static Uint8 bmp4[] = {
+      'B', 'M', 0x4A, 0, 0, 0, 0, 0, 0, 0, 0x3E, 0, 0, 0,
+      40, 0, 0, 0, 4, 0, 0, 0, 3, 0, 0, 0, 1, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0,
+      0x10, 0x20, 0x30, 0, 0x40, 0x50, 0x60, 0,
+      0x01, 0x10, 0, 0, 0x11, 0x00, 0, 0, 0x00, 0x01, 0, 0
+   };
+   static Uint8 bmp1[] = {
+      'B', 'M', 0x44, 0, 0, 0, 0, 0, 0, 0, 0x3E, 0, 0, 0,
+      40, 0, 0, 0, 10, 0, 0, 0, 2, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0xFF, 0xFF, 0xFF, 0,
+      0xA5, 0x80, 0, 0, 0x0F, 0x40
+   };
+   static const Uint8 expect4[3][4] = { { 0, 0, 0, 1 }, { 1, 1, 0, 0 }, { 0, 1, 1, 0 } };
+   static const Uint8 expect1[2][10] = { { 0, 0, 0, 0, 1, 1, 1, 1, 0, 1 }, { 1, 0, 1, 0, 0, 1, 0, 1, 1, 0 } };
+   const int bpps[3] = { 8, 24, 32 };
+   Uint8 *file;
+   const int filesize = 64 * 1024;
+   SDL_Surface *face, *rface;
+   SDL_RWops *rw;
+   int ret, i, k, x, y, written;
+
+   file = (Uint8 *)SDL_malloc(filesize);
+   SDLTest_AssertCheck(file != NULL, "Verify file buffer is not NULL");
+   if (file == NULL) return TEST_ABORTED;
+
+   for (k = 0; k < SDL_arraysize(bpps); ++k) {
+      /* Odd width so the rows are padded in the file */
+      if (bpps[k] == 32) {
+         face = SDL_CreateRGBSurface(0, 37, 23, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+      } else if (bpps[k] == 24) {
+         face = SDL_CreateRGBSurface(0, 37, 23, 24, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+      } else {
+         face = SDL_CreateRGBSurface(0, 37, 23, 8, 0, 0, 0, 0);
+      }
+      SDLTest_AssertCheck(face != NULL, "Verify %d bpp surface is not NULL", bpps[k]);
+      if (face == NULL) continue;
+      for (y = 0; y < face->h; ++y) {
+         for (x = 0; x < face->w * face->format->BytesPerPixel; ++x) {
+            ((Uint8 *)face->pixels)[y * face->pitch + x] = (Uint8)SDLTest_RandomIntegerInRange(1, 255);
+         }
+      }
+      if (face->format->palette) {
+         for (i = 0; i < face->format->palette->ncolors; ++i) {
+            face->format->palette->colors[i].r = (Uint8)SDLTest_RandomUint8();
+            face->format->palette->colors[i].g = (Uint8)SDLTest_RandomUint8();
+            face->format->palette->colors[i].b = (Uint8)SDLTest_RandomUint8();
+         }
+      }
+
+      rw = SDL_RWFromMem(file, filesize);
+      ret = SDL_SaveBMP_RW(face, rw, 0);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SaveBMP_RW, expected: 0, got: %i", ret);
+      written = (int)SDL_RWtell(rw);
+      SDL_RWclose(rw);
+      x = file[2] | (file[3] << 8) | (file[4] << 16) | (file[5] << 24);
+      SDLTest_AssertCheck(x == written, "Verify BMP file size, expected: %i, got: %i", written, x);
+
+      rface = _loadBMPBothWays(file, written, "saved bitmap");
+      if (rface != NULL) {
+         SDLTest_AssertCheck(rface->format->format == face->format->format, "Verify format of loaded surface, expected: %s, got: %s",
+                             SDL_GetPixelFormatName(face->format->format), SDL_GetPixelFormatName(rface->format->format));
+         for (y = 0; y < face->h; ++y) {
+            if (SDL_memcmp((Uint8 *)face->pixels + y * face->pitch, (Uint8 *)rface->pixels + y * rface->pitch,
+                           face->w * face->format->BytesPerPixel) != 0) {
+               break;
+            }
+         }
+         SDLTest_AssertCheck(y == face->h, "Verify %d bpp pixels survive the round trip, first bad row: %i", bpps[k], y);
+         if (face->format->palette) {
+            for (i = 0; i < face->format->palette->ncolors; ++i) {
+               const SDL_Color *a = &face->format->palette->colors[i];
+               const SDL_Color *b = &rface->format->palette->colors[i];
+               if (a->r != b->r || a->g != b->g || a->b != b->b) {
+                  break;
+               }
+            }
+            SDLTest_AssertCheck(i == face->format->palette->ncolors, "Verify palette survives the round trip, first bad entry: %i", i);
+         }
+         SDL_FreeSurface(rface);
+      }
+      SDL_FreeSurface(face);
+   }
+
+   rface = _loadBMPBothWays(bmp4, sizeof(bmp4), "4 bpp bitmap");
+   if (rface != NULL) {
+      for (y = 0; y < 3; ++y) {
+         if (SDL_memcmp((Uint8 *)rface->pixels + y * rface->pitch, expect4[y], 4) != 0) {
+            break;
+         }
+      }
+      SDLTest_AssertCheck(y == 3, "Verify 4 bpp pixels, first bad row: %i", y);
+      SDLTest_AssertCheck(rface->format->palette->colors[1].r == 0x60, "Verify 4 bpp palette, expected: 0x60, got: 0x%.2x", rface->format->palette->colors[1].r);
+      SDL_FreeSurface(rface);
+   }
+
+   /* The padding after the last row may be missing */
+   rface = _loadBMPBothWays(bmp1, sizeof(bmp1), "1 bpp bitmap");
+   if (rface != NULL) {
+      for (y = 0; y < 2; ++y) {
+         if (SDL_memcmp((Uint8 *)rface->pixels + y * rface->pitch, expect1[y], 10) != 0) {
+            break;
+         }
+      }
+      SDLTest_AssertCheck(y == 2, "Verify 1 bpp pixels, first bad row: %i", y);
+      SDL_FreeSurface(rface);
+   }
+
+   /* Truncated pixel data fails */
+   rface = SDL_LoadBMP_RW(SDL_RWFromConstMem(bmp1, sizeof(bmp1) - 1), 1);
+   SDLTest_AssertCheck(rface == NULL, "Verify truncated bitmap fails to load");
+   SDL_FreeSurface(rface);
+
+   SDL_free(file);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests aligned pixel allocation, surface pools and copies between aligned surfaces.
+ */
+int
+surface_testAlignedAndPooled(void *arg)
+{
+   SDL_SurfacePool *pool;
+   SDL_Surface *face, *other, *src, *dst;
+   Uint8 *buffer;
+   void *pixels;
+   int i, x, y, ret, offset;
+
+   /* Other surfaces keep plain heap pixels, which can be freed or replaced */
+   face = SDL_CreateRGBSurface(0, 33, 7, 24, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+   SDLTest_AssertCheck(face != NULL, "Verify surface is not NULL");
+   if (face == NULL) return TEST_ABORTED;
+   SDLTest_AssertCheck(face->pitch == 100, "Verify pitch, expected: 100, got: %i", face->pitch);
+   SDL_free(face->pixels);
+   face->pixels = SDL_malloc(face->h * face->pitch);
+   SDLTest_AssertCheck(face->pixels != NULL, "Verify replacement pixels were allocated");
+   SDL_FreeSurface(face);
+   SDLTest_AssertPass("Call to SDL_FreeSurface() with replaced pixels");
+
+   /* SDL_SIMD_ALIGNED surfaces are aligned and have padded rows */
+   face = SDL_CreateRGBSurface(SDL_SIMD_ALIGNED, 33, 7, 24, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+   SDLTest_AssertCheck(face != NULL, "Verify aligned surface is not NULL");
+   if (face == NULL) return TEST_ABORTED;
+   SDLTest_AssertCheck(((uintptr_t)face->pixels & (SDL_SURFACE_ALIGNMENT - 1)) == 0, "Verify pixels are aligned");
+   SDLTest_AssertCheck(face->pitch == 128, "Verify padded pitch, expected: 128, got: %i", face->pitch);
+   SDLTest_AssertCheck((face->flags & SDL_SIMD_ALIGNED) != 0, "Verify SDL_SIMD_ALIGNED flag is set");
+   SDL_FreeSurface(face);
+
+   /* Freed pixels are recycled for the same size class, and cleared */
+   pool = SDL_CreateSurfacePool(0);
+   SDLTest_AssertCheck(pool != NULL, "Verify pool is not NULL");
+   if (pool == NULL) return TEST_ABORTED;
+   face = SDL_CreateRGBSurfaceFromPool(pool, 0, 64, 64, 32, 0, 0, 0, 0);
+   SDLTest_AssertCheck(face != NULL, "Verify pooled surface is not NULL");
+   if (face == NULL) return TEST_ABORTED;
+   SDL_memset(face->pixels, 0xAA, face->pitch * face->h);
+   pixels = face->pixels;
+   SDL_FreeSurface(face);
+
+   face = SDL_CreateRGBSurfaceFromPool(pool, 0, 62, 64, 32, 0, 0, 0, 0);
+   SDLTest_AssertCheck(face != NULL, "Verify pooled surface is not NULL");
+   if (face == NULL) return TEST_ABORTED;
+   SDLTest_AssertCheck(face->pixels == pixels, "Verify pixels are recycled");
+   for (i = 0; i < face->pitch * face->h; ++i) {
+      if (((Uint8 *)face->pixels)[i] != 0) {
+         break;
+      }
+   }
+   SDLTest_AssertCheck(i == face->pitch * face->h, "Verify recycled pixels are cleared, first nonzero byte: %i", i);
+
+   other = SDL_CreateRGBSurfaceFromPool(pool, 0, 256, 256, 32, 0, 0, 0, 0);
+   SDLTest_AssertCheck(other != NULL && other->pixels != pixels, "Verify a larger surface gets other pixels");
+   SDL_FreeSurface(other);
+
+   /* Surfaces outlive their pool */
+   SDL_FreeSurfacePool(pool);
+   SDL_memset(face->pixels, 0x55, face->pitch * face->h);
+   SDL_FreeSurface(face);
+
+   /* A pool with a size limit doesn't keep what doesn't fit */
+   pool = SDL_CreateSurfacePool(1024);
+   SDLTest_AssertCheck(pool != NULL, "Verify limited pool is not NULL");
+   if (pool == NULL) return TEST_ABORTED;
+   face = SDL_CreateRGBSurfaceFromPool(pool, 0, 64, 64, 32, 0, 0, 0, 0);
+   other = SDL_CreateRGBSurfaceFromPool(pool, 0, 8, 8, 32, 0, 0, 0, 0);
+   SDLTest_AssertCheck(face != NULL && other != NULL, "Verify limited pool surfaces are not NULL");
+   SDL_FreeSurface(face);
+   pixels = other->pixels;
+   SDL_FreeSurface(other);
+   other = SDL_CreateRGBSurfaceFromPool(pool, 0, 8, 8, 32, 0, 0, 0, 0);
+   SDLTest_AssertCheck(other != NULL && other->pixels == pixels, "Verify small pixels are recycled");
+   SDL_FreeSurface(other);
+   SDL_FreeSurfacePool(pool);
+
+   /* Copies from aligned, unaligned and unpadded sources */
+   buffer = (Uint8 *)SDL_malloc(101 * 40 * 4 + 4);
+   SDLTest_AssertCheck(buffer != NULL, "Verify buffer is not NULL");
+   if (buffer == NULL) return TEST_ABORTED;
+   for (i = 0; i < 101 * 40 * 4 + 4; ++i) {
+      buffer[i] = (Uint8)SDLTest_RandomUint8();
+   }
+   for (offset = 0; offset < 8; offset += 4) {
+      for (i = 0; i < 2; ++i) {
+         const int w = i ? 100 : 101;
+         src = SDL_CreateRGBSurfaceFrom(buffer + offset, w, 40, 32, w * 4, 0, 0, 0, 0);
+         dst = SDL_CreateRGBSurface(i ? 0 : SDL_SIMD_ALIGNED, w, 40, 32, 0, 0, 0, 0);
+         SDLTest_AssertCheck(src != NULL && dst != NULL, "Verify copy surfaces are not NULL");
+         if (src == NULL || dst == NULL) {
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+            continue;
+         }
+         ret = SDL_BlitSurface(src, NULL, dst, NULL);
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+         for (y = 0; y < dst->h; ++y) {
+            for (x = 0; x < dst->w * 4; ++x) {
+               if (((Uint8 *)dst->pixels)[y * dst->pitch + x] != ((Uint8 *)src->pixels)[y * src->pitch + x]) {
+                  break;
+               }
+            }
+            if (x < dst->w * 4) {
+               break;
+            }
+         }
+         SDLTest_AssertCheck(y == dst->h, "Verify %i wide copy from offset %i, first bad row: %i", w, offset, y);
+         SDL_FreeSurface(src);
+         SDL_FreeSurface(dst);
+      }
+   }
+   SDL_free(buffer);
+
+   return TEST_COMPLETED;
+}
+
+/* Fills a surface with runs of transparent, opaque and translucent pixels */
+static void
+_fillRLESource(SDL_Surface *surface, int y0, int y1)
+{
+   int x, y;
+   for (y = y0; y < y1; ++y) {
+      Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+      for (x = 0; x < surface->w; ++x) {
+         Uint32 alpha;
+         switch ((x / 5 + y / 3 + SDLTest_RandomIntegerInRange(0, 1)) % 3) {
+         case 0: alpha = 0; break;
+         case 1: alpha = 255; break;
+         default: alpha = SDLTest_RandomIntegerInRange(1, 254); break;
+         }
+         row[x] = (SDLTest_RandomUint32() & 0x00FFFFFF) | (alpha << 24);
+         if (!surface->format->Amask && alpha == 0) {
+            row[x] = 0x00123456;
+         }
+      }
+   }
+}
+
+/* Copies the pixels by hand, blitting would drop the RLE encoding */
+static SDL_Surface *
+_copyRLESource(SDL_Surface *src, int alpha, int rle)
+{
+   SDL_Surface *copy;
+   int y;
+
+   copy = SDL_CreateRGBSurface(0, src->w, src->h, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, alpha ? 0xFF000000 : 0);
+   SDLTest_AssertCheck(copy != NULL, "Verify copied surface is not NULL");
+   if (copy == NULL) return NULL;
+   for (y = 0; y < src->h; ++y) {
+      SDL_memcpy((Uint8 *)copy->pixels + y * copy->pitch, (Uint8 *)src->pixels + y * src->pitch, src->w * 4);
+   }
+   if (alpha) {
+      SDL_SetSurfaceBlendMode(copy, SDL_BLENDMODE_BLEND);
+   } else {
+      SDL_SetColorKey(copy, SDL_TRUE, 0x00123456);
+   }
+   SDL_SetSurfaceRLE(copy, rle);
+   return copy;
+}
+
+static int
+_compareRLEBlits(SDL_Surface *rle, SDL_Surface *plain, SDL_Surface *background)
+{
+   SDL_Surface *a, *b;
+   SDL_Rect rect;
+   int ret, x, y, differ = 0;
+
+   a = SDL_ConvertSurface(background, background->format, 0);
+   b = SDL_ConvertSurface(background, background->format, 0);
+   SDLTest_AssertCheck(a != NULL && b != NULL, "Verify destination surfaces are not NULL");
+   if (a == NULL || b == NULL) {
+      SDL_FreeSurface(a);
+      SDL_FreeSurface(b);
+      return -1;
+   }
+   rect.x = 3;
+   rect.y = 2;
+   ret = SDL_BlitSurface(rle, NULL, a, &rect);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck((rle->flags & SDL_RLEACCEL) != 0, "Verify surface is RLE accelerated");
+   rect.x = 3;
+   rect.y = 2;
+   ret = SDL_BlitSurface(plain, NULL, b, &rect);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+   for (y = 0; y < a->h; ++y) {
+      const Uint32 *rowa = (const Uint32 *)((Uint8 *)a->pixels + y * a->pitch);
+      const Uint32 *rowb = (const Uint32 *)((Uint8 *)b->pixels + y * b->pitch);
+      for (x = 0; x < a->w; ++x) {
+         if ((rowa[x] ^ rowb[x]) & 0x00FFFFFF) {
+            differ = 1;
+         }
+      }
+   }
+   SDL_FreeSurface(a);
+   SDL_FreeSurface(b);
+   return differ;
+}
+
+/**
+ * @brief Tests that RLE surfaces pick up changes made while locked
+ */
+int
+surface_testRLELockUnlock(void *arg)
+{
+   SDL_Surface *background, *src, *fresh;
+   int pass, ret;
+
+   background = SDL_CreateRGBSurface(0, 80, 60, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+   SDLTest_AssertCheck(background != NULL, "Verify background surface is not NULL");
+   if (background == NULL) return TEST_ABORTED;
+   SDL_FillRect(background, NULL, 0x00406080);
+
+   for (pass = 0; pass < 2; ++pass) {
+      src = SDL_CreateRGBSurface(0, 70, 50, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, pass ? 0xFF000000 : 0);
+      SDLTest_AssertCheck(src != NULL, "Verify source surface is not NULL");
+      if (src == NULL) break;
+      _fillRLESource(src, 0, src->h);
+      if (pass) {
+         SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND);
+      } else {
+         SDL_SetColorKey(src, SDL_TRUE, 0x00123456);
+      }
+      SDL_SetSurfaceRLE(src, 1);
+      fresh = _copyRLESource(src, pass, pass);
+      if (fresh == NULL) {
+         SDL_FreeSurface(src);
+         break;
+      }
+      ret = _compareRLEBlits(src, fresh, background);
+      SDLTest_AssertCheck(ret == 0, "Verify RLE blit matches, pass %i", pass);
+      SDL_FreeSurface(fresh);
+
+      /* Change a few lines through a lock, and some through SDL_FillRect() */
+      ret = SDL_LockSurface(src);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_LockSurface, expected: 0, got: %i", ret);
+      _fillRLESource(src, 10, 14);
+      _fillRLESource(src, src->h - 3, src->h);
+      SDL_UnlockSurface(src);
+      SDL_LockSurface(src);
+      _fillRLESource(src, 0, 1);
+      SDL_UnlockSurface(src);
+      {
+         SDL_Rect rect = { 20, 30, 8, 4 };
+         ret = SDL_FillRect(src, &rect, pass ? 0x80FF0000 : 0x00123456);
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRect, expected: 0, got: %i", ret);
+      }
+
+      /* Colorkey blits give the same result with or without RLE, pixel
+         alpha is compared against a surface encoded from scratch */
+      fresh = _copyRLESource(src, pass, pass);
+      if (fresh == NULL) {
+         SDL_FreeSurface(src);
+         break;
+      }
+      ret = _compareRLEBlits(src, fresh, background);
+      SDLTest_AssertCheck(ret == 0, "Verify RLE blit matches after changes, pass %i", pass);
+      SDL_FreeSurface(fresh);
+      SDL_FreeSurface(src);
+   }
+
+   /* Translucent pixels are blended onto targets without an alpha channel */
+   src = SDL_CreateRGBSurface(0, 4, 1, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+   if (src != NULL) {
+      Uint32 pixel;
+      SDL_FillRect(src, NULL, 0x80FFFFFF);
+      SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND);
+      SDL_SetSurfaceRLE(src, 1);
+      SDL_FillRect(background, NULL, 0);
+      SDL_BlitSurface(src, NULL, background, NULL);
+      SDLTest_AssertCheck((src->flags & SDL_RLEACCEL) != 0, "Verify surface is RLE accelerated");
+      pixel = *(Uint32 *)background->pixels & 0xFF;
+      SDLTest_AssertCheck(pixel >= 0x7F && pixel <= 0x80, "Verify translucent pixel is blended, expected: 0x7f or 0x80, got: 0x%.2x", pixel);
+      SDL_FreeSurface(src);
+   }
+   SDL_FreeSurface(background);
+
+   return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Surface test cases */
@@ -630,11 +1620,40 @@ static const SDLTest_TestCaseReference surfaceTest11 =
 static const SDLTest_TestCaseReference surfaceTest12 =
         { (SDLTest_TestCaseFp)surface_testBlitBlendMod, "surface_testBlitBlendMod", "Tests blitting routines with mod blending mode.", TEST_ENABLED};
 
+static const SDLTest_TestCaseReference surfaceTest13 =
+        { (SDLTest_TestCaseFp)surface_testBlitScaledLinear, "surface_testBlitScaledLinear", "Tests scaled blitting with linear filtering.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest14 =
+        { (SDLTest_TestCaseFp)surface_testSoftStretch, "surface_testSoftStretch", "Tests stretched blits against a nearest neighbour reference.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest15 =
+        { (SDLTest_TestCaseFp)surface_testBlitThreads, "surface_testBlitThreads", "Tests blits split across worker threads.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest16 =
+        { (SDLTest_TestCaseFp)surface_testBlitAlternateDestinations, "surface_testBlitAlternateDestinations", "Tests blitting one surface to several destinations in turn.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest17 =
+        { (SDLTest_TestCaseFp)surface_testPremultipliedAlpha, "surface_testPremultipliedAlpha", "Tests premultiplied alpha conversion and blending.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest18 =
+        { (SDLTest_TestCaseFp)surface_testFillRects, "surface_testFillRects", "Tests batched rectangle fills.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest19 =
+        { (SDLTest_TestCaseFp)surface_testBMPRoundTrip, "surface_testBMPRoundTrip", "Tests saving and loading bitmaps through memory streams.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest20 =
+        { (SDLTest_TestCaseFp)surface_testAlignedAndPooled, "surface_testAlignedAndPooled", "Tests aligned pixel allocation and surface pools.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest21 =
+        { (SDLTest_TestCaseFp)surface_testRLELockUnlock, "surface_testRLELockUnlock", "Tests that RLE surfaces pick up changes made while locked.", TEST_ENABLED};
+
 /* Sequence of Surface test cases */
 static const SDLTest_TestCaseReference *surfaceTests[] =  {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTest13, &surfaceTest14, &surfaceTest15,
+    &surfaceTest16, &surfaceTest17, &surfaceTest18, &surfaceTest19, &surfaceTest20,
+    &surfaceTest21, NULL
 };
 
 /* Surface test suite (global) */
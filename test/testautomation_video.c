@@ -16,6 +16,7 @@
 #endif
 
 #include "SDL.h"
+#include "SDL_shape.h"
 #include "SDL_test.h"
 
 /* Private helpers */
@@ -1720,6 +1721,172 @@ video_getSetWindowData(void *arg)
   return returnValue;
 }
 
+/* Helper: set a window shape and check that the mode reads back unchanged */
+void _setAndCheckWindowShape(SDL_Window *window, SDL_Surface *shape, SDL_WindowShapeMode *mode, const char *description)
+{
+  SDL_WindowShapeMode result;
+  int returnValue;
+
+  returnValue = SDL_SetWindowShape(window, shape, mode);
+  SDLTest_AssertPass("Call to SDL_SetWindowShape(%s)", description);
+  SDLTest_AssertCheck(returnValue == 0, "Validate result value; expected: 0, got: %d", returnValue);
+
+  SDL_memset(&result, 0, sizeof(result));
+  returnValue = SDL_GetShapedWindowMode(window, &result);
+  SDLTest_AssertPass("Call to SDL_GetShapedWindowMode()");
+  SDLTest_AssertCheck(returnValue == 0, "Validate result value; expected: 0, got: %d", returnValue);
+  SDLTest_AssertCheck(result.mode == mode->mode, "Validate mode; expected: %d, got: %d", mode->mode, result.mode);
+  if (mode->mode == ShapeModeColorKey) {
+    SDLTest_AssertCheck(SDL_memcmp(&result.parameters.colorKey, &mode->parameters.colorKey, sizeof(SDL_Color)) == 0, "Validate color key");
+  } else {
+    SDLTest_AssertCheck(result.parameters.binarizationCutoff == mode->parameters.binarizationCutoff,
+      "Validate binarization cutoff; expected: %d, got: %d", mode->parameters.binarizationCutoff, result.parameters.binarizationCutoff);
+  }
+}
+
+/**
+ * @brief Tests shaped windows with alpha and color key shapes in several formats
+ *
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_CreateShapedWindow
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_SetWindowShape
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_GetShapedWindowMode
+ */
+int
+video_getSetWindowShape(void *arg)
+{
+  const char* title = "video_getSetWindowShape Test Window";
+  const int w = 67, h = 41;
+  SDL_Window* window;
+  SDL_Surface* shape;
+  SDL_WindowShapeMode mode;
+  SDL_Color colors[4] = { { 255, 0, 0, 255 }, { 0, 255, 0, 255 }, { 0, 0, 255, 255 }, { 255, 255, 255, 255 } };
+  SDL_Rect rect;
+  Uint32 *pixels;
+  Uint8 *indices;
+  int returnValue;
+  int x, y, dx, dy;
+
+  /* Plain windows can't be shaped */
+  window = _createVideoSuiteTestWindow(title);
+  if (window == NULL) return TEST_ABORTED;
+  shape = SDL_CreateRGBSurface(0, w, h, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+  SDLTest_AssertCheck(shape != NULL, "Validate that returned surface is not NULL");
+  if (shape == NULL) {
+    _destroyVideoSuiteTestWindow(window);
+    return TEST_ABORTED;
+  }
+  SDL_memset(&mode, 0, sizeof(mode));
+  mode.mode = ShapeModeDefault;
+  mode.parameters.binarizationCutoff = 1;
+
+  SDLTest_AssertCheck(SDL_IsShapedWindow(window) == SDL_FALSE, "Validate that a plain window is not shaped");
+  returnValue = SDL_SetWindowShape(window, shape, &mode);
+  SDLTest_AssertPass("Call to SDL_SetWindowShape(plain window)");
+  SDLTest_AssertCheck(returnValue == SDL_NONSHAPEABLE_WINDOW, "Validate result value; expected: %d, got: %d", SDL_NONSHAPEABLE_WINDOW, returnValue);
+  returnValue = SDL_GetShapedWindowMode(window, &mode);
+  SDLTest_AssertPass("Call to SDL_GetShapedWindowMode(plain window)");
+  SDLTest_AssertCheck(returnValue == SDL_NONSHAPEABLE_WINDOW, "Validate result value; expected: %d, got: %d", SDL_NONSHAPEABLE_WINDOW, returnValue);
+  returnValue = SDL_SetWindowShape(NULL, shape, &mode);
+  SDLTest_AssertPass("Call to SDL_SetWindowShape(window=NULL)");
+  SDLTest_AssertCheck(returnValue == SDL_NONSHAPEABLE_WINDOW, "Validate result value; expected: %d, got: %d", SDL_NONSHAPEABLE_WINDOW, returnValue);
+  _destroyVideoSuiteTestWindow(window);
+
+  window = SDL_CreateShapedWindow(title, 10, 10, w, h, 0);
+  SDLTest_AssertPass("Call to SDL_CreateShapedWindow('Title',10,10,%d,%d,0)", w, h);
+  if (window == NULL) {
+    SDLTest_Log("Shaped windows are not supported by this video driver: %s", SDL_GetError());
+    SDL_FreeSurface(shape);
+    return TEST_SKIPPED;
+  }
+  SDLTest_AssertCheck(SDL_IsShapedWindow(window) == SDL_TRUE, "Validate that the window is shaped");
+  returnValue = SDL_GetShapedWindowMode(window, NULL);
+  SDLTest_AssertPass("Call to SDL_GetShapedWindowMode(shape_mode=NULL)");
+  SDLTest_AssertCheck(returnValue == SDL_WINDOW_LACKS_SHAPE, "Validate result value; expected: %d, got: %d", SDL_WINDOW_LACKS_SHAPE, returnValue);
+  returnValue = SDL_SetWindowShape(window, NULL, &mode);
+  SDLTest_AssertPass("Call to SDL_SetWindowShape(shape=NULL)");
+  SDLTest_AssertCheck(returnValue == SDL_INVALID_SHAPE_ARGUMENT, "Validate result value; expected: %d, got: %d", SDL_INVALID_SHAPE_ARGUMENT, returnValue);
+
+  /* An ellipse with a soft edge, so rows have runs of every length and
+     the alpha modes disagree about the edge pixels */
+  for (y = 0; y < h; y++) {
+    pixels = (Uint32 *)((Uint8 *)shape->pixels + y * shape->pitch);
+    for (x = 0; x < w; x++) {
+      dx = (2 * x - w) * h;
+      dy = (2 * y - h) * w;
+      if (dx * dx + dy * dy < (w * h) * (w * h) * 2 / 3) {
+        pixels[x] = 0xFF204060;
+      } else if (dx * dx + dy * dy < (w * h) * (w * h)) {
+        pixels[x] = 0x80204060;
+      } else {
+        pixels[x] = 0x00204060;
+      }
+    }
+  }
+  _setAndCheckWindowShape(window, shape, &mode, "ShapeModeDefault");
+  returnValue = SDL_GetShapedWindowMode(window, NULL);
+  SDLTest_AssertPass("Call to SDL_GetShapedWindowMode(shape_mode=NULL)");
+  SDLTest_AssertCheck(returnValue == 0, "Validate result value; expected: 0, got: %d", returnValue);
+
+  /* The same shape again, then one that differs in a few pixels */
+  _setAndCheckWindowShape(window, shape, &mode, "ShapeModeDefault, unchanged");
+  rect.x = 3; rect.y = 5; rect.w = 9; rect.h = 4;
+  SDL_FillRect(shape, &rect, 0xFF000000);
+  rect.x = w / 2; rect.y = h / 2; rect.w = 5; rect.h = 7;
+  SDL_FillRect(shape, &rect, 0x00000000);
+  _setAndCheckWindowShape(window, shape, &mode, "ShapeModeDefault, changed");
+
+  mode.mode = ShapeModeBinarizeAlpha;
+  mode.parameters.binarizationCutoff = 0x90;
+  _setAndCheckWindowShape(window, shape, &mode, "ShapeModeBinarizeAlpha");
+  mode.mode = ShapeModeReverseBinarizeAlpha;
+  _setAndCheckWindowShape(window, shape, &mode, "ShapeModeReverseBinarizeAlpha");
+
+  /* Entirely transparent and entirely opaque */
+  mode.mode = ShapeModeDefault;
+  mode.parameters.binarizationCutoff = 1;
+  SDL_FillRect(shape, NULL, 0x00FFFFFF);
+  _setAndCheckWindowShape(window, shape, &mode, "ShapeModeDefault, transparent");
+  SDL_FillRect(shape, NULL, 0xFFFFFFFF);
+  _setAndCheckWindowShape(window, shape, &mode, "ShapeModeDefault, opaque");
+
+  /* Color key on an RGB surface */
+  mode.mode = ShapeModeColorKey;
+  mode.parameters.colorKey = colors[0];
+  SDL_FreeSurface(shape);
+  shape = SDL_CreateRGBSurface(0, w, h, 16, 0xF800, 0x07E0, 0x001F, 0);
+  SDLTest_AssertCheck(shape != NULL, "Validate that returned surface is not NULL");
+  if (shape != NULL) {
+    SDL_FillRect(shape, NULL, SDL_MapRGB(shape->format, 255, 0, 0));
+    rect.x = 1; rect.y = 2; rect.w = w - 7; rect.h = h / 2;
+    SDL_FillRect(shape, &rect, SDL_MapRGB(shape->format, 0, 0, 255));
+    _setAndCheckWindowShape(window, shape, &mode, "ShapeModeColorKey, RGB565");
+    SDL_FreeSurface(shape);
+  }
+
+  /* Color key on a palettized surface */
+  shape = SDL_CreateRGBSurface(0, w, h, 8, 0, 0, 0, 0);
+  SDLTest_AssertCheck(shape != NULL, "Validate that returned surface is not NULL");
+  if (shape != NULL) {
+    SDL_SetPaletteColors(shape->format->palette, colors, 0, SDL_arraysize(colors));
+    for (y = 0; y < h; y++) {
+      indices = (Uint8 *)shape->pixels + y * shape->pitch;
+      for (x = 0; x < w; x++) {
+        indices[x] = ((x / 3) ^ (y / 2)) & 3;
+      }
+    }
+    _setAndCheckWindowShape(window, shape, &mode, "ShapeModeColorKey, INDEX8");
+    mode.mode = ShapeModeDefault;
+    mode.parameters.binarizationCutoff = 1;
+    _setAndCheckWindowShape(window, shape, &mode, "ShapeModeDefault, INDEX8");
+    SDL_FreeSurface(shape);
+  }
+
+  SDL_DestroyWindow(window);
+  SDLTest_AssertPass("Call to SDL_DestroyWindow()");
+
+  return TEST_COMPLETED;
+}
+
 
 /* ================= Test References ================== */
 
@@ -1793,13 +1960,16 @@ static const SDLTest_TestCaseReference videoTest22 =
 static const SDLTest_TestCaseReference videoTest23 =
         { (SDLTest_TestCaseFp)video_getSetWindowData, "video_getSetWindowData",  "Checks SDL_SetWindowData and SDL_GetWindowData positive and negative cases", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference videoTest24 =
+        { (SDLTest_TestCaseFp)video_getSetWindowShape, "video_getSetWindowShape",  "Checks SDL_CreateShapedWindow, SDL_SetWindowShape and SDL_GetShapedWindowMode positive and negative cases", TEST_ENABLED };
+
 /* Sequence of Video test cases */
 static const SDLTest_TestCaseReference *videoTests[] =  {
     &videoTest1, &videoTest2, &videoTest3, &videoTest4, &videoTest5, &videoTest6,
     &videoTest7, &videoTest8, &videoTest9, &videoTest10, &videoTest11, &videoTest12,
     &videoTest13, &videoTest14, &videoTest15, &videoTest16, &videoTest17,
     &videoTest18, &videoTest19, &videoTest20, &videoTest21, &videoTest22,
-    &videoTest23, NULL
+    &videoTest23, &videoTest24, NULL
 };
 
 /* Video test suite (global) */